@@ -29,7 +29,7 @@
 #include <cstdint>    // for uint32_t
 #include <stdexcept>  // for overflow_error, underflow_error
 #include <string>     // for string
-#include <utility>    // for pair
+#include <utility>    // for pair, move
 #include <vector>     // for vector
 
 #include <boost/algorithm/string.hpp>  // TODO: Convert Uility.h over to boost algorithms (or the other way around?)
@@ -87,12 +87,11 @@ public:
     //! full instruction and binary form of opcode and separate operands
     Assembly_Instruction(const std::string& p_opcode,  // TODO: Maybe refactor?
                          std::vector<std::string> p_operands)
-        : m_opcode(p_opcode)
+        : m_opcode(p_opcode), m_operands(std::move(p_operands))
     {
-        for (std::string& operand : p_operands)
+        for (std::string& operand : m_operands)
         {
             boost::algorithm::trim(operand);  // Remove whitespace
-            m_operands.push_back(operand);
         }
     }
 
@@ -104,10 +103,42 @@ public:
 
     // Move constructor
     Assembly_Instruction(Assembly_Instruction&& other) noexcept
-        : m_opcode(std::move(other.m_opcode)), m_operands(other.m_operands)
+        : m_opcode(std::move(other.m_opcode)),
+          m_operands(std::move(other.m_operands))
     {
     }
 
+    //! @brief Creates an instruction from its human readable form, as
+    //! recorded by a simulator e.g. "add r0, r1". Everything before the first
+    //! space is the opcode and the rest is split into operands on commas.
+    //! @param p_instruction The instruction as a string.
+    //! @returns The parsed instruction.
+    // TODO: Some instructions don't have operands, this fails with those.
+    static Assembly_Instruction Parse(std::string p_instruction)
+    {
+        // Remove the opcode from the instruction and store it separately. If
+        // there is no space then the whole instruction is the opcode.
+        const auto position = p_instruction.find(' ');
+        const std::string opcode{p_instruction.substr(0, position)};
+        if (std::string::npos == position)
+        {
+            p_instruction.clear();
+        }
+        else
+        {
+            p_instruction.erase(0, position + 1);
+        }
+
+        // Remove white space
+        boost::algorithm::trim(p_instruction);
+
+        // Convert the rest of the instruction into a list of operands
+        std::vector<std::string> operands;
+        boost::split(operands, p_instruction, boost::is_any_of(","));
+
+        return Assembly_Instruction(opcode, std::move(operands));
+    }
+
     //! @todo document
     //! Move constructor
     //// TODO: should move be exchange?
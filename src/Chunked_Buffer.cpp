@@ -0,0 +1,171 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Chunked_Buffer.cpp
+    @brief Contains the Chunked_Buffer class which stores a large array in
+    fixed size chunks, spilling chunks to a temporary file once too much
+    memory is in use.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for count_if
+#include <atomic>     // for atomic
+#include <cstdlib>    // for getenv, mkstemp
+#include <limits>     // for numeric_limits
+#include <string>     // for string
+
+#include <sys/mman.h>  // for mmap, munmap
+#include <unistd.h>    // for close, ftruncate, unlink
+
+#include "Chunked_Buffer.hpp"
+
+#include "Error.hpp"          // for Report_Error
+#include "Memory_Budget.hpp"  // for Memory_Budget
+
+namespace
+{
+//! The bytes held in memory by the chunks of every Chunked_Buffer.
+std::atomic<std::size_t> memory_used{0};
+
+//! The number of bytes chunks can hold in memory before they are spilled.
+std::atomic<std::size_t> memory_limit{std::numeric_limits<std::size_t>::max()};
+}  // namespace
+
+GILES::Internal::Chunked_Buffer::Chunked_Buffer(const std::size_t p_size)
+    : m_size{p_size}, m_chunks{}, m_file{-1}, m_file_size{0}
+{
+    m_chunks.reserve((m_size + Chunk_Length - 1) / Chunk_Length);
+    try
+    {
+        for (std::size_t first{0}; first < m_size; first += Chunk_Length)
+        {
+            const std::size_t bytes{chunk_bytes(m_chunks.size())};
+            if (memory_used.fetch_add(bytes) + bytes <= memory_limit)
+            {
+                m_chunks.push_back(
+                    {new std::size_t[bytes / sizeof(std::size_t)](), false});
+                Memory_Budget::Add(bytes);
+            }
+            else
+            {
+                memory_used -= bytes;
+                m_chunks.push_back({spill_chunk(bytes), true});
+            }
+        }
+    }
+    catch (...)
+    {
+        // The destructor is not called if the constructor fails.
+        release();
+        throw;
+    }
+}
+
+GILES::Internal::Chunked_Buffer::~Chunked_Buffer() { release(); }
+
+void GILES::Internal::Chunked_Buffer::release()
+{
+    for (std::size_t i{0}; i < m_chunks.size(); ++i)
+    {
+        const std::size_t bytes{chunk_bytes(i)};
+        if (m_chunks[i].Spilled)
+        {
+            ::munmap(m_chunks[i].Data, bytes);
+        }
+        else
+        {
+            delete[] m_chunks[i].Data;
+            memory_used -= bytes;
+            Memory_Budget::Remove(bytes);
+        }
+    }
+    m_chunks.clear();
+
+    if (-1 != m_file)
+    {
+        ::close(m_file);
+        m_file = -1;
+    }
+}
+
+std::size_t*
+GILES::Internal::Chunked_Buffer::spill_chunk(const std::size_t p_bytes)
+{
+    if (-1 == m_file)
+    {
+        const char* const directory{std::getenv("TMPDIR")};
+        std::string path{nullptr == directory ? "/tmp" : directory};
+        path += "/GILES-XXXXXX";
+
+        m_file = ::mkstemp(path.data());
+        if (-1 == m_file)
+        {
+            Error::Report_Error(
+                "Could not create a temporary file in '{}' to hold the "
+                "recorded execution",
+                nullptr == directory ? "/tmp" : directory);
+        }
+        ::unlink(path.c_str());
+    }
+
+    // Every chunk but the last is a multiple of the page size, so each new
+    // chunk starts on a page boundary.
+    if (0 != ::ftruncate(m_file, static_cast<off_t>(m_file_size + p_bytes)))
+    {
+        Error::Report_Error("Could not extend the temporary file holding the "
+                            "recorded execution");
+    }
+    void* const data{::mmap(nullptr,
+                            p_bytes,
+                            PROT_READ | PROT_WRITE,
+                            MAP_SHARED,
+                            m_file,
+                            static_cast<off_t>(m_file_size))};
+    if (MAP_FAILED == data)
+    {
+        Error::Report_Error("Could not map the temporary file holding the "
+                            "recorded execution");
+    }
+    m_file_size += p_bytes;
+
+    // New parts of the file read as zero so there is no need to clear it.
+    return static_cast<std::size_t*>(data);
+}
+
+std::size_t
+GILES::Internal::Chunked_Buffer::Get_Number_Of_Spilled_Chunks() const
+{
+    return static_cast<std::size_t>(std::count_if(
+        m_chunks.begin(), m_chunks.end(), [](const Chunk& p_chunk) {
+            return p_chunk.Spilled;
+        }));
+}
+
+void GILES::Internal::Chunked_Buffer::Set_Memory_Limit(
+    const std::size_t p_bytes)
+{
+    memory_limit =
+        0 == p_bytes ? std::numeric_limits<std::size_t>::max() : p_bytes;
+}
+
+std::size_t GILES::Internal::Chunked_Buffer::Get_Memory_Used()
+{
+    return memory_used;
+}
@@ -0,0 +1,131 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Chunked_Buffer.hpp
+    @brief Contains the Chunked_Buffer class which stores a large array in
+    fixed size chunks, spilling chunks to a temporary file once too much
+    memory is in use.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef CHUNKED_BUFFER_HPP
+#define CHUNKED_BUFFER_HPP
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Chunked_Buffer
+//! @brief A fixed size array of values, zero initialised, that is stored in
+//! fixed size chunks rather than one contiguous allocation. While the total
+//! size of the chunks held in memory by every Chunked_Buffer is below the
+//! memory limit, chunks are allocated in memory. After that they are mapped
+//! from a temporary file instead, so that the operating system can page them
+//! out to disk. This allows recordings of billions of clock cycles.
+class Chunked_Buffer
+{
+public:
+    //! The number of values in each chunk. This is 1MiB of values, which is a
+    //! multiple of the page size so chunks can be mapped from a file.
+    static constexpr std::size_t Chunk_Length{std::size_t{1} << 17};
+
+private:
+    struct Chunk
+    {
+        std::size_t* Data;
+
+        //! Whether this is mapped from m_file rather than allocated.
+        bool Spilled;
+    };
+
+    std::size_t m_size;
+
+    std::vector<Chunk> m_chunks;
+
+    //! The temporary file spilled chunks are mapped from or -1 if no chunks
+    //! have been spilled. The file is deleted as soon as it is created, so it
+    //! is removed even if GILES crashes.
+    int m_file;
+
+    std::size_t m_file_size;
+
+    //! @brief Retrieves the size of a chunk. The last chunk is only as long as
+    //! it needs to be.
+    //! @param p_chunk The index of the chunk.
+    //! @returns The size in bytes.
+    std::size_t chunk_bytes(const std::size_t p_chunk) const
+    {
+        const std::size_t first{p_chunk * Chunk_Length};
+        return (m_size - first < Chunk_Length ? m_size - first : Chunk_Length) *
+               sizeof(std::size_t);
+    }
+
+    //! @brief Maps a new chunk from the end of m_file.
+    //! @param p_bytes The size of the chunk in bytes.
+    std::size_t* spill_chunk(const std::size_t p_bytes);
+
+    //! @brief Frees every chunk and closes m_file.
+    void release();
+
+public:
+    //! @brief Creates a buffer of p_size values, all zero.
+    //! @param p_size The number of values.
+    explicit Chunked_Buffer(const std::size_t p_size);
+
+    ~Chunked_Buffer();
+
+    Chunked_Buffer(const Chunked_Buffer&) = delete;
+    Chunked_Buffer& operator=(const Chunked_Buffer&) = delete;
+
+    std::size_t& operator[](const std::size_t p_index)
+    {
+        return m_chunks[p_index / Chunk_Length].Data[p_index % Chunk_Length];
+    }
+
+    const std::size_t& operator[](const std::size_t p_index) const
+    {
+        return m_chunks[p_index / Chunk_Length].Data[p_index % Chunk_Length];
+    }
+
+    std::size_t Size() const { return m_size; }
+
+    //! @brief Retrieves the number of chunks that are mapped from the
+    //! temporary file rather than held in memory.
+    //! @returns The number of chunks.
+    std::size_t Get_Number_Of_Spilled_Chunks() const;
+
+    //! @brief Sets how many bytes the chunks of every Chunked_Buffer can hold
+    //! in memory before new chunks are spilled to a temporary file. This only
+    //! affects chunks created afterwards.
+    //! @param p_bytes The limit in bytes, or 0 for no limit.
+    static void Set_Memory_Limit(const std::size_t p_bytes);
+
+    //! @brief Retrieves the number of bytes held in memory by the chunks of
+    //! every Chunked_Buffer.
+    //! @returns The number of bytes.
+    static std::size_t Get_Memory_Used();
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // CHUNKED_BUFFER_HPP
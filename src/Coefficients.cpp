@@ -23,7 +23,7 @@
     @copyright GNU Affero General Public License Version 3+
 */
 
-#include <algorithm>  // for find
+#include <algorithm>  // for all_of
 #include <stdexcept>  // for out_of_range
 
 #include "Coefficients.hpp"
@@ -32,6 +32,54 @@ namespace GILES
 {
 namespace Internal
 {
+GILES::Internal::Coefficients::Coefficients(
+    const nlohmann::json& p_coefficients)
+    : m_coefficients(p_coefficients), m_categories{}, m_term_coefficients{}
+{
+    // emplace keeps the first category found for each instruction, the same as
+    // searching the categories in order.
+    for (const auto& category : m_coefficients.items())
+    {
+        // The Instruction Categories are optional. If there are no
+        // categories then the 'category' is simply the opcode
+        m_categories.emplace(category.key(), category.key());
+
+        // Ensure this category has an instruction section before accessing it.
+        if (const auto instructions = category.value().find("Instructions");
+            category.value().end() != instructions)
+        {
+            for (const auto& instruction : *instructions)
+            {
+                if (instruction.is_string())
+                {
+                    m_categories.emplace(instruction.get<std::string>(),
+                                         category.key());
+                }
+            }
+        }
+
+        if (const auto terms = category.value().find("Coefficients");
+            category.value().end() != terms && terms->is_object())
+        {
+            for (const auto& term : terms->items())
+            {
+                // Other terms are indexed by a further category, so they are
+                // retrieved using Get_Coefficient instead.
+                if (term.value().is_array() &&
+                    std::all_of(term.value().begin(),
+                                term.value().end(),
+                                [](const auto& p_value) {
+                                    return p_value.is_number();
+                                }))
+                {
+                    m_term_coefficients[category.key()].emplace(
+                        term.key(), term.value().get<std::vector<double>>());
+                }
+            }
+        }
+    }
+}
+
 //! @brief Retrieves the category that the given instruction is contained
 //! within. This is a utility function that is used to assist in retrieving
 //! other
@@ -48,30 +96,13 @@ namespace Internal
 const std::string& GILES::Internal::Coefficients::Get_Instruction_Category(
     const std::string& p_opcode) const
 {
-    for (const auto& category : m_coefficients.items())
+    const auto category = m_categories.find(p_opcode);
+    if (m_categories.end() == category)
     {
-        // The Instruction Categories are optional. If there are no
-        // categories then the 'category' is simply the opcode
-        if (category.key() == p_opcode)
-        {
-            return p_opcode;
-        }
-
-        // Ensure this category has an instruction section before accessing it.
-        if (category.value().find("Instructions") != category.value().end())
-        {
-            // If the instruction is in this category, return the name of the
-            // category.
-            if (const auto& instructions = category.value().at("Instructions");
-                instructions.end() !=
-                std::find(instructions.begin(), instructions.end(), p_opcode))
-            {
-                return category.key();
-            }
-        }
+        throw std::out_of_range("This instruction (" + p_opcode +
+                                ") was not found within the Coefficients");
     }
-    throw std::out_of_range("This instruction (" + p_opcode +
-                            ") was not found within the Coefficients");
+    return category->second;
 }
 
 //! @brief Retrieves a list of all interaction terms contained within the
@@ -106,11 +137,27 @@ GILES::Internal::Coefficients::Get_Interaction_Terms() const
 //! required for.
 //! @param p_interaction_term The interaction term from within the model
 //! that the Coefficients are required for.
-//! @returns An ordered vector of the coefficient values.
-const std::vector<double> GILES::Internal::Coefficients::Get_Coefficients(
+//! @returns An ordered vector of the coefficient values. This is not copied
+//! so it remains valid for as long as the Coefficients.
+const std::vector<double>& GILES::Internal::Coefficients::Get_Coefficients(
     const std::string& p_opcode, const std::string& p_interaction_term) const
 {
-    return get_coefficient<std::vector<double>>(p_opcode, p_interaction_term);
+    const std::string& category{Get_Instruction_Category(p_opcode)};
+    if (const auto terms = m_term_coefficients.find(category);
+        m_term_coefficients.end() != terms)
+    {
+        if (const auto coefficients = terms->second.find(p_interaction_term);
+            terms->second.end() != coefficients)
+        {
+            return coefficients->second;
+        }
+    }
+
+    // The term is missing or is not a list of values. Retrieving it from the
+    // json reports why.
+    get_coefficient<std::vector<double>>(p_opcode, p_interaction_term);
+    throw std::out_of_range("The interaction term (" + p_interaction_term +
+                            ") is not a list of coefficients");
 }
 
 //! @brief Retrieves the Constant for the Instruction Category that contains
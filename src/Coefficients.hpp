@@ -28,6 +28,7 @@
 
 #include <string>         // for string
 #include <typeinfo>       // for typeid
+#include <unordered_map>  // for unordered_map
 #include <unordered_set>  // for unordered_set
 #include <vector>         // for vector
 
@@ -54,6 +55,18 @@ class Coefficients
 private:
     const nlohmann::json m_coefficients;
 
+    //! The category that contains each instruction, indexed by opcode. These
+    //! are found once, on construction, as they are needed for every
+    //! coefficient that is retrieved.
+    std::unordered_map<std::string, std::string> m_categories;
+
+    //! The coefficients of every interaction term that is a list of values,
+    //! indexed by category and then by interaction term. These are kept
+    //! outside of the json so that they can be retrieved without being copied.
+    std::unordered_map<std::string,
+                       std::unordered_map<std::string, std::vector<double>>>
+        m_term_coefficients;
+
     //! @brief Retrieves a value from the Coefficients. This is a generic
     //! function that can retrieve anything, dependent on its parameters. The
     //! parameters in p_categories are all evaluated in the order they are
@@ -198,17 +211,24 @@ public:
     //! @warning Validation of the json p_coefficients should have already
     //! occurred, using the Validator_Coefficients class, before calling the
     //! constructor.
-    explicit Coefficients(const nlohmann::json& p_coefficients)
-        : m_coefficients(p_coefficients)
-    {
-    }
+    explicit Coefficients(const nlohmann::json& p_coefficients);
 
     const std::string&
     Get_Instruction_Category(const std::string& p_opcode) const;
 
+    //! @brief Checks whether the instruction given by p_opcode is contained
+    //! within the Coefficients. Unlike Get_Instruction_Category(), this does
+    //! not throw when it is not.
+    //! @param p_opcode The opcode of the instruction.
+    //! @returns true if the instruction was profiled, false if not.
+    bool Is_Profiled(const std::string& p_opcode) const
+    {
+        return m_categories.end() != m_categories.find(p_opcode);
+    }
+
     const std::unordered_set<std::string> Get_Interaction_Terms() const;
 
-    const std::vector<double>
+    const std::vector<double>&
     Get_Coefficients(const std::string& p_opcode,
                      const std::string& p_interaction_term) const;
 
@@ -0,0 +1,915 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Daemon.cpp
+    @brief This file contains a command line executable that keeps GILES
+    running in the background, accepting jobs over a Unix domain socket.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>           // for find, max
+#include <atomic>              // for atomic
+#include <cerrno>              // for errno, EINTR
+#include <chrono>              // for steady_clock, duration
+#include <condition_variable>  // for condition_variable
+#include <csignal>             // for signal, SIGINT, SIGTERM, sig_atomic_t
+#include <cstdlib>             // for exit, EXIT_SUCCESS
+#include <cstring>             // for strerror, strncpy
+#include <deque>               // for deque
+#include <fstream>             // for ifstream
+#include <map>                 // for map
+#include <memory>              // for shared_ptr, make_shared
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <optional>            // for optional
+#include <stdexcept>           // for invalid_argument
+#include <string>              // for string
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+#include <sys/socket.h>  // for socket, bind, listen, accept, send, recv
+#include <sys/un.h>      // for sockaddr_un
+#include <unistd.h>      // for close, unlink
+
+#include <boost/program_options.hpp>  // for options_description, value...
+#include <fmt/format.h>               // for format, print
+#include <fmt/ostream.h>              // for operator<<
+#include <nlohmann/json.hpp>          // for json
+
+#include "Abstract_Factory.hpp"  // for Model_Factory, Output_Factory
+#include "Coefficients.hpp"      // for Coefficients
+#include "Error.hpp"             // for Report_Error, Throw_Errors
+#include "GILES.cpp"             // for GILES
+#include "IO.hpp"                // for IO
+#include "Job.hpp"               // for Job
+#include "Output.hpp"            // for Output, Output_Options
+
+//! Anonymous namespace is used as this functionality is only required when
+//! building not as a library.
+namespace
+{
+std::string m_socket_path;
+std::string m_coefficients_path;
+std::string m_output_format;
+std::size_t m_concurrent_jobs;
+
+// The socket that clients connect to. This is shut down when SIGINT or
+// SIGTERM is received, which stops the daemon.
+std::atomic<int> m_listener{-1};
+volatile std::sig_atomic_t m_stop_requested{0};
+
+//! @brief Prints an error message and exits. This is to be called when the
+//! program cannot run given the supplied command line arguments.
+//! @note This function is marked as noreturn as it is guaranteed to always
+//! halt the program. (Through std::exit())
+//! @param p_message An error message can optionally be provided. This will
+//! be printed first on a separate line if provided.
+template <typename... args_t>
+[[noreturn]] void bad_options(const args_t&... p_message) {
+    fmt::print(p_message...);
+    GILES::Internal::Error::Report_Exit(
+        "\nPlease use option --help or -h to see proper usage");
+}
+
+//! @brief Interprets the command line flags.
+void parse_command_line_flags(int argc, char* argv[])
+{
+    boost::program_options::options_description options_description{fmt::format(
+        "Keeps GILES running, accepting jobs over a Unix domain socket\n"
+        "Usage: {} [--socket] SOCKET [--coefficients COEFFICIENTS]\n",
+        argv[0])};
+
+    // clang-format off
+
+    // Adds the command line options.
+    options_description.add_options()
+        ("help,h", "Print help")
+        ("socket",
+            boost::program_options::value<std::string>()->default_value(
+            "giles.sock"),
+            "The path of the Unix domain socket to accept jobs on")
+        ("coefficients,c",
+            boost::program_options::value<std::string>()->default_value(
+            "./coeffs.json"),
+            "Coefficients file, used by every job")
+        ("format",
+            boost::program_options::value<std::string>()->default_value(
+            "TRS"),
+            "The format that traces are saved in, if a job does not give one")
+        ("concurrent-jobs",
+            boost::program_options::value<std::size_t>()->default_value(2),
+            "The number of jobs that run at once. The threads available are "
+            "shared equally between them");
+    // clang-format on
+
+    boost::program_options::positional_options_description
+        positional_options_description;
+    positional_options_description.add("socket", 1);
+
+    boost::program_options::variables_map options;
+    try
+    {
+        // Parse the provided arguments.
+        boost::program_options::store(
+            boost::program_options::command_line_parser(argc, argv)
+                .options(options_description)
+                .positional(positional_options_description)
+                .run(),
+            options);
+        boost::program_options::notify(options);
+    }
+    catch (const std::exception& exception)
+    {
+        bad_options(exception.what());
+    }
+
+    if (options.count("help"))  // if help flag is passed
+    {
+        fmt::print("{}\n", options_description);
+        std::exit(EXIT_SUCCESS);
+    }
+
+    m_socket_path       = options["socket"].as<std::string>();
+    m_coefficients_path = options["coefficients"].as<std::string>();
+    m_output_format     = options["format"].as<std::string>();
+    m_concurrent_jobs   = options["concurrent-jobs"].as<std::size_t>();
+    if (0 == m_concurrent_jobs)
+    {
+        bad_options("At least one job must be able to run at once");
+    }
+}
+
+//! @brief Converts bytes into a string of hexadecimal digits.
+//! @param p_bytes The bytes.
+//! @returns The hexadecimal digits. e.g. "00ff10".
+std::string to_hex(const std::string& p_bytes)
+{
+    std::string hex;
+    for (const auto byte : p_bytes)
+    {
+        hex += fmt::format("{:02x}", static_cast<unsigned char>(byte));
+    }
+    return hex;
+}
+
+//! @class Connection
+//! @brief A client connected to the daemon. Each message sent to the client
+//! is a single line of JSON. Messages are queued and sent by a thread of their
+//! own, so that a slow client does not hold up the threads generating its
+//! traces until the queue is full. The connection is closed once it is no
+//! longer used, i.e. once the client has stopped sending jobs and every job it
+//! sent has finished.
+class Connection
+{
+private:
+    //! The number of traces that can wait to be sent before the threads
+    //! generating them wait for the client.
+    static constexpr std::size_t queued_traces_limit{256};
+
+    //! A message waiting to be sent. Traces are kept as they are, rather than
+    //! as JSON, so that they are only converted by the sending thread.
+    struct Message
+    {
+        //! The message, if this is not a trace.
+        std::optional<nlohmann::json> Status{};
+
+        std::size_t Job{0};
+        std::size_t Run{0};
+        std::vector<float> Trace{};
+        std::string Extra_Data{};
+    };
+
+    const int m_socket;
+
+    //! Bytes received that do not yet make up a whole line.
+    std::string m_received;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Message> m_queue;
+
+    //! The number of traces in m_queue.
+    std::size_t m_queued_traces;
+
+    //! Set once a message could not be sent, as the client has gone away.
+    bool m_failed;
+
+    //! Set when the connection is being closed, once m_queue is sent.
+    bool m_closing;
+
+    std::thread m_sender;
+
+    //! @brief Sends a line to the client.
+    //! @param p_line The line, including the new line.
+    //! @returns false if the client has gone away.
+    bool send(const std::string& p_line) const
+    {
+        std::size_t sent{0};
+        while (sent < p_line.size())
+        {
+            const auto result = ::send(m_socket,
+                                       p_line.data() + sent,
+                                       p_line.size() - sent,
+                                       MSG_NOSIGNAL);
+            if (result < 0 && EINTR == errno)
+            {
+                continue;
+            }
+            if (result < 0)
+            {
+                return false;
+            }
+            sent += static_cast<std::size_t>(result);
+        }
+        return true;
+    }
+
+    //! @brief Sends the queued messages, in order, until the connection is
+    //! closed. If the client goes away the rest are dropped.
+    void send_messages()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (true)
+        {
+            m_condition.wait(
+                lock, [this] { return m_closing || !m_queue.empty(); });
+            if (m_queue.empty())
+            {
+                return;
+            }
+            Message message{std::move(m_queue.front())};
+            m_queue.pop_front();
+            lock.unlock();
+
+            const std::string line{
+                message.Status
+                    ? message.Status->dump()
+                    : nlohmann::json{{"job", message.Job},
+                                     {"run", message.Run},
+                                     {"trace", message.Trace},
+                                     {"extra_data", to_hex(message.Extra_Data)}}
+                          .dump()};
+            const bool sent{send(line + "\n")};
+
+            lock.lock();
+            if (!message.Status)
+            {
+                --m_queued_traces;
+            }
+            if (!sent)
+            {
+                m_failed = true;
+                m_queue.clear();
+                m_queued_traces = 0;
+            }
+            m_condition.notify_all();
+        }
+    }
+
+public:
+    explicit Connection(const int p_socket)
+        : m_socket{p_socket}, m_received{}, m_mutex{}, m_condition{},
+          m_queue{}, m_queued_traces{0}, m_failed{false}, m_closing{false},
+          m_sender{}
+    {
+        m_sender = std::thread{&Connection::send_messages, this};
+    }
+
+    //! @brief Sends the messages still queued and closes the connection.
+    ~Connection()
+    {
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            m_closing = true;
+        }
+        m_condition.notify_all();
+        m_sender.join();
+        ::close(m_socket);
+    }
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    //! @brief Queues a message to be sent. If the client has gone away the
+    //! message is dropped, as there is no one left to tell.
+    //! @param p_message The message.
+    void Send(const nlohmann::json& p_message)
+    {
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_failed)
+            {
+                return;
+            }
+            m_queue.push_back({p_message});
+        }
+        m_condition.notify_all();
+    }
+
+    //! @brief Queues a trace to be sent, waiting while too many are queued
+    //! already. This can be called from any thread.
+    //! @param p_job The number of the job that generated the trace.
+    //! @param p_run_index The index of the run that generated the trace.
+    //! @param p_trace The trace.
+    //! @param p_extra_data The extra data of the trace.
+    //! @returns false if the client has gone away, in which case the trace is
+    //! dropped.
+    bool Send_Trace(const std::size_t p_job,
+                    const std::size_t p_run_index,
+                    const std::vector<float>& p_trace,
+                    const std::string& p_extra_data)
+    {
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_condition.wait(lock, [this] {
+                return m_failed || m_queued_traces < queued_traces_limit;
+            });
+            if (m_failed)
+            {
+                return false;
+            }
+            m_queue.push_back(
+                {std::nullopt, p_job, p_run_index, p_trace, p_extra_data});
+            ++m_queued_traces;
+        }
+        m_condition.notify_all();
+        return true;
+    }
+
+    //! @brief Disconnects the client, e.g. as the daemon is stopping. A call
+    //! to Receive() that is waiting returns and messages are no longer sent.
+    void Shut_Down() const { ::shutdown(m_socket, SHUT_RDWR); }
+
+    //! @brief Waits for the client to send a line. This must only be called
+    //! from one thread.
+    //! @param p_line Where to store the line, without the new line.
+    //! @returns true if a line was received, false if the client has stopped
+    //! sending.
+    bool Receive(std::string* const p_line)
+    {
+        std::size_t end;
+        while (std::string::npos == (end = m_received.find('\n')))
+        {
+            char buffer[4096];
+            const auto result = ::recv(m_socket, buffer, sizeof(buffer), 0);
+            if (result < 0 && EINTR == errno)
+            {
+                continue;
+            }
+            if (result <= 0)
+            {
+                return false;
+            }
+            m_received.append(buffer, static_cast<std::size_t>(result));
+        }
+
+        *p_line = m_received.substr(0, end);
+        m_received.erase(0, end + 1);
+        return true;
+    }
+};
+
+//! A job sent by a client.
+struct Request
+{
+    std::shared_ptr<Connection> Client;
+
+    //! The position of the job among those sent by the client, starting at 1.
+    std::size_t Number;
+
+    GILES::Internal::Job Job;
+};
+
+//! @class Scheduler
+//! @brief Holds the jobs waiting to run. Clients take turns to have a job
+//! started, so that a client sending many jobs does not hold up the others.
+class Scheduler
+{
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    //! The jobs waiting to run, by client.
+    std::map<Connection*, std::deque<Request>> m_waiting;
+
+    //! The clients with jobs waiting, in the order they will be served.
+    std::deque<Connection*> m_turns;
+
+    //! The jobs that are running, and the client that sent each, so that
+    //! they can be stopped.
+    std::map<GILES::GILES*, Connection*> m_running;
+
+    bool m_stopping;
+
+public:
+    Scheduler()
+        : m_mutex{}, m_condition{}, m_waiting{}, m_turns{}, m_running{},
+          m_stopping{false}
+    {
+    }
+
+    //! @brief Adds a job to those waiting to run.
+    //! @param p_request The job.
+    void Submit(Request p_request)
+    {
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            auto& waiting = m_waiting[p_request.Client.get()];
+            if (waiting.empty())
+            {
+                m_turns.push_back(p_request.Client.get());
+            }
+            waiting.push_back(std::move(p_request));
+        }
+        m_condition.notify_one();
+    }
+
+    //! @brief Waits for a job to run.
+    //! @returns The next job, or nothing if the daemon is stopping.
+    std::optional<Request> Next()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_condition.wait(
+            lock, [this] { return m_stopping || !m_turns.empty(); });
+        if (m_stopping)
+        {
+            return std::nullopt;
+        }
+
+        Connection* const client{m_turns.front()};
+        m_turns.pop_front();
+
+        auto& waiting = m_waiting[client];
+        Request request{std::move(waiting.front())};
+        waiting.pop_front();
+        if (waiting.empty())
+        {
+            m_waiting.erase(client);
+        }
+        else
+        {
+            m_turns.push_back(client);
+        }
+        return request;
+    }
+
+    //! @brief Records that a job is running, so that it is stopped along with
+    //! the daemon or if its client goes away.
+    //! @param p_giles The job.
+    //! @param p_client The client that sent the job.
+    //! @returns false if the daemon is stopping, in which case the job should
+    //! not be ran.
+    bool Started(GILES::GILES* const p_giles, Connection* const p_client)
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_running.emplace(p_giles, p_client);
+        return !m_stopping;
+    }
+
+    //! @brief Records that a job has finished.
+    //! @param p_giles The job.
+    void Finished(GILES::GILES* const p_giles)
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_running.erase(p_giles);
+    }
+
+    //! @brief Stops the running jobs sent by a client, once the traces
+    //! already being generated are sent, and drops those still waiting. This
+    //! is used once the client has gone away.
+    //! @param p_client The client.
+    void Cancel(Connection* const p_client)
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        for (const auto& [giles, client] : m_running)
+        {
+            if (client == p_client)
+            {
+                giles->Stop();
+            }
+        }
+        if (0 != m_waiting.erase(p_client))
+        {
+            m_turns.erase(
+                std::find(m_turns.begin(), m_turns.end(), p_client));
+        }
+    }
+
+    //! @brief Stops every running job, once the traces already being
+    //! generated are saved, and prevents any more from starting.
+    void Stop()
+    {
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            m_stopping = true;
+            for (const auto& running : m_running)
+            {
+                running.first->Stop();
+            }
+        }
+        m_condition.notify_all();
+    }
+};
+
+//! @class Output_Stream
+//! @brief Sends every trace to a client as it is generated, for jobs that do
+//! not save their traces to a file. If the client goes away every job it
+//! sent is cancelled, as there is no one left to send the traces to.
+class Output_Stream : public GILES::Internal::Output
+{
+private:
+    const std::shared_ptr<Connection> m_connection;
+    const std::size_t m_job;
+    Scheduler& m_scheduler;
+
+public:
+    Output_Stream(const std::shared_ptr<Connection>& p_connection,
+                  const std::size_t p_job,
+                  Scheduler& p_scheduler)
+        : Output{GILES::Internal::Output_Options{}},
+          m_connection{p_connection}, m_job{p_job}, m_scheduler{p_scheduler}
+    {
+    }
+
+    void Start(const std::size_t /*p_number_of_runs*/,
+               const std::size_t /*p_number_of_threads*/) override
+    {
+    }
+
+    void Add_Trace(const std::size_t /*p_thread*/,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override
+    {
+        if (!m_connection->Send_Trace(
+                m_job, p_run_index, p_trace, p_extra_data))
+        {
+            m_scheduler.Cancel(m_connection.get());
+        }
+    }
+
+    void Finish() override {}
+};
+
+//! @brief Checks that a job can be ran, so that a mistake by one client does
+//! not stop the daemon for every client.
+//! @param p_job The job.
+//! @throws std::invalid_argument If the job can not be ran, describing why in
+//! the same way as IO::Parse_Job().
+void check_job(const GILES::Internal::Job& p_job)
+{
+    if (!std::ifstream{p_job.Program_Path})
+    {
+        throw std::invalid_argument{
+            fmt::format("has a program, '{}', that could not be opened",
+                        p_job.Program_Path)};
+    }
+    if (0 == GILES::Internal::Model_Factory::Get_All().count(p_job.Model_Name))
+    {
+        throw std::invalid_argument{
+            fmt::format("has a model, '{}', that could not be found",
+                        p_job.Model_Name)};
+    }
+    const auto format = p_job.Output_Format.value_or(m_output_format);
+    if (p_job.Traces_Path &&
+        0 == GILES::Internal::Output_Factory::Get_All().count(format))
+    {
+        throw std::invalid_argument{
+            fmt::format("has a format, '{}', that could not be found",
+                        format)};
+    }
+    if (0 == p_job.Number_Of_Runs)
+    {
+        throw std::invalid_argument{"needs at least one run"};
+    }
+}
+
+//! @brief Receives jobs from a client until it stops sending, adding each to
+//! those waiting to run.
+//! @param p_client The client.
+//! @param p_scheduler Where jobs wait to run.
+void receive_jobs(std::shared_ptr<Connection> p_client,
+                  Scheduler* const p_scheduler)
+{
+    std::size_t number{0};
+    std::string line;
+    while (p_client->Receive(&line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+        ++number;
+
+        try
+        {
+            auto job = GILES::Internal::IO().Parse_Job(line);
+            check_job(job);
+
+            p_client->Send({{"job", number}, {"status", "queued"}});
+            p_scheduler->Submit({p_client, number, std::move(job)});
+        }
+        catch (const std::exception& exception)
+        {
+            const auto message =
+                fmt::format("Job {} {}", number, exception.what());
+            p_client->Send({{"job", number},
+                            {"status", "error"},
+                            {"message", message}});
+        }
+    }
+}
+
+//! @class Clients
+//! @brief The clients connected to the daemon, each served by its own thread
+//! until it stops sending jobs. These are kept so that, when the daemon stops,
+//! every client is disconnected and its thread has finished before the
+//! Scheduler it submits jobs to is destroyed.
+class Clients
+{
+private:
+    struct Client
+    {
+        //! The connection to the client. This is kept weakly, so that the
+        //! connection is still closed once it is no longer used.
+        std::weak_ptr<Connection> Link;
+
+        std::thread Thread;
+
+        //! Set once the thread has finished, so that it can be joined.
+        std::shared_ptr<std::atomic<bool>> Finished;
+    };
+
+    std::vector<Client> m_clients;
+
+    //! @brief Joins the threads of the clients that have stopped sending
+    //! jobs, and forgets the clients whose connections have been closed.
+    void join_finished()
+    {
+        for (auto client = m_clients.begin(); client != m_clients.end();)
+        {
+            if (*client->Finished && client->Thread.joinable())
+            {
+                client->Thread.join();
+            }
+            if (!client->Thread.joinable() && client->Link.expired())
+            {
+                client = m_clients.erase(client);
+            }
+            else
+            {
+                ++client;
+            }
+        }
+    }
+
+public:
+    Clients() : m_clients{} {}
+
+    ~Clients() { Disconnect(); }
+
+    Clients(const Clients&) = delete;
+    Clients& operator=(const Clients&) = delete;
+
+    //! @brief Starts receiving jobs from a client that has connected.
+    //! @param p_socket The socket of the client.
+    //! @param p_scheduler Where jobs wait to run. This must outlive every
+    //! client, i.e. until Disconnect() has been called.
+    void Add(const int p_socket, Scheduler* const p_scheduler)
+    {
+        join_finished();
+
+        const auto connection = std::make_shared<Connection>(p_socket);
+        const auto finished   = std::make_shared<std::atomic<bool>>(false);
+        m_clients.push_back(
+            {connection,
+             std::thread{[connection, p_scheduler, finished] {
+                 receive_jobs(connection, p_scheduler);
+                 *finished = true;
+             }},
+             finished});
+    }
+
+    //! @brief Disconnects every client, including those still waiting for
+    //! their jobs after they have stopped sending, and waits for their
+    //! threads to finish.
+    void Disconnect()
+    {
+        for (const auto& client : m_clients)
+        {
+            if (const auto connection = client.Link.lock())
+            {
+                connection->Shut_Down();
+            }
+        }
+        for (auto& client : m_clients)
+        {
+            if (client.Thread.joinable())
+            {
+                client.Thread.join();
+            }
+        }
+        m_clients.clear();
+    }
+};
+
+//! @brief Runs jobs until the daemon is stopped.
+//! @param p_coefficients The Coefficients used by every job.
+//! @param p_number_of_threads The number of threads each job uses.
+//! @param p_scheduler Where jobs wait to run.
+void run_jobs(
+    const std::shared_ptr<const GILES::Internal::Coefficients>& p_coefficients,
+    const std::size_t p_number_of_threads,
+    Scheduler* const p_scheduler)
+{
+    while (auto request = p_scheduler->Next())
+    {
+        const auto& job = request->Job;
+
+        GILES::GILES giles{job.Program_Path,
+                           p_coefficients,
+                           job.Traces_Path,
+                           job.Number_Of_Runs,
+                           job.Model_Name};
+        giles.Set_Output_Format(job.Output_Format.value_or(m_output_format));
+        giles.Set_Number_Of_Threads(p_number_of_threads);
+        if (job.Fault)
+        {
+            giles.Inject_Fault(
+                job.Fault_Cycle, job.Fault_Register, job.Fault_Bit);
+        }
+        if (job.Timeout)
+        {
+            giles.Set_Timeout(job.Timeout.value());
+        }
+        if (!job.Traces_Path)
+        {
+            giles.Add_Output(std::make_shared<Output_Stream>(
+                request->Client, request->Number, *p_scheduler));
+        }
+
+        if (!p_scheduler->Started(&giles, request->Client.get()))
+        {
+            p_scheduler->Finished(&giles);
+            break;
+        }
+        request->Client->Send(
+            {{"job", request->Number}, {"status", "running"}});
+
+        // An error only fails this job rather than stopping the daemon.
+        const auto start_time = std::chrono::steady_clock::now();
+        std::optional<std::string> error;
+        try
+        {
+            const GILES::Internal::Error::Throw_Errors throw_errors;
+            giles.Run();
+        }
+        catch (const std::exception& exception)
+        {
+            error = exception.what();
+        }
+        const std::chrono::duration<double> elapsed{
+            std::chrono::steady_clock::now() - start_time};
+
+        p_scheduler->Finished(&giles);
+        if (error)
+        {
+            const auto message = fmt::format(
+                "Job {} failed. {}", request->Number, error.value());
+            request->Client->Send({{"job", request->Number},
+                                   {"status", "error"},
+                                   {"message", message}});
+            continue;
+        }
+        request->Client->Send({{"job", request->Number},
+                               {"status", "done"},
+                               {"seconds", elapsed.count()}});
+    }
+}
+
+//! @brief Stops the daemon when SIGINT or SIGTERM is received, by shutting
+//! down the socket that clients connect to.
+//! @param p_signal The signal that was received.
+void handle_stop_signal(const int p_signal)
+{
+    std::signal(p_signal, SIG_DFL);
+    m_stop_requested = 1;
+    ::shutdown(m_listener, SHUT_RDWR);
+}
+
+//! @brief Opens the socket that clients connect to. A socket left behind by
+//! a daemon that is no longer running is replaced.
+//! @returns The socket.
+int listen_for_clients()
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (m_socket_path.size() >= sizeof(address.sun_path))
+    {
+        GILES::Internal::Error::Report_Error("The socket path '{}' is too long",
+                                             m_socket_path);
+    }
+    std::strncpy(
+        address.sun_path, m_socket_path.c_str(), sizeof(address.sun_path) - 1);
+    const auto* const socket_address =
+        reinterpret_cast<const sockaddr*>(&address);
+
+    const int existing{::socket(AF_UNIX, SOCK_STREAM, 0)};
+    if (existing >= 0 &&
+        0 == ::connect(existing, socket_address, sizeof(address)))
+    {
+        GILES::Internal::Error::Report_Error(
+            "Another daemon is already using '{}'", m_socket_path);
+    }
+    ::close(existing);
+    ::unlink(m_socket_path.c_str());
+
+    const int listener{::socket(AF_UNIX, SOCK_STREAM, 0)};
+    if (listener < 0 ||
+        0 != ::bind(listener, socket_address, sizeof(address)) ||
+        0 != ::listen(listener, SOMAXCONN))
+    {
+        GILES::Internal::Error::Report_Error("Could not listen on '{}'. {}",
+                                             m_socket_path,
+                                             std::strerror(errno));
+    }
+    return listener;
+}
+}  // namespace
+
+//! @brief The entry point of the program.
+int main(int argc, char* argv[])
+{
+    parse_command_line_flags(argc, argv);
+
+    // Check the format before doing any work.
+    GILES::Internal::Output_Factory::Find(m_output_format);
+
+    const auto coefficients =
+        std::make_shared<const GILES::Internal::Coefficients>(
+            GILES::Internal::IO().Load_Coefficients(m_coefficients_path));
+
+    m_listener = listen_for_clients();
+    std::signal(SIGINT, handle_stop_signal);
+    std::signal(SIGTERM, handle_stop_signal);
+
+    // The threads available are shared equally between the jobs running.
+    const std::size_t number_of_threads{std::max<std::size_t>(
+        1, std::thread::hardware_concurrency() / m_concurrent_jobs)};
+
+    Scheduler scheduler;
+    Clients clients;
+    std::vector<std::thread> workers;
+    for (std::size_t i{0}; i < m_concurrent_jobs; ++i)
+    {
+        workers.emplace_back(
+            run_jobs, coefficients, number_of_threads, &scheduler);
+    }
+
+    fmt::print("Accepting jobs on '{}'\n", m_socket_path);
+    while (0 == m_stop_requested)
+    {
+        const int client{::accept(m_listener, nullptr, nullptr)};
+        if (client < 0)
+        {
+            if (EINTR == errno || 0 != m_stop_requested)
+            {
+                continue;
+            }
+            GILES::Internal::Error::Report_Error(
+                "Could not accept a client. {}", std::strerror(errno));
+        }
+
+        // Clients are served by their own thread, which finishes once the
+        // client stops sending jobs.
+        clients.Add(client, &scheduler);
+    }
+
+    fmt::print("Stopping...\n");
+    scheduler.Stop();
+    clients.Disconnect();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    ::close(m_listener);
+    ::unlink(m_socket_path.c_str());
+    return 0;
+}
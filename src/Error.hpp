@@ -26,9 +26,10 @@
 #ifndef ERROR_HPP
 #define ERROR_HPP
 
-#include <cstdlib>  // for exit, EXIT_FAILURE
+#include <cstdlib>    // for exit, EXIT_FAILURE
+#include <stdexcept>  // for runtime_error
 
-#include <fmt/format.h>  // for print, vprint, make_format_args.
+#include <fmt/format.h>  // for print, vprint, vformat, make_format_args.
 
 namespace GILES
 {
@@ -39,7 +40,54 @@ namespace Internal
 //! loading the Coefficients file and saving generated Traces.
 struct Error
 {
+public:
+    //! @class Exception
+    //! @brief Thrown by Report_Error(), instead of stopping execution, while a
+    //! Throw_Errors object exists on the calling thread. The message is the
+    //! formatted error message.
+    class Exception : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    //! @class Throw_Errors
+    //! @brief While this exists, Report_Error() throws an Exception on the
+    //! thread that constructed it rather than stopping execution. This allows
+    //! GILES to be used within a program that must keep running after an
+    //! error, such as a service running many jobs.
+    class Throw_Errors
+    {
+    private:
+        const bool m_previous;
+
+    public:
+        //! @param p_enabled Whether errors are thrown. This allows a thread to
+        //! match the behaviour of the thread that started it.
+        explicit Throw_Errors(const bool p_enabled = true)
+            : m_previous{Is_Throwing()}
+        {
+            throwing() = p_enabled;
+        }
+
+        ~Throw_Errors() { throwing() = m_previous; }
+
+        Throw_Errors(const Throw_Errors&) = delete;
+        Throw_Errors& operator=(const Throw_Errors&) = delete;
+    };
+
+    //! @returns Whether Report_Error() throws an Exception on the calling
+    //! thread, rather than stopping execution.
+    static bool Is_Throwing() { return throwing(); }
+
 private:
+    //! @returns Whether errors are thrown on the calling thread.
+    static bool& throwing()
+    {
+        thread_local bool throwing{false};
+        return throwing;
+    }
+
     //! @brief Prints a formatted error message followed by a newline.
     //! @param p_format The format string to be printed.
     //! @param p_args The arguments to be printed in the format string.
@@ -62,7 +110,8 @@ private:
     }
 
     //! @brief Prints a new line followed by: "Error: ", followed by a formatted
-    //! error message and stops execution.
+    //! error message and stops execution. If errors are being thrown then an
+    //! Exception holding the message is thrown instead.
     //! @note This function is marked as noreturn as it is guaranteed to always
     //! halt the program. (Through std::exit())
     //! @param p_format The format string to be printed.
@@ -70,6 +119,10 @@ private:
     [[noreturn]] static void vreport_error(const char* p_format,
                                            fmt::format_args p_args)
     {
+        if (throwing())
+        {
+            throw Exception{fmt::vformat(p_format, p_args)};
+        }
         fmt::print("\nError: ");
         vreport_exit(p_format, p_args);
     }
@@ -88,7 +141,8 @@ public:
     //! @brief Prints "Error: " followed by a formatted error message and stops
     //! execution.
     //! @note This function is marked as noreturn as it is guaranteed to always
-    //! halt the program. (Through std::exit())
+    //! halt the program. (Through std::exit()) If a Throw_Errors object exists
+    //! on the calling thread then an Exception is thrown instead.
     //! @param p_format The format string to be printed.
     //! @param p_args The arguments to be printed in the format string.:
     template <typename... Args>
@@ -27,20 +27,26 @@
 #ifndef EXECUTION_HPP
 #define EXECUTION_HPP
 
-#include <algorithm>  // for min
-#include <any>        // for any, any_cast, bad_any_cast
-#include <deque>      // for deque
-#include <map>        // for map
-#include <memory>     // for shared_ptr
-#include <stdexcept>  // for range_error
-#include <string>     // for string
-#include <vector>     // for vector
-
-#include <boost/algorithm/string.hpp>  // TODO: Convert Uility.h over to boost algorithms (or the other way around?)
-
-#include "Assembly_Instruction.hpp"
-#include "Error.hpp"    // for Report_Error
-#include "Utility.hpp"  // for string_split
+#include <algorithm>    // for min
+#include <any>          // for any, any_cast, bad_any_cast
+#include <cerrno>       // for errno, ERANGE
+#include <cstdlib>      // for strtol
+#include <deque>        // for deque
+#include <limits>       // for numeric_limits
+#include <map>          // for map
+#include <memory>       // for shared_ptr, make_shared
+#include <optional>     // for optional
+#include <stdexcept>    // for range_error, out_of_range
+#include <string>       // for string
+#include <type_traits>  // for is_same_v
+#include <utility>      // for move
+#include <vector>       // for vector
+
+#include "Assembly_Instruction.hpp"  // for Assembly_Instruction
+#include "Error.hpp"                 // for Report_Error
+#include "Instruction_Stream.hpp"    // for Instruction_Stream
+#include "Pipeline_States.hpp"       // for Pipeline_State
+#include "Register_Delta.hpp"        // for Register_Delta, Register_Columns
 
 #include <iostream>  // for temp debugging
 
@@ -58,25 +64,25 @@ namespace Internal
 class Execution
 {
 public:
-    //! The states that a processor pipeline stage can be in. These are needed
-    //! to be stored as if the pipeline stage is not running smoothly (i.e.
-    //! Normal state) then it could prevent leakage from being calculated in a
-    //! normal fashion.
-    //! @see https://en.wikipedia.org/wiki/Pipeline_stall
-    //! @see https://en.wikipedia.org/wiki/Pipeline_flush
-    enum class State
-    {
-        Normal,
-        Stalled,
-        Flushing
-    };
+    //! The states that a processor pipeline stage can be in.
+    //! @see Pipeline_State
+    using State = Pipeline_State;
 
 private:
+    //! The number of clock cycles that occurred during the execution.
+    std::size_t m_number_of_cycles;
+
+    //! The pipeline stages as recorded by the simulator. These are the same on
+    //! every run of a constant time program and so are shared between every
+    //! Execution of that program rather than copied into each one.
+    std::shared_ptr<const Instruction_Stream> m_instruction_stream;
+
     //! @brief A data structure for storing the per clock cycle pipeline of any
     //! given processor. The values are indexed by clock cycle and then by
-    //! pipeline stage. For each clock cycle (stored as a vector) there will be
-    //! a map storing the value for that pipeline stage, during that cycle, as
-    //! indexed by the name of the pipeline stage.
+    //! pipeline stage. For each clock cycle there will be a map storing the
+    //! value for that pipeline stage, during that cycle, as indexed by the
+    //! name of the pipeline stage. Only cycles that values have been added to
+    //! are stored. These take priority over m_instruction_stream.
     //! clock cycle no<pipe stage<pipe_name, <value state, value>>>
     //! e.g. 20<<"Decode", <Normal, <"str r1, r2">>>>
     //! @see https://en.wikipedia.org/wiki/Instruction_pipelining
@@ -86,14 +92,91 @@ private:
     //! containers. Resizing of the vector caused the copy constructor to be
     //! called on unique_ptr causing a compile error.
     // TODO: const correctness
-    std::vector<std::map<const std::string, std::any>> m_pipeline;
+    std::map<std::size_t, std::map<const std::string, std::any>> m_pipeline;
+
+    //! The instructions in m_pipeline that have been retrieved with
+    //! Get_Instruction(), already parsed. These are indexed in the same way as
+    //! m_pipeline. Instructions in m_instruction_stream are parsed by the
+    //! stream instead, so that they are shared. As this is filled in by a
+    //! const function, an Execution with values added to it directly should
+    //! only be used by one thread at a time.
+    mutable std::map<std::size_t, std::map<std::string, Assembly_Instruction>>
+        m_instructions;
 
     // TODO: const correctness
     //! The state of the processor registers during each cycle of the execution
-    //! of the target program.
+    //! of the target program. This is only sized once registers are added, so
+    //! it may be shorter than the execution.
     //! @see https://en.wikipedia.org/wiki/Processor_register
     std::vector<std::map<std::string, std::size_t>> m_registers;
 
+    //! When set, the registers are stored here, packed into a fixed size value
+    //! per register per cycle, instead of in m_registers.
+    //! @see Add_Registers_Columns
+    std::shared_ptr<const Register_Columns> m_register_columns;
+
+    //! When set, the registers are stored here as the differences from a
+    //! reference run instead of in m_registers.
+    //! @see Compress_Registers
+    std::optional<Register_Delta> m_register_delta;
+
+    //! @brief Moves the registers from m_register_columns or
+    //! m_register_delta back into m_registers so that they can be changed.
+    void unpack_registers()
+    {
+        if (m_register_columns || m_register_delta)
+        {
+            const std::size_t number_of_cycles{
+                m_register_delta ? m_register_delta->Get_Cycle_Count()
+                                 : m_register_columns->Get_Cycle_Count()};
+            m_registers.resize(number_of_cycles);
+            for (std::size_t cycle{0}; cycle < number_of_cycles; ++cycle)
+            {
+                m_registers[cycle] = Get_Registers(cycle);
+            }
+            m_register_columns.reset();
+            m_register_delta.reset();
+        }
+    }
+
+    //! @brief Finds a value that has been added to the pipeline stage given by
+    //! p_pipeline_stage_name at the clock cycle given by p_cycle, using
+    //! Add_Value() or Add_Pipeline_Stage().
+    //! @param p_cycle The clock cycle number.
+    //! @param p_pipeline_stage_name The pipeline stage.
+    //! @returns The value or nullptr if no value has been added.
+    const std::any* find_value(const std::size_t p_cycle,
+                               const std::string& p_pipeline_stage_name) const
+    {
+        const auto cycle = m_pipeline.find(p_cycle);
+        if (m_pipeline.end() == cycle)
+        {
+            return nullptr;
+        }
+        const auto value = cycle->second.find(p_pipeline_stage_name);
+        return cycle->second.end() == value ? nullptr : &value->second;
+    }
+
+    //! @brief Checks that the pipeline stage given by p_pipeline_stage_name
+    //! at the clock cycle given by p_cycle can be read from
+    //! m_instruction_stream. This is used when no value has been added to this
+    //! Execution directly.
+    //! @param p_cycle The clock cycle number.
+    //! @param p_pipeline_stage_name The pipeline stage.
+    //! @throws std::out_of_range When the stage is not in m_instruction_stream
+    //! or p_cycle is past the end of this Execution.
+    void
+    check_instruction_stream(const std::size_t p_cycle,
+                             const std::string& p_pipeline_stage_name) const
+    {
+        if (p_cycle >= m_number_of_cycles || !m_instruction_stream ||
+            !m_instruction_stream->Has_Stage(p_pipeline_stage_name))
+        {
+            throw std::out_of_range("No value is stored for the pipeline stage "
+                                    "during that clock cycle");
+        }
+    }
+
     //! @brief Retrieves the type of state of the pipeline stage given by
     //! p_pipeline_stage_name at the clock cycle given by p_cycle. This is
     //! different from retrieving the value as this will return an enum
@@ -105,26 +188,26 @@ private:
     //! @param p_pipeline_stage_name The pipeline stage from which to
     //! retrieve the state.
     //! @returns The requested type of state using the State enum.
+    //! @throws std::out_of_range When no value is stored for that stage during
+    //! that cycle.
     //! @see https://en.wikipedia.org/wiki/Instruction_pipelining
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
     //! @see https://en.wikipedia.org/wiki/Pipeline_stall
     GILES::Internal::Execution::State
-    get_state(const uint32_t p_cycle,
+    get_state(const std::size_t p_cycle,
               const std::string& p_pipeline_stage_name) const
     {
-        try
+        if (const std::any* const value{
+                find_value(p_cycle, p_pipeline_stage_name)})
         {
-            // TODO: If entire program is outside of trigger points then this
-            // will crash (size=0 out of range)
-            return std::any_cast<State>(
-                m_pipeline.at(p_cycle).at(p_pipeline_stage_name));
-        }
-        catch (const std::bad_any_cast&)
-        {
-            // if the cast failed then it is not a state and instead a value
-            // therefore the state is implicitly normal.
-            return State::Normal;
+            // If this is not a state then it is a value and therefore the
+            // state is implicitly normal.
+            const State* const state{std::any_cast<State>(value)};
+            return nullptr == state ? State::Normal : *state;
         }
+
+        check_instruction_stream(p_cycle, p_pipeline_stage_name);
+        return m_instruction_stream->Get_State(p_cycle, p_pipeline_stage_name);
     }
 
 public:
@@ -138,10 +221,36 @@ public:
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
     //! @see https://en.wikipedia.org/wiki/Processor_register
     explicit Execution(const std::size_t p_number_of_cycles)
-        : m_pipeline(p_number_of_cycles), m_registers(p_number_of_cycles)
+        : m_number_of_cycles{p_number_of_cycles},
+          m_instruction_stream{},
+          m_pipeline{},
+          m_instructions{},
+          m_registers{},
+          m_register_columns{},
+          m_register_delta{}
     {
     }
 
+    //! @brief Shares the pipeline stages held in p_instruction_stream with
+    //! this Execution. Values added with Add_Value() or Add_Pipeline_Stage()
+    //! take priority over these.
+    //! @param p_instruction_stream The interned pipeline stages.
+    //! @see Instruction_Stream::Intern
+    void Set_Instruction_Stream(
+        std::shared_ptr<const Instruction_Stream> p_instruction_stream)
+    {
+        m_instruction_stream = std::move(p_instruction_stream);
+    }
+
+    //! @brief Retrieves the pipeline stages shared with this Execution, if
+    //! any.
+    //! @returns The interned pipeline stages or nullptr.
+    const std::shared_ptr<const Instruction_Stream>&
+    Get_Instruction_Stream() const
+    {
+        return m_instruction_stream;
+    }
+
     //! @brief This allows for adding an entire pre recorded pipeline stage
     //! at once. This pre recorded pipeline stage should be provided by the
     //! simulator and contain the per clock cycle information related to the
@@ -181,13 +290,14 @@ public:
         // Pipeline stages should all be the same length but may not be in the
         // case of errors.
         const std::size_t size{
-            std::min(p_pipeline_stage.size(), m_pipeline.size())};
+            std::min(p_pipeline_stage.size(), m_number_of_cycles)};
 
         // Transpose the vector into m_pipeline.
         for (std::size_t cycle = 0; cycle < size; ++cycle)
         {
             // Add it to m_pipeline.
             m_pipeline[cycle][p_pipeline_stage_name] = p_pipeline_stage[cycle];
+            m_instructions.erase(cycle);
         }
     }
 
@@ -214,6 +324,7 @@ public:
     {
         // Add it to m_pipeline.
         m_pipeline[p_cycle][p_pipeline_stage_name] = p_value;
+        m_instructions.erase(p_cycle);
     }
 
     //! @brief Retrieves the state of the pipeline stage given by
@@ -235,19 +346,31 @@ public:
     //! @see https://en.wikipedia.org/wiki/Instruction_pipelining
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
     template <typename T_Value_Type>
-    const T_Value_Type Get_Value(const uint32_t p_cycle,
+    const T_Value_Type Get_Value(const std::size_t p_cycle,
                                  const std::string& p_pipeline_stage_name) const
     {
-        try
+        if (const std::any* const value{
+                find_value(p_cycle, p_pipeline_stage_name)})
         {
-            return std::any_cast<T_Value_Type>(
-                m_pipeline.at(p_cycle).at(p_pipeline_stage_name));
+            if (const T_Value_Type* const typed_value{
+                    std::any_cast<T_Value_Type>(value)})
+            {
+                return *typed_value;
+            }
         }
-        catch (const std::bad_any_cast&)
+        else
         {
-            throw std::invalid_argument("The requested pipeline state is "
-                                        "not stored as the requested type");
+            check_instruction_stream(p_cycle, p_pipeline_stage_name);
+
+            // The instruction stream only holds strings.
+            if constexpr (std::is_same_v<std::string, T_Value_Type>)
+            {
+                return m_instruction_stream->Get_Value(p_cycle,
+                                                       p_pipeline_stage_name);
+            }
         }
+        throw std::invalid_argument("The requested pipeline state is "
+                                    "not stored as the requested type");
     }
 
     //! @brief Retrieves the type of state of the pipeline stage given by
@@ -267,7 +390,7 @@ public:
     //! @see https://en.wikipedia.org/wiki/Instruction_pipelining
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
     //! @see https://en.wikipedia.org/wiki/Pipeline_stall
-    State Get_State_Unsafe(const uint32_t p_cycle,
+    State Get_State_Unsafe(const std::size_t p_cycle,
                            const std::string& p_pipeline_stage_name) const
     {
         try
@@ -297,7 +420,7 @@ public:
     //! @see https://en.wikipedia.org/wiki/Instruction_pipelining
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
     //! @see https://en.wikipedia.org/wiki/Pipeline_stall
-    State Get_State(const uint32_t p_cycle,
+    State Get_State(const std::size_t p_cycle,
                     const std::string& p_pipeline_stage_name) const
     {
         try
@@ -325,7 +448,7 @@ public:
     //! @see https://en.wikipedia.org/wiki/Instruction_pipelining
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
     //! @see https://en.wikipedia.org/wiki/Pipeline_stall
-    bool Is_Normal_State(const std::uint32_t p_cycle,
+    bool Is_Normal_State(const std::size_t p_cycle,
                          const std::string& p_pipeline_stage_name) const
     {
         return GILES::Internal::Execution::State::Normal ==
@@ -345,15 +468,60 @@ public:
     //! @see https://en.wikipedia.org/wiki/Instruction_pipelining
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
     //! @see https://en.wikipedia.org/wiki/Pipeline_stall
-    bool Is_Normal_State_Unsafe(const std::uint32_t p_cycle,
+    bool Is_Normal_State_Unsafe(const std::size_t p_cycle,
                                 const std::string& p_pipeline_stage_name) const
     {
         return GILES::Internal::Execution::State::Normal ==
                Get_State_Unsafe(p_cycle, p_pipeline_stage_name);
     }
 
+    //! @brief Finds the next clock cycle at which the pipeline stage given by
+    //! p_pipeline_stage_name is in a Normal state. Stalls and flushes recorded
+    //! by the Emulator are skipped over in one go, so this is the fastest way
+    //! to visit only the Normal cycles:
+    //! @code
+    //! for (auto i = Next_Normal_Cycle(0, "Execute"); i < Get_Cycle_Count();
+    //!      i = Next_Normal_Cycle(i + 1, "Execute"))
+    //! @endcode
+    //! As with Is_Normal_State_Unsafe(), cycles without a value are not
+    //! Normal.
+    //! @param p_cycle The clock cycle number to start from.
+    //! @param p_pipeline_stage_name The pipeline stage.
+    //! @returns The first Normal cycle at or after p_cycle or
+    //! Get_Cycle_Count() if there are none.
+    //! @see https://en.wikipedia.org/wiki/Pipeline_stall
+    std::size_t
+    Next_Normal_Cycle(const std::size_t p_cycle,
+                      const std::string& p_pipeline_stage_name) const
+    {
+        // Values added to this Execution could change the state of any cycle,
+        // so only the instruction stream can be skipped through directly.
+        if (m_pipeline.empty() && m_instruction_stream &&
+            m_instruction_stream->Has_Stage(p_pipeline_stage_name))
+        {
+            const Pipeline_States& states{
+                m_instruction_stream->Get_States(p_pipeline_stage_name)};
+            const std::size_t cycle{states.Next_Normal(p_cycle)};
+
+            // Cycles past the end of the stage have no value.
+            return cycle < states.Get_Cycle_Count()
+                       ? std::min(cycle, m_number_of_cycles)
+                       : m_number_of_cycles;
+        }
+
+        std::size_t cycle{p_cycle};
+        while (cycle < m_number_of_cycles &&
+               !Is_Normal_State_Unsafe(cycle, p_pipeline_stage_name))
+        {
+            ++cycle;
+        }
+        return std::min(cycle, m_number_of_cycles);
+    }
+
     //! @brief Retrieves the instruction in the pipeline stage given by
-    //! p_pipeline_stage_name at the clock cycle given by p_cycle.
+    //! p_pipeline_stage_name at the clock cycle given by p_cycle. Each
+    //! instruction is only parsed once, so after the first call this does not
+    //! allocate.
     //! @warning This function does not check the type of the Value before
     //! attempting to turn it into an assembly instruction. This should be
     //! done separately; Get_State() can help with this.
@@ -361,44 +529,34 @@ public:
     //! pipeline state.
     //! @param p_pipeline_stage_name The pipeline stage from which to
     //! retrieve the state.
-    //! @returns The requested instruction.
+    //! @returns The requested instruction. This remains valid for as long as
+    //! this Execution.
     //! @see https://en.wikipedia.org/wiki/Instruction_pipelining
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
-    // TODO: Settle on using boost for all string functions or not using
-    // boost.
-    const GILES::Internal::Assembly_Instruction
-    Get_Instruction(const uint32_t p_cycle,
+    const GILES::Internal::Assembly_Instruction&
+    Get_Instruction(const std::size_t p_cycle,
                     const std::string& p_pipeline_stage_name) const
     {
-        // Get the instruction as a string
-        std::string instruction =
-            Get_Value<std::string>(p_cycle, p_pipeline_stage_name);
-
-        // Remove the opcode from the instruction and store it in a separate
-        // variable.
-        // TODO: Some instructions don't have operands, this fails with those.
-        std::string opcode =
-            GILES::Internal::Utility::string_split_head_pop(&instruction, " ");
-
-        // Remove white space
-        boost::algorithm::trim(instruction);
-
-        // Convert the rest of the instruction into a list of operands
-        std::vector<std::string> operands =
-            GILES::Internal::Utility::string_split(instruction, ",");
-
-        /*
-         *std::vector<std::uint32_t> operand_values;
-         *std::transform(operands.begin(),
-         *               operands.end(),
-         *               operand_values.begin(),
-         *               [&](const auto p_operand) {
-         *                   return Get_Operand_Value(p_cycle, p_operand);
-         *               });
-         */
+        if (nullptr == find_value(p_cycle, p_pipeline_stage_name))
+        {
+            check_instruction_stream(p_cycle, p_pipeline_stage_name);
+            return m_instruction_stream->Get_Instruction(p_cycle,
+                                                         p_pipeline_stage_name);
+        }
 
-        // Create a new instruction and return it.
-        return Assembly_Instruction(opcode, operands /*, operand_values*/);
+        std::map<std::string, Assembly_Instruction>& instructions{
+            m_instructions[p_cycle]};
+        auto instruction = instructions.find(p_pipeline_stage_name);
+        if (instructions.end() == instruction)
+        {
+            instruction =
+                instructions
+                    .emplace(p_pipeline_stage_name,
+                             Assembly_Instruction::Parse(Get_Value<std::string>(
+                                 p_cycle, p_pipeline_stage_name)))
+                    .first;
+        }
+        return instruction->second;
     }
 
     //! @brief Adds the state of all registers as they were during every clock
@@ -411,9 +569,25 @@ public:
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
     //! @todo Validate that the same set of registers are given for each cycle?
     void Add_Registers_All(
-        const std::vector<std::map<std::string, std::size_t>> p_registers)
+        std::vector<std::map<std::string, std::size_t>> p_registers)
     {
-        m_registers = p_registers;
+        m_registers = std::move(p_registers);
+        m_register_columns.reset();
+        m_register_delta.reset();
+    }
+
+    //! @brief Adds the state of all registers as they were during every clock
+    //! cycle, already packed into columns. This uses far less memory than
+    //! Add_Registers_All() and, for very long executions, spills to a
+    //! temporary file rather than running out of memory.
+    //! @param p_registers The registers during every clock cycle.
+    //! @see Chunked_Buffer
+    void Add_Registers_Columns(
+        std::shared_ptr<const Register_Columns> p_registers)
+    {
+        m_registers = std::vector<std::map<std::string, std::size_t>>{};
+        m_register_columns = std::move(p_registers);
+        m_register_delta.reset();
     }
 
     //! @brief Adds the state of all registers as they were during the clock
@@ -429,7 +603,82 @@ public:
     Add_Registers_Cycle(const std::size_t p_cycle,
                         const std::map<std::string, std::size_t>& p_registers)
     {
-        m_registers[p_cycle] = p_registers;
+        unpack_registers();
+        if (m_registers.size() < m_number_of_cycles)
+        {
+            m_registers.resize(m_number_of_cycles);
+        }
+        m_registers.at(p_cycle) = p_registers;
+    }
+
+    //! @brief Stores the registers as only the values that differ from those
+    //! in p_reference. Most registers hold the same value on every run of a
+    //! program so this greatly reduces the memory used by Executions that are
+    //! kept, while still allowing any register during any cycle to be
+    //! retrieved quickly. Registers added afterwards cause the registers to be
+    //! stored in full again.
+    //! @param p_reference The reference run, usually from
+    //! Make_Register_Reference() on another Execution of the same program.
+    //! @returns true if the registers were compressed, false if they contain a
+    //! register that is not in p_reference, in which case they are left as
+    //! they were.
+    bool Compress_Registers(std::shared_ptr<const Register_Columns> p_reference)
+    {
+        try
+        {
+            if (m_register_columns)
+            {
+                m_register_delta.emplace(std::move(p_reference),
+                                         *m_register_columns);
+            }
+            else
+            {
+                unpack_registers();
+
+                // Cycles without registers are stored as empty.
+                if (m_registers.size() < m_number_of_cycles)
+                {
+                    m_registers.resize(m_number_of_cycles);
+                }
+                m_register_delta.emplace(std::move(p_reference), m_registers);
+            }
+        }
+        catch (const std::invalid_argument&)
+        {
+            return false;
+        }
+
+        m_registers = std::vector<std::map<std::string, std::size_t>>{};
+        m_register_columns.reset();
+        return true;
+    }
+
+    //! @brief Checks whether the registers are stored relative to a reference
+    //! run.
+    //! @returns true if Compress_Registers() has been used, false if not.
+    bool Is_Compressed() const { return m_register_delta.has_value(); }
+
+    //! @brief Creates a reference run from the registers of this Execution,
+    //! for other Executions to be compressed against.
+    //! @returns The reference run.
+    std::shared_ptr<const Register_Columns> Make_Register_Reference() const
+    {
+        if (m_register_columns)
+        {
+            return m_register_columns;
+        }
+        if (!m_register_delta)
+        {
+            return std::make_shared<const Register_Columns>(m_registers);
+        }
+        std::vector<std::map<std::string, std::size_t>> registers;
+        registers.reserve(m_register_delta->Get_Cycle_Count());
+        for (std::size_t cycle{0}; cycle < m_register_delta->Get_Cycle_Count();
+             ++cycle)
+        {
+            registers.push_back(m_register_delta->Get_Registers(cycle));
+        }
+        return std::make_shared<const Register_Columns>(registers);
     }
 
     //! @brief Checks whether or not a value is the name of a register by
@@ -440,7 +689,18 @@ public:
     //! false if it is not.
     bool Is_Register(const std::string& p_value) const
     {
-        return m_registers[0].end() != m_registers[0].find(p_value);
+        if (m_register_delta)
+        {
+            return m_register_delta->Is_Present(0, p_value);
+        }
+        if (m_register_columns)
+        {
+            const std::size_t index{m_register_columns->Find(p_value)};
+            return m_register_columns->Get_Names().size() != index &&
+                   m_register_columns->Is_Present(0, index);
+        }
+        return !m_registers.empty() &&
+               m_registers[0].end() != m_registers[0].find(p_value);
     }
 
     //! @brief Get the state of the registers as they were after the number
@@ -448,11 +708,29 @@ public:
     //! @param p_cycle The cycle number at which to retrieve the registers
     //! from.
     //! @returns The registers as they were during that cycle.
+    //! @throws std::out_of_range When p_cycle is past the end of the execution.
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
-    const std::map<std::string, std::size_t>&
+    std::map<std::string, std::size_t>
     Get_Registers(const std::size_t p_cycle) const
     {
-        return m_registers.at(p_cycle);
+        if (m_register_delta)
+        {
+            return m_register_delta->Get_Registers(p_cycle);
+        }
+        if (m_register_columns)
+        {
+            return m_register_columns->Get_Registers(p_cycle);
+        }
+        if (p_cycle < m_registers.size())
+        {
+            return m_registers[p_cycle];
+        }
+        if (p_cycle < m_number_of_cycles)
+        {
+            return {};
+        }
+        throw std::out_of_range("The clock cycle is past the end of the "
+                                "execution");
     }
 
     //! @todo document
@@ -461,6 +739,14 @@ public:
     std::size_t Get_Register_Value(const std::size_t p_cycle,
                                    const std::string& p_register_name) const
     {
+        if (m_register_delta)
+        {
+            return m_register_delta->Get_Value(p_cycle, p_register_name);
+        }
+        if (m_register_columns)
+        {
+            return m_register_columns->Get_Value(p_cycle, p_register_name);
+        }
         return m_registers.at(p_cycle).at(p_register_name);
     }
 
@@ -477,18 +763,31 @@ public:
     std::size_t Get_Operand_Value(const std::size_t p_cycle,
                                   const std::string& p_operand) const
     {
-        try
+        if (Is_Register(p_operand))
         {
-            return Is_Register(p_operand)
-                       ? Get_Register_Value(p_cycle, p_operand)
-                       : static_cast<std::size_t>(std::stoi(p_operand));
+            return Get_Register_Value(p_cycle, p_operand);
         }
+
+        // This is read in the same way as std::stoi, but without throwing when
+        // p_operand is not numeric as that happens for every immediate.
+        const char* const begin{p_operand.c_str()};
+        char* end{nullptr};
+        errno = 0;
+        const long value{std::strtol(begin, &end, 10)};
+
         // If p_operand is not numeric, i.e. corrupted data, try to recover by
         // clearing that value.
-        catch (const std::invalid_argument&)
+        if (begin == end)
         {
             return 0;
         }
+        if (ERANGE == errno || value < std::numeric_limits<int>::min() ||
+            value > std::numeric_limits<int>::max())
+        {
+            throw std::out_of_range("The operand " + p_operand +
+                                    " is too large");
+        }
+        return static_cast<std::size_t>(static_cast<int>(value));
     }
 
     //! @brief Retrieves the value of an operand in numerical form. If that
@@ -511,22 +810,20 @@ public:
         const GILES::Internal::Assembly_Instruction& p_instruction,
         const std::uint8_t p_operand_number) const
     {
-        try
-        {
-            return Get_Operand_Value(
-                p_cycle, p_instruction.Get_Operand(p_operand_number));
-        }
-        catch (const std::runtime_error&)
+        if (0 == p_operand_number ||
+            p_operand_number > p_instruction.Get_Number_of_Operands())
         {
             return 0;
         }
+        return Get_Operand_Value(p_cycle,
+                                 p_instruction.Get_Operand(p_operand_number));
     }
 
     //! @brief Retrieves the total number of clock cycles that occurred
     //! during the running of the target program.
     //! @returns The total number of clock cycles.
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
-    std::size_t Get_Cycle_Count() const { return m_pipeline.size(); }
+    std::size_t Get_Cycle_Count() const { return m_number_of_cycles; }
 
     //! TODO: Future: Make use of this.
     //! TODO: Maybe move this to be under Execution instead.
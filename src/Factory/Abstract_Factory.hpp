@@ -44,6 +44,8 @@ class Coefficients;
 class Emulator;
 class Execution;
 class Model;
+class Output;
+struct Output_Options;
 
 //! @class Abstract_Factory
 //! @brief This is a static factory class that assists in the construction of
@@ -176,6 +178,13 @@ using Model_Factory =
 //! the scenes, refer to the Abstract_Factory class.
 using Emulator_Factory = Abstract_Factory<Emulator, const std::string&>;
 
+//! @brief This exists only to simply the usage of the Abstract_Factory
+//! class. By providing an intermediate, the possibility of accidentally
+//! initialising a separate template is eliminated. Additionally, this
+//! provides for a more meaningful name. To see what is actually going on behind
+//! the scenes, refer to the Abstract_Factory class.
+using Output_Factory = Abstract_Factory<Output, const Output_Options&>;
+
 }  // namespace Internal
 }  // namespace GILES
 
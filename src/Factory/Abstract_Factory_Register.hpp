@@ -43,6 +43,8 @@ class Model;
 class Execution;
 class Coefficients;
 class Emulator;
+class Output;
+struct Output_Options;
 
 //! @class Abstract_Factory_Register
 //! @brief This class is used to assist with the self registration of classes
@@ -143,6 +145,15 @@ using Model_Factory_Register = Abstract_Factory_Register<Model,
 template <typename derived_t>
 using Emulator_Factory_Register =
     Abstract_Factory_Register<Emulator, derived_t, const std::string&>;
+
+//! @brief This exists only to simply the usage of the
+//! Abstract_Factory_Register class. By providing an intermediate, the
+//! possibility of accidentally initialising a separate template is
+//! eliminated. To see what is actually going on behind the scenes, refer to the
+//! Abstract_Factory_Register class.
+template <typename derived_t>
+using Output_Factory_Register =
+    Abstract_Factory_Register<Output, derived_t, const Output_Options&>;
 }  // namespace Internal
 }  // namespace GILES
 
@@ -24,23 +24,58 @@
     @copyright GNU Affero General Public License Version 3+
 */
 
-#include <memory>         // for make_unique, unique_ptr
-#include <optional>       // for optional
-#include <string>         // for string
-#include <unordered_map>  // for unordered_map
-#include <unordered_set>  // for unordered_set
-#include <utility>        // for pair, move
-
-#include <Traces_Serialiser.hpp>
+// This file is included by the executables and tests, as well as being built
+// into the library, so it is guarded in the same way as a header.
+#ifndef GILES_CPP
+#define GILES_CPP
+
+#include <algorithm>           // for min, max
+#include <atomic>              // for atomic
+#include <chrono>              // for steady_clock, duration, milliseconds
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for ptrdiff_t, size_t
+#include <cstdio>              // for remove
+#include <cstdlib>             // for getenv, mkstemp
+#include <deque>               // for deque
+#include <exception>           // for exception_ptr, rethrow_exception
+#include <future>              // for promise, shared_future
+#include <iterator>            // for input_iterator_tag
+#include <limits>              // for numeric_limits
+#include <memory>              // for make_shared, make_unique, shared_ptr...
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <optional>            // for optional
+#include <string>              // for string
+#include <thread>              // for thread
+#include <tuple>               // for tie
+#include <unordered_map>       // for unordered_map
+#include <unordered_set>       // for unordered_set
+#include <utility>             // for pair, move
+#include <vector>              // for vector
+
+#include <unistd.h>  // for close
+
+#ifdef _OPENMP
+#include <omp.h>  // for omp_get_max_threads, omp_get_thread_num
+#endif
+
 #include <fmt/format.h>  // for print
 
-#include "Abstract_Factory.hpp"  // for Emulator_Factory, Model_Factory
-#include "Coefficients.hpp"      // for Coefficients
-#include "Emulator.hpp"          // for Emulator
-#include "Error.hpp"             // for Report_Error
-#include "Execution.hpp"         // for Execution
-#include "IO.hpp"                // for IO
-#include "Model.hpp"             // for Model
+#include "Abstract_Factory.hpp"        // for Emulator_Factory, Model_Factory
+#include "Coefficients.hpp"            // for Coefficients
+#include "Emulator.hpp"                // for Emulator
+#include "Error.hpp"                   // for Report_Error, Throw_Errors
+#include "Execution.hpp"               // for Execution
+#include "IO.hpp"                      // for IO
+#include "Input_Generator.hpp"         // for Input_Generator
+#include "Journal.hpp"                 // for Journal
+#include "Matrix/Output_Batches.hpp"   // for Output_Batches
+#include "Matrix/Output_Matrix.hpp"    // for Output_Matrix
+#include "Matrix/Trace_Matrix.hpp"     // for Trace_Matrix
+#include "Memory_Budget.hpp"           // for Memory_Budget
+#include "Model.hpp"                   // for Model
+#include "Ordered/Output_Ordered.hpp"  // for Output_Ordered
+#include "Output.hpp"                  // for Output, Output_Options
+#include "Program_Image.hpp"           // for Program_Image
 
 namespace GILES
 {
@@ -50,29 +85,133 @@ namespace GILES
 class GILES
 {
 private:
-    const Internal::Coefficients m_coefficients;
+    // Shared with every other GILES using the same Coefficients, e.g. each
+    // job in a job file, rather than each keeping its own copy.
+    const std::shared_ptr<const Internal::Coefficients> m_coefficients;
     const std::string m_program_path;
     const std::string m_model_name;
-    const std::string m_simulator_name;
+
+    // The simulator used by Run(), or empty if every simulator is used.
+    std::string m_simulator_name;
+
     const std::optional<std::string>& m_traces_path;
     const std::uint32_t m_number_of_runs;
 
     // A timeout to stop execution after a set number of cycles.
-    std::optional<std::uint32_t> m_timeout;
+    std::optional<std::uint64_t> m_timeout;
 
     // These options are related to fault injection.
     bool m_fault;
-    std::uint32_t m_fault_cycle;
+    std::uint64_t m_fault_cycle;
     std::string m_fault_register;
     std::uint8_t m_fault_bit;
 
-    // Future: This data is stored here as well as in Traces_Serialiser as it
-    // should be able to be accessed programmatically in the future.
-    // TODO: Add getter.
-    std::vector<std::vector<float>> m_traces;
-    std::vector<std::string> m_extra_data;
+    // Generates the inputs placed in the memory of the target before each
+    // run, if any are used.
+    std::optional<Internal::Input_Generator> m_input_generator;
+
+    // The variables read from the memory of the target after each run.
+    std::vector<Internal::Program_Image::Buffer> m_target_outputs;
+
+    // Keeps the generated traces in memory, if they are to be accessed
+    // programmatically. See Collect_Traces().
+    std::shared_ptr<Internal::Output_Matrix> m_matrix;
+
+    //! The first run, completed ahead of Run() to calibrate the size of the
+    //! traces or to estimate the cost of a job.
+    struct Calibration
+    {
+        //! The number of clock cycles the run took.
+        std::uint64_t Cycles{0};
+
+        std::vector<float> Trace{};
+        std::string Extra_Data{};
+    };
+
+    // The first run completed by each simulator, by name, ahead of Run().
+    // Run() reuses these rather than running the first run again. They are
+    // forgotten if a setting that changes the runs is given afterwards.
+    std::unordered_map<std::string, Calibration> m_calibrations;
+
+    // The run index and length of the first trace generated by the current
+    // call to Run_Simulator(), used to check that every trace is the same
+    // length.
+    std::optional<std::pair<std::size_t, std::size_t>> m_first_trace;
+
+    // The format traces are saved in at m_traces_path and its settings.
+    std::string m_output_format;
+    Internal::Output_Options m_output_options;
+
+    // Any Outputs in addition to the one at m_traces_path, stored by name
+    // along with their settings. e.g. templates.
+    std::vector<std::pair<std::string, Internal::Output_Options>>
+        m_additional_outputs;
+
+    // Outputs constructed by the caller, in addition to those above.
+    std::vector<std::shared_ptr<Internal::Output>> m_custom_outputs;
+
+    // Everywhere the generated traces are sent to during a run. These are
+    // constructed at the start of each run.
+    std::vector<std::shared_ptr<Internal::Output>> m_outputs;
+
+    // The number of threads used to generate traces, if limited.
+    std::optional<std::size_t> m_number_of_threads;
+
+    // The number of runs each thread takes at a time.
+    std::size_t m_batch_size;
+
+    // Whether to choose the number of threads and the batch size by
+    // measuring how quickly traces are generated. See Tune().
+    bool m_tune;
+
+    //! How long traces are generated for when measuring each combination of
+    //! the number of threads and the batch size.
+    static constexpr std::chrono::milliseconds tuning_interval{500};
+
+    //! The largest batch size tried when tuning.
+    static constexpr std::size_t maximum_tuned_batch_size{64};
+
+    // Whether to continue from the traces saved by a run that was
+    // interrupted, rather than starting again.
+    bool m_resume;
+
+    // Records the runs whose traces have been saved, when saving in a format
+    // that can be resumed.
+    std::unique_ptr<Internal::Journal> m_journal;
+
+    // The runs completed by each thread that have not been recorded in the
+    // journal yet.
+    std::vector<std::vector<std::size_t>> m_unjournaled_runs;
+
+    //! The number of runs each thread completes before they are saved and
+    //! recorded in the journal.
+    static constexpr std::size_t journal_interval{1024};
+
+    // Counts the calls to Stop(), and the errors that stopped trace
+    // generation, each of which prevents any more runs from being started.
+    // These are counted, rather than setting a flag, so that a call made
+    // before Run() stops it while those that stopped an earlier call to Run()
+    // are forgotten. This is atomic, and lock free, so that Stop() can be
+    // called from a signal handler.
+    std::atomic<std::size_t> m_stop_requests;
+    static_assert(std::atomic<std::size_t>::is_always_lock_free,
+                  "Stop() must be safe to call from a signal handler");
+
+    // The value of m_stop_requests when the last call to Run() finished.
+    std::size_t m_stop_requests_finished;
+
+    // The stop requests up to this one are ignored by the current call to
+    // Run(). This is set to m_stop_requests_finished when Run() starts.
+    std::atomic<std::size_t> m_stop_requests_ignored;
+
+    // The number of runs that were started during the last call to
+    // Run_Simulator(). Runs are started in order so these are the runs with
+    // an index lower than this.
+    std::size_t m_runs_started;
 
-    Traces_Serialiser::Serialiser<float> m_serialiser;
+    // The number of runs completed, including those completed before
+    // resuming. This is read by other threads to report progress.
+    std::atomic<std::size_t> m_runs_completed;
 
     // TODO: Future: This has been left in as it will be used in future versions
     // when running multiple models at once is supported.
@@ -101,20 +240,28 @@ private:
         return models_in_use;
     }*/
 
+    //! @returns Whether any more runs should be started.
+    bool stopping() const { return m_stop_requests != m_stop_requests_ignored; }
+
     //! @brief Prints a warning if the target program does not run in a constant
     //! number of clock cycles each time it is executed.
     //! @returns true if a warning was printed, false if not.
-    //! @param p_trace_index The index of the current trace to have its size
-    //! checked.
+    //! @param p_run_index The index of the run that generated the trace.
+    //! @param p_size The length of the trace.
     //! @see https://en.wikipedia.org/wiki/Clock_cycle
     //! @todo: Future: This should only be checked if TRS files are being used.
-    bool warn_if_not_constant_time() const
+    bool warn_if_not_constant_time(const std::size_t p_run_index,
+                                   const std::size_t p_size)
     {
-        const auto current_size      = m_traces.back().size();
-        static const auto first_size = m_traces.front().size();
+        if (!m_first_trace)
+        {
+            m_first_trace = std::make_pair(p_run_index, p_size);
+            return false;
+        }
+        const auto [first_run_index, first_size] = m_first_trace.value();
 
         // If there is no size difference then return false.
-        if (first_size == current_size)
+        if (first_size == p_size)
         {
             return false;
         }
@@ -123,28 +270,787 @@ private:
             "The target program did not run in a constant number of cycles.\n"
             "If this was not an intentional countermeasure to timing attacks "
             "then this is considered insecure.\n"
-            "Trace number 0 took {} clock cycles.\n"
+            "Trace number {} took {} clock cycles.\n"
             "Trace number {} took {} clock cycles.\n",
+            first_run_index,
             first_size,
-            m_traces.size() - 1,  // Trace index
-            current_size);
+            p_run_index,
+            p_size);
         return true;
     }
 
+    //! @returns A description of the memory accounted for by the
+    //! Memory_Budget, for the progress output. e.g. "Memory: 812 of 8192 MB"
+    static std::string describe_memory_used()
+    {
+        const std::size_t used{Internal::Memory_Budget::Get_Used() /
+                               (1024 * 1024)};
+        const std::size_t limit{Internal::Memory_Budget::Get_Limit() /
+                                (1024 * 1024)};
+        if (0 == Internal::Memory_Budget::Get_Limit())
+        {
+            return fmt::format("Memory: {} MB", used);
+        }
+        return fmt::format("Memory: {} of {} MB", used, limit);
+    }
+
     //! @brief Prints a warning it traces will not be saved after the program
     //! stops.
     //! This is to prevent long running operations resulting in no output
     //! accidentally.
     void warn_if_not_saving() const
     {
-        // If no path has been specified to save traces to.
-        if (!m_traces_path)
+        // If no path has been specified to save traces to, and the caller is
+        // not collecting them.
+        if (!m_traces_path && m_custom_outputs.empty())
         {
             Internal::Error::Report_Warning(
                 "Trace(s) will not be saved to disk");
         }
     }
 
+    //! @brief Constructs every Output that traces will be sent to. This is the
+    //! Output saving to m_traces_path, if a path was given, followed by any
+    //! that were added using Add_Output(). Outputs constructed by the caller
+    //! are used as they are.
+    void construct_outputs()
+    {
+        m_outputs.clear();
+
+        // If a path was provided then save to it.
+        if (m_traces_path)
+        {
+            auto options   = m_output_options;
+            options.Path   = m_traces_path.value();
+            options.Resume = m_resume;
+            m_outputs.emplace_back(
+                Internal::Output_Factory::Construct(m_output_format, options));
+        }
+
+        for (auto [name, options] : m_additional_outputs)
+        {
+            options.Resume = m_resume;
+            m_outputs.emplace_back(
+                Internal::Output_Factory::Construct(name, options));
+        }
+
+        m_outputs.insert(
+            m_outputs.end(), m_custom_outputs.begin(), m_custom_outputs.end());
+    }
+
+    //! @brief Opens the journal, if the traces are being saved in a format
+    //! that can be resumed. When resuming, every Output must be able to
+    //! continue from where the interrupted run stopped.
+    void open_journal()
+    {
+        m_journal.reset();
+        m_unjournaled_runs.assign(get_number_of_threads(), {});
+
+        const bool resumable{m_traces_path && m_outputs.front()->Resumable()};
+        if (m_resume)
+        {
+            for (const auto& output : m_outputs)
+            {
+                if (!resumable || !output->Resumable())
+                {
+                    Internal::Error::Report_Error(
+                        "Only runs saving traces in the NumPy or Raw formats, "
+                        "without any additional outputs, can be resumed.");
+                }
+            }
+        }
+
+        if (resumable)
+        {
+            m_journal = std::make_unique<Internal::Journal>(
+                Internal::Journal::Journal_Path(m_traces_path.value()),
+                m_number_of_runs,
+                m_resume);
+        }
+    }
+
+    //! @brief Records a run as complete. Every journal_interval runs the
+    //! calling thread's traces are saved and its runs are added to the
+    //! journal.
+    //! @param p_run_index The index of the completed run.
+    void journal_run(const std::size_t p_run_index)
+    {
+        if (!m_journal)
+        {
+            return;
+        }
+
+        auto& runs = m_unjournaled_runs[get_thread_index()];
+        runs.push_back(p_run_index);
+        if (runs.size() >= journal_interval)
+        {
+            for (const auto& output : m_outputs)
+            {
+                output->Flush(get_thread_index());
+            }
+            m_journal->Add(runs);
+            runs.clear();
+        }
+    }
+
+    //! @brief Retrieves the number of threads that will be used to generate
+    //! traces.
+    //! @returns The number of threads or 1 if OpenMP is not available.
+    std::size_t get_number_of_threads() const
+    {
+        if (m_number_of_threads)
+        {
+            return m_number_of_threads.value();
+        }
+#ifdef _OPENMP
+        return static_cast<std::size_t>(omp_get_max_threads());
+#else
+        return 1;
+#endif
+    }
+
+    //! @brief Creates an empty temporary file.
+    //! @returns The path to the file.
+    static std::string create_temporary_file()
+    {
+        const char* const directory{std::getenv("TMPDIR")};
+        std::string path{std::string{directory ? directory : "/tmp"} +
+                         "/giles-program-XXXXXX"};
+
+        const int file{::mkstemp(&path[0])};
+        if (file < 0)
+        {
+            Internal::Error::Report_Error("Could not create '{}'", path);
+        }
+        ::close(file);
+        return path;
+    }
+
+    //! @brief Retrieves the index of the calling thread.
+    //! @returns A number lower than get_number_of_threads() or 0 if OpenMP is
+    //! not available.
+    static std::size_t get_thread_index()
+    {
+#ifdef _OPENMP
+        return static_cast<std::size_t>(omp_get_thread_num());
+#else
+        return 0;
+#endif
+    }
+
+    //! @class Run_Setup
+    //! @brief Constructs the simulator for each run with the inputs of the run
+    //! placed in the memory of the target, and collects the extra data of the
+    //! run once it is complete. This is shared by every run that generates a
+    //! trace, including the calibration run, so that they are all prepared in
+    //! the same way.
+    //! Inputs are written straight into the memory of the target if the
+    //! simulator allows it. Otherwise each thread runs its own copy of the
+    //! program, saved to a temporary file, holding the inputs of its current
+    //! run. The copies are removed when this is destroyed.
+    class Run_Setup
+    {
+    private:
+        const GILES& m_giles;
+        const std::string m_simulator_name;
+        bool m_memory_access;
+        std::vector<Internal::Program_Image> m_program_images;
+        std::vector<std::string> m_program_paths;
+
+        //! @brief Removes the copies of the program.
+        void remove_copies() const
+        {
+            if (!m_program_images.empty())
+            {
+                for (const auto& path : m_program_paths)
+                {
+                    std::remove(path.c_str());
+                }
+            }
+        }
+
+    public:
+        //! @param p_giles The settings of the runs.
+        //! @param p_simulator_name The name of the simulator to use.
+        //! @param p_number_of_threads The number of threads preparing runs at
+        //! once.
+        Run_Setup(const GILES& p_giles,
+                  const std::string& p_simulator_name,
+                  const std::size_t p_number_of_threads)
+            : m_giles{p_giles}, m_simulator_name{p_simulator_name},
+              m_memory_access{
+                  Internal::Emulator_Factory::Construct(
+                      p_simulator_name, p_giles.m_program_path)
+                      ->Supports_Memory_Access()},
+              m_program_images{},
+              m_program_paths(p_number_of_threads, p_giles.m_program_path)
+        {
+            if (!m_giles.m_target_outputs.empty() && !m_memory_access)
+            {
+                Internal::Error::Report_Error(
+                    "The {} simulator can not read the memory of the target "
+                    "so target outputs can not be used",
+                    m_simulator_name);
+            }
+
+            if (!m_giles.m_input_generator || m_memory_access)
+            {
+                return;
+            }
+
+            const Internal::Program_Image program_image{
+                m_giles.m_program_path};
+            for (const auto& input : m_giles.m_input_generator->Get_Inputs())
+            {
+                if (!program_image.Is_Writable(input.Address, input.Size))
+                {
+                    Internal::Error::Report_Error(
+                        "The {} bytes at 0x{:08x} are not initialised by "
+                        "'{}' so can not be used as an input. Only memory "
+                        "loaded from the program, e.g. .data, can be used.",
+                        input.Size,
+                        input.Address,
+                        m_giles.m_program_path);
+                }
+            }
+
+            m_program_images = std::vector<Internal::Program_Image>(
+                p_number_of_threads, program_image);
+            try
+            {
+                for (auto& path : m_program_paths)
+                {
+                    path = create_temporary_file();
+                }
+            }
+            catch (...)
+            {
+                remove_copies();
+                throw;
+            }
+        }
+
+        ~Run_Setup() { remove_copies(); }
+
+        Run_Setup(const Run_Setup&) = delete;
+        Run_Setup& operator=(const Run_Setup&) = delete;
+
+        //! @brief Constructs the simulator for a run, ready to be ran, with
+        //! the inputs of the run in memory and any timeout or fault added.
+        //! @param p_thread The index of the calling thread. No other thread
+        //! may prepare a run using the same index at the same time.
+        //! @param p_run_index The index of the run.
+        //! @param p_inputs Set to the inputs of the run. These depend only on
+        //! the run index so they need not be generated ahead of time, or in
+        //! order.
+        //! @returns The simulator.
+        std::unique_ptr<Internal::Emulator>
+        Prepare(const std::size_t p_thread,
+                const std::size_t p_run_index,
+                std::vector<std::string>& p_inputs)
+        {
+            p_inputs.clear();
+            if (m_giles.m_input_generator)
+            {
+                p_inputs = m_giles.m_input_generator->Generate(p_run_index);
+            }
+
+            if (!m_program_images.empty())
+            {
+                for (std::size_t j{0}; j < p_inputs.size(); ++j)
+                {
+                    m_program_images[p_thread].Write(
+                        m_giles.m_input_generator->Get_Inputs()[j].Address,
+                        p_inputs[j]);
+                }
+                m_program_images[p_thread].Save(m_program_paths[p_thread]);
+            }
+
+            auto simulator = Internal::Emulator_Factory::Construct(
+                m_simulator_name, m_program_paths[p_thread]);
+
+            if (m_memory_access)
+            {
+                for (std::size_t j{0}; j < p_inputs.size(); ++j)
+                {
+                    simulator->Write_Memory(
+                        m_giles.m_input_generator->Get_Inputs()[j].Address,
+                        p_inputs[j]);
+                }
+            }
+
+            if (m_giles.m_timeout)
+            {
+                simulator->Add_Timeout(m_giles.m_timeout.value());
+            }
+
+            if (m_giles.m_fault)
+            {
+                simulator->Inject_Fault(m_giles.m_fault_cycle,
+                                        m_giles.m_fault_register,
+                                        m_giles.m_fault_bit);
+            }
+            return simulator;
+        }
+
+        //! @brief Collects the extra data of a run that has been completed.
+        //! This starts with the inputs and outputs of the target, followed by
+        //! any extra data from the simulator.
+        //! @param p_simulator The simulator that completed the run.
+        //! @param p_inputs The inputs of the run.
+        //! @param p_extra_data Set to the extra data.
+        void Collect_Extra_Data(Internal::Emulator& p_simulator,
+                                const std::vector<std::string>& p_inputs,
+                                std::string& p_extra_data) const
+        {
+            p_extra_data.clear();
+            for (const auto& input : p_inputs)
+            {
+                p_extra_data += input;
+            }
+            for (const auto& output : m_giles.m_target_outputs)
+            {
+                p_extra_data +=
+                    p_simulator.Read_Memory(output.Address, output.Size);
+            }
+            p_extra_data += p_simulator.Get_Extra_Data();
+        }
+    };
+
+    //! @brief Completes a run and generates its trace. When the traces are
+    //! only kept in memory the model writes straight into the row of the run,
+    //! rather than the trace being copied there.
+    //! @param p_run_setup Prepares the simulator for the run.
+    //! @param p_run_index The index of the run.
+    //! @param p_inputs Set to the inputs of the run.
+    //! @param p_trace Set to the trace, unless it was written in place.
+    //! @param p_extra_data Set to the extra data of the run.
+    //! @returns The number of samples in the trace and whether it was written
+    //! in place.
+    std::pair<std::size_t, bool>
+    generate_trace(Run_Setup& p_run_setup,
+                   const std::size_t p_run_index,
+                   std::vector<std::string>& p_inputs,
+                   std::vector<float>& p_trace,
+                   std::string& p_extra_data)
+    {
+        const auto simulator = p_run_setup.Prepare(
+            get_thread_index(), p_run_index, p_inputs);
+        const auto execution = simulator->Run_Code();
+        p_run_setup.Collect_Extra_Data(*simulator, p_inputs, p_extra_data);
+
+        // Initialise all models.
+        // TODO: Future: Add support for using multiple models at once using
+        // this code.
+        /*for (const auto& model_interface :
+             GILES::Internal::Model_Factory::Get_All())
+        {
+
+        // Construct the model, ready for use.
+        const auto model = GILES::Internal::Model_Factory::Construct(
+            model_interface.first, execution, m_coefficients);*/
+
+        // Construct the model, ready for use.
+        const auto model = Internal::Model_Factory::Construct(
+            m_model_name, execution, *m_coefficients);
+
+        const std::size_t trace_length{model->Get_Trace_Length()};
+
+        // Every row of the kept traces is allocated up front, so the trace is
+        // only generated into p_trace if it is longer than expected.
+        auto row =
+            m_matrix && 1 == m_outputs.size()
+                ? m_matrix->Take_Row(
+                      p_run_index, trace_length, p_extra_data.size())
+                : std::optional<Internal::Output_Matrix::Row>{};
+        if (row)
+        {
+            model->Generate_Traces(row->Samples());
+            row->Complete(trace_length, p_extra_data);
+            return {trace_length, true};
+        }
+
+        p_trace.resize(trace_length);
+        model->Generate_Traces(p_trace.data());
+        return {trace_length, false};
+    }
+
+    //! @brief Runs the simulator given by p_simulator_name, and the model,
+    //! on every thread and sends every trace generated to the outputs.
+    //! @param p_simulator_name The name of the simulator to use.
+    //! @param p_number_of_runs The number of runs to complete.
+    //! @param p_deadline If given, no more batches of runs are started after
+    //! this time and nothing is printed. This is used to measure how quickly
+    //! traces are generated while tuning.
+    //! @returns The number of runs that were started. Runs are started in
+    //! order so these are the runs with an index lower than this.
+    std::size_t generate_traces(
+        const std::string& p_simulator_name,
+        const std::size_t p_number_of_runs,
+        const std::optional<std::chrono::steady_clock::time_point>& p_deadline)
+    {
+        // Ensures that the constant time warning is not printed over and
+        // over, or while tuning.
+        bool warning_printed{p_deadline.has_value()};
+
+        Run_Setup run_setup{*this, p_simulator_name, get_number_of_threads()};
+
+        // Runs are handed out in order, rather than being divided between
+        // threads up front, so that if Stop() is called every run before the
+        // last one started is completed. Each thread takes a batch of runs at
+        // a time, which it always completes.
+        std::atomic<std::size_t> next_run{0};
+
+        // The number of runs that have been started and not yet handed to the
+        // outputs. Their memory is freed once they are.
+        std::atomic<std::size_t> runs_in_progress{0};
+
+        // The first error thrown by any thread, if Report_Error() is throwing
+        // errors rather than stopping the program.
+        std::exception_ptr error;
+        const bool throwing_errors{Internal::Error::Is_Throwing()};
+#pragma omp parallel num_threads(static_cast<int>(get_number_of_threads()))
+        try
+        {
+            // Errors on every thread are reported in the same way as errors
+            // on the calling thread. If errors are thrown then the first is
+            // passed on to the caller once every thread has stopped.
+            const Internal::Error::Throw_Errors throw_errors{throwing_errors};
+
+            // Each thread reuses the memory of its trace, which the model
+            // writes into, and of its inputs and extra data. After the first
+            // run has sized them, targets that run in constant time never
+            // need them to be reallocated.
+            std::vector<float> trace;
+            std::vector<std::string> inputs;
+            std::string extra_data;
+            Internal::Memory_Budget::Held trace_memory;
+
+            // The runs of the current batch that have not been started.
+            std::size_t batch_start{0};
+            std::size_t batch_end{0};
+            while (true)
+            {
+                if (batch_start == batch_end)
+                {
+                    if (stopping() ||
+                        (p_deadline &&
+                         std::chrono::steady_clock::now() >= *p_deadline))
+                    {
+                        break;
+                    }
+
+                    // Wait for memory to be freed before starting another
+                    // batch. Only runs in progress, and the outputs writing
+                    // their queued traces, free memory so this does not wait
+                    // if there are neither.
+                    Internal::Memory_Budget::Wait([this, &runs_in_progress] {
+                        return stopping() ||
+                               (0 == runs_in_progress &&
+                                0 == Internal::Memory_Budget::Get_Queued());
+                    });
+
+                    // Stop() may have been called while waiting.
+                    if (stopping())
+                    {
+                        break;
+                    }
+
+                    batch_start = next_run.fetch_add(m_batch_size);
+                    if (batch_start >= p_number_of_runs)
+                    {
+                        break;
+                    }
+                    batch_end =
+                        std::min(batch_start + m_batch_size, p_number_of_runs);
+                }
+                const std::size_t i{batch_start++};
+
+                // Skip runs whose traces were saved before resuming.
+                if (m_journal && m_journal->Is_Complete(i))
+                {
+                    continue;
+                }
+
+                const std::size_t thread{get_thread_index()};
+                ++runs_in_progress;
+
+                // The first run may have been completed ahead of time, to
+                // calibrate or estimate the cost, in which case it is reused.
+                // It is not reused while tuning, as nothing is saved.
+                const auto calibration =
+                    0 == i && !p_deadline
+                        ? m_calibrations.find(p_simulator_name)
+                        : m_calibrations.end();
+                std::size_t trace_length{0};
+                bool in_place{false};
+                if (calibration != m_calibrations.end())
+                {
+                    trace        = calibration->second.Trace;
+                    extra_data   = calibration->second.Extra_Data;
+                    trace_length = trace.size();
+                }
+                else
+                {
+                    std::tie(trace_length, in_place) =
+                        generate_trace(run_setup, i, inputs, trace, extra_data);
+                }
+
+                // Increment the counter of number of traces generated.
+                const std::size_t steps_completed{++m_runs_completed};
+
+                // Outputs handle their own locking so this is done outside of
+                // the critical section below.
+                if (!in_place)
+                {
+                    for (const auto& output : m_outputs)
+                    {
+                        output->Add_Trace(thread, i, trace, extra_data);
+                    }
+                }
+                journal_run(i);
+                trace_memory.Set(trace.capacity() * sizeof(float) +
+                                 extra_data.capacity());
+                --runs_in_progress;
+
+// This is marked critical as the first trace is shared between threads.
+#pragma omp critical
+                {
+                    // If this warning hasn't been printed before.
+                    if (!warning_printed)
+                    {
+                        // Will print a warning if the target program is not
+                        // constant time.
+                        warning_printed =
+                            warn_if_not_constant_time(i, trace_length);
+                    }
+                }
+
+                // The memory used can shrink, so it is padded to cover what
+                // was printed before.
+                if (!p_deadline)
+                {
+                    fmt::print("\rGenerated: {} of {} traces. ({}%) {:<24}",
+                               steps_completed,
+                               p_number_of_runs,
+                               100.0 * steps_completed / p_number_of_runs,
+                               describe_memory_used());
+                }
+                //}
+            }
+        }
+        catch (...)
+        {
+#pragma omp critical
+            {
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+            ++m_stop_requests;
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        return std::min<std::size_t>(next_run, p_number_of_runs);
+    }
+
+    //! @brief Completes the first run ahead of Run(), unless it has been
+    //! already. This finds the number of samples in each trace, and the
+    //! number of bytes of extra data saved alongside it, which every trace has
+    //! if the target runs in constant time. The run is prepared exactly as
+    //! generate_traces() prepares it, so generate_traces() reuses it rather
+    //! than running it again.
+    //! @param p_simulator_name The name of the simulator to use.
+    //! @returns The completed run.
+    const Calibration& calibrate(const std::string& p_simulator_name)
+    {
+        const auto found = m_calibrations.find(p_simulator_name);
+        if (found != m_calibrations.end())
+        {
+            return found->second;
+        }
+
+        Run_Setup run_setup{*this, p_simulator_name, 1};
+
+        std::vector<std::string> inputs;
+        const auto simulator = run_setup.Prepare(0, 0, inputs);
+        const auto execution = simulator->Run_Code();
+        const auto model     = Internal::Model_Factory::Construct(
+            m_model_name, execution, *m_coefficients);
+
+        Calibration calibration;
+        calibration.Cycles = execution.Get_Cycle_Count();
+        calibration.Trace.resize(model->Get_Trace_Length());
+        model->Generate_Traces(calibration.Trace.data());
+        run_setup.Collect_Extra_Data(
+            *simulator, inputs, calibration.Extra_Data);
+        return m_calibrations.emplace(p_simulator_name, std::move(calibration))
+            .first->second;
+    }
+
+    //! @brief Measures how quickly traces are generated using different
+    //! numbers of threads and batch sizes, and keeps the fastest. The number
+    //! of threads is chosen first, taking one run at a time, and then the
+    //! batch size is doubled for as long as that is faster. This is done
+    //! before any Outputs are constructed so the traces are not saved.
+    //! Neither more threads than runs, nor batches that would leave a thread
+    //! without any runs, are tried.
+    //! @param p_simulator_name The name of the simulator to use.
+    void tune(const std::string& p_simulator_name)
+    {
+        // There is nothing to share between threads.
+        if (m_number_of_runs <= 1)
+        {
+            m_number_of_threads = 1;
+            m_batch_size        = 1;
+            return;
+        }
+
+        fmt::print("Tuning...\n");
+
+        // Every run is completed, so the number of runs started over the
+        // time taken gives the rate.
+        const auto measure = [this, &p_simulator_name](
+                                 const std::size_t p_number_of_threads,
+                                 const std::size_t p_batch_size) {
+            m_number_of_threads = p_number_of_threads;
+            m_batch_size        = p_batch_size;
+            const auto start    = std::chrono::steady_clock::now();
+            const std::size_t runs{
+                generate_traces(p_simulator_name,
+                                std::numeric_limits<std::uint32_t>::max(),
+                                start + tuning_interval)};
+            const std::chrono::duration<double> elapsed{
+                std::chrono::steady_clock::now() - start};
+            return runs / elapsed.count();
+        };
+
+        const std::size_t maximum_threads{
+            std::min<std::size_t>(get_number_of_threads(), m_number_of_runs)};
+
+        // The first runs also load the program and fill caches, so they are
+        // not measured.
+        measure(maximum_threads, 1);
+
+        std::size_t best_threads{1};
+        double best_rate{0};
+        for (std::size_t threads{1}; !stopping(); threads *= 2)
+        {
+            threads = std::min(threads, maximum_threads);
+            const double rate{measure(threads, 1)};
+            if (rate > best_rate)
+            {
+                best_threads = threads;
+                best_rate    = rate;
+            }
+            if (threads == maximum_threads)
+            {
+                break;
+            }
+        }
+
+        // Larger batches are only used if they are noticeably faster, as
+        // Stop() has to wait for every run taken to be completed.
+        std::size_t best_batch_size{1};
+        for (std::size_t batch_size{2};
+             batch_size <= maximum_tuned_batch_size &&
+             batch_size * best_threads <= m_number_of_runs && !stopping();
+             batch_size *= 2)
+        {
+            const double rate{measure(best_threads, batch_size)};
+            if (rate < best_rate * 1.05)
+            {
+                break;
+            }
+            best_batch_size = batch_size;
+            best_rate       = rate;
+        }
+
+        m_number_of_threads = best_threads;
+        m_batch_size        = best_batch_size;
+        m_runs_completed    = 0;
+        fmt::print("Tuned: {} threads taking {} runs at a time ({:.1f} "
+                   "traces/s). Use --threads {} --batch-size {} to skip "
+                   "tuning.\n",
+                   best_threads,
+                   best_batch_size,
+                   best_rate,
+                   best_threads,
+                   best_batch_size);
+    }
+
+    //! @brief Generates traces using every simulator, in turn, until every
+    //! run has been completed or trace generation is stopped.
+    void run_simulators()
+    {
+        warn_if_not_saving();
+        // Initialise all emulators.
+        for (const auto& emulator_interface :
+             Internal::Emulator_Factory::Get_All())
+        {
+            if (!m_simulator_name.empty() &&
+                emulator_interface.first != m_simulator_name)
+            {
+                continue;
+            }
+            fmt::print("Using simulator: {}\n", emulator_interface.first);
+
+            if (m_tune)
+            {
+                tune(emulator_interface.first);
+            }
+
+            // Kept traces are allocated up front, using the size of a
+            // calibration trace, rather than once the first run completes.
+            if (m_matrix)
+            {
+                const auto& calibration = calibrate(emulator_interface.first);
+                m_matrix->Set_Trace_Size(calibration.Trace.size(),
+                                         calibration.Extra_Data.size());
+            }
+
+            construct_outputs();
+            open_journal();
+            for (const auto& output : m_outputs)
+            {
+                output->Start(m_number_of_runs, get_number_of_threads());
+            }
+
+            // Run the emulator and send the results to the outputs.
+            Run_Simulator(emulator_interface.first);
+
+            // Save anything the outputs are still holding.
+            for (const auto& output : m_outputs)
+            {
+                if (m_runs_started < m_number_of_runs)
+                {
+                    output->Stopped(m_runs_started);
+                }
+                output->Finish();
+            }
+            m_outputs.clear();
+
+            // Every trace has now been saved.
+            if (m_journal)
+            {
+                for (const auto& runs : m_unjournaled_runs)
+                {
+                    m_journal->Add(runs);
+                }
+                m_journal.reset();
+            }
+
+            if (stopping())
+            {
+                break;
+            }
+        }
+    }
+
 public:
     // TODO: Separate out some of the functionality in here into an API
     //! @brief The main entry point to the GILES library. This controls the
@@ -163,38 +1069,307 @@ public:
               "Hamming Weight")  // TODO: Set the default using cmake
                                  // configuring a static var in an external
                                  // file.
-    : m_coefficients{Internal::IO().Load_Coefficients(p_coefficients_path)},
+    : GILES(p_program_path,
+            std::make_shared<const Internal::Coefficients>(
+                Internal::IO().Load_Coefficients(p_coefficients_path)),
+            p_traces_path,
+            p_number_of_runs,
+            p_model_name)
+    {
+    }
+
+    //! @brief Constructs GILES using Coefficients that have already been
+    //! loaded. This allows many programs to be ran without loading the
+    //! Coefficients each time.
+    //! @param p_program_path The path to the target executable to be ran in
+    //! the emulator.
+    //! @param p_coefficients The Coefficients. These are shared, not copied.
+    //! @param p_traces_path The path to save the Traces to. This must remain
+    //! valid for as long as GILES is used.
+    //! @param p_number_of_runs The number of traces to generate.
+    //! @param p_model_name The name of the model used to generate traces.
+    GILES(const std::string& p_program_path,
+          const std::shared_ptr<const Internal::Coefficients>& p_coefficients,
+          const std::optional<std::string>& p_traces_path,
+          const std::uint32_t p_number_of_runs,
+          const std::string& p_model_name = "Hamming Weight")
+    : m_coefficients{p_coefficients},
       m_program_path{p_program_path}, m_model_name{std::move(p_model_name)},
-      m_traces_path{p_traces_path},
-      m_number_of_runs{p_number_of_runs}, m_fault{false}, m_serialiser{}
+      m_simulator_name{}, m_traces_path{p_traces_path},
+      m_number_of_runs{p_number_of_runs}, m_fault{false},
+      m_input_generator{}, m_target_outputs{}, m_matrix{}, m_calibrations{},
+      m_first_trace{},
+      m_output_format{"TRS"}, m_output_options{}, m_additional_outputs{},
+      m_custom_outputs{}, m_outputs{}, m_number_of_threads{},
+      m_batch_size{1}, m_tune{false},
+      m_resume{false}, m_journal{}, m_unjournaled_runs{},
+      m_stop_requests{0}, m_stop_requests_finished{0},
+      m_stop_requests_ignored{0}, m_runs_started{0}, m_runs_completed{0}
     {
         // Check the supplied model name is valid
         Internal::Model_Factory::Find(p_model_name);
     }
 
-    //! @todo Document
-    void Run()
+    //! @brief Sets the format that traces are saved in at the traces path.
+    //! If this is not called then traces are saved in the TRS format.
+    //! @param p_output_format The name of the Output to use. e.g. "TRS".
+    //! @param p_options The settings for the Output. The path is ignored as
+    //! the traces path given to the constructor is used instead.
+    void Set_Output_Format(const std::string& p_output_format,
+                           const Internal::Output_Options& p_options = {})
     {
-        warn_if_not_saving();
-        // Initialise all emulators.
+        // Check the supplied format name is valid
+        Internal::Output_Factory::Find(p_output_format);
+
+        m_output_format  = p_output_format;
+        m_output_options = p_options;
+    }
+
+    //! @brief Only uses one simulator, rather than every simulator that GILES
+    //! was built with.
+    //! @param p_simulator_name The name of the simulator. e.g. "Thumb Sim".
+    void Set_Simulator(const std::string& p_simulator_name)
+    {
+        // Check the supplied simulator name is valid
+        Internal::Emulator_Factory::Find(p_simulator_name);
+
+        m_simulator_name = p_simulator_name;
+    }
+
+    //! @brief Adds somewhere for the generated traces to be sent to, in
+    //! addition to the traces path.
+    //! @param p_output_name The name of the Output to use. e.g. "Templates".
+    //! @param p_options The settings for the Output, including the path that
+    //! it will save to.
+    void Add_Output(const std::string& p_output_name,
+                    const Internal::Output_Options& p_options)
+    {
+        // Check the supplied output name is valid
+        Internal::Output_Factory::Find(p_output_name);
+
+        m_additional_outputs.emplace_back(p_output_name, p_options);
+    }
+
+    //! @brief Sends the generated traces to an Output constructed by the
+    //! caller, in addition to the traces path. e.g. one that passes traces on
+    //! as they are generated.
+    //! @param p_output The Output to use. This is started and finished by
+    //! Run() along with every other Output.
+    void Add_Output(const std::shared_ptr<Internal::Output>& p_output)
+    {
+        m_custom_outputs.push_back(p_output);
+    }
+
+    //! @brief Keeps every trace generated by Run() in memory, so that they can
+    //! be used without saving them to disk. The traces are held in a single
+    //! matrix, allocated once the length of the first trace is known, rather
+    //! than allocating for each trace.
+    //! @see Get_Traces()
+    void Collect_Traces()
+    {
+        if (!m_matrix)
+        {
+            m_matrix = std::make_shared<Internal::Output_Matrix>();
+            Add_Output(m_matrix);
+        }
+    }
+
+    //! @brief Retrieves the traces generated by the last call to Run().
+    //! Collect_Traces() must have been called before Run().
+    //! @returns The traces as a contiguous row-major matrix, where row i holds
+    //! the trace of run i.
+    const Internal::Trace_Matrix& Get_Traces() const
+    {
+        if (!m_matrix)
+        {
+            Internal::Error::Report_Error(
+                "Traces are only kept if Collect_Traces() is called before "
+                "Run()");
+        }
+        return m_matrix->Get_Matrix();
+    }
+
+    //! @brief Passes traces to a callback as they are generated, in batches,
+    //! so that they can be used without keeping every trace in memory or
+    //! saving them to disk.
+    //! @param p_callback The callback. This is called concurrently from every
+    //! thread generating traces. @see Internal::Output_Batches::Callback
+    //! @param p_batch_size The number of traces in each batch.
+    void Add_Callback(const Internal::Output_Batches::Callback& p_callback,
+                      const std::size_t p_batch_size = 1024)
+    {
+        Add_Output(std::make_shared<Internal::Output_Batches>(p_callback,
+                                                              p_batch_size));
+    }
+
+    //! @brief Limits the number of threads used to generate traces. If this
+    //! is not called then every available thread is used.
+    //! @param p_number_of_threads The number of threads to use.
+    void Set_Number_Of_Threads(const std::size_t p_number_of_threads)
+    {
+        m_number_of_threads = std::max<std::size_t>(1, p_number_of_threads);
+    }
+
+    //! @brief Sets the number of runs each thread takes at a time. Taking
+    //! more than one run at a time means threads wait for each other less
+    //! often, which helps when each run is short. Every run taken is
+    //! completed, even if Stop() is called. If this is not called then runs
+    //! are taken one at a time.
+    //! @param p_batch_size The number of runs.
+    void Set_Batch_Size(const std::size_t p_batch_size)
+    {
+        m_batch_size = std::max<std::size_t>(1, p_batch_size);
+    }
+
+    //! @brief Before generating traces, generates traces without saving them
+    //! for a few seconds using different numbers of threads and batch sizes
+    //! and then uses whichever was the fastest. The choice is printed so that
+    //! it can be given to Set_Number_Of_Threads() and Set_Batch_Size() rather
+    //! than tuning every time. No more threads are used than would be used
+    //! otherwise.
+    void Tune() { m_tune = true; }
+
+    //! @brief Estimates the cost of calling Run() by completing the first run
+    //! with each simulator. Run() reuses these runs, rather than running them
+    //! again, so this adds no work provided that every setting has been given
+    //! beforehand.
+    //! @returns The number of clock cycles that every run is expected to take
+    //! in total.
+    std::uint64_t Estimate_Cycles()
+    {
+        if (0 == m_number_of_runs)
+        {
+            return 0;
+        }
+
+        std::uint64_t cycles{0};
         for (const auto& emulator_interface :
              Internal::Emulator_Factory::Get_All())
         {
-            fmt::print("Using simulator: {}\n", emulator_interface.first);
+            if (!m_simulator_name.empty() &&
+                emulator_interface.first != m_simulator_name)
+            {
+                continue;
+            }
+            cycles += calibrate(emulator_interface.first).Cycles;
+        }
+        return cycles * m_number_of_runs;
+    }
 
-            // Run the emulator and save the results to m_traces.
-            Run_Simulator(emulator_interface.first);
+    //! @brief Continues from the traces saved by a run that was interrupted,
+    //! skipping the runs recorded in its journal. The number of runs and the
+    //! traces path must be the same as those of the interrupted run.
+    void Resume() { m_resume = true; }
 
-            // If a path was provided then save.
-            if (m_traces_path)
+    //! @brief Places inputs, such as plaintexts, keys and masks, in the memory
+    //! of the target program before each run, instead of the target
+    //! generating its own. The inputs of each run are added to the start of
+    //! its extra data.
+    //! @param p_inputs The inputs to place in memory. Inputs given by name are
+    //! found using the symbol table of the target program.
+    //! @param p_seed Along with the run index, this determines the value of
+    //! every random input. The same seed always produces the same inputs.
+    void
+    Set_Inputs(const std::vector<Internal::Input_Generator::Input>& p_inputs,
+               const std::uint64_t p_seed)
+    {
+        auto inputs = p_inputs;
+        for (auto& input : inputs)
+        {
+            if (!input.Symbol.empty())
             {
-                // Save to file.
-                m_serialiser.Save(m_traces_path.value());
+                const auto buffer = Internal::Program_Image{m_program_path}
+                                        .Find_Buffer(input.Symbol);
+                input.Address = buffer.Address;
+                if (0 == input.Size)
+                {
+                    input.Size = buffer.Size;
+                }
             }
         }
+        m_input_generator.emplace(inputs, p_seed);
+        m_calibrations.clear();
+    }
+
+    //! @brief Reads a variable from the memory of the target after each run,
+    //! e.g. a ciphertext, and adds it to the extra data after any inputs.
+    //! This requires a simulator that supports memory access.
+    //! @param p_address The address of the variable.
+    //! @param p_size The size of the variable in bytes.
+    void Add_Target_Output(const std::uint32_t p_address,
+                           const std::size_t p_size)
+    {
+        m_target_outputs.push_back({p_address, p_size});
+        m_calibrations.clear();
+    }
+
+    //! @brief Reads a variable from the memory of the target after each run,
+    //! found using the symbol table of the target program.
+    //! @param p_symbol The name of the variable. e.g. "ciphertext".
+    //! @param p_size The number of bytes to read, or 0 to read the whole
+    //! variable.
+    void Add_Target_Output(const std::string& p_symbol,
+                           const std::size_t p_size = 0)
+    {
+        auto buffer =
+            Internal::Program_Image{m_program_path}.Find_Buffer(p_symbol);
+        if (0 != p_size)
+        {
+            buffer.Size = p_size;
+        }
+        m_target_outputs.push_back(buffer);
+        m_calibrations.clear();
+    }
+
+    //! @brief Stops generating traces. No more runs are started, the runs
+    //! already in progress are completed and their traces are saved. The
+    //! outputs are then finished as if only those runs had been requested.
+    //! This can be called from another thread or from a signal handler.
+    void Stop() { ++m_stop_requests; }
+
+    //! @returns Whether Stop() has been called, or an error has stopped trace
+    //! generation, since the last call to Run() finished.
+    bool Is_Stopping() const { return stopping(); }
+
+    //! @returns The number of runs that Run() will complete.
+    std::uint32_t Get_Number_Of_Runs() const { return m_number_of_runs; }
+
+    //! @returns The number of runs completed so far, including any completed
+    //! before resuming. This can be called from another thread to report
+    //! progress while Run() is in progress.
+    std::size_t Get_Runs_Completed() const { return m_runs_completed; }
+
+    //! @returns The number of threads used to generate traces, which is
+    //! chosen by Run() if Tune() has been called.
+    std::size_t Get_Number_Of_Threads() const
+    {
+        return get_number_of_threads();
+    }
+
+    //! @returns The number of runs each thread takes at a time, which is
+    //! chosen by Run() if Tune() has been called.
+    std::size_t Get_Batch_Size() const { return m_batch_size; }
+
+    //! @brief Generates the traces, sending them to every Output.
+    void Run()
+    {
+        // Only calls to Stop() made since the last call to Run() finished
+        // apply to this one. Those made before this starts still stop it.
+        m_stop_requests_ignored = m_stop_requests_finished;
+
+        try
+        {
+            run_simulators();
+        }
+        catch (...)
+        {
+            m_stop_requests_finished = m_stop_requests;
+            throw;
+        }
+        m_stop_requests_finished = m_stop_requests;
     }
 
-    void Inject_Fault(const std::uint32_t p_cycle_to_fault,
+    void Inject_Fault(const std::uint64_t p_cycle_to_fault,
                       const std::string& p_register_to_fault,
                       const std::uint8_t p_bit_to_fault)
     {
@@ -202,105 +1377,409 @@ public:
         m_fault_cycle    = p_cycle_to_fault;
         m_fault_register = p_register_to_fault;
         m_fault_bit      = p_bit_to_fault;
+        m_calibrations.clear();
     }
 
-    void Set_Timeout(const std::uint32_t p_number_of_cycles)
+    void Set_Timeout(const std::uint64_t p_number_of_cycles)
     {
         m_timeout = p_number_of_cycles;
+        m_calibrations.clear();
     }
 
-    //! @brief Runs the simulator given by p_simulator_name and TODO:
-    decltype(m_traces) Run_Simulator(const std::string& p_simulator_name)
+    //! @brief Runs the simulator given by p_simulator_name and sends every
+    //! trace generated to the outputs.
+    //! @param p_simulator_name The name of the simulator to use.
+    void Run_Simulator(const std::string& p_simulator_name)
     {
         fmt::print("Using model: {}\n", m_model_name);
 
-        // Ensures that the constant time warning is not printed over and over.
-        bool warning_printed{false};
+        m_first_trace.reset();
+
+        // Used to indicate progress. 'i' is not used as it is not thread safe.
+        // This is. Runs completed before resuming are included.
+        m_runs_completed = m_journal ? m_journal->Number_Completed() : 0;
 
-        // Used to indicate progress to the user. 'i' is not used as it is not
-        // thread safe. This is.
-        uint32_t steps_completed{0};
+        const std::size_t steps_resumed{m_runs_completed};
+        const auto start_time = std::chrono::steady_clock::now();
 
         fmt::print("Starting... (0.0%)\n");
+        m_runs_started =
+            generate_traces(p_simulator_name, m_number_of_runs, std::nullopt);
 
-#pragma omp parallel for
-        for (std::size_t i = 0; i < m_number_of_runs; ++i)
+        const std::chrono::duration<double> elapsed{
+            std::chrono::steady_clock::now() - start_time};
+        const std::size_t steps_generated{m_runs_completed - steps_resumed};
+        if (m_runs_started < m_number_of_runs)
         {
-            // Construct the simulator, ready for use.
-            const auto simulator = Internal::Emulator_Factory::Construct(
-                p_simulator_name, m_program_path);
+            fmt::print("\nStopped. The first {} of {} traces were saved.\n",
+                       m_runs_started,
+                       m_number_of_runs);
+        }
+        else
+        {
+            fmt::print("\nDone!\n");
+        }
+        fmt::print("Generated {} traces in {:.2f}s ({:.1f} traces/s)\n",
+                   steps_generated,
+                   elapsed.count(),
+                   elapsed.count() > 0 ? steps_generated / elapsed.count()
+                                       : 0.0);
+    }
+};
 
-            if (m_timeout)
+//! @class Trace_Generator
+//! @brief Generates traces in the background and hands them over one at a
+//! time, in run order, for code that uses each trace as it arrives. Only a
+//! bounded number of runs are generated ahead of the trace being used, so
+//! memory use does not depend on the number of runs. e.g.
+//! @code
+//! for (const auto& trace : GILES::Trace_Generator{giles})
+//! {
+//!     analyse(trace.Run, trace.Samples, trace.Extra_Data);
+//! }
+//! @endcode
+//! Stopping early, by destroying the Trace_Generator, stops GILES once the
+//! runs in progress are completed.
+class Trace_Generator
+{
+public:
+    using Trace = Internal::Output_Ordered::Trace;
+
+    //! @class Iterator
+    //! @brief Steps through the traces. Traces can only be stepped through
+    //! once and each is only valid until the next is taken.
+    class Iterator
+    {
+    private:
+        //! This is nullptr once every trace has been taken.
+        Trace_Generator* m_generator;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = Trace;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Trace*;
+        using reference         = const Trace&;
+
+        explicit Iterator(Trace_Generator* const p_generator)
+            : m_generator{p_generator}
+        {
+        }
+
+        reference operator*() const { return m_generator->m_current; }
+        pointer operator->() const { return &m_generator->m_current; }
+
+        Iterator& operator++()
+        {
+            if (!m_generator->next())
             {
-                simulator->Add_Timeout(m_timeout.value());
+                m_generator = nullptr;
             }
+            return *this;
+        }
+
+        bool operator==(const Iterator& p_other) const
+        {
+            return m_generator == p_other.m_generator;
+        }
+        bool operator!=(const Iterator& p_other) const
+        {
+            return !(*this == p_other);
+        }
+    };
+
+private:
+    GILES& m_giles;
+    const std::shared_ptr<Internal::Output_Ordered> m_output;
+
+    //! The trace that was taken last.
+    Trace m_current;
 
-            if (m_fault)
+    //! The error that stopped GILES, if errors are being thrown.
+    std::exception_ptr m_error;
+
+    //! Runs GILES.
+    std::thread m_thread;
+
+    //! @brief Takes the trace of the next run, waiting for it to be
+    //! generated.
+    //! @returns true if a trace was taken, false if there are no more.
+    //! @throws Internal::Error::Exception If GILES stopped with an error.
+    bool next()
+    {
+        if (m_output->Take(&m_current))
+        {
+            return true;
+        }
+        if (m_error)
+        {
+            std::rethrow_exception(m_error);
+        }
+        return false;
+    }
+
+public:
+    //! @brief Starts generating traces in the background. Errors are thrown
+    //! when the traces are stepped through if a Throw_Errors object exists on
+    //! the calling thread, otherwise they stop the program as usual.
+    //! @param p_giles The traces to generate. This must not be ran again.
+    //! @param p_lookahead The number of runs that can be generated ahead of
+    //! the trace being used.
+    explicit Trace_Generator(GILES& p_giles, const std::size_t p_lookahead = 64)
+        : m_giles{p_giles},
+          m_output{std::make_shared<Internal::Output_Ordered>(p_lookahead)},
+          m_current{}, m_error{}, m_thread{}
+    {
+        m_giles.Add_Output(m_output);
+
+        const bool throwing_errors{Internal::Error::Is_Throwing()};
+        m_thread = std::thread{[this, throwing_errors] {
+            try
+            {
+                const Internal::Error::Throw_Errors throw_errors{
+                    throwing_errors};
+                m_giles.Run();
+            }
+            catch (...)
             {
-                simulator->Inject_Fault(
-                    m_fault_cycle, m_fault_register, m_fault_bit);
+                m_error = std::current_exception();
             }
+            m_output->Finish();
+        }};
+    }
 
-            const auto execution = simulator->Run_Code();
+    //! @brief Stops generating traces, if any are still to be generated.
+    ~Trace_Generator()
+    {
+        m_giles.Stop();
+        m_output->Close();
+        m_thread.join();
+    }
 
-            // Any extra data to be included in the trace.
-            const auto extra_data = simulator->Get_Extra_Data();
+    Trace_Generator(const Trace_Generator&) = delete;
+    Trace_Generator& operator=(const Trace_Generator&) = delete;
 
-            // Initialise all models.
-            // TODO: Future: Add support for using multiple models at once using
-            // this code.
-            /*for (const auto& model_interface :
-                 GILES::Internal::Model_Factory::Get_All())
-            {
+    //! @returns An iterator to the first trace, waiting for it to be
+    //! generated. This must only be called once.
+    Iterator begin()
+    {
+        Iterator iterator{this};
+        return ++iterator;
+    }
 
-            // Construct the model, ready for use.
-            const auto model = GILES::Internal::Model_Factory::Construct(
-                model_interface.first, execution, m_coefficients);*/
+    //! @returns An iterator that is reached once every trace has been taken.
+    Iterator end() { return Iterator{nullptr}; }
+};
 
-            // Construct the model, ready for use.
-            const auto model = Internal::Model_Factory::Construct(
-                m_model_name, execution, m_coefficients);
+//! @class Job_Pool
+//! @brief Runs GILES in the background, so that it can be used within a long
+//! running program such as an analysis service. Up to a set number of jobs run
+//! at once, each using an equal share of the threads, so jobs running together
+//! do not oversubscribe the cores. Errors are returned as part of the Result
+//! of a job rather than stopping the program.
+class Job_Pool
+{
+public:
+    //! The outcome of a job.
+    struct Result
+    {
+        //! The number of runs completed, including any completed before
+        //! resuming.
+        std::size_t Runs_Completed{0};
 
-            // If this is not the first trace gathered then ensure that all
-            // traces are the same length (Meaning the target algorithm runs
-            // in constant time). This is a requirement for using the TRS
-            // trace format.
-            const auto trace = model->Generate_Traces();
+        //! Whether the job was cancelled before every run was completed.
+        bool Cancelled{false};
 
-            // Increment the counter of number of traces generated.
-#pragma omp atomic
-            ++steps_completed;
+        //! The error that stopped the job, if it failed.
+        std::optional<std::string> Error{};
+    };
 
-// This is marked critical to ensure everything gets added and
-// locks are automatically handled.
-#pragma omp critical
-            {
-                // Add the generated trace to the list of traces.
-                m_traces.emplace_back(trace);
+    //! @class Handle
+    //! @brief Refers to a job that has been submitted. This can be copied and
+    //! used from any thread, to wait for the job, check its progress or
+    //! cancel it.
+    class Handle
+    {
+    private:
+        std::shared_ptr<GILES> m_giles;
+        std::shared_future<Result> m_result;
+
+    public:
+        Handle(const std::shared_ptr<GILES>& p_giles,
+               const std::shared_future<Result>& p_result)
+            : m_giles{p_giles}, m_result{p_result}
+        {
+        }
+
+        //! @returns Whether the job has finished, successfully or not.
+        bool Is_Done() const
+        {
+            return std::future_status::ready ==
+                   m_result.wait_for(std::chrono::seconds{0});
+        }
 
-                // Add any extra information given by the simulator to the
-                // traces.
-                m_extra_data.emplace_back(extra_data);
+        //! @brief Waits for the job to finish.
+        void Wait() const { m_result.wait(); }
 
-                m_serialiser.Add_Trace(trace, extra_data);
+        //! @brief Waits for the job to finish.
+        //! @returns The outcome of the job.
+        const Result& Get() const { return m_result.get(); }
+
+        //! @returns The proportion of the runs that have been completed, from
+        //! 0 to 1.
+        double Get_Progress() const
+        {
+            const auto number_of_runs = m_giles->Get_Number_Of_Runs();
+            return 0 == number_of_runs
+                       ? 1.0
+                       : static_cast<double>(m_giles->Get_Runs_Completed()) /
+                             number_of_runs;
+        }
+
+        //! @brief Cancels the job. If it is running then no more runs are
+        //! started and it finishes once the runs in progress are completed,
+        //! as if it had been stopped using GILES::Stop(). If it is waiting to
+        //! run then it is not started.
+        void Cancel() const { m_giles->Stop(); }
+    };
+
+private:
+    //! A job waiting to run.
+    struct Job
+    {
+        std::shared_ptr<GILES> Giles{};
+        std::promise<Result> Promise{};
+    };
 
-                // If this warning hasn't been printed before.
-                if (!warning_printed)
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Job> m_waiting;
+
+    //! The jobs that are running, so that they can be cancelled.
+    std::unordered_set<std::shared_ptr<GILES>> m_running;
+
+    //! Set when the pool is destroyed.
+    bool m_stopping;
+
+    const std::size_t m_threads_per_job;
+
+    //! Each of these runs one job at a time.
+    std::vector<std::thread> m_workers;
+
+    //! @brief Runs jobs until the pool is destroyed and no jobs are waiting.
+    void run_jobs()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock{m_mutex};
+                m_condition.wait(
+                    lock, [this] { return m_stopping || !m_waiting.empty(); });
+                if (m_waiting.empty())
                 {
-                    // Will print a warning if the target program is not
-                    // constant time.
-                    warning_printed = warn_if_not_constant_time();
+                    return;
                 }
+                job = std::move(m_waiting.front());
+                m_waiting.pop_front();
+                m_running.insert(job.Giles);
             }
 
-            fmt::print("\rGenerated: {} of {} traces. ({}%)",
-                       steps_completed,
-                       m_number_of_runs,
-                       100.0 * steps_completed / m_number_of_runs);
-            //}
+            Result result;
+            try
+            {
+                const Internal::Error::Throw_Errors throw_errors;
+                if (!job.Giles->Is_Stopping())
+                {
+                    job.Giles->Run();
+                }
+            }
+            catch (const std::exception& exception)
+            {
+                result.Error = exception.what();
+            }
+            result.Runs_Completed = job.Giles->Get_Runs_Completed();
+            result.Cancelled = !result.Error && job.Giles->Is_Stopping() &&
+                               result.Runs_Completed <
+                                   job.Giles->Get_Number_Of_Runs();
+
+            {
+                const std::lock_guard<std::mutex> lock{m_mutex};
+                m_running.erase(job.Giles);
+            }
+            job.Promise.set_value(result);
         }
-        fmt::print("\nDone!\n");
-        return m_traces;
+    }
+
+public:
+    //! @brief Starts the threads that run jobs.
+    //! @param p_concurrent_jobs The number of jobs that run at once.
+    //! @param p_number_of_threads The number of threads shared between the
+    //! jobs running at once. If this is 0 then every hardware thread is used.
+    explicit Job_Pool(const std::size_t p_concurrent_jobs   = 1,
+                      const std::size_t p_number_of_threads = 0)
+        : m_mutex{}, m_condition{}, m_waiting{}, m_running{},
+          m_stopping{false},
+          m_threads_per_job{std::max<std::size_t>(
+              1,
+              (0 == p_number_of_threads ? std::thread::hardware_concurrency()
+                                        : p_number_of_threads) /
+                  std::max<std::size_t>(1, p_concurrent_jobs))},
+          m_workers{}
+    {
+        for (std::size_t i{0}; i < std::max<std::size_t>(1, p_concurrent_jobs);
+             ++i)
+        {
+            m_workers.emplace_back(&Job_Pool::run_jobs, this);
+        }
+    }
+
+    //! @brief Cancels every job, waiting for those that are running to
+    //! finish.
+    ~Job_Pool()
+    {
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            m_stopping = true;
+            for (const auto& job : m_waiting)
+            {
+                job.Giles->Stop();
+            }
+            for (const auto& giles : m_running)
+            {
+                giles->Stop();
+            }
+        }
+        m_condition.notify_all();
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    Job_Pool(const Job_Pool&) = delete;
+    Job_Pool& operator=(const Job_Pool&) = delete;
+
+    //! @brief Adds a job to be ran once a worker is free. Jobs are started in
+    //! the order they are submitted.
+    //! @param p_giles The job, with every setting and Output already given.
+    //! The traces path given when it was constructed must remain valid until
+    //! the job is done. Its number of threads is set by the pool.
+    //! @returns A handle to the job.
+    Handle Submit(const std::shared_ptr<GILES>& p_giles)
+    {
+        p_giles->Set_Number_Of_Threads(m_threads_per_job);
+
+        std::promise<Result> promise;
+        const Handle handle{p_giles, promise.get_future().share()};
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            m_waiting.push_back({p_giles, std::move(promise)});
+        }
+        m_condition.notify_one();
+        return handle;
     }
 };
 }  // namespace GILES
+
+#endif  // GILES_CPP
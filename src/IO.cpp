@@ -28,11 +28,13 @@
 #include <cstdlib>    // for exit, EXIT_FAILURE
 #include <fstream>    // for ifstream
 #include <stdexcept>  // for invalid_argument
+#include <vector>     // for vector
 
 #include <nlohmann/json.hpp>  // for json, basic_json<>::exception
 
 #include "Coefficients.hpp"            // for Coefficients
 #include "Error.hpp"                   // for Report_Error
+#include "Job.hpp"                     // for Job
 #include "Validator_Coefficients.hpp"  // for Validator_Coefficients
 
 namespace GILES
@@ -75,5 +77,129 @@ const GILES::Internal::Coefficients GILES::Internal::IO::Load_Coefficients(
     }
     return GILES::Internal::Coefficients{json};
 }
+
+namespace
+{
+//! @brief Interprets a single job.
+//! @param p_json The job as a JSON object.
+//! @returns The job.
+//! @throws std::invalid_argument If the job could not be interpreted.
+GILES::Internal::Job parse_job(const nlohmann::json& p_json)
+{
+    GILES::Internal::Job job;
+    try
+    {
+        job.Program_Path   = p_json.at("program").get<std::string>();
+        job.Model_Name     = p_json.value("model", job.Model_Name);
+        job.Number_Of_Runs = p_json.value("runs", job.Number_Of_Runs);
+        if (0 != p_json.count("output"))
+        {
+            job.Traces_Path = p_json["output"].get<std::string>();
+        }
+        if (0 != p_json.count("format"))
+        {
+            job.Output_Format = p_json["format"].get<std::string>();
+        }
+        if (0 != p_json.count("fault"))
+        {
+            const auto& fault = p_json["fault"];
+            if (!fault.is_array() || 3 != fault.size())
+            {
+                throw std::invalid_argument{"fault"};
+            }
+            job.Fault          = true;
+            job.Fault_Cycle    = fault[0].get<std::uint64_t>();
+            job.Fault_Register = fault[1].get<std::string>();
+            job.Fault_Bit      = fault[2].get<std::uint8_t>();
+        }
+        if (0 != p_json.count("timeout"))
+        {
+            job.Timeout = p_json["timeout"].get<std::uint64_t>();
+        }
+    }
+    catch (const std::exception&)
+    {
+        throw std::invalid_argument{
+            "could not be interpreted. Every job needs a \"program\" and may "
+            "have \"model\", \"runs\", \"output\", \"format\", \"fault\" and "
+            "\"timeout\"."};
+    }
+    return job;
+}
+}  // namespace
+
+//! @brief Interprets a single job, given as a JSON object in the same form as
+//! each job within a job file. See Load_Jobs().
+//! @param p_job The job as a string of JSON.
+//! @returns The job.
+//! @throws std::invalid_argument If the job could not be interpreted. Unlike
+//! the other functions here, this does not stop execution, so that one bad
+//! job can be rejected while others continue.
+const GILES::Internal::Job
+GILES::Internal::IO::Parse_Job(const std::string& p_job) const
+{
+    nlohmann::json json;
+    try
+    {
+        json = nlohmann::json::parse(p_job);
+    }
+    catch (nlohmann::detail::parse_error&)
+    {
+        throw std::invalid_argument{"is not valid JSON"};
+    }
+    return parse_job(json);
+}
+
+//! @brief Loads a list of jobs from a JSON file. The file holds an array with
+//! an object for each job. e.g.
+//! [{"program": "aes.elf", "runs": 1000, "output": "aes.trs",
+//!   "model": "Power", "format": "TRS", "fault": [10, "R0", 2],
+//!   "timeout": 100000}]
+//! Only "program" is required.
+//! @param p_jobs_path The path where the jobs should be loaded from.
+//! @returns The jobs, in the order they are listed.
+const std::vector<GILES::Internal::Job>
+GILES::Internal::IO::Load_Jobs(const std::string& p_jobs_path) const
+{
+    std::ifstream file{p_jobs_path};
+    if (!file.is_open())
+    {
+        GILES::Internal::Error::Report_Error("Could not open job file '{}'",
+                                             p_jobs_path);
+    }
+
+    nlohmann::json json;
+    try
+    {
+        json = nlohmann::json::parse(file);
+    }
+    catch (nlohmann::detail::parse_error&)
+    {
+        GILES::Internal::Error::Report_Error(
+            "Job file '{}' is not a valid JSON file", p_jobs_path);
+    }
+    if (!json.is_array())
+    {
+        GILES::Internal::Error::Report_Error(
+            "Job file '{}' must contain an array of jobs", p_jobs_path);
+    }
+
+    std::vector<Job> jobs;
+    for (std::size_t i{0}; i < json.size(); ++i)
+    {
+        try
+        {
+            jobs.push_back(parse_job(json[i]));
+        }
+        catch (const std::exception& exception)
+        {
+            GILES::Internal::Error::Report_Error("Job {} in '{}' {}",
+                                                 i + 1,
+                                                 p_jobs_path,
+                                                 exception.what());
+        }
+    }
+    return jobs;
+}
 }  // namespace Internal
 }  // namespace GILES
@@ -27,8 +27,10 @@
 #define IO_HPP
 
 #include <string>  // for string
+#include <vector>  // for vector
 
 #include "Coefficients.hpp"  // for Coefficients
+#include "Job.hpp"           // for Job
 
 namespace GILES
 {
@@ -41,6 +43,11 @@ struct IO
 {
     const GILES::Internal::Coefficients
     Load_Coefficients(const std::string& p_coefficients_path) const;
+
+    const std::vector<GILES::Internal::Job>
+    Load_Jobs(const std::string& p_jobs_path) const;
+
+    const GILES::Internal::Job Parse_Job(const std::string& p_job) const;
 };
 }  // namespace Internal
 }  // namespace GILES
@@ -0,0 +1,122 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Input_Generator.cpp
+    @brief Contains the Input_Generator class which generates the inputs given
+    to the target program in each run.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <array>    // for array
+#include <cstdint>  // for uint32_t, uint64_t
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "Input_Generator.hpp"
+
+#include "Error.hpp"  // for Report_Error
+
+GILES::Internal::Input_Generator::Input_Generator(
+    const std::vector<Input>& p_inputs, const std::uint64_t p_seed)
+    : m_inputs{p_inputs}, m_seed{p_seed}
+{
+    for (const auto& input : m_inputs)
+    {
+        if (Kind::Random != input.Type &&
+            input.Fixed_Value.size() != input.Size)
+        {
+            Error::Report_Error("The fixed value of the input at 0x{:08x} is "
+                                "{} bytes but the input is {} bytes",
+                                input.Address,
+                                input.Fixed_Value.size(),
+                                input.Size);
+        }
+    }
+}
+
+//! @brief Generates the values of the inputs for a run. Each input is given
+//! its own stream of random values, so adding an input does not change the
+//! values of the others.
+std::vector<std::string>
+GILES::Internal::Input_Generator::Generate(const std::size_t p_run_index) const
+{
+    const std::array<std::uint32_t, 2> key{
+        static_cast<std::uint32_t>(m_seed),
+        static_cast<std::uint32_t>(m_seed >> 32)};
+
+    std::vector<std::string> values;
+    values.reserve(m_inputs.size());
+    for (std::size_t i{0}; i < m_inputs.size(); ++i)
+    {
+        const auto& input = m_inputs[i];
+        if (Kind::Fixed == input.Type ||
+            (Kind::Interleaved == input.Type && 0 == p_run_index % 2))
+        {
+            values.push_back(input.Fixed_Value);
+            continue;
+        }
+
+        // The counter is made up of the run, the input and the block.
+        std::string value(input.Size, '\0');
+        for (std::size_t byte{0}; byte < input.Size; byte += 16)
+        {
+            const auto block = Philox(
+                {static_cast<std::uint32_t>(p_run_index),
+                 static_cast<std::uint32_t>(std::uint64_t{p_run_index} >> 32),
+                 static_cast<std::uint32_t>(i),
+                 static_cast<std::uint32_t>(byte / 16)},
+                key);
+            for (std::size_t j{0}; j < 16 && byte + j < input.Size; ++j)
+            {
+                value[byte + j] =
+                    static_cast<char>(block[j / 4] >> (8 * (j % 4)));
+            }
+        }
+        values.push_back(std::move(value));
+    }
+    return values;
+}
+
+std::array<std::uint32_t, 4>
+GILES::Internal::Input_Generator::Philox(std::array<std::uint32_t, 4> p_counter,
+                                         std::array<std::uint32_t, 2> p_key)
+{
+    constexpr std::uint64_t multiplier_0{0xD2511F53};
+    constexpr std::uint64_t multiplier_1{0xCD9E8D57};
+    constexpr std::uint32_t weyl_0{0x9E3779B9};
+    constexpr std::uint32_t weyl_1{0xBB67AE85};
+
+    for (std::size_t round{0}; round < 10; ++round)
+    {
+        const std::uint64_t product_0{multiplier_0 * p_counter[0]};
+        const std::uint64_t product_1{multiplier_1 * p_counter[2]};
+        p_counter = {
+            static_cast<std::uint32_t>(product_1 >> 32) ^ p_counter[1] ^
+                p_key[0],
+            static_cast<std::uint32_t>(product_1),
+            static_cast<std::uint32_t>(product_0 >> 32) ^ p_counter[3] ^
+                p_key[1],
+            static_cast<std::uint32_t>(product_0)};
+        p_key[0] += weyl_0;
+        p_key[1] += weyl_1;
+    }
+    return p_counter;
+}
@@ -0,0 +1,114 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Input_Generator.hpp
+    @brief Contains the Input_Generator class which generates the inputs given
+    to the target program in each run.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef INPUT_GENERATOR_HPP
+#define INPUT_GENERATOR_HPP
+
+#include <array>    // for array
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Input_Generator
+//! @brief Generates the inputs, such as plaintexts, keys and masks, that are
+//! placed in the memory of the target program before each run.
+//!
+//! Random inputs are generated using the Philox4x32-10 counter based random
+//! number generator, keyed on a seed, with the run index as the counter. The
+//! inputs of a run therefore only depend on the seed and the run index. This
+//! makes every campaign reproducible, allows runs to be generated in any
+//! order, by any thread, and means resumed runs are given the same inputs.
+//! @see https://doi.org/10.1145/2063384.2063405
+class Input_Generator
+{
+public:
+    //! How the value of an input is chosen in each run.
+    enum class Kind
+    {
+        Random,  //!< A new random value in every run.
+        Fixed,   //!< Fixed_Value in every run.
+
+        //! Fixed_Value in even runs and a random value in odd runs, as used
+        //! by fixed-vs-random leakage assessment.
+        Interleaved
+    };
+
+    //! A buffer in the memory of the target that is written before each run.
+    struct Input
+    {
+        std::uint32_t Address;
+        std::size_t Size;
+        Kind Type{Kind::Random};
+
+        //! The bytes used by Fixed and Interleaved inputs. This must be Size
+        //! bytes long.
+        std::string Fixed_Value{};
+
+        //! The name of the variable holding the input, if it was given by
+        //! name. This is used by GILES to find the address, and the size if
+        //! Size is 0, before the generator is constructed.
+        std::string Symbol{};
+    };
+
+private:
+    const std::vector<Input> m_inputs;
+    const std::uint64_t m_seed;
+
+public:
+    //! @brief Constructs a generator for the inputs given.
+    //! @param p_inputs The inputs to generate.
+    //! @param p_seed The seed that, along with the run index, determines
+    //! every random value.
+    Input_Generator(const std::vector<Input>& p_inputs,
+                    const std::uint64_t p_seed);
+
+    //! @brief Retrieves the inputs that are generated.
+    //! @returns The inputs.
+    const std::vector<Input>& Get_Inputs() const { return m_inputs; }
+
+    //! @brief Generates the values of the inputs for a run. This can be
+    //! called from any thread.
+    //! @param p_run_index The index of the run.
+    //! @returns The value of each input, in the order they were given.
+    std::vector<std::string> Generate(const std::size_t p_run_index) const;
+
+    //! @brief The Philox4x32-10 block function.
+    //! @param p_counter The counter.
+    //! @param p_key The key.
+    //! @returns 128 random bits.
+    static std::array<std::uint32_t, 4>
+    Philox(std::array<std::uint32_t, 4> p_counter,
+           std::array<std::uint32_t, 2> p_key);
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // INPUT_GENERATOR_HPP
@@ -0,0 +1,205 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Instruction_Stream.cpp
+    @brief Contains the Instruction_Stream class which holds the contents of
+    the pipeline stages throughout an Execution, so that they can be shared by
+    every Execution of the same program.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <functional>     // for hash
+#include <iterator>       // for next
+#include <mutex>          // for mutex, lock_guard, call_once
+#include <stdexcept>      // for out_of_range
+#include <string_view>    // for string_view
+#include <unordered_map>  // for unordered_map, unordered_multimap
+#include <utility>        // for move
+
+#include "Instruction_Stream.hpp"
+
+namespace
+{
+//! @brief Mixes p_value into p_seed.
+//! @see https://www.boost.org/doc/libs/release/libs/container_hash/
+void hash_combine(std::size_t* const p_seed, const std::size_t p_value)
+{
+    *p_seed ^= p_value + 0x9E3779B9 + (*p_seed << 6) + (*p_seed >> 2);
+}
+}  // namespace
+
+void GILES::Internal::Instruction_Stream::Add_Stage(const std::string& p_name,
+                                                    const Stage& p_stage)
+{
+    Stored_Stage stored;
+    const auto cycles = std::make_shared<Chunked_Buffer>(p_stage.size());
+
+    // The position of each distinct value within stored.Values.
+    std::unordered_map<std::string_view, std::size_t> positions;
+    for (std::size_t cycle{0}; cycle < p_stage.size(); ++cycle)
+    {
+        const auto [position, inserted] =
+            positions.try_emplace(p_stage[cycle], stored.Values.size());
+        if (inserted)
+        {
+            stored.Values.push_back(p_stage[cycle]);
+        }
+        (*cycles)[cycle] = position->second;
+    }
+    stored.Cycles = cycles;
+
+    m_states.insert_or_assign(p_name, Pipeline_States{p_stage.size()});
+    m_stages.insert_or_assign(p_name, std::move(stored));
+    m_instructions.insert_or_assign(p_name, std::make_shared<Instructions>());
+}
+
+std::size_t GILES::Internal::Instruction_Stream::checked_cycle(
+    const std::size_t p_cycle, const Stored_Stage& p_stage)
+{
+    if (p_cycle >= p_stage.Cycles->Size())
+    {
+        throw std::out_of_range{"Clock cycle " + std::to_string(p_cycle) +
+                                " is past the end of the pipeline stage"};
+    }
+    return p_cycle;
+}
+
+bool GILES::Internal::Instruction_Stream::Is_Stage(const std::string& p_name,
+                                                   const Stage& p_stage) const
+{
+    const auto found = m_stages.find(p_name);
+    if (m_stages.end() == found ||
+        found->second.Cycles->Size() != p_stage.size())
+    {
+        return false;
+    }
+    const Stored_Stage& stage{found->second};
+    for (std::size_t cycle{0}; cycle < p_stage.size(); ++cycle)
+    {
+        if (stage.Values[(*stage.Cycles)[cycle]] != p_stage[cycle])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GILES::Internal::Instruction_Stream::operator==(
+    const Instruction_Stream& p_other) const
+{
+    if (m_states != p_other.m_states ||
+        m_stages.size() != p_other.m_stages.size())
+    {
+        return false;
+    }
+    for (const auto& [name, stage] : m_stages)
+    {
+        const auto other = p_other.m_stages.find(name);
+        if (p_other.m_stages.end() == other ||
+            stage.Values != other->second.Values ||
+            stage.Cycles->Size() != other->second.Cycles->Size())
+        {
+            return false;
+        }
+        // Values are numbered in order of first use, so identical stages
+        // have identical indices.
+        for (std::size_t cycle{0}; cycle < stage.Cycles->Size(); ++cycle)
+        {
+            if ((*stage.Cycles)[cycle] != (*other->second.Cycles)[cycle])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+const GILES::Internal::Assembly_Instruction&
+GILES::Internal::Instruction_Stream::Get_Instruction(
+    const std::size_t p_cycle, const std::string& p_name) const
+{
+    const Stored_Stage& stage{m_stages.at(p_name)};
+    Instructions& instructions{*m_instructions.at(p_name)};
+    std::call_once(instructions.Parsed, [&] {
+        instructions.Values.reserve(stage.Values.size());
+        for (const std::string& value : stage.Values)
+        {
+            instructions.Values.push_back(Assembly_Instruction::Parse(value));
+        }
+    });
+    return instructions
+        .Values[(*stage.Cycles)[checked_cycle(p_cycle, stage)]];
+}
+
+std::shared_ptr<const GILES::Internal::Instruction_Stream>
+GILES::Internal::Instruction_Stream::Intern(Instruction_Stream p_stream)
+{
+    std::size_t hash{0};
+    for (const auto& [name, stage] : p_stream.m_stages)
+    {
+        hash_combine(&hash, std::hash<std::string>{}(name));
+        hash_combine(&hash, stage.Cycles->Size());
+        for (const std::string& value : stage.Values)
+        {
+            hash_combine(&hash, std::hash<std::string>{}(value));
+        }
+        for (std::size_t cycle{0}; cycle < stage.Cycles->Size(); ++cycle)
+        {
+            hash_combine(&hash, (*stage.Cycles)[cycle]);
+        }
+        for (const auto& run : p_stream.m_states.at(name).Get_Runs())
+        {
+            hash_combine(&hash, run.First);
+            hash_combine(&hash, run.Length);
+            hash_combine(&hash, static_cast<std::size_t>(run.State));
+        }
+    }
+    p_stream.m_hash = hash;
+
+    // Only weak references are kept so that a stream is freed once no
+    // Execution is using it.
+    static std::unordered_multimap<std::size_t,
+                                   std::weak_ptr<const Instruction_Stream>>
+        interned;
+    static std::mutex mutex;
+    const std::lock_guard<std::mutex> lock{mutex};
+
+    const auto [first, last] = interned.equal_range(hash);
+    for (auto candidate = first; candidate != last; ++candidate)
+    {
+        if (const auto existing = candidate->second.lock();
+            existing && p_stream == *existing)
+        {
+            return existing;
+        }
+    }
+
+    // Forget streams that are no longer in use before adding the new one.
+    for (auto entry = interned.begin(); entry != interned.end();)
+    {
+        entry = entry->second.expired() ? interned.erase(entry)
+                                        : std::next(entry);
+    }
+
+    const auto stream =
+        std::make_shared<const Instruction_Stream>(std::move(p_stream));
+    interned.emplace(hash, stream);
+    return stream;
+}
@@ -0,0 +1,221 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Instruction_Stream.hpp
+    @brief Contains the Instruction_Stream class which holds the contents of
+    the pipeline stages throughout an Execution, so that they can be shared by
+    every Execution of the same program.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef INSTRUCTION_STREAM_HPP
+#define INSTRUCTION_STREAM_HPP
+
+#include <cstddef>  // for size_t
+#include <map>      // for map
+#include <memory>   // for shared_ptr
+#include <mutex>    // for once_flag
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Assembly_Instruction.hpp"  // for Assembly_Instruction
+#include "Chunked_Buffer.hpp"        // for Chunked_Buffer
+#include "Pipeline_States.hpp"       // for Pipeline_States, Pipeline_State
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Instruction_Stream
+//! @brief The per clock cycle contents of each pipeline stage, e.g. "Fetch",
+//! and the state of each stage during every cycle. For a constant time
+//! program these are the same on every run, only the values in the registers
+//! differ, so a single Instruction_Stream is shared by every Execution rather
+//! than each Execution storing its own copy.
+//!
+//! An Instruction_Stream is filled in and then passed to Intern() which
+//! returns an immutable shared copy. Identical streams that are interned
+//! return the same copy.
+class Instruction_Stream
+{
+public:
+    //! The contents of one pipeline stage, indexed by clock cycle.
+    using Stage = std::vector<std::string>;
+
+private:
+    //! The contents of a pipeline stage as it is stored. Each distinct value
+    //! is stored once and every cycle refers to it by index. The indices are
+    //! held in a Chunked_Buffer, so that long recordings are spilled to disk
+    //! with the registers rather than held in memory as one string per cycle.
+    struct Stored_Stage
+    {
+        std::vector<std::string> Values;
+        std::shared_ptr<const Chunked_Buffer> Cycles;
+    };
+
+    //! The contents of each pipeline stage, indexed by the name of the stage.
+    std::map<std::string, Stored_Stage> m_stages;
+
+    //! The state of each pipeline stage during every cycle, indexed by the
+    //! name of the stage. These are sized to match the stage.
+    std::map<std::string, Pipeline_States> m_states;
+
+    //! A hash of the stages and states. This is set by Intern().
+    std::size_t m_hash;
+
+    //! The distinct values of a pipeline stage parsed into instructions, in
+    //! the same order as Stored_Stage::Values.
+    struct Instructions
+    {
+        Instructions() : Parsed{}, Values{} {}
+
+        std::once_flag Parsed;
+        std::vector<Assembly_Instruction> Values;
+    };
+
+    //! The parsed contents of each pipeline stage, indexed by the name of the
+    //! stage. A stage is only parsed the first time Get_Instruction() is used
+    //! with it, as most stages never are. These are held by pointer so that
+    //! the stream can still be copied and moved.
+    std::map<std::string, std::shared_ptr<Instructions>> m_instructions;
+
+    //! @brief Checks that p_cycle is within p_stage.
+    //! @param p_cycle The clock cycle.
+    //! @param p_stage The pipeline stage.
+    //! @returns p_cycle.
+    //! @throws std::out_of_range When the stage is not that long.
+    static std::size_t checked_cycle(const std::size_t p_cycle,
+                                     const Stored_Stage& p_stage);
+
+public:
+    Instruction_Stream()
+        : m_stages{}, m_states{}, m_hash{0}, m_instructions{}
+    {
+    }
+
+    //! @brief Adds an entire pipeline stage, replacing any existing stage with
+    //! the same name. Every cycle of the stage starts off Normal.
+    //! @param p_name The name of the pipeline stage e.g. "Fetch".
+    //! @param p_stage The contents of the stage during every clock cycle.
+    void Add_Stage(const std::string& p_name, const Stage& p_stage);
+
+    //! @brief Sets the state of a pipeline stage during consecutive clock
+    //! cycles, e.g. a stall.
+    //! @param p_name The name of the pipeline stage.
+    //! @param p_first The first clock cycle.
+    //! @param p_length The number of clock cycles.
+    //! @param p_state The state of the stage during those cycles.
+    //! @throws std::out_of_range When the stage has not been added or is not
+    //! that long.
+    void Set_State(const std::string& p_name,
+                   const std::size_t p_first,
+                   const std::size_t p_length,
+                   const Pipeline_State p_state)
+    {
+        m_states.at(p_name).Set(p_first, p_length, p_state);
+    }
+
+    //! @brief Checks whether a pipeline stage has been added.
+    //! @param p_name The name of the pipeline stage.
+    //! @returns true if the stage is present, false if not.
+    bool Has_Stage(const std::string& p_name) const
+    {
+        return m_stages.end() != m_stages.find(p_name);
+    }
+
+    //! @brief Checks whether a pipeline stage matches p_stage, without
+    //! creating a new Instruction_Stream.
+    //! @param p_name The name of the pipeline stage.
+    //! @param p_stage The contents to compare against.
+    //! @returns true if the stage is present and identical to p_stage.
+    bool Is_Stage(const std::string& p_name, const Stage& p_stage) const;
+
+    //! @brief Retrieves the contents of a pipeline stage during a clock cycle.
+    //! @param p_cycle The clock cycle.
+    //! @param p_name The name of the pipeline stage.
+    //! @returns The contents of the stage.
+    //! @throws std::out_of_range When the stage is not present or is not that
+    //! long.
+    const std::string& Get_Value(const std::size_t p_cycle,
+                                 const std::string& p_name) const
+    {
+        const Stored_Stage& stage{m_stages.at(p_name)};
+        return stage.Values[(*stage.Cycles)[checked_cycle(p_cycle, stage)]];
+    }
+
+    //! @brief Retrieves the contents of a pipeline stage during a clock cycle
+    //! as an instruction. The whole stage is parsed the first time this is
+    //! used with it, after which this does not allocate. This can be called
+    //! from any thread.
+    //! @param p_cycle The clock cycle.
+    //! @param p_name The name of the pipeline stage.
+    //! @returns The instruction.
+    //! @throws std::out_of_range When the stage is not present or is not that
+    //! long.
+    const Assembly_Instruction&
+    Get_Instruction(const std::size_t p_cycle, const std::string& p_name) const;
+
+    //! @brief Retrieves the state of a pipeline stage during a clock cycle.
+    //! @param p_cycle The clock cycle.
+    //! @param p_name The name of the pipeline stage.
+    //! @returns The state.
+    //! @throws std::out_of_range When the stage is not present or is not that
+    //! long.
+    Pipeline_State Get_State(const std::size_t p_cycle,
+                             const std::string& p_name) const
+    {
+        return m_states.at(p_name).Get(p_cycle);
+    }
+
+    //! @brief Retrieves the state of a pipeline stage during every cycle.
+    //! @param p_name The name of the pipeline stage.
+    //! @returns The states.
+    //! @throws std::out_of_range When the stage is not present.
+    const Pipeline_States& Get_States(const std::string& p_name) const
+    {
+        return m_states.at(p_name);
+    }
+
+    //! @brief Retrieves the hash of the contents of this stream. This is only
+    //! set once the stream has been interned.
+    //! @returns The hash.
+    std::size_t Get_Hash() const { return m_hash; }
+
+    bool operator==(const Instruction_Stream& p_other) const;
+
+    bool operator!=(const Instruction_Stream& p_other) const
+    {
+        return !(*this == p_other);
+    }
+
+    //! @brief Retrieves the shared copy of p_stream. If an identical stream
+    //! has already been interned, and is still in use, then that is returned
+    //! and p_stream is discarded. Streams are matched by their hash and then
+    //! compared in full, so a hash collision can not cause the wrong stream to
+    //! be returned. This can be called from any thread.
+    //! @param p_stream The stream to be shared.
+    //! @returns The shared, immutable copy.
+    static std::shared_ptr<const Instruction_Stream>
+    Intern(Instruction_Stream p_stream);
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // INSTRUCTION_STREAM_HPP
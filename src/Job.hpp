@@ -0,0 +1,66 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Job.hpp
+    @brief Contains the Job struct which describes a single run of GILES
+    within a batch.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef JOB_HPP
+#define JOB_HPP
+
+#include <cstdint>   // for uint8_t, uint32_t, uint64_t
+#include <optional>  // for optional
+#include <string>    // for string
+
+namespace GILES
+{
+namespace Internal
+{
+//! @struct Job
+//! @brief The settings for generating traces from one target program. Many
+//! jobs can be loaded from a job file, using IO::Load_Jobs(), and ran in the
+//! same process so that the Coefficients only need to be loaded once.
+struct Job
+{
+    std::string Program_Path{};
+    std::string Model_Name{"Hamming Weight"};
+    std::uint32_t Number_Of_Runs{1};
+
+    //! Where the traces are saved. If not given, the traces are not saved.
+    std::optional<std::string> Traces_Path{};
+
+    //! The format the traces are saved in. If not given, the format given on
+    //! the command line is used.
+    std::optional<std::string> Output_Format{};
+
+    // These options are related to fault injection.
+    bool Fault{false};
+    std::uint64_t Fault_Cycle{0};
+    std::string Fault_Register{};
+    std::uint8_t Fault_Bit{0};
+
+    std::optional<std::uint64_t> Timeout{};
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // JOB_HPP
@@ -0,0 +1,164 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Journal.cpp
+    @brief Contains the Journal class which records the runs that have been
+    completed so that an interrupted run can be resumed.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cerrno>   // for errno, EINTR
+#include <cstdint>  // for uint64_t
+#include <cstring>  // for memcmp, strerror
+#include <fstream>  // for ifstream
+#include <mutex>    // for lock_guard
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <fcntl.h>   // for open, O_CREAT, O_WRONLY
+#include <unistd.h>  // for close, ftruncate, lseek, write
+
+#include "Journal.hpp"
+
+#include "Error.hpp"  // for Report_Error, Report_Warning
+
+static_assert(sizeof(GILES::Internal::Journal::Header) == 64,
+              "The header must be exactly 64 bytes");
+
+//! @brief Reads the existing journal, if resuming, and opens it ready for
+//! runs to be added.
+GILES::Internal::Journal::Journal(const std::string& p_path,
+                                  const std::size_t p_number_of_runs,
+                                  const bool p_resume)
+    : m_path{p_path}, m_file{-1}, m_completed(p_number_of_runs, 0),
+      m_number_completed{0}, m_mutex{}
+{
+    // The number of bytes of the existing journal that are kept.
+    std::uint64_t size{0};
+
+    std::ifstream existing{m_path, std::ios::binary};
+    if (p_resume && !existing)
+    {
+        Error::Report_Warning(
+            "No journal was found at '{}'. Starting from the first run.",
+            m_path);
+    }
+    else if (p_resume)
+    {
+        const Header expected;
+        Header header;
+        existing.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!existing ||
+            0 != std::memcmp(
+                     header.Magic, expected.Magic, sizeof(header.Magic)) ||
+            header.Version != expected.Version)
+        {
+            Error::Report_Error(
+                "'{}' is not a journal saved by this version of GILES", m_path);
+        }
+        if (header.Number_Of_Runs != p_number_of_runs)
+        {
+            Error::Report_Error("The journal at '{}' is for {} runs but {} "
+                                "were requested. The number of runs must be "
+                                "the same when resuming.",
+                                m_path,
+                                header.Number_Of_Runs,
+                                p_number_of_runs);
+        }
+        size = sizeof(header);
+
+        // A run that was only partly written when GILES stopped is ignored.
+        std::uint64_t run_index;
+        while (existing.read(reinterpret_cast<char*>(&run_index),
+                             sizeof(run_index)))
+        {
+            if (run_index >= p_number_of_runs)
+            {
+                Error::Report_Error("The journal at '{}' is corrupt", m_path);
+            }
+            if (0 == m_completed[run_index])
+            {
+                m_completed[run_index] = 1;
+                ++m_number_completed;
+            }
+            size += sizeof(run_index);
+        }
+    }
+    existing.close();
+
+    m_file = ::open(m_path.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (m_file < 0 || 0 != ::ftruncate(m_file, static_cast<off_t>(size)) ||
+        ::lseek(m_file, 0, SEEK_END) < 0)
+    {
+        Error::Report_Error("Could not open '{}' for writing. {}",
+                            m_path,
+                            std::strerror(errno));
+    }
+
+    if (0 == size)
+    {
+        Header header;
+        header.Number_Of_Runs = p_number_of_runs;
+        write(&header, sizeof(header));
+    }
+}
+
+GILES::Internal::Journal::~Journal()
+{
+    if (m_file >= 0)
+    {
+        ::close(m_file);
+    }
+}
+
+//! @brief Writes to the end of the journal. This is not buffered so that
+//! everything written is kept if GILES stops.
+//! @param p_data The bytes to write.
+//! @param p_size The number of bytes to write.
+void GILES::Internal::Journal::write(const void* const p_data,
+                                     const std::size_t p_size) const
+{
+    const auto* data = static_cast<const char*>(p_data);
+    std::size_t written{0};
+    while (written < p_size)
+    {
+        const auto result = ::write(m_file, data + written, p_size - written);
+        if (result < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if (result < 0)
+        {
+            Error::Report_Error(
+                "Could not write '{}'. {}", m_path, std::strerror(errno));
+        }
+        written += static_cast<std::size_t>(result);
+    }
+}
+
+void GILES::Internal::Journal::Add(
+    const std::vector<std::size_t>& p_run_indices)
+{
+    const std::vector<std::uint64_t> run_indices(p_run_indices.begin(),
+                                                 p_run_indices.end());
+
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    write(run_indices.data(), run_indices.size() * sizeof(std::uint64_t));
+}
@@ -0,0 +1,124 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Journal.hpp
+    @brief Contains the Journal class which records the runs that have been
+    completed so that an interrupted run can be resumed.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t
+#include <mutex>    // for mutex
+#include <string>   // for string
+#include <vector>   // for vector
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Journal
+//! @brief Records the index of every run whose trace has been saved, so that
+//! if GILES is stopped the remaining runs can be completed later. Runs must
+//! only be added once every Output has saved their traces.
+//!
+//! All values are stored little-endian. The journal is laid out as:
+//! - A Header.
+//! - The index of every completed run as uint64, in the order they were
+//!   added.
+class Journal
+{
+public:
+    //! The start of every journal.
+    struct Header
+    {
+        char Magic[8]{'G', 'I', 'L', 'E', 'S', 'J', 'N', 'L'};
+        std::uint32_t Version{1};
+        std::uint32_t Reserved{0};
+        std::uint64_t Number_Of_Runs{0};
+        std::uint64_t Padding[5]{};
+    };
+
+private:
+    const std::string m_path;
+
+    int m_file;
+
+    //! Whether each run was completed before this journal was opened. char is
+    //! used rather than bool so that this can be read from many threads.
+    std::vector<char> m_completed;
+
+    std::size_t m_number_completed;
+
+    //! Ensures that runs added by different threads are not interleaved.
+    std::mutex m_mutex;
+
+    void write(const void* const p_data, const std::size_t p_size) const;
+
+public:
+    //! @brief Opens the journal at p_path.
+    //! @param p_path The path to the journal.
+    //! @param p_number_of_runs The total number of runs.
+    //! @param p_resume Whether to continue from an existing journal, rather
+    //! than starting a new one. If the journal does not exist then a new one
+    //! is started.
+    Journal(const std::string& p_path,
+            const std::size_t p_number_of_runs,
+            const bool p_resume);
+
+    //! @brief Closes the journal.
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    //! @brief Whether a run was completed before this journal was opened.
+    //! This can be called from any thread.
+    //! @param p_run_index The index of the run.
+    //! @returns true if the run has been completed, false if not.
+    bool Is_Complete(const std::size_t p_run_index) const
+    {
+        return 0 != m_completed.at(p_run_index);
+    }
+
+    //! @brief Retrieves the number of runs completed before this journal was
+    //! opened.
+    //! @returns The number of runs.
+    std::size_t Number_Completed() const { return m_number_completed; }
+
+    //! @brief Records runs as completed. This can be called from any thread.
+    //! @param p_run_indices The indices of the runs.
+    void Add(const std::vector<std::size_t>& p_run_indices);
+
+    //! @brief Retrieves the path of the journal kept alongside a traces file.
+    //! @param p_traces_path The path to the traces file.
+    //! @returns The path to the journal.
+    static const std::string Journal_Path(const std::string& p_traces_path)
+    {
+        return p_traces_path + ".journal";
+    }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // JOURNAL_HPP
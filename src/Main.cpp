@@ -24,20 +24,30 @@
     @copyright GNU Affero General Public License Version 3+
 */
 
-#include <algorithm>  // for move
-#include <cstdlib>    // for exit, EXIT_SUCCESS
+#include <algorithm>  // for move, stable_sort
+#include <atomic>     // for atomic
+#include <cctype>     // for isdigit
+#include <csignal>    // for signal, SIGINT, SIGTERM, SIG_DFL
+#include <cstdint>    // for uint64_t
+#include <cstdlib>    // for exit, EXIT_SUCCESS, EXIT_FAILURE
 #include <memory>     // for __shared_ptr_access
 #include <optional>   // for optional
 #include <stdexcept>  // for invalid_argument
 #include <string>     // for string, operator<<
+#include <utility>    // for pair
 #include <vector>     // for vector
 
 #include <boost/program_options.hpp>  // for options_description, value...
 #include <fmt/format.h>               // for format
 #include <fmt/ostream.h>              // for operator<<
 
-#include "Error.hpp"  // for Report_Exit
-#include "GILES.cpp"  // for GILES
+#include "Chunked_Buffer.hpp"     // for Chunked_Buffer
+#include "Error.hpp"              // for Report_Exit
+#include "GILES.cpp"              // for GILES, Job_Pool
+#include "IO.hpp"                 // for IO
+#include "Input_Generator.hpp"    // for Input_Generator
+#include "Job.hpp"                // for Job
+#include "Memory_Budget.hpp"      // for Memory_Budget
 
 //! Anonymous namespace is used as this functionality is only required when
 //! building not as a library.
@@ -49,15 +59,46 @@ std::string m_coefficients_path;
 std::string m_model_name;
 std::string m_simulator_name;
 std::optional<std::string> m_traces_path;
+std::string m_output_format;
+std::size_t m_traces_per_tile;
+std::size_t m_samples_per_chunk;
+std::size_t m_write_budget;
+std::size_t m_execution_memory;
+std::size_t m_max_memory;
+std::size_t m_number_of_threads;
+std::size_t m_batch_size;
+bool m_tune{false};
+bool m_index{false};
+bool m_preview{false};
+bool m_resume{false};
+std::optional<std::string> m_jobs_path;
+std::size_t m_concurrent_jobs;
 std::uint32_t m_number_of_runs;
 
 // These options are related to fault injection.
 bool m_fault{false};
-std::uint32_t m_fault_cycle;
+std::uint64_t m_fault_cycle;
 std::string m_fault_register;
 std::uint8_t m_fault_bit;
 
-std::optional<std::uint32_t> m_timeout;
+std::optional<std::uint64_t> m_timeout;
+
+// These options are related to placing inputs in the memory of the target.
+std::vector<GILES::Internal::Input_Generator::Input> m_inputs;
+std::uint64_t m_seed;
+std::vector<GILES::Internal::Input_Generator::Input> m_target_outputs;
+
+// These options are related to building templates.
+std::optional<std::string> m_templates_path;
+std::vector<std::size_t> m_points_of_interest;
+std::vector<std::size_t> m_label;
+
+// The GILES instance that is stopped when SIGINT or SIGTERM is received.
+std::atomic<GILES::GILES*> m_giles{nullptr};
+
+// The jobs in the job file, every one of which is stopped when SIGINT or
+// SIGTERM is received. Those that have not started are then skipped.
+std::atomic<const std::vector<std::shared_ptr<GILES::GILES>>*> m_jobs{nullptr};
 
 //! @brief Prints an error message and exits. This is to be called when the
 //! program cannot run given the supplied command line arguments.
@@ -72,6 +113,162 @@ template <typename... args_t>
         "\nPlease use option --help or -h to see proper usage");
 }
 
+//! @brief Converts a string of hexadecimal digits into the bytes they
+//! represent.
+//! @param p_hex The hexadecimal digits. e.g. "00ff10".
+//! @returns The bytes.
+std::string from_hex(const std::string& p_hex)
+{
+    if (0 != p_hex.size() % 2 ||
+        std::string::npos != p_hex.find_first_not_of("0123456789abcdefABCDEF"))
+    {
+        bad_options("Fixed inputs must be given as pairs of hexadecimal "
+                    "digits. e.g. "
+                    "\"--target-input 0x20000000:3:fixed=00ff10\"");
+    }
+
+    std::string bytes;
+    for (std::size_t i{0}; i < p_hex.size(); i += 2)
+    {
+        bytes.push_back(
+            static_cast<char>(std::stoul(p_hex.substr(i, 2), nullptr, 16)));
+    }
+    return bytes;
+}
+
+//! @brief Interprets a variable in the memory of the target given as
+//! ADDRESS:SIZE or NAME[:SIZE].
+//! @param p_buffer The variable as given on the command line.
+//! @returns The variable, as a random input. If a name is given without a
+//! size then its size is 0.
+GILES::Internal::Input_Generator::Input
+parse_buffer(const std::string& p_buffer)
+{
+    GILES::Internal::Input_Generator::Input buffer{};
+    try
+    {
+        const auto size_start = p_buffer.find(':');
+        const std::string location{p_buffer.substr(0, size_start)};
+        if (location.empty())
+        {
+            throw std::invalid_argument{p_buffer};
+        }
+
+        if (std::isdigit(static_cast<unsigned char>(location[0])))
+        {
+            buffer.Address =
+                static_cast<std::uint32_t>(std::stoul(location, nullptr, 0));
+        }
+        else
+        {
+            buffer.Symbol = location;
+        }
+
+        if (std::string::npos != size_start)
+        {
+            buffer.Size =
+                std::stoul(p_buffer.substr(size_start + 1), nullptr, 0);
+        }
+        if (buffer.Symbol.empty() && 0 == buffer.Size)
+        {
+            throw std::invalid_argument{p_buffer};
+        }
+    }
+    catch (const std::exception&)
+    {
+        bad_options("\"{}\" could not be interpreted. Expected ADDRESS:SIZE "
+                    "or NAME[:SIZE]",
+                    p_buffer);
+    }
+    return buffer;
+}
+
+//! @brief Interprets an amount of memory given as a number followed by K, M,
+//! G or T. A number without a suffix is a number of megabytes.
+//! @param p_size The amount of memory as given on the command line. e.g. "8G"
+//! @returns The number of bytes.
+std::size_t parse_memory_size(const std::string& p_size)
+{
+    std::size_t bytes{0};
+    try
+    {
+        std::size_t end{0};
+        bytes = std::stoull(p_size, &end);
+
+        const std::string suffix{p_size.substr(end)};
+        if (suffix.empty() || "M" == suffix || "m" == suffix)
+        {
+            bytes *= std::size_t{1} << 20;
+        }
+        else if ("K" == suffix || "k" == suffix)
+        {
+            bytes *= std::size_t{1} << 10;
+        }
+        else if ("G" == suffix || "g" == suffix)
+        {
+            bytes *= std::size_t{1} << 30;
+        }
+        else if ("T" == suffix || "t" == suffix)
+        {
+            bytes *= std::size_t{1} << 40;
+        }
+        else
+        {
+            throw std::invalid_argument{p_size};
+        }
+    }
+    catch (const std::exception&)
+    {
+        bad_options("\"{}\" could not be interpreted as an amount of memory. "
+                    "e.g. \"8G\" or \"512M\"",
+                    p_size);
+    }
+    return bytes;
+}
+
+//! @brief Interprets an input given as a variable, see parse_buffer(),
+//! optionally followed by :fixed=HEX or :interleaved=HEX.
+//! @param p_input The input as given on the command line.
+//! @returns The input.
+GILES::Internal::Input_Generator::Input parse_input(const std::string& p_input)
+{
+    using GILES::Internal::Input_Generator;
+
+    const auto kind_start = p_input.rfind(':');
+    const auto value_start =
+        std::string::npos == kind_start ? kind_start
+                                        : p_input.find('=', kind_start);
+    if (std::string::npos == value_start)
+    {
+        return parse_buffer(p_input);
+    }
+
+    auto input = parse_buffer(p_input.substr(0, kind_start));
+    const std::string kind{
+        p_input.substr(kind_start + 1, value_start - kind_start - 1)};
+    if ("fixed" == kind)
+    {
+        input.Type = Input_Generator::Kind::Fixed;
+    }
+    else if ("interleaved" == kind)
+    {
+        input.Type = Input_Generator::Kind::Interleaved;
+    }
+    else
+    {
+        bad_options("\"{}\" is not a kind of input. Expected \"fixed\" or "
+                    "\"interleaved\"",
+                    kind);
+    }
+
+    input.Fixed_Value = from_hex(p_input.substr(value_start + 1));
+    if (0 == input.Size)
+    {
+        input.Size = input.Fixed_Value.size();
+    }
+    return input;
+}
+
 //! @brief Interprets the command line flags.
 //! @param p_options The options as contained within a string.
 // TODO: Returns tag?
@@ -83,6 +280,8 @@ void parse_command_line_flags(int argc, char* argv[])
         argv[0])};
 
     std::vector<std::string> fault_options{};
+    std::vector<std::string> input_options{};
+    std::vector<std::string> target_output_options{};
 
     // clang-format off
 
@@ -102,6 +301,60 @@ void parse_command_line_flags(int argc, char* argv[])
         ("output,o",
             boost::program_options::value<std::string>(),
             "Generated traces output file")
+        ("format",
+            boost::program_options::value<std::string>()->default_value(
+            "TRS"),
+            "The format that generated traces are saved in")
+        ("traces-per-tile",
+            boost::program_options::value<std::size_t>()->default_value(1024),
+            "The number of traces written together when using the "
+            "\"Sample Major\" or \"Chunked\" formats")
+        ("samples-per-chunk",
+            boost::program_options::value<std::size_t>()->default_value(1024),
+            "The number of samples in each chunk when using the \"Chunked\" "
+            "format")
+        ("write-budget",
+            boost::program_options::value<std::size_t>()->default_value(64),
+            "The number of megabytes of traces that can wait to be written "
+            "before trace generation waits for the disk")
+        ("execution-memory",
+            boost::program_options::value<std::size_t>()->default_value(0),
+            "The number of megabytes of registers and pipeline stages that "
+            "recorded executions can hold in memory before the rest are kept "
+            "in a temporary file. 0 is no limit")
+        ("max-memory",
+            boost::program_options::value<std::string>()->default_value("0"),
+            "The memory, e.g. 8G or 512M, that executions, traces and data "
+            "waiting to be written can use before no more runs are started "
+            "until some is freed. 0 is no limit")
+        ("threads",
+            boost::program_options::value<std::size_t>()->default_value(0),
+            "The number of threads used to generate traces. 0 uses every "
+            "available thread")
+        ("batch-size",
+            boost::program_options::value<std::size_t>()->default_value(1),
+            "The number of runs each thread takes at a time")
+        ("tune",
+            "Choose the number of threads and batch size by briefly measuring "
+            "how quickly traces are generated with each, before generating "
+            "traces. --threads limits the number of threads tried")
+        ("index",
+            "Save an index alongside the generated traces, allowing individual "
+            "traces to be retrieved quickly using GILES-query")
+        ("preview",
+            "Save a small preview of the minimum, maximum and mean of every "
+            "sample alongside the generated traces")
+        ("resume",
+            "Continue a run that was interrupted, only generating the traces "
+            "that were not saved")
+        ("jobs",
+            boost::program_options::value<std::string>(),
+            "Run every job listed in this JSON file, instead of a single "
+            "executable, sharing the coefficients and worker threads")
+        ("concurrent-jobs",
+            boost::program_options::value<std::size_t>()->default_value(2),
+            "The number of jobs from the job file that run at once. The "
+            "threads available are shared equally between them")
         ("simulator,s",
             boost::program_options::value<std::string>()->default_value(
             "Thumb Sim"),
@@ -120,8 +373,44 @@ void parse_command_line_flags(int argc, char* argv[])
             "before the 10th clock cycle, by flipping the second least "
             "significant bit in the register R0")
         ("timeout,t",
-            boost::program_options::value<std::uint32_t>(),
-            "The number of clock cycles to force stop execution after");
+            boost::program_options::value<std::uint64_t>(),
+            "The number of clock cycles to force stop execution after")
+        ("target-input",
+            boost::program_options::value<std::vector<std::string>>(
+            &input_options)
+            ->multitoken(),
+            "Place an input in the memory of the target before each run and "
+            "add it to the extra data. e.g. \"--target-input 0x20000000:16\" "
+            "is 16 random bytes at 0x20000000 and \"--target-input key\" is "
+            "the variable named key. Append \":fixed=HEX\" to use the same "
+            "value in every run or \":interleaved=HEX\" to use it in every "
+            "other run")
+        ("seed",
+            boost::program_options::value<std::uint64_t>()->default_value(0),
+            "The seed used to generate random inputs")
+        ("target-output",
+            boost::program_options::value<std::vector<std::string>>(
+            &target_output_options)
+            ->multitoken(),
+            "Read a variable from the memory of the target after each run and "
+            "add it to the extra data, after any inputs. e.g. "
+            "\"--target-output ciphertext\"")
+        ("templates",
+            boost::program_options::value<std::string>(),
+            "Build templates (the mean trace of each class and a pooled "
+            "covariance matrix) and save them to this file")
+        ("poi",
+            boost::program_options::value<std::vector<std::size_t>>(
+            &m_points_of_interest)
+            ->multitoken(),
+            "The samples used when building templates. e.g. \"--poi 3 7 12\". "
+            "If not given, every sample is used")
+        ("label",
+            boost::program_options::value<std::vector<std::size_t>>(&m_label)
+            ->multitoken(),
+            "Where the class label used when building templates is within the "
+            "extra data. e.g. \"--label 4 2\" is the 2 bytes starting at the "
+            "fifth byte. If not given, the first byte is used");
     // clang-format on
 
     boost::program_options::positional_options_description
@@ -157,7 +446,34 @@ void parse_command_line_flags(int argc, char* argv[])
         m_traces_path = options["output"].as<std::string>();
     }
 
-    if (options.count("input"))  // if input flag is passed
+    if (options.count("jobs"))  // if jobs flag is passed
+    {
+        m_jobs_path       = options["jobs"].as<std::string>();
+        m_concurrent_jobs = options["concurrent-jobs"].as<std::size_t>();
+        if (0 == m_concurrent_jobs)
+        {
+            bad_options("At least one job must be able to run at once");
+        }
+        for (const char* option : {"input",
+                                   "output",
+                                   "index",
+                                   "preview",
+                                   "resume",
+                                   "fault",
+                                   "timeout",
+                                   "target-input",
+                                   "target-output",
+                                   "templates"})
+        {
+            if (options.count(option))
+            {
+                bad_options("The {} option can not be used with a job file. "
+                            "Jobs are described within the file.",
+                            option);
+            }
+        }
+    }
+    else if (options.count("input"))  // if input flag is passed
     {
         m_program_path = options["input"].as<std::string>();
     }
@@ -186,7 +502,7 @@ void parse_command_line_flags(int argc, char* argv[])
                             number_of_fault_options,
                             size);
             }
-            m_fault_cycle    = std::stoi(fault_options[0]);
+            m_fault_cycle    = std::stoull(fault_options[0]);
             m_fault_register = fault_options[1];
             m_fault_bit      = std::stoi(fault_options[2]);
         }
@@ -199,7 +515,73 @@ void parse_command_line_flags(int argc, char* argv[])
 
     if (options.count("timeout"))
     {
-        m_timeout = options["timeout"].as<std::uint32_t>();
+        m_timeout = options["timeout"].as<std::uint64_t>();
+    }
+
+    for (const auto& input : input_options)
+    {
+        m_inputs.push_back(parse_input(input));
+    }
+
+    // default 0 is used if flag is not passed
+    m_seed = options["seed"].as<std::uint64_t>();
+
+    for (const auto& output : target_output_options)
+    {
+        m_target_outputs.push_back(parse_buffer(output));
+    }
+
+    if (options.count("index"))
+    {
+        if (!m_traces_path)
+        {
+            bad_options("The index option requires an output file.(-o / "
+                        "--output \"Path to traces\")");
+        }
+        m_index = true;
+    }
+
+    if (options.count("preview"))
+    {
+        if (!m_traces_path)
+        {
+            bad_options("The preview option requires an output file.(-o / "
+                        "--output \"Path to traces\")");
+        }
+        m_preview = true;
+    }
+
+    if (options.count("resume"))
+    {
+        if (!m_traces_path)
+        {
+            bad_options("The resume option requires an output file.(-o / "
+                        "--output \"Path to traces\")");
+        }
+        m_resume = true;
+    }
+
+    if (options.count("tune"))
+    {
+        m_tune = true;
+    }
+
+    if (options.count("templates"))
+    {
+        m_templates_path = options["templates"].as<std::string>();
+    }
+
+    if (options.count("label"))
+    {
+        constexpr std::uint8_t number_of_label_options{2};
+        if (const std::size_t size{m_label.size()};
+            size != number_of_label_options)
+        {
+            bad_options("Incorrect number of template label options "
+                        "provided.\nExpected: {}\nGot: {}",
+                        number_of_label_options,
+                        size);
+        }
     }
 
     // default "./coeffs.json" is used if flag is not passed
@@ -211,10 +593,154 @@ void parse_command_line_flags(int argc, char* argv[])
     // default "Hamming Weight" is used if flag is not passed
     m_model_name = options["model"].as<std::string>();
 
+    // default "TRS" is used if flag is not passed
+    m_output_format = options["format"].as<std::string>();
+
+    // default 1024 is used if flag is not passed
+    m_traces_per_tile = options["traces-per-tile"].as<std::size_t>();
+
+    // default 1024 is used if flag is not passed
+    m_samples_per_chunk = options["samples-per-chunk"].as<std::size_t>();
+
+    // default 64 is used if flag is not passed
+    m_write_budget = options["write-budget"].as<std::size_t>();
+
+    // default 0 is used if flag is not passed
+    m_execution_memory = options["execution-memory"].as<std::size_t>();
+
+    // default "0" is used if flag is not passed
+    m_max_memory = parse_memory_size(options["max-memory"].as<std::string>());
+
+    // default 0 is used if flag is not passed
+    m_number_of_threads = options["threads"].as<std::size_t>();
+
+    // default 1 is used if flag is not passed
+    m_batch_size = options["batch-size"].as<std::size_t>();
+
     // default 1 is used if flag is not passed
     // TODO: Remove this default?
     m_number_of_runs = options["runs"].as<std::uint32_t>();
 }
+
+//! @brief Stops GILES gracefully when SIGINT or SIGTERM is received, so that
+//! the traces generated so far are saved. A second signal stops GILES
+//! immediately as the default handler is restored.
+//! @param p_signal The signal that was received.
+void handle_stop_signal(const int p_signal)
+{
+    std::signal(p_signal, SIG_DFL);
+    if (auto* const giles = m_giles.load())
+    {
+        giles->Stop();
+    }
+    if (const auto* const jobs = m_jobs.load())
+    {
+        for (const auto& job : *jobs)
+        {
+            job->Stop();
+        }
+    }
+}
+
+//! @brief Runs every job in the job file within this process, so that the
+//! Coefficients are only loaded once. The jobs are ran together on one
+//! Job_Pool, up to m_concurrent_jobs at a time, longest first. As each job is
+//! only started once a worker is free, starting the longest first stops a long
+//! job from being left to run on its own at the end of the batch, so the
+//! whole batch finishes sooner.
+//! @param p_output_options The settings for the Output of every job.
+//! @returns Whether every job succeeded.
+bool run_jobs(const GILES::Internal::Output_Options& p_output_options)
+{
+    const auto coefficients =
+        std::make_shared<const GILES::Internal::Coefficients>(
+            GILES::Internal::IO().Load_Coefficients(m_coefficients_path));
+    const auto jobs = GILES::Internal::IO().Load_Jobs(m_jobs_path.value());
+
+    std::vector<std::shared_ptr<GILES::GILES>> batch;
+    std::vector<std::pair<std::uint64_t, std::size_t>> costs;
+    for (std::size_t i{0}; i < jobs.size(); ++i)
+    {
+        const auto& job = jobs[i];
+        auto giles      = std::make_shared<GILES::GILES>(job.Program_Path,
+                                                    coefficients,
+                                                    job.Traces_Path,
+                                                    job.Number_Of_Runs,
+                                                    job.Model_Name);
+        giles->Set_Output_Format(job.Output_Format.value_or(m_output_format),
+                                 p_output_options);
+        if (job.Fault)
+        {
+            giles->Inject_Fault(
+                job.Fault_Cycle, job.Fault_Register, job.Fault_Bit);
+        }
+        if (job.Timeout)
+        {
+            giles->Set_Timeout(job.Timeout.value());
+        }
+        giles->Set_Batch_Size(m_batch_size);
+        if (m_tune)
+        {
+            giles->Tune();
+        }
+
+        // The run used to estimate the cost is the first run of the job,
+        // which is reused rather than ran again.
+        costs.emplace_back(giles->Estimate_Cycles(), i);
+        batch.push_back(std::move(giles));
+    }
+
+    std::stable_sort(
+        costs.begin(), costs.end(), [](const auto& p_a, const auto& p_b) {
+            return p_a.first > p_b.first;
+        });
+
+    bool succeeded{true};
+    {
+        m_jobs = &batch;
+        GILES::Job_Pool pool{m_concurrent_jobs, m_number_of_threads};
+
+        std::vector<GILES::Job_Pool::Handle> handles;
+        for (const auto& cost : costs)
+        {
+            handles.push_back(pool.Submit(batch[cost.second]));
+        }
+
+        for (std::size_t i{0}; i < handles.size(); ++i)
+        {
+            const auto& job    = jobs[costs[i].second];
+            const auto& result = handles[i].Get();
+            if (result.Error)
+            {
+                fmt::print("\nJob {} of {} ({}) failed: {}\n",
+                           i + 1,
+                           jobs.size(),
+                           job.Program_Path,
+                           result.Error.value());
+                succeeded = false;
+            }
+            else if (result.Cancelled)
+            {
+                fmt::print("\nJob {} of {} ({}) was stopped after {} of {} "
+                           "runs\n",
+                           i + 1,
+                           jobs.size(),
+                           job.Program_Path,
+                           result.Runs_Completed,
+                           job.Number_Of_Runs);
+            }
+            else
+            {
+                fmt::print("\nJob {} of {} ({}) is done\n",
+                           i + 1,
+                           jobs.size(),
+                           job.Program_Path);
+            }
+        }
+    }
+    m_jobs = nullptr;
+    return succeeded;
+}
 }  // namespace
 
 //! @brief The entry point of the program.
@@ -222,12 +748,32 @@ int main(int argc, char* argv[])
 {
     parse_command_line_flags(argc, argv);
 
+    GILES::Internal::Output_Options output_options;
+    output_options.Traces_Per_Tile   = m_traces_per_tile;
+    output_options.Samples_Per_Chunk = m_samples_per_chunk;
+    output_options.Write_Budget      = m_write_budget * 1024 * 1024;
+
+    GILES::Internal::Chunked_Buffer::Set_Memory_Limit(m_execution_memory *
+                                                      1024 * 1024);
+    GILES::Internal::Memory_Budget::Set_Limit(m_max_memory);
+
+    std::signal(SIGINT, handle_stop_signal);
+    std::signal(SIGTERM, handle_stop_signal);
+
+    // If a job file is provided then run every job instead.
+    if (m_jobs_path)
+    {
+        return run_jobs(output_options) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     GILES::GILES giles = GILES::GILES(m_program_path,
                                       m_coefficients_path,
                                       m_traces_path,
                                       m_number_of_runs,
                                       m_model_name);
 
+    giles.Set_Output_Format(m_output_format, output_options);
+
     // If fault inject options are provided then send them to GILES,
     if (m_fault)
     {
@@ -240,6 +786,77 @@ int main(int argc, char* argv[])
         giles.Set_Timeout(m_timeout.value());
     }
 
+    // If the threads option is provided then only use that many threads.
+    if (0 != m_number_of_threads)
+    {
+        giles.Set_Number_Of_Threads(m_number_of_threads);
+    }
+
+    giles.Set_Batch_Size(m_batch_size);
+
+    // If the tune option is provided then choose the number of threads and
+    // the batch size before generating traces.
+    if (m_tune)
+    {
+        giles.Tune();
+    }
+
+    // If any inputs are provided then generate them rather than the target.
+    if (!m_inputs.empty())
+    {
+        giles.Set_Inputs(m_inputs, m_seed);
+    }
+
+    // If any target outputs are provided then read them after each run.
+    for (const auto& output : m_target_outputs)
+    {
+        if (output.Symbol.empty())
+        {
+            giles.Add_Target_Output(output.Address, output.Size);
+        }
+        else
+        {
+            giles.Add_Target_Output(output.Symbol, output.Size);
+        }
+    }
+
+    // If the resume option is provided then continue the interrupted run.
+    if (m_resume)
+    {
+        giles.Resume();
+    }
+
+    // If the index option is provided then index the saved traces as well.
+    // Additional outputs are finished after the traces have been saved, which
+    // the index relies on.
+    if (m_index)
+    {
+        GILES::Internal::Output_Options options{m_traces_path.value()};
+        options.Format       = m_output_format;
+        options.Write_Budget = output_options.Write_Budget;
+        giles.Add_Output("Index", options);
+    }
+
+    // If the preview option is provided then preview the traces as well.
+    if (m_preview)
+    {
+        giles.Add_Output("Preview", {m_traces_path.value()});
+    }
+
+    // If the templates option is provided then build templates as well.
+    if (m_templates_path)
+    {
+        GILES::Internal::Output_Options options{m_templates_path.value(),
+                                                m_points_of_interest};
+        if (!m_label.empty())
+        {
+            options.Label_Offset = m_label[0];
+            options.Label_Length = m_label[1];
+        }
+        giles.Add_Output("Templates", options);
+    }
+
+    m_giles = &giles;
     giles.Run();
     return 0;
 }
@@ -0,0 +1,122 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Memory_Budget.cpp
+    @brief Contains the Memory_Budget class which accounts for the memory held
+    while generating traces and makes threads wait while too much is in use.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <atomic>              // for atomic
+#include <chrono>              // for milliseconds
+#include <condition_variable>  // for condition_variable
+#include <functional>          // for function
+#include <mutex>               // for mutex, unique_lock
+
+#include "Memory_Budget.hpp"
+
+namespace
+{
+//! The bytes accounted for by Add() and not yet given to Remove().
+std::atomic<std::size_t> memory_used{0};
+
+//! The part of memory_used given to Add_Queued() and not yet given to
+//! Remove_Queued().
+std::atomic<std::size_t> memory_queued{0};
+
+//! The number of bytes that can be in use, or 0 for no limit.
+std::atomic<std::size_t> memory_limit{0};
+
+//! Guards waiting on memory_freed.
+std::mutex mutex;
+
+//! Signalled whenever memory is freed while there is a limit.
+std::condition_variable memory_freed;
+
+//! How often waiting threads check whether they should give up. Memory freed
+//! just before a thread waits is also noticed by then.
+constexpr std::chrono::milliseconds poll_interval{10};
+}  // namespace
+
+void GILES::Internal::Memory_Budget::Set_Limit(const std::size_t p_bytes)
+{
+    memory_limit = p_bytes;
+    memory_freed.notify_all();
+}
+
+std::size_t GILES::Internal::Memory_Budget::Get_Limit()
+{
+    return memory_limit;
+}
+
+std::size_t GILES::Internal::Memory_Budget::Get_Used() { return memory_used; }
+
+void GILES::Internal::Memory_Budget::Add(const std::size_t p_bytes)
+{
+    memory_used += p_bytes;
+}
+
+void GILES::Internal::Memory_Budget::Remove(const std::size_t p_bytes)
+{
+    memory_used -= p_bytes;
+    if (0 != memory_limit)
+    {
+        memory_freed.notify_all();
+    }
+}
+
+void GILES::Internal::Memory_Budget::Add_Queued(const std::size_t p_bytes)
+{
+    memory_queued += p_bytes;
+    Add(p_bytes);
+}
+
+void GILES::Internal::Memory_Budget::Remove_Queued(const std::size_t p_bytes)
+{
+    memory_queued -= p_bytes;
+    Remove(p_bytes);
+}
+
+std::size_t GILES::Internal::Memory_Budget::Get_Queued()
+{
+    return memory_queued;
+}
+
+//! @brief Waits until the memory in use is within the limit. Memory can only
+//! be freed by work already in progress or by queued data being written, so
+//! the caller must give up waiting once there is neither, otherwise it would
+//! wait forever.
+//! @param p_give_up Called while waiting. Waiting stops as soon as this
+//! returns true, e.g. when no other work is in progress and nothing is
+//! queued, or when trace generation is stopping.
+void GILES::Internal::Memory_Budget::Wait(
+    const std::function<bool()>& p_give_up)
+{
+    const auto within_limit = [] {
+        const std::size_t limit{memory_limit};
+        return 0 == limit || memory_used <= limit;
+    };
+
+    std::unique_lock<std::mutex> lock{mutex};
+    while (!within_limit() && !p_give_up())
+    {
+        memory_freed.wait_for(lock, poll_interval);
+    }
+}
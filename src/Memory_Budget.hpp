@@ -0,0 +1,123 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Memory_Budget.hpp
+    @brief Contains the Memory_Budget class which accounts for the memory held
+    while generating traces and makes threads wait while too much is in use.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef MEMORY_BUDGET_HPP
+#define MEMORY_BUDGET_HPP
+
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Memory_Budget
+//! @brief Accounts for the bytes held in memory by the registers and pipeline
+//! stages of recorded executions, the trace buffers of each thread, kept
+//! traces and data waiting to be written, across every GILES instance in the
+//! process. Memory is always accounted for when it is allocated, so nothing
+//! in progress has to wait. Instead, threads wait in Wait() before starting
+//! new work while more than the limit is in use, until enough has been freed.
+//! @note Every member function may be called from any thread.
+class Memory_Budget
+{
+public:
+    //! @class Held
+    //! @brief Accounts for a buffer that is reused and may grow, such as the
+    //! trace of a thread, for as long as this is alive.
+    class Held
+    {
+    private:
+        std::size_t m_bytes;
+
+    public:
+        Held() : m_bytes{0} {}
+
+        ~Held() { Set(0); }
+
+        Held(const Held&) = delete;
+        Held& operator=(const Held&) = delete;
+
+        //! @brief Changes the number of bytes accounted for.
+        //! @param p_bytes The current size of the buffer in bytes.
+        void Set(const std::size_t p_bytes)
+        {
+            if (p_bytes > m_bytes)
+            {
+                Add(p_bytes - m_bytes);
+            }
+            else if (p_bytes < m_bytes)
+            {
+                Remove(m_bytes - p_bytes);
+            }
+            m_bytes = p_bytes;
+        }
+    };
+
+    //! @brief Sets the number of bytes that can be in use before Wait() has
+    //! to wait.
+    //! @param p_bytes The limit in bytes, or 0 for no limit.
+    static void Set_Limit(const std::size_t p_bytes);
+
+    //! @returns The limit in bytes, or 0 if there is no limit.
+    static std::size_t Get_Limit();
+
+    //! @returns The number of bytes currently accounted for.
+    static std::size_t Get_Used();
+
+    //! @brief Accounts for memory that has been allocated.
+    //! @param p_bytes The number of bytes.
+    static void Add(const std::size_t p_bytes);
+
+    //! @brief Accounts for memory that has been freed, waking any threads
+    //! waiting for it.
+    //! @param p_bytes The number of bytes. This must have been given to
+    //! Add() before.
+    static void Remove(const std::size_t p_bytes);
+
+    //! @brief Accounts for memory holding data that has been queued for a
+    //! background thread, e.g. traces waiting to be written. Queued memory is
+    //! freed without any more work being started, so threads can keep waiting
+    //! for it even when no work is in progress.
+    //! @param p_bytes The number of bytes.
+    static void Add_Queued(const std::size_t p_bytes);
+
+    //! @brief Accounts for queued memory that has been freed, waking any
+    //! threads waiting for it.
+    //! @param p_bytes The number of bytes. This must have been given to
+    //! Add_Queued() before.
+    static void Remove_Queued(const std::size_t p_bytes);
+
+    //! @returns The number of bytes accounted for by Add_Queued() that have
+    //! not yet been freed. These are included in Get_Used().
+    static std::size_t Get_Queued();
+
+    static void Wait(const std::function<bool()>& p_give_up);
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // MEMORY_BUDGET_HPP
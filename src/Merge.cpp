@@ -0,0 +1,149 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Merge.cpp
+    @brief This file contains a command line executable that merges the shards
+    saved by the "Sharded" format into a single file, in run order.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdlib>  // for exit, EXIT_SUCCESS
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <boost/program_options.hpp>  // for options_description, value...
+#include <fmt/format.h>               // for format, print
+#include <fmt/ostream.h>              // for operator<<
+
+#include "Error.hpp"                  // for Report_Exit
+#include "Sharded/Shard_Merger.hpp"  // for Shard_Merger
+
+//! Anonymous namespace is used as this functionality is only required when
+//! building not as a library.
+namespace
+{
+std::vector<std::string> m_shard_paths;
+std::string m_output_path;
+std::string m_output_format;
+
+//! @brief Prints an error message and exits. This is to be called when the
+//! program cannot run given the supplied command line arguments.
+//! @note This function is marked as noreturn as it is guaranteed to always
+//! halt the program. (Through std::exit())
+//! @param p_message An error message can optionally be provided. This will
+//! be printed first on a separate line if provided.
+template <typename... args_t>
+[[noreturn]] void bad_options(const args_t&... p_message) {
+    fmt::print(p_message...);
+    GILES::Internal::Error::Report_Exit(
+        "\nPlease use option --help or -h to see proper usage");
+}
+
+//! @brief Interprets the command line flags.
+void parse_command_line_flags(int argc, char* argv[])
+{
+    boost::program_options::options_description options_description{fmt::format(
+        "Merges the shards saved by the \"Sharded\" format of GILES\n"
+        "Usage: {} --output OUTPUT SHARD...\n",
+        argv[0])};
+
+    // clang-format off
+
+    // Adds the command line options.
+    options_description.add_options()
+        ("help,h", "Print help")
+        ("output,o",
+            boost::program_options::value<std::string>(),
+            "The file to save the merged traces to")
+        ("format",
+            boost::program_options::value<std::string>()->default_value(
+            "NumPy"),
+            "The format that the merged traces are saved in")
+        ("shards",
+            boost::program_options::value<std::vector<std::string>>(),
+            "The shards to merge");
+
+    // clang-format on
+
+    boost::program_options::positional_options_description
+        positional_options_description;
+    positional_options_description.add("shards", -1);
+
+    boost::program_options::variables_map options;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::command_line_parser(argc, argv)
+                .options(options_description)
+                .positional(positional_options_description)
+                .run(),
+            options);
+        boost::program_options::notify(options);
+    }
+    catch (const std::exception& exception)
+    {
+        bad_options(exception.what());
+    }
+
+    if (options.count("help"))  // if help flag is passed
+    {
+        fmt::print("{}\n", options_description);
+        std::exit(EXIT_SUCCESS);
+    }
+
+    if (options.count("output"))
+    {
+        m_output_path = options["output"].as<std::string>();
+    }
+    else
+    {
+        bad_options("Output option is required.(-o / --output \"Path to "
+                    "merged traces\")");
+    }
+
+    if (options.count("shards"))
+    {
+        m_shard_paths = options["shards"].as<std::vector<std::string>>();
+    }
+    else
+    {
+        bad_options("At least one shard is required.");
+    }
+
+    // default "NumPy" is used if flag is not passed
+    m_output_format = options["format"].as<std::string>();
+}
+}  // namespace
+
+//! @brief The entry point of the program.
+int main(int argc, char* argv[])
+{
+    parse_command_line_flags(argc, argv);
+
+    GILES::Internal::Shard_Merger merger{
+        m_shard_paths, m_output_path, m_output_format};
+    merger.Merge();
+
+    fmt::print("Merged {} traces from {} shards into '{}'\n",
+               merger.Number_Of_Traces(),
+               merger.Number_Of_Shards(),
+               m_output_path);
+    return 0;
+}
@@ -25,8 +25,8 @@
     @copyright GNU Affero General Public License Version 3+
 */
 
-#include <cstddef>  // for uint8_t, size_t
-#include <vector>   // for vector
+#include <algorithm>  // for fill
+#include <cstddef>    // for uint8_t, size_t
 
 #include "Model_Hamming_Weight.hpp"
 
@@ -40,30 +40,25 @@ const std::unordered_set<std::string>
 
 //! @brief This function contains the mathematical calculations that generate
 //! the Traces.
-//! @returns The generated Traces for the target program.
-const std::vector<float>
-GILES::Internal::Model_Hamming_Weight::Generate_Traces()
+//! @param p_trace Where to write the Traces. This must have room for one
+//! sample per clock cycle.
+void GILES::Internal::Model_Hamming_Weight::Generate_Traces(
+    float* const p_trace)
 {
-    std::vector<float> traces;
-
+    // In the case of stalls and flushes just assume these use no power for
+    // now. The memory may hold the trace of a previous run so it is cleared.
     const std::size_t number_of_cycles{m_execution.Get_Cycle_Count()};
-    for (std::size_t i{0}; i < number_of_cycles; ++i)
-    {
-        // Prevents trying to calculate the hamming weight of stalls and
-        // flushes.
-        if (!m_execution.Is_Normal_State(i, "Execute"))
-        {
-            // In the case of stalls and flushes just assume these use no power
-            // for now.
-            traces.push_back(0);
-            continue;
-        }
+    std::fill(p_trace, p_trace + number_of_cycles, 0.0f);
 
+    // Prevents trying to calculate the hamming weight of stalls and flushes by
+    // skipping straight over them.
+    for (std::size_t i{m_execution.Next_Normal_Cycle(0, "Execute")};
+         i < number_of_cycles;
+         i = m_execution.Next_Normal_Cycle(i + 1, "Execute"))
+    {
         // Calculates the Hamming weight of the first operand of the instruction
-        // at clock cycle 'i' and appends it to the traces object.
-        traces.push_back(
-            Model_Math::Hamming_Weight(m_execution.Get_Operand_Value(
-                i, m_execution.Get_Instruction(i, "Execute"), 1)));
+        // at clock cycle 'i' and stores it in the traces object.
+        p_trace[i] = Model_Math::Hamming_Weight(m_execution.Get_Operand_Value(
+            i, m_execution.Get_Instruction(i, "Execute"), 1));
     }
-    return traces;
 }
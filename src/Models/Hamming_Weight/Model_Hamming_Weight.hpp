@@ -68,7 +68,15 @@ public:
     {
     }
 
-    const std::vector<float> Generate_Traces() override;
+    using Model::Generate_Traces;
+
+    //! @returns One sample for every clock cycle.
+    std::size_t Get_Trace_Length() const override
+    {
+        return m_execution.Get_Cycle_Count();
+    }
+
+    void Generate_Traces(float* const p_trace) override;
 
     //! @brief Retrieves a list of the interaction terms that are used within
     //! the model. These must be provided by the Coefficients in order for
@@ -28,6 +28,7 @@
 #define MODEL_HPP
 
 #include <algorithm>      // for all_of
+#include <cstddef>        // for size_t
 #include <string>         // for string
 #include <unordered_set>  // for unordered_set
 #include <vector>         // for vector
@@ -64,10 +65,28 @@ protected:
     }
 
 public:
+    //! @brief In derived classes, this function should return the number of
+    //! samples that Generate_Traces() will produce. This is known before the
+    //! Traces are generated so that the caller can provide the memory for
+    //! them, e.g. a buffer that is reused for every run.
+    //! @returns The number of samples.
+    virtual std::size_t Get_Trace_Length() const = 0;
+
     //! @brief In derived classes, this function should contain the
-    //! mathematical calculations that generate the Traces.
+    //! mathematical calculations that generate the Traces, writing every
+    //! sample in place rather than allocating.
+    //! @param p_trace Where to write the Traces. This must have room for
+    //! Get_Trace_Length() samples.
+    virtual void Generate_Traces(float* const p_trace) = 0;
+
+    //! @brief Generates the Traces into a vector of their own.
     //! @returns The generated Traces for the target program.
-    virtual const std::vector<float> Generate_Traces() = 0;
+    const std::vector<float> Generate_Traces()
+    {
+        std::vector<float> traces(Get_Trace_Length());
+        Generate_Traces(traces.data());
+        return traces;
+    }
 
     //! @brief Virtual destructor to ensure proper memory cleanup.
     //! @see https://stackoverflow.com/a/461224
@@ -26,207 +26,222 @@
 #include "Model_Power.hpp"
 
 #include <cstdint>  // for size_t
-#include <deque>    // for deque
-#include <utility>  // for pair, make_pair
 #include <vector>   // for vector
 
+namespace GILES
+{
+namespace Internal
+{
+const std::string Model_Power::Terms::Bit_Flip1{"Bit_Flip1"};
+const std::string Model_Power::Terms::Bit_Flip1_Bit_Interactions{
+    "Bit_Flip1_Bit_Interactions"};
+const std::string Model_Power::Terms::Bit_Flip2{"Bit_Flip2"};
+const std::string Model_Power::Terms::Bit_Flip2_Bit_Interactions{
+    "Bit_Flip2_Bit_Interactions"};
+// TODO: Shorten strings as much as possible.
+const std::string
+    Model_Power::Terms::Hamming_Distance_Operand1_Previous_Instruction{
+        "Hamming_Distance_Operand1_Previous_Instruction"};
+const std::string
+    Model_Power::Terms::Hamming_Distance_Operand1_Subsequent_Instruction{
+        "Hamming_Distance_Operand1_Subsequent_Instruction"};
+const std::string
+    Model_Power::Terms::Hamming_Distance_Operand2_Previous_Instruction{
+        "Hamming_Distance_Operand2_Previous_Instruction"};
+const std::string
+    Model_Power::Terms::Hamming_Distance_Operand2_Subsequent_Instruction{
+        "Hamming_Distance_Operand2_Subsequent_Instruction"};
+const std::string
+    Model_Power::Terms::Hamming_Weight_Operand1_Previous_Instruction{
+        "Hamming_Weight_Operand1_Previous_Instruction"};
+const std::string
+    Model_Power::Terms::Hamming_Weight_Operand1_Subsequent_Instruction{
+        "Hamming_Weight_Operand1_Subsequent_Instruction"};
+const std::string
+    Model_Power::Terms::Hamming_Weight_Operand2_Previous_Instruction{
+        "Hamming_Weight_Operand2_Previous_Instruction"};
+const std::string
+    Model_Power::Terms::Hamming_Weight_Operand2_Subsequent_Instruction{
+        "Hamming_Weight_Operand2_Subsequent_Instruction"};
+const std::string Model_Power::Terms::Operand1{"Operand1"};
+const std::string Model_Power::Terms::Operand1_Bit_Interactions{
+    "Operand1_Bit_Interactions"};
+const std::string Model_Power::Terms::Operand2{"Operand2"};
+const std::string Model_Power::Terms::Operand2_Bit_Interactions{
+    "Operand2_Bit_Interactions"};
+const std::string Model_Power::Terms::Previous_Instruction{
+    "Previous_Instruction"};
+const std::string Model_Power::Terms::Subsequent_Instruction{
+    "Subsequent_Instruction"};
+}  // namespace Internal
+}  // namespace GILES
+
 //! The list of interaction terms used by this model in order to generate
 //! traces.
 const std::unordered_set<std::string>
     GILES::Internal::Model_Power::m_required_interaction_terms{
-        "Bit_Flip1",
-        "Bit_Flip1_Bit_Interactions",
-        "Bit_Flip2",
-        "Bit_Flip2_Bit_Interactions",
-        // TODO: Shorten strings as much as possible.
-        "Hamming_Distance_Operand1_Previous_Instruction",
-        "Hamming_Distance_Operand1_Subsequent_Instruction",
-        "Hamming_Distance_Operand2_Previous_Instruction",
-        "Hamming_Distance_Operand2_Subsequent_Instruction",
-        "Hamming_Weight_Operand1_Previous_Instruction",
-        "Hamming_Weight_Operand1_Subsequent_Instruction",
-        "Hamming_Weight_Operand2_Previous_Instruction",
-        "Hamming_Weight_Operand2_Subsequent_Instruction",
-        "Operand1",
-        "Operand1_Bit_Interactions",
-        "Operand2",
-        "Operand2_Bit_Interactions",
-        "Previous_Instruction",
-        "Subsequent_Instruction"};
+        Terms::Bit_Flip1,
+        Terms::Bit_Flip1_Bit_Interactions,
+        Terms::Bit_Flip2,
+        Terms::Bit_Flip2_Bit_Interactions,
+        Terms::Hamming_Distance_Operand1_Previous_Instruction,
+        Terms::Hamming_Distance_Operand1_Subsequent_Instruction,
+        Terms::Hamming_Distance_Operand2_Previous_Instruction,
+        Terms::Hamming_Distance_Operand2_Subsequent_Instruction,
+        Terms::Hamming_Weight_Operand1_Previous_Instruction,
+        Terms::Hamming_Weight_Operand1_Subsequent_Instruction,
+        Terms::Hamming_Weight_Operand2_Previous_Instruction,
+        Terms::Hamming_Weight_Operand2_Subsequent_Instruction,
+        Terms::Operand1,
+        Terms::Operand1_Bit_Interactions,
+        Terms::Operand2,
+        Terms::Operand2_Bit_Interactions,
+        Terms::Previous_Instruction,
+        Terms::Subsequent_Instruction};
 
 //! @brief This function contains the mathematical calculations that generate
 //! the Traces.
-//! @returns The generated Traces for the target program.
-const std::vector<float> GILES::Internal::Model_Power::Generate_Traces()
+//! @param p_trace Where to write the Traces. Sample i - 1 is the cycle i.
+//! @note Nothing here allocates once every instruction has been retrieved from
+//! the Execution once, so after the first trace no allocations are made at
+//! all.
+void GILES::Internal::Model_Power::Generate_Traces(float* const p_trace)
 {
-
-    //! A sliding window that stores information about the previous, current and
-    //! next instructions.
-    //! Populated with the first two instructions, ready to be used as the
-    //! previous and current instruction in calculations.
-    //! This is done in advance as the loop below only adds the next
-    //! instruction.
-    std::deque<GILES::Internal::Model_Power::Assembly_Instruction_Power>
-        instructions_window{
-            {get_instruction_terms(0), get_instruction_terms(1)}};
-
-    const auto previous_instruction = instructions_window.front();
-    const auto current_instruction  = instructions_window[1];
-    const auto next_instruction     = instructions_window.back();
-
-    //! The interactions between the instructions stored in instructions_window.
-    //! This constructs the deque and adds one item to it, the interactions
-    //! between the first and second instructions.
-    std::deque<Instruction_Terms_Interactions> instruction_interactions_window(
-        {{previous_instruction, current_instruction}});
-
-    std::vector<float> traces;
-
-    // Start at 1 as we are taking the previous cycle into account in the
-    // calculations.
-    // Finish at size - 1 As we are taking the next cycle into account in the
-    // calculations.
+    // The first two instructions, ready to be used as the previous and current
+    // instruction in calculations. This is done in advance as the loop below
+    // only retrieves the next instruction.
+    // TODO: The previous instruction is never moved along with the others.
+    // If the constant of the previous instruction was 0 then it was either
+    // unprofiled or an abnormal state. In this case we do not want to use it
+    // in calculations so for the sake of these calculations we will pretend
+    // it didn't occur. This should only be the case for abnormal states.
+    const Assembly_Instruction_Power previous_instruction{
+        get_instruction_terms(0)};
+    Assembly_Instruction_Power current_instruction{get_instruction_terms(1)};
+
+    // Moved along to be the current instruction at the start of each cycle.
+    Assembly_Instruction_Power next_instruction{current_instruction};
+
+    //! The interactions between the first and second instructions. These are
+    //! used during the first cycle.
+    const Instruction_Terms_Interactions first_interactions{
+        previous_instruction, current_instruction};
+
+    //! The interactions used during every cycle after the first. These were
+    //! made from the second instruction before the loop moved it along.
+    // TODO: These should be made from the instructions in each cycle.
+    const Instruction_Terms_Interactions later_interactions{
+        current_instruction, current_instruction};
+
+    float constant{0};
+
+    const std::size_t size{m_execution.Get_Cycle_Count()};
+
+    // Start at 1 and end at size -1 as this takes into account the previous
+    // and next instructions.
+    for (std::size_t i{1}; i + 1 < size; ++i)
     {
-        float constant{0};
-
-        const std::size_t size{m_execution.Get_Cycle_Count()};
-
-        // Start at 1 and end at size -1 as this takes into account the previous
-        // and next instructions.
-        for (std::size_t i{1}; i < size - 1; ++i)
-        {
-            // TODO: Add a special case for when i = 0 and i = last (and i = 1?/
-            // last-1?).
-
-            // Add the next set of operands.
-            instructions_window.emplace_back(get_instruction_terms(i + 1));
-
-            // Add the next set of cross instruction interactions.
-            instruction_interactions_window.emplace_back(current_instruction,
-                                                         next_instruction);
-
-            // if the constant of the previous instruction was 0 then it was
-            // either unprofiled or an abnormal state. In this case we do not
-            // want to use it in calculations so for the sake of these
-            // calculations we will pretend it didn't occur.
-            // TODO: This should only be the case for abnormal states.
-            // Unprofiled instructions should not be captured by this.
-            if (0 != constant)
-            {
-                const auto previous_instruction = instructions_window.front();
-            }
-            const auto current_instruction = instructions_window[1];
-            const auto next_instruction    = instructions_window.back();
-
-            // std::cout << instruction_interactions_window.size() <<
-            // std::endl;
-
-            // TODO: Delete this?
-            // TODO: Can/ Should this be made constexpr?
-            const std::string& current_opcode{current_instruction.Get_Opcode()};
-
-            const std::string& previous_opcode{
-                previous_instruction.Get_Opcode()};
-
-            const std::string& next_opcode{next_instruction.Get_Opcode()};
-
-            // TODO: Bit flip 1 and 2 bit interactions is always 0 in the coeffs
-            // file. Can these be removed? Is this a bug when turning into json?
-            // Operand 1 and 2 bit interactions are only non 0 for muls and
-            // stores
-
-            // TODO: How does this work when the bit flip is based on 2
-            // instructions but the opcode isn't?
-            const auto bit_flip_1 = calculate_term(
-                current_opcode,
-                "Bit_Flip1",  // TODO: This is a typo, why does it not crash???
-                instruction_interactions_window.front().Operand_1_Bit_Flip);
-
-            // TODO: How does this work when the bit flip is based on 2
-            // instructions but the opcode isn't?
-            const auto bit_flip_2 = calculate_term(
-                current_opcode,
-                "Bit_Flip2",
-                instruction_interactions_window.front().Operand_2_Bit_Flip);
-
-            const auto bit_flip_interactions_1 = calculate_term(
-                current_opcode,
-                "Bit_Flip1_Bit_Interactions",
-                std::bitset<32>(instruction_interactions_window.front()
-                                    .Bit_Flip1_Bit_Interactions));
-
-            const auto bit_flip_interactions_2 = calculate_term(
-                current_opcode,
-                "Bit_Flip2_Bit_Interactions",
-                std::bitset<32>(instruction_interactions_window.front()
-                                    .Bit_Flip2_Bit_Interactions));
-
-            const auto operand_1 =
-                calculate_term(current_opcode,
-                               "Operand1",
-                               std::bitset<32>(current_instruction.Operand_1));
-            // TODO: Which version should be used?
-            /*
-             *        const auto operand_1 =
-             *            sum_of_scalar_multiply(current_instruction.Operand_1,
-             *                                   Get_Coefficient(current_opcode,
-             * "Operand1"));
-             */
-
-            const auto operand_2 =
-                calculate_term(current_opcode,
-                               "Operand2",
-                               std::bitset<32>(current_instruction.Operand_2));
-
-            const auto operand_1_bit_interactions = calculate_term(
-                current_opcode,
-                "Operand1_Bit_Interactions",
-                std::bitset<32>(
-                    current_instruction.Operand_1_Bit_Interactions));
-
-            const auto operand_2_bit_interactions = calculate_term(
-                current_opcode,
-                "Operand2_Bit_Interactions",
-                std::bitset<32>(
-                    current_instruction.Operand_2_Bit_Interactions));
-
-            const auto previous_instruction_term = Get_Coefficient(
-                current_opcode, "Previous_Instruction", previous_opcode);
-
-            const auto subsequent_instruction_term = Get_Coefficient(
-                current_opcode, "Subsequent_Instruction", next_opcode);
-
-            const auto hamming_weight_terms = calculate_hamming_weight_terms(
-                current_instruction, previous_opcode, next_opcode);
-
-            const auto hamming_distance_terms =
-                calculate_hamming_distance_terms(current_instruction,
-                                                 previous_instruction,
-                                                 next_instruction);
-
-            constant = Get_Constant(current_opcode);
-
-            // clang-format off
-            traces.emplace_back(constant * (
-                                previous_instruction_term +
-                                subsequent_instruction_term +
-                                operand_1 +
-                                operand_2 +
-                                operand_1_bit_interactions +
-                                operand_2_bit_interactions +
-                                bit_flip_1 +
-                                bit_flip_2 +
-                                bit_flip_interactions_1 +
-                                bit_flip_interactions_2 +
-                                hamming_weight_terms +
-                                hamming_distance_terms));
-            // clang-format on
-
-            // fmt::print("{}: {}\n", i, traces.back());
-            // Get rid of the now unneeded instruction 2 cycles before.
-            instructions_window.pop_front();
-            instruction_interactions_window.pop_front();
-        }
+        // TODO: Add a special case for when i = 0 and i = last (and i = 1?/
+        // last-1?).
+
+        // Move the window along by one and add the next set of operands. This
+        // holds the instructions in a fixed number of variables, rather than a
+        // container, so that nothing is allocated.
+        current_instruction = next_instruction;
+        next_instruction    = get_instruction_terms(i + 1);
+
+        const Instruction_Terms_Interactions& interactions{
+            1 == i ? first_interactions : later_interactions};
+
+        // TODO: Can/ Should this be made constexpr?
+        const std::string& current_opcode{current_instruction.Get_Opcode()};
+
+        const std::string& previous_opcode{previous_instruction.Get_Opcode()};
+
+        const std::string& next_opcode{next_instruction.Get_Opcode()};
+
+        // TODO: Bit flip 1 and 2 bit interactions is always 0 in the coeffs
+        // file. Can these be removed? Is this a bug when turning into json?
+        // Operand 1 and 2 bit interactions are only non 0 for muls and
+        // stores
+
+        // TODO: How does this work when the bit flip is based on 2
+        // instructions but the opcode isn't?
+        const auto bit_flip_1 = calculate_term(
+            current_opcode, Terms::Bit_Flip1, interactions.Operand_1_Bit_Flip);
+
+        // TODO: How does this work when the bit flip is based on 2
+        // instructions but the opcode isn't?
+        const auto bit_flip_2 = calculate_term(
+            current_opcode, Terms::Bit_Flip2, interactions.Operand_2_Bit_Flip);
+
+        const auto bit_flip_interactions_1 = calculate_term(
+            current_opcode,
+            Terms::Bit_Flip1_Bit_Interactions,
+            std::bitset<32>(interactions.Bit_Flip1_Bit_Interactions));
+
+        const auto bit_flip_interactions_2 = calculate_term(
+            current_opcode,
+            Terms::Bit_Flip2_Bit_Interactions,
+            std::bitset<32>(interactions.Bit_Flip2_Bit_Interactions));
+
+        const auto operand_1 =
+            calculate_term(current_opcode,
+                           Terms::Operand1,
+                           std::bitset<32>(current_instruction.Operand_1));
+        // TODO: Which version should be used?
+        /*
+         *        const auto operand_1 =
+         *            sum_of_scalar_multiply(current_instruction.Operand_1,
+         *                                   Get_Coefficient(current_opcode,
+         * "Operand1"));
+         */
+
+        const auto operand_2 =
+            calculate_term(current_opcode,
+                           Terms::Operand2,
+                           std::bitset<32>(current_instruction.Operand_2));
+
+        const auto operand_1_bit_interactions = calculate_term(
+            current_opcode,
+            Terms::Operand1_Bit_Interactions,
+            std::bitset<32>(current_instruction.Operand_1_Bit_Interactions));
+
+        const auto operand_2_bit_interactions = calculate_term(
+            current_opcode,
+            Terms::Operand2_Bit_Interactions,
+            std::bitset<32>(current_instruction.Operand_2_Bit_Interactions));
+
+        const auto previous_instruction_term = Get_Coefficient(
+            current_opcode, Terms::Previous_Instruction, previous_opcode);
+
+        const auto subsequent_instruction_term = Get_Coefficient(
+            current_opcode, Terms::Subsequent_Instruction, next_opcode);
+
+        const auto hamming_weight_terms = calculate_hamming_weight_terms(
+            current_instruction, previous_opcode, next_opcode);
+
+        const auto hamming_distance_terms = calculate_hamming_distance_terms(
+            current_instruction, previous_instruction, next_instruction);
+
+        constant = Get_Constant(current_opcode);
+
+        // clang-format off
+        p_trace[i - 1] = static_cast<float>(constant * (
+                            previous_instruction_term +
+                            subsequent_instruction_term +
+                            operand_1 +
+                            operand_2 +
+                            operand_1_bit_interactions +
+                            operand_2_bit_interactions +
+                            bit_flip_1 +
+                            bit_flip_2 +
+                            bit_flip_interactions_1 +
+                            bit_flip_interactions_2 +
+                            hamming_weight_terms +
+                            hamming_distance_terms));
+        // clang-format on
+
+        // fmt::print("{}: {}\n", i, p_trace[i - 1]);
     }
-    return traces;
 }
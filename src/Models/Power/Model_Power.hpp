@@ -29,8 +29,8 @@
 
 #include <bitset>       // for bitset
 #include <cstdint>      // for size_t
+#include <functional>   // for reference_wrapper
 #include <string>       // for string
-#include <string_view>  // for string_view
 #include <type_traits>  // for is_same
 #include <utility>      // for pair
 #include <vector>       // for vector
@@ -85,31 +85,40 @@ private:
     // Used to store intermediate terms needed in leakage calculations, that are
     // related to a specific instruction. This exists for the simple reason of
     // saving the time recalculating the data.
-    // TODO: This should inherit from Assembly_Instruction
-    struct Assembly_Instruction_Power : Assembly_Instruction,
-                                        Instruction_Terms_Helper
+    // The instruction itself is referred to rather than copied, as the
+    // Execution keeps it, so that these can be made every cycle without
+    // allocating.
+    struct Assembly_Instruction_Power : Instruction_Terms_Helper
     {
         Assembly_Instruction_Power(
             const GILES::Internal::Assembly_Instruction& p_instruction,
             const std::size_t p_operand_1,
             const std::size_t p_operand_2)  // TODO: Encode Operand value into
                                             // Assembly_Instruction
-            : GILES::Internal::Assembly_Instruction(p_instruction),
-              Operand_1(p_operand_1), Operand_2(p_operand_2),
+            : Instruction(p_instruction), Operand_1(p_operand_1),
+              Operand_2(p_operand_2),
               Operand_1_Bit_Interactions(calculate_interactions(p_operand_1)),
               Operand_2_Bit_Interactions(calculate_interactions(p_operand_2))
         {
         }
 
+        const std::string& Get_Opcode() const
+        {
+            return Instruction.get().Get_Opcode();
+        }
+
+        std::reference_wrapper<const GILES::Internal::Assembly_Instruction>
+            Instruction;
+
         // Does this need to be stored? -
         // Saves recalculating it
         //
         // TODO: MOVE OPERANDS UP TO
         // ASSEMBLY_INSTRUCTION!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-        const std::uint32_t Operand_1;
-        const std::uint32_t Operand_2;
-        const std::size_t Operand_1_Bit_Interactions;
-        const std::size_t Operand_2_Bit_Interactions;
+        std::uint32_t Operand_1;
+        std::uint32_t Operand_2;
+        std::size_t Operand_1_Bit_Interactions;
+        std::size_t Operand_2_Bit_Interactions;
     };
 
     //! @todo: document
@@ -156,23 +165,58 @@ private:
         }
     };
 
+    //! The names of the interaction terms within the Coefficients. These are
+    //! only created once, rather than from a literal every cycle, as most are
+    //! too long to be stored without allocating.
+    struct Terms
+    {
+        static const std::string Bit_Flip1;
+        static const std::string Bit_Flip1_Bit_Interactions;
+        static const std::string Bit_Flip2;
+        static const std::string Bit_Flip2_Bit_Interactions;
+        static const std::string Hamming_Distance_Operand1_Previous_Instruction;
+        static const std::string
+            Hamming_Distance_Operand1_Subsequent_Instruction;
+        static const std::string Hamming_Distance_Operand2_Previous_Instruction;
+        static const std::string
+            Hamming_Distance_Operand2_Subsequent_Instruction;
+        static const std::string Hamming_Weight_Operand1_Previous_Instruction;
+        static const std::string Hamming_Weight_Operand1_Subsequent_Instruction;
+        static const std::string Hamming_Weight_Operand2_Previous_Instruction;
+        static const std::string Hamming_Weight_Operand2_Subsequent_Instruction;
+        static const std::string Operand1;
+        static const std::string Operand1_Bit_Interactions;
+        static const std::string Operand2;
+        static const std::string Operand2_Bit_Interactions;
+        static const std::string Previous_Instruction;
+        static const std::string Subsequent_Instruction;
+    };
+
     static const std::unordered_set<std::string> m_required_interaction_terms;
 
     //! @brief A wrapper around the Get_Coefficient function that will return 0
     //! if an instruction is not found.
-    template <typename... T_categories>
-    std::vector<double>
+    const std::vector<double>&
     Get_Coefficients(const std::string& p_opcode,
-                     const T_categories&... p_categories) const
+                     const std::string& p_interaction_term) const
     {
+        // 32 0s is large enough to be accessed without segfaulting.
+        static const std::vector<double> not_found(32, 0);
+
+        // Unprofiled instructions and abnormal states are checked for first
+        // as they are common and throwing allocates.
+        if (!m_coefficients.Is_Profiled(p_opcode))
+        {
+            return not_found;
+        }
         try
         {
-            return m_coefficients.Get_Coefficients(p_opcode, p_categories...);
+            return m_coefficients.Get_Coefficients(p_opcode,
+                                                   p_interaction_term);
         }
         catch (const std::out_of_range& exception_not_found)
         {
-            // 32 0s is large enough to be accessed without segfaulting.
-            return std::vector<double>(32, 0);
+            return not_found;
         }
     }
 
@@ -191,6 +235,10 @@ private:
                            const std::string& p_instruction_term,
                            const std::string& p_target_category) const
     {
+        if (!m_coefficients.Is_Profiled(p_opcode))
+        {
+            return 0;
+        }
         try
         {
             return m_coefficients.Get_Coefficient(
@@ -212,6 +260,10 @@ private:
     //! instruction belongs to or 0 if the instruction was not found.
     double Get_Constant(const std::string& p_opcode) const
     {
+        if (!m_coefficients.Is_Profiled(p_opcode))
+        {
+            return 0;
+        }
         try
         {
             return m_coefficients.Get_Constant(p_opcode);
@@ -229,21 +281,18 @@ private:
     //! @returns The name of the category that the instruction is contained
     //! within. If the coefficients are not categorised then the instruction
     //! opcode is returned or "Shifts" if the instruction is not found.
-    const std::string
+    const std::string&
     Get_Instruction_Category(const std::string& p_opcode) const
     {
-        try
-        {
-            return m_coefficients.Get_Instruction_Category(p_opcode);
-        }
         // Instruction was not profiled so return any value that prevents a
         // crash. This be be zeroed out later on in calculations.
-        catch (const std::out_of_range& exception_not_found)
-        {
-            return "Shifts";
-            // Linear regression means that nothing is done for ALU and this is
-            // an invalid value so Shifts is used as the default value
-        }
+        // Linear regression means that nothing is done for ALU and this is
+        // an invalid value so Shifts is used as the default value
+        static const std::string not_found{"Shifts"};
+
+        return m_coefficients.Is_Profiled(p_opcode)
+                   ? m_coefficients.Get_Instruction_Category(p_opcode)
+                   : not_found;
     }
 
     //! @brief Retrieves the Assembly_Instruction that is in the execute
@@ -268,8 +317,9 @@ private:
             // Return a fake instruction to prevent crashing
             // Currently stalls and flushes are stored as zeros in
             // calculations.
-            return Assembly_Instruction_Power(
-                Assembly_Instruction("Abnormal State", {"0", "0"}), 0, 0);
+            static const Assembly_Instruction abnormal_state{"Abnormal State",
+                                                             {"0", "0"}};
+            return Assembly_Instruction_Power(abnormal_state, 0, 0);
         }
 
         // Retrieves what is in the "Execute" pipeline stage at clock cycle
@@ -279,7 +329,7 @@ private:
 
         // Add the next set of operands.
         return Assembly_Instruction_Power(
-            m_execution.Get_Instruction(p_cycle, "Execute"),
+            instruction,
             m_execution.Get_Operand_Value(p_cycle, instruction, 1),
             m_execution.Get_Operand_Value(p_cycle, instruction, 2));
     }
@@ -348,7 +398,7 @@ private:
     {
         // This is based off of what original Elmo does to calculate an
         // individual term
-        const auto coefficients = Get_Coefficients(p_opcode, p_term_name);
+        const auto& coefficients = Get_Coefficients(p_opcode, p_term_name);
         double total{0};
         for (std::size_t i{0}; i < N; ++i)
         {
@@ -357,40 +407,32 @@ private:
         return total;
     }
 
-    //! @brief Used only when calling calculate_hamming_x functions.
-    //! Increases readability for a simple boolean value.
-    enum class Instruction
-    {
-        Previous,
-        Subsequent
-    };
-
     double calculate_hamming_weight_terms(
         const Assembly_Instruction_Power& p_current_instruction,
         const std::string& p_opcode_previous,
         const std::string& p_opcode_next) const
     {
-        const auto category_previous =
+        const auto& category_previous =
             Get_Instruction_Category(p_opcode_previous);
 
-        const auto category_next = Get_Instruction_Category(p_opcode_next);
-
-        return calculate_hamming_weight(p_current_instruction,
-                                        1,
-                                        Instruction::Previous,
-                                        category_previous) +
-               calculate_hamming_weight(p_current_instruction,
-                                        2,
-                                        Instruction::Previous,
-                                        category_previous) +
-               calculate_hamming_weight(p_current_instruction,
-                                        1,
-                                        Instruction::Subsequent,
-                                        category_next) +
-               calculate_hamming_weight(p_current_instruction,
-                                        2,
-                                        Instruction::Subsequent,
-                                        category_next);
+        const auto& category_next = Get_Instruction_Category(p_opcode_next);
+
+        return calculate_hamming_weight(
+                   p_current_instruction,
+                   Terms::Hamming_Weight_Operand1_Previous_Instruction,
+                   category_previous) +
+               calculate_hamming_weight(
+                   p_current_instruction,
+                   Terms::Hamming_Weight_Operand2_Previous_Instruction,
+                   category_previous) +
+               calculate_hamming_weight(
+                   p_current_instruction,
+                   Terms::Hamming_Weight_Operand1_Subsequent_Instruction,
+                   category_next) +
+               calculate_hamming_weight(
+                   p_current_instruction,
+                   Terms::Hamming_Weight_Operand2_Subsequent_Instruction,
+                   category_next);
     }
 
     double calculate_hamming_distance_terms(
@@ -398,42 +440,35 @@ private:
         const Assembly_Instruction_Power& p_previous_instruction,
         const Assembly_Instruction_Power& p_next_instruction) const
     {
-        return calculate_hamming_distance(p_current_instruction,
-                                          p_previous_instruction,
-                                          1,
-                                          Instruction::Previous) +
-               calculate_hamming_distance(p_current_instruction,
-                                          p_previous_instruction,
-                                          2,
-                                          Instruction::Previous) +
-               calculate_hamming_distance(p_current_instruction,
-                                          p_next_instruction,
-                                          1,
-                                          Instruction::Subsequent) +
-               calculate_hamming_distance(p_current_instruction,
-                                          p_next_instruction,
-                                          2,
-                                          Instruction::Subsequent);
+        return calculate_hamming_distance(
+                   p_current_instruction,
+                   p_previous_instruction,
+                   Terms::Hamming_Distance_Operand1_Previous_Instruction) +
+               calculate_hamming_distance(
+                   p_current_instruction,
+                   p_previous_instruction,
+                   Terms::Hamming_Distance_Operand2_Previous_Instruction) +
+               calculate_hamming_distance(
+                   p_current_instruction,
+                   p_next_instruction,
+                   Terms::Hamming_Distance_Operand1_Subsequent_Instruction) +
+               calculate_hamming_distance(
+                   p_current_instruction,
+                   p_next_instruction,
+                   Terms::Hamming_Distance_Operand2_Subsequent_Instruction);
     }
 
     double calculate_hamming_weight(
         const Assembly_Instruction_Power& p_current_instruction,
-        const std::size_t p_operand_index,
-        const Instruction p_previous_or_next_instruction,
+        const std::string& p_term_name,
         const std::string& p_opcode_target)
         const  // TODO: Why is this type
                // double?? What should it be?
     {
-        std::string instruction{Instruction::Previous ==
-                                        p_previous_or_next_instruction
-                                    ? "Previous"
-                                    : "Subsequent"};
         // This is based off of what original elmo does to calculate an
         // individual term
         return Get_Coefficient(p_current_instruction.Get_Opcode(),
-                               "Hamming_Weight_Operand" +
-                                   std::to_string(p_operand_index) + "_" +
-                                   instruction + "_Instruction",
+                               p_term_name,
                                p_opcode_target) *
                // hamming_weight(current_instruction.Get_Operand(p_operand_index));
                Model_Math::Hamming_Weight(p_current_instruction.Operand_1);
@@ -442,24 +477,15 @@ private:
     double calculate_hamming_distance(
         const Assembly_Instruction_Power& p_current_instruction,
         const Assembly_Instruction_Power& p_target_instruction,
-        const std::size_t p_operand_index,
-        const Instruction p_previous_or_next_instruction)
+        const std::string& p_term_name)
         const  // TODO: Why is this type
                // double?? What should it be?
     {
-        const std::string_view instruction{
-            Instruction::Previous == p_previous_or_next_instruction
-                ? "Previous"
-                : "Subsequent"};
-
         // This is based off of what original elmo does to calculate an
         // individual term
-        return Get_Coefficient(
-                   p_current_instruction.Get_Opcode(),
-                   fmt::format("Hamming_Distance_Operand{}_{}_Instruction",
-                               p_operand_index,
-                               instruction),
-                   p_target_instruction.Get_Opcode()) *
+        return Get_Coefficient(p_current_instruction.Get_Opcode(),
+                               p_term_name,
+                               p_target_instruction.Get_Opcode()) *
                Model_Math::Hamming_Distance(p_current_instruction.Operand_1,
                                             p_target_instruction.Operand_1);
     }
@@ -477,8 +503,19 @@ public:
     //! generate the power Traces.
     //! TODO: Improve this description with details of how elmo power model
     //! works.
-    //! @returns The generated Traces for the target program
-    const std::vector<float> Generate_Traces() override;
+    //! @param p_trace Where to write the Traces. This must have room for
+    //! Get_Trace_Length() samples.
+    void Generate_Traces(float* const p_trace) override;
+
+    using Model::Generate_Traces;
+
+    //! @returns One sample for every clock cycle except the first and last,
+    //! as each sample uses the instructions either side of it.
+    std::size_t Get_Trace_Length() const override
+    {
+        const std::size_t size{m_execution.Get_Cycle_Count()};
+        return size > 2 ? size - 2 : 0;
+    }
 
     //! @brief Retrieves a list of the interaction terms that are used within
     //! the model. These must be provided by the Coefficients in order for
@@ -51,14 +51,23 @@ const std::unordered_set<std::string>
         "Previous_Instruction",
         "Subsequent_Instruction"};
 
+//! @brief This function returns the number of samples that Generate_Traces()
+//! will write.
+//! @returns The number of samples.
+std::size_t GILES::Internal::Model_TEMPLATE::Get_Trace_Length() const
+{
+    // *** Place your code here ***
+    return 0;  // temp placeholder for debugging reasons
+}
+
 //! @brief This function contains the mathematical calculations that generate
 //! the Traces.
-//! @returns The generated Traces for the target program.
-const std::vector<float>
-GILES::Internal::Model_TEMPLATE::Generate_Traces()
+//! @param p_trace Where to write the Traces. This has room for
+//! Get_Trace_Length() samples.
+void GILES::Internal::Model_TEMPLATE::Generate_Traces(float* const p_trace)
 {
     // *** Place your code here ***
     //! @note m_coefficients and m_execution can be made use of to generate the
     //! traces.
-    return std::vector<float>();  // temp placeholder for debugging reasons
+    static_cast<void>(p_trace);
 }
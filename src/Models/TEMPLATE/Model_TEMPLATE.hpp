@@ -31,6 +31,7 @@
 #ifndef MODEL_TEMPLATE_HPP
 #define MODEL_TEMPLATE_HPP
 
+#include <cstddef>        // for size_t
 #include <string>         // for string
 #include <unordered_set>  // for unordered_set
 #include <vector>         // for vector
@@ -65,7 +66,11 @@ public:
     {
     }
 
-    const std::vector<float> Generate_Traces() override;
+    using Model::Generate_Traces;
+
+    std::size_t Get_Trace_Length() const override;
+
+    void Generate_Traces(float* const p_trace) override;
 
     //! @brief Retrieves a list of the interaction terms that are used within
     //! the model. These must be provided by the Coefficients in order for
@@ -0,0 +1,357 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Codec.cpp
+    @brief Contains the Codec class which losslessly compresses blocks of
+    samples.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for min
+#include <cstdint>    // for uint8_t, uint32_t
+#include <cstring>    // for memcpy
+#include <vector>     // for vector
+
+#include "Codec.hpp"
+
+#include "Error.hpp"  // for Report_Error
+
+namespace
+{
+//! The first byte of every compressed block.
+enum Method : std::uint8_t
+{
+    Stored     = 0,
+    Compressed = 1
+};
+
+//! The shortest repeated sequence that is worth replacing.
+constexpr std::size_t minimum_match{4};
+
+//! The furthest back a repeated sequence can be found.
+constexpr std::size_t maximum_offset{65535};
+
+//! The number of bits used to index the table of previous sequences.
+constexpr std::size_t hash_bits{14};
+
+//! @brief Appends a value using as few bytes as possible. Each byte holds 7
+//! bits of the value and the top bit is set if more bytes follow.
+//! @param p_value The value to append.
+//! @param p_output The bytes to append to.
+void write_varint(std::size_t p_value, std::vector<std::uint8_t>* const p_output)
+{
+    while (p_value >= 0x80)
+    {
+        p_output->push_back(static_cast<std::uint8_t>(p_value | 0x80));
+        p_value >>= 7;
+    }
+    p_output->push_back(static_cast<std::uint8_t>(p_value));
+}
+
+//! @brief Reads a value written by write_varint(), advancing p_input past it.
+//! @param p_input The position to read from.
+//! @param p_input_end The end of the input.
+//! @returns The value read.
+std::size_t read_varint(const std::uint8_t** const p_input,
+                        const std::uint8_t* const p_input_end)
+{
+    std::size_t value{0};
+    for (std::size_t shift{0}; shift < 64; shift += 7)
+    {
+        if (*p_input >= p_input_end)
+        {
+            break;
+        }
+        const std::uint8_t byte{*(*p_input)++};
+        value |= static_cast<std::size_t>(byte & 0x7F) << shift;
+        if (0 == (byte & 0x80))
+        {
+            return value;
+        }
+    }
+    GILES::Internal::Error::Report_Error("Compressed samples are corrupt");
+}
+
+//! @brief Reads 4 bytes as a single value for comparing sequences.
+//! @param p_input The position to read from.
+//! @returns The 4 bytes.
+std::uint32_t read_sequence(const std::uint8_t* const p_input)
+{
+    std::uint32_t value;
+    std::memcpy(&value, p_input, sizeof(value));
+    return value;
+}
+}  // namespace
+
+//! @brief Replaces each value with the XOR of itself and the value before it
+//! in the same row.
+//! @param p_values The values to encode.
+//! @param p_row_length The number of values in each row.
+void GILES::Internal::Codec::delta_encode(
+    std::vector<std::uint32_t>* const p_values, const std::size_t p_row_length)
+{
+    auto& values = *p_values;
+    for (std::size_t row{0}; row < values.size(); row += p_row_length)
+    {
+        const std::size_t row_end{std::min(row + p_row_length, values.size())};
+        // Working backwards means each value is encoded against the original
+        // value before it.
+        for (std::size_t i{row_end - 1}; i > row; --i)
+        {
+            values[i] ^= values[i - 1];
+        }
+    }
+}
+
+//! @brief Reverses delta_encode().
+//! @param p_values The values to decode.
+//! @param p_row_length The number of values in each row.
+void GILES::Internal::Codec::delta_decode(
+    std::vector<std::uint32_t>* const p_values, const std::size_t p_row_length)
+{
+    auto& values = *p_values;
+    for (std::size_t row{0}; row < values.size(); row += p_row_length)
+    {
+        const std::size_t row_end{std::min(row + p_row_length, values.size())};
+        for (std::size_t i{row + 1}; i < row_end; ++i)
+        {
+            values[i] ^= values[i - 1];
+        }
+    }
+}
+
+//! @brief Regroups the bits of p_values so that bit n of every value is stored
+//! together. Within each of the 32 groups, each byte holds bit n of 8
+//! consecutive values.
+//! @param p_values The values to shuffle. Values are added as zeros to make
+//! the number of values a multiple of 8.
+//! @returns The shuffled bits.
+const std::vector<std::uint8_t>
+GILES::Internal::Codec::bitshuffle(const std::vector<std::uint32_t>& p_values)
+{
+    const std::size_t bytes_per_bit{(p_values.size() + 7) / 8};
+    std::vector<std::uint8_t> shuffled(32 * bytes_per_bit, 0);
+    for (std::size_t i{0}; i < p_values.size(); ++i)
+    {
+        const std::uint32_t value{p_values[i]};
+        const std::size_t byte{i / 8};
+        const auto position = static_cast<std::uint8_t>(1U << (i % 8));
+        for (std::size_t bit{0}; bit < 32; ++bit)
+        {
+            if (0 != ((value >> bit) & 1))
+            {
+                shuffled[bit * bytes_per_bit + byte] |= position;
+            }
+        }
+    }
+    return shuffled;
+}
+
+//! @brief Reverses bitshuffle().
+//! @param p_bytes The shuffled bits.
+//! @param p_number_of_values The number of values that were shuffled.
+//! @returns The original values.
+const std::vector<std::uint32_t>
+GILES::Internal::Codec::bitunshuffle(const std::uint8_t* const p_bytes,
+                                     const std::size_t p_number_of_values)
+{
+    const std::size_t bytes_per_bit{(p_number_of_values + 7) / 8};
+    std::vector<std::uint32_t> values(p_number_of_values, 0);
+    for (std::size_t bit{0}; bit < 32; ++bit)
+    {
+        const std::uint8_t* const group{p_bytes + bit * bytes_per_bit};
+        for (std::size_t i{0}; i < p_number_of_values; ++i)
+        {
+            values[i] |= static_cast<std::uint32_t>((group[i / 8] >> (i % 8)) & 1)
+                         << bit;
+        }
+    }
+    return values;
+}
+
+//! @brief Replaces repeated sequences of bytes with references to their
+//! previous occurrence. The output is a series of literal runs, each
+//! optionally followed by a repeat:
+//! - The number of literal bytes, then the literal bytes.
+//! - The length of the repeat, less minimum_match, then how far back it
+//!   starts.
+//!
+//! Every number is written using write_varint(). Repeats may overlap the bytes
+//! they produce, so a run of a single byte is a repeat 1 byte back.
+//! @param p_input The bytes to compress.
+//! @param p_output The bytes to append the compressed bytes to.
+void GILES::Internal::Codec::lz_compress(
+    const std::vector<std::uint8_t>& p_input,
+    std::vector<std::uint8_t>* const p_output)
+{
+    const std::size_t size{p_input.size()};
+    const std::uint8_t* const input{p_input.data()};
+
+    // The most recent position that each hashed sequence was seen at, plus one
+    // so that zero means not seen.
+    std::vector<std::size_t> table(std::size_t{1} << hash_bits, 0);
+
+    std::size_t literal_start{0};
+    std::size_t position{0};
+    while (position + minimum_match <= size)
+    {
+        const std::uint32_t sequence{read_sequence(input + position)};
+        const std::size_t hash{(sequence * 2654435761U) >> (32 - hash_bits)};
+        const std::size_t candidate{table[hash]};
+        table[hash] = position + 1;
+
+        if (0 == candidate || position + 1 - candidate > maximum_offset ||
+            read_sequence(input + candidate - 1) != sequence)
+        {
+            ++position;
+            continue;
+        }
+
+        const std::size_t match_start{candidate - 1};
+        std::size_t length{minimum_match};
+        while (position + length < size &&
+               input[match_start + length] == input[position + length])
+        {
+            ++length;
+        }
+
+        write_varint(position - literal_start, p_output);
+        p_output->insert(
+            p_output->end(), input + literal_start, input + position);
+        write_varint(length - minimum_match, p_output);
+        write_varint(position - match_start, p_output);
+
+        position += length;
+        literal_start = position;
+    }
+
+    write_varint(size - literal_start, p_output);
+    p_output->insert(p_output->end(), input + literal_start, input + size);
+}
+
+//! @brief Reverses lz_compress().
+//! @param p_input The compressed bytes.
+//! @param p_input_end The end of the compressed bytes.
+//! @param p_output_size The number of bytes that were compressed.
+//! @returns The original bytes.
+const std::vector<std::uint8_t>
+GILES::Internal::Codec::lz_decompress(const std::uint8_t* p_input,
+                                      const std::uint8_t* const p_input_end,
+                                      const std::size_t p_output_size)
+{
+    std::vector<std::uint8_t> output;
+    output.reserve(p_output_size);
+    while (output.size() < p_output_size)
+    {
+        const std::size_t literals{read_varint(&p_input, p_input_end)};
+        if (literals > static_cast<std::size_t>(p_input_end - p_input) ||
+            literals > p_output_size - output.size())
+        {
+            Error::Report_Error("Compressed samples are corrupt");
+        }
+        output.insert(output.end(), p_input, p_input + literals);
+        p_input += literals;
+
+        if (output.size() == p_output_size)
+        {
+            break;
+        }
+
+        const std::size_t length{read_varint(&p_input, p_input_end) +
+                                 minimum_match};
+        const std::size_t offset{read_varint(&p_input, p_input_end)};
+        if (0 == offset || offset > output.size() ||
+            length > p_output_size - output.size())
+        {
+            Error::Report_Error("Compressed samples are corrupt");
+        }
+        // Copied one byte at a time as the repeat may overlap itself.
+        const std::size_t start{output.size() - offset};
+        for (std::size_t i{0}; i < length; ++i)
+        {
+            output.push_back(output[start + i]);
+        }
+    }
+    return output;
+}
+
+const std::vector<std::uint8_t>
+GILES::Internal::Codec::Compress(const std::vector<float>& p_samples,
+                                 const std::size_t p_row_length)
+{
+    std::vector<std::uint32_t> values(p_samples.size());
+    std::memcpy(values.data(), p_samples.data(), values.size() * sizeof(float));
+
+    if (0 != p_row_length)
+    {
+        delta_encode(&values, p_row_length);
+    }
+
+    std::vector<std::uint8_t> compressed{Compressed};
+    lz_compress(bitshuffle(values), &compressed);
+
+    const std::size_t stored_size{1 + p_samples.size() * sizeof(float)};
+    if (compressed.size() >= stored_size)
+    {
+        compressed.assign(stored_size, Stored);
+        std::memcpy(compressed.data() + 1,
+                    p_samples.data(),
+                    p_samples.size() * sizeof(float));
+    }
+    return compressed;
+}
+
+const std::vector<float>
+GILES::Internal::Codec::Decompress(const std::vector<std::uint8_t>& p_compressed,
+                                   const std::size_t p_number_of_samples,
+                                   const std::size_t p_row_length)
+{
+    std::vector<float> samples(p_number_of_samples);
+    if (p_compressed.empty())
+    {
+        Error::Report_Error("Compressed samples are corrupt");
+    }
+
+    if (Stored == p_compressed.front())
+    {
+        if (p_compressed.size() != 1 + p_number_of_samples * sizeof(float))
+        {
+            Error::Report_Error("Compressed samples are corrupt");
+        }
+        std::memcpy(samples.data(),
+                    p_compressed.data() + 1,
+                    p_number_of_samples * sizeof(float));
+        return samples;
+    }
+
+    const std::size_t shuffled_size{32 * ((p_number_of_samples + 7) / 8)};
+    const auto shuffled = lz_decompress(p_compressed.data() + 1,
+                                        p_compressed.data() + p_compressed.size(),
+                                        shuffled_size);
+    auto values = bitunshuffle(shuffled.data(), p_number_of_samples);
+
+    if (0 != p_row_length)
+    {
+        delta_decode(&values, p_row_length);
+    }
+
+    std::memcpy(samples.data(), values.data(), samples.size() * sizeof(float));
+    return samples;
+}
@@ -0,0 +1,101 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Codec.hpp
+    @brief Contains the Codec class which losslessly compresses blocks of
+    samples.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef CODEC_HPP
+#define CODEC_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, uint32_t
+#include <vector>   // for vector
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Codec
+//! @brief A small, fast, lossless compressor for blocks of float samples. The
+//! samples are treated as rows of a given length and compressed in three
+//! stages:
+//! - Delta: Each sample is replaced with the XOR of itself and the previous
+//!   sample in the same row. Neighbouring samples of a smooth trace share
+//!   their sign, exponent and upper mantissa bits, so these become zero.
+//! - Bitshuffle: The bits are regrouped so that bit n of every sample is
+//!   stored together. The mostly zero upper bits form long runs of zero bytes.
+//! - LZ: Repeated byte sequences, including the runs of zeros, are replaced
+//!   with references to their previous occurrence.
+//!
+//! If this would make a block larger, the block is stored uncompressed
+//! instead. A single leading byte records which was used.
+//! @note Samples are stored little-endian.
+struct Codec
+{
+private:
+    static void delta_encode(std::vector<std::uint32_t>* const p_values,
+                             const std::size_t p_row_length);
+
+    static void delta_decode(std::vector<std::uint32_t>* const p_values,
+                             const std::size_t p_row_length);
+
+    static const std::vector<std::uint8_t>
+    bitshuffle(const std::vector<std::uint32_t>& p_values);
+
+    static const std::vector<std::uint32_t>
+    bitunshuffle(const std::uint8_t* const p_bytes,
+                 const std::size_t p_number_of_values);
+
+    static void lz_compress(const std::vector<std::uint8_t>& p_input,
+                            std::vector<std::uint8_t>* const p_output);
+
+    static const std::vector<std::uint8_t>
+    lz_decompress(const std::uint8_t* p_input,
+                  const std::uint8_t* const p_input_end,
+                  const std::size_t p_output_size);
+
+public:
+    //! @brief Compresses a block of samples.
+    //! @param p_samples The samples to compress, stored one row after another.
+    //! @param p_row_length The number of samples in each row. Samples are only
+    //! compared against their neighbours within the same row.
+    //! @returns The compressed samples.
+    static const std::vector<std::uint8_t>
+    Compress(const std::vector<float>& p_samples,
+             const std::size_t p_row_length);
+
+    //! @brief Decompresses a block of samples produced by Compress().
+    //! @param p_compressed The compressed samples.
+    //! @param p_number_of_samples The total number of samples in the block.
+    //! @param p_row_length The number of samples in each row. This must match
+    //! the value given to Compress().
+    //! @returns The original samples.
+    static const std::vector<float>
+    Decompress(const std::vector<std::uint8_t>& p_compressed,
+               const std::size_t p_number_of_samples,
+               const std::size_t p_row_length);
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // CODEC_HPP
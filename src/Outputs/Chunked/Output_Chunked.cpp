@@ -0,0 +1,308 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Chunked.cpp
+    @brief Contains an Output that saves traces compressed in chunks, along with
+    statistics for every chunk.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for min, max
+#include <cstdint>    // for uint8_t, uint32_t, uint64_t
+#include <memory>     // for make_unique
+#include <mutex>      // for call_once, lock_guard, unique_lock
+#include <string>     // for string
+#include <thread>     // for thread
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "Output_Chunked.hpp"
+
+#include "Codec.hpp"          // for Codec
+#include "Error.hpp"          // for Report_Error
+#include "Memory_Budget.hpp"  // for Memory_Budget
+
+static_assert(sizeof(GILES::Internal::Output_Chunked::Header) == 80,
+              "The header must be exactly 80 bytes");
+
+namespace
+{
+//! The number of threads compressing and writing tiles.
+constexpr std::size_t writer_threads{2};
+
+//! The number of full tiles that can wait to be compressed before the threads
+//! generating traces have to wait.
+constexpr std::size_t maximum_queued_tiles{4 * writer_threads};
+}  // namespace
+
+GILES::Internal::Output_Chunked::~Output_Chunked() { stop_writers(); }
+
+//! @brief Hands a full tile to the writer threads, waiting if too many tiles
+//! are already waiting.
+//! @param p_tile The tile to write.
+void GILES::Internal::Output_Chunked::enqueue(Tile&& p_tile)
+{
+    Memory_Budget::Add_Queued(p_tile.Bytes());
+    {
+        std::unique_lock<std::mutex> lock{m_queue_mutex};
+        m_queue_changed.wait(
+            lock, [this] { return m_queue.size() < maximum_queued_tiles; });
+        m_queue.push_back(std::move(p_tile));
+    }
+    m_queue_changed.notify_all();
+}
+
+//! @brief Run by each writer thread. Writes tiles as they are added to the
+//! queue until the queue is empty and no more tiles will be added.
+void GILES::Internal::Output_Chunked::write_tiles()
+{
+    while (true)
+    {
+        Tile tile;
+        {
+            std::unique_lock<std::mutex> lock{m_queue_mutex};
+            m_queue_changed.wait(
+                lock, [this] { return !m_queue.empty() || m_finishing; });
+            if (m_queue.empty())
+            {
+                return;
+            }
+            tile = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_queue_changed.notify_all();
+
+        write_tile(tile);
+        Memory_Budget::Remove_Queued(tile.Bytes());
+    }
+}
+
+//! @brief Splits a tile into chunks, compresses them and appends them, along
+//! with the record of the tile, to the end of the file.
+//! @param p_tile The tile to write.
+void GILES::Internal::Output_Chunked::write_tile(const Tile& p_tile)
+{
+    const std::size_t rows{p_tile.Run_Indices.size()};
+    if (0 == rows)
+    {
+        return;
+    }
+    const std::size_t columns{m_number_of_samples};
+
+    // Compression and statistics are done before taking the lock as they make
+    // up nearly all of the work.
+    std::vector<std::vector<std::uint8_t>> chunks;
+    std::vector<Sample_Statistics> statistics;
+    statistics.reserve(columns);
+    std::vector<float> chunk;
+    for (std::size_t first{0}; first < columns;
+         first += m_options.Samples_Per_Chunk)
+    {
+        const std::size_t width{
+            std::min(m_options.Samples_Per_Chunk, columns - first)};
+
+        chunk.clear();
+        for (std::size_t row{0}; row < rows; ++row)
+        {
+            const auto start = p_tile.Rows.begin() + row * columns + first;
+            chunk.insert(chunk.end(), start, start + width);
+        }
+
+        for (std::size_t column{0}; column < width; ++column)
+        {
+            float minimum{chunk[column]};
+            float maximum{chunk[column]};
+            double sum{0};
+            for (std::size_t row{0}; row < rows; ++row)
+            {
+                const float sample{chunk[row * width + column]};
+                minimum = std::min(minimum, sample);
+                maximum = std::max(maximum, sample);
+                sum += sample;
+            }
+            statistics.push_back(
+                {minimum, maximum, static_cast<float>(sum / rows)});
+        }
+
+        chunks.push_back(Codec::Compress(chunk, width));
+    }
+
+    const std::lock_guard<std::mutex> lock{m_file_mutex};
+
+    const std::uint64_t tile_number{m_tile_index.size()};
+    const std::uint64_t first_statistic{m_statistics.size()};
+    for (std::size_t i{0}; i < chunks.size(); ++i)
+    {
+        const std::size_t first{i * m_options.Samples_Per_Chunk};
+        m_chunk_index.push_back(
+            {m_file->Position(),
+             static_cast<std::uint64_t>(chunks[i].size()),
+             tile_number,
+             static_cast<std::uint64_t>(first),
+             static_cast<std::uint64_t>(
+                 std::min(m_options.Samples_Per_Chunk, columns - first)),
+             first_statistic + first});
+        m_file->Append(chunks[i].data(), chunks[i].size());
+    }
+    m_statistics.insert(
+        m_statistics.end(), statistics.begin(), statistics.end());
+
+    m_tile_index.push_back({m_file->Position(),
+                            static_cast<std::uint64_t>(rows),
+                            m_number_of_traces});
+    m_number_of_traces += rows;
+
+    m_file->Append(p_tile.Run_Indices.data(), rows * sizeof(std::uint64_t));
+    for (const auto& extra_data : p_tile.Extra_Data)
+    {
+        const auto size = static_cast<std::uint32_t>(extra_data.size());
+        m_file->Append(&size, sizeof(size));
+        m_file->Append(extra_data.data(), extra_data.size());
+    }
+}
+
+//! @brief Creates the Header describing everything written so far.
+//! @param p_footer_offset The position of the footer within the file.
+//! @returns The Header.
+const GILES::Internal::Output_Chunked::Header
+GILES::Internal::Output_Chunked::header(
+    const std::uint64_t p_footer_offset) const
+{
+    Header header;
+    header.Number_Of_Samples = m_number_of_samples;
+    header.Number_Of_Traces  = m_number_of_traces;
+    header.Traces_Per_Tile   = m_options.Traces_Per_Tile;
+    header.Samples_Per_Chunk = m_options.Samples_Per_Chunk;
+    header.Number_Of_Tiles   = m_tile_index.size();
+    header.Number_Of_Chunks  = m_chunk_index.size();
+    header.Footer_Offset     = p_footer_offset;
+    return header;
+}
+
+//! @brief Waits for the writer threads to write every queued tile and then
+//! stops them.
+void GILES::Internal::Output_Chunked::stop_writers()
+{
+    {
+        const std::lock_guard<std::mutex> lock{m_queue_mutex};
+        m_finishing = true;
+    }
+    m_queue_changed.notify_all();
+
+    for (auto& writer : m_writers)
+    {
+        writer.join();
+    }
+    m_writers.clear();
+}
+
+//! @brief Opens the file, reserving space for the Header, creates one tile for
+//! every thread and starts the writer threads.
+//! @param p_number_of_threads The number of threads that will add traces.
+void GILES::Internal::Output_Chunked::Start(
+    const std::size_t /*p_number_of_runs*/,
+    const std::size_t p_number_of_threads)
+{
+    if (0 == m_options.Traces_Per_Tile)
+    {
+        Error::Report_Error("The number of traces per tile cannot be 0");
+    }
+    if (0 == m_options.Samples_Per_Chunk)
+    {
+        Error::Report_Error("The number of samples per chunk cannot be 0");
+    }
+
+    m_file = std::make_unique<Writer>(m_options.Path, m_options.Write_Budget);
+    const auto placeholder = header(0);
+    m_file->Append(&placeholder, sizeof(placeholder));
+
+    m_tiles.assign(p_number_of_threads, Tile{});
+
+    m_finishing = false;
+    for (std::size_t i{0}; i < writer_threads; ++i)
+    {
+        m_writers.emplace_back(&Output_Chunked::write_tiles, this);
+    }
+}
+
+//! @brief Adds a trace to the tile belonging to the calling thread, handing
+//! that tile to the writer threads once it is full.
+void GILES::Internal::Output_Chunked::Add_Trace(
+    const std::size_t p_thread,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    std::call_once(m_number_of_samples_resolved,
+                   [this, &p_trace] { m_number_of_samples = p_trace.size(); });
+
+    if (p_trace.size() != m_number_of_samples)
+    {
+        Error::Report_Error("The {} format requires every trace to be the same "
+                            "length. Trace {} has {} samples but {} were "
+                            "expected.",
+                            Get_Name(),
+                            p_run_index,
+                            p_trace.size(),
+                            m_number_of_samples);
+    }
+
+    auto& tile = m_tiles.at(p_thread);
+    if (tile.Rows.empty())
+    {
+        tile.Rows.reserve(m_options.Traces_Per_Tile * m_number_of_samples);
+    }
+    tile.Rows.insert(tile.Rows.end(), p_trace.begin(), p_trace.end());
+    tile.Run_Indices.push_back(p_run_index);
+    tile.Extra_Data.push_back(p_extra_data);
+
+    if (tile.Run_Indices.size() >= m_options.Traces_Per_Tile)
+    {
+        enqueue(std::move(tile));
+        tile = Tile{};
+    }
+}
+
+//! @brief Writes any partially filled tiles, waits for the writer threads to
+//! finish and then saves the footer and completes the Header.
+void GILES::Internal::Output_Chunked::Finish()
+{
+    for (auto& tile : m_tiles)
+    {
+        if (!tile.Run_Indices.empty())
+        {
+            enqueue(std::move(tile));
+        }
+    }
+    m_tiles.clear();
+
+    stop_writers();
+
+    const auto completed = header(m_file->Position());
+    m_file->Append(m_tile_index.data(),
+                   m_tile_index.size() * sizeof(Tile_Entry));
+    m_file->Append(m_chunk_index.data(),
+                   m_chunk_index.size() * sizeof(Chunk_Entry));
+    m_file->Append(m_statistics.data(),
+                   m_statistics.size() * sizeof(Sample_Statistics));
+
+    m_file->Write(&completed, sizeof(completed), 0);
+    m_file->Close();
+}
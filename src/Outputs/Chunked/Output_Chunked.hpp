@@ -0,0 +1,241 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Chunked.hpp
+    @brief Contains an Output that saves traces compressed in chunks, along with
+    statistics for every chunk.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_CHUNKED_HPP
+#define OUTPUT_CHUNKED_HPP
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for uint32_t, uint64_t
+#include <deque>               // for deque
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex, once_flag
+#include <string>              // for string
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+#include "Output.hpp"  // for Output_Interface
+#include "Writer.hpp"  // for Writer
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Chunked
+//! @brief Saves the generated traces compressed, in chunks. Traces are
+//! collected into tiles of up to Output_Options::Traces_Per_Tile traces and
+//! each tile is split into chunks of up to Output_Options::Samples_Per_Chunk
+//! samples. Every chunk is compressed on its own using the Codec class, so
+//! chunks can be decompressed independently and in parallel. The minimum,
+//! maximum and mean of each sample across the traces in a chunk are kept in
+//! the footer, allowing readers to skip chunks without decompressing them.
+//!
+//! Compression is done by a small number of writer threads, separate from the
+//! threads generating traces. A thread only waits for the writer threads if
+//! they have fallen so far behind that the tiles waiting to be compressed
+//! would use too much memory.
+//!
+//! All values are stored little-endian. The file is laid out as:
+//! - A Header.
+//! - For each tile, in the order they were compressed, each chunk of the tile
+//!   followed by a record of the tile. A chunk containing k traces of c
+//!   samples is compressed as k rows of c samples. The record holds the k run
+//!   indices as uint64, then for each trace a uint32 length followed by that
+//!   many bytes of extra data.
+//! - The footer, at Header::Footer_Offset. This holds one Tile_Entry per tile,
+//!   one Chunk_Entry per chunk and then the Sample_Statistics of every chunk.
+//! @note Every trace must contain the same number of samples.
+class Output_Chunked : public virtual Output_Interface<Output_Chunked>
+{
+public:
+    //! The start of the file.
+    struct Header
+    {
+        char Magic[8]{'G', 'I', 'L', 'E', 'S', 'C', 'M', 'P'};
+        std::uint32_t Version{1};
+        std::uint32_t Reserved{0};
+        std::uint64_t Number_Of_Samples{0};
+        std::uint64_t Number_Of_Traces{0};
+        std::uint64_t Traces_Per_Tile{0};
+        std::uint64_t Samples_Per_Chunk{0};
+        std::uint64_t Number_Of_Tiles{0};
+        std::uint64_t Number_Of_Chunks{0};
+        std::uint64_t Footer_Offset{0};
+        std::uint64_t Padding{0};
+    };
+
+    //! Where to find the record of one tile within the file.
+    struct Tile_Entry
+    {
+        //! The position of the first byte of the record.
+        std::uint64_t Offset;
+
+        //! The number of traces within the tile.
+        std::uint64_t Number_Of_Traces;
+
+        //! The position of the first trace of this tile within the file, when
+        //! counting every trace in every previous tile.
+        std::uint64_t First_Trace;
+    };
+
+    //! Where to find one chunk within the file.
+    struct Chunk_Entry
+    {
+        //! The position of the first byte of the compressed chunk.
+        std::uint64_t Offset;
+
+        //! The number of bytes in the compressed chunk.
+        std::uint64_t Size;
+
+        //! The index of the Tile_Entry for the tile this chunk is part of.
+        std::uint64_t Tile;
+
+        //! The first sample, within each trace, held in this chunk.
+        std::uint64_t First_Sample;
+
+        //! The number of samples, within each trace, held in this chunk.
+        std::uint64_t Number_Of_Samples;
+
+        //! The index of the Sample_Statistics for the first sample of this
+        //! chunk. The rest follow in order.
+        std::uint64_t Statistics;
+    };
+
+    //! A summary of one sample across every trace in one chunk.
+    struct Sample_Statistics
+    {
+        float Minimum;
+        float Maximum;
+        float Mean;
+    };
+
+private:
+    //! The traces collected by a single thread that have not been written.
+    struct Tile
+    {
+        //! The traces, one after another, as they were generated.
+        std::vector<float> Rows{};
+
+        std::vector<std::uint64_t> Run_Indices{};
+        std::vector<std::string> Extra_Data{};
+
+        //! @returns The number of bytes held by the traces and extra data,
+        //! which is accounted for by the Memory_Budget while queued.
+        std::size_t Bytes() const
+        {
+            std::size_t bytes{Rows.capacity() * sizeof(float)};
+            for (const auto& extra_data : Extra_Data)
+            {
+                bytes += extra_data.size();
+            }
+            return bytes;
+        }
+    };
+
+    //! One tile per thread so that collecting traces needs no locking.
+    std::vector<Tile> m_tiles;
+
+    //! The number of samples in every trace, taken from the first trace.
+    std::size_t m_number_of_samples;
+
+    //! Ensures m_number_of_samples is only set once.
+    std::once_flag m_number_of_samples_resolved;
+
+    //! Full tiles waiting to be compressed by the writer threads.
+    std::deque<Tile> m_queue;
+
+    //! Set once no more tiles will be added to m_queue.
+    bool m_finishing;
+
+    //! Guards m_queue and m_finishing.
+    std::mutex m_queue_mutex;
+
+    //! Signalled whenever a tile is added to or removed from m_queue, or
+    //! m_finishing is set.
+    std::condition_variable m_queue_changed;
+
+    std::vector<std::thread> m_writers;
+
+    //! The location and statistics of everything written so far.
+    std::vector<Tile_Entry> m_tile_index;
+    std::vector<Chunk_Entry> m_chunk_index;
+    std::vector<Sample_Statistics> m_statistics;
+
+    //! The number of traces written so far.
+    std::uint64_t m_number_of_traces;
+
+    //! Writes the file in the background.
+    std::unique_ptr<Writer> m_file;
+
+    //! Guards m_file, the indices above and m_number_of_traces.
+    std::mutex m_file_mutex;
+
+    void enqueue(Tile&& p_tile);
+
+    void write_tiles();
+
+    void write_tile(const Tile& p_tile);
+
+    const Header header(const std::uint64_t p_footer_offset) const;
+
+    void stop_writers();
+
+public:
+    //! @brief Constructs an Output that will save to the path given in
+    //! p_options.
+    //! @param p_options The settings for this Output.
+    explicit Output_Chunked(const Output_Options& p_options)
+        : Output_Interface{p_options}, m_tiles{}, m_number_of_samples{0},
+          m_number_of_samples_resolved{}, m_queue{}, m_finishing{false},
+          m_queue_mutex{}, m_queue_changed{}, m_writers{}, m_tile_index{},
+          m_chunk_index{}, m_statistics{}, m_number_of_traces{0}, m_file{},
+          m_file_mutex{}
+    {
+    }
+
+    //! @brief Stops the writer threads if Finish() was never called.
+    virtual ~Output_Chunked();
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    //! @brief Retrieves the name of this Output.
+    //! @returns The name as a string.
+    //! @note This is needed to ensure self registration in the factory
+    //! works. The factory registration requires this as unique identifier.
+    static const std::string Get_Name() { return "Chunked"; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_CHUNKED_HPP
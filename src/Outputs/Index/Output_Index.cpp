@@ -0,0 +1,270 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Index.cpp
+    @brief Contains an Output that saves an index of the traces saved by
+    another Output.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdint>  // for uint8_t, uint16_t, uint32_t, uint64_t
+#include <cstring>  // for memcmp
+#include <fstream>  // for ifstream
+#include <mutex>    // for call_once
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output_Index.hpp"
+
+#include "Error.hpp"   // for Report_Error
+#include "Writer.hpp"  // for Writer
+
+//! The tags used in the header of a TRS file.
+//! @see https://github.com/bristol-sca/Traces-Serialiser
+namespace
+{
+constexpr std::uint8_t trs_number_of_samples{0x42};
+constexpr std::uint8_t trs_sample_coding{0x43};
+constexpr std::uint8_t trs_data_length{0x44};
+constexpr std::uint8_t trs_title_space{0x45};
+constexpr std::uint8_t trs_trace_block{0x5F};
+
+//! The sample coding of 4 byte floating point samples.
+constexpr std::uint8_t trs_float{0x14};
+}  // namespace
+
+GILES::Internal::Output_Index::Output_Index(const Output_Options& p_options)
+    : Output_Interface{p_options}, m_entries{}, m_added{},
+      m_number_of_samples{0}, m_number_of_samples_resolved{}
+{
+    if ("TRS" != m_options.Format && "NumPy" != m_options.Format &&
+        "Raw" != m_options.Format)
+    {
+        Error::Report_Error("Traces saved in the {} format can not be indexed. "
+                            "Only the TRS, NumPy and Raw formats are "
+                            "supported.",
+                            m_options.Format);
+    }
+}
+
+//! @brief Reads the header of a TRS file to find where the traces are.
+//! @returns Where the traces are.
+const GILES::Internal::Output_Index::Layout
+GILES::Internal::Output_Index::layout_trs() const
+{
+    std::ifstream file{m_options.Path, std::ios::binary};
+
+    std::uint64_t number_of_samples{0};
+    std::uint64_t sample_coding{trs_float};
+    std::uint64_t data_length{0};
+    std::uint64_t title_space{0};
+    for (;;)
+    {
+        std::uint8_t tag{0};
+        std::uint8_t length{0};
+        file.read(reinterpret_cast<char*>(&tag), 1);
+        file.read(reinterpret_cast<char*>(&length), 1);
+
+        // Lengths of 128 or more are given in the following bytes.
+        std::uint64_t size{length};
+        if (0 != (length & 0x80))
+        {
+            size = 0;
+            for (std::uint8_t i{0}; i < (length & 0x7F); ++i)
+            {
+                std::uint8_t byte{0};
+                file.read(reinterpret_cast<char*>(&byte), 1);
+                size |= static_cast<std::uint64_t>(byte) << (8 * i);
+            }
+        }
+        if (!file)
+        {
+            Error::Report_Error("Could not read the header of '{}'",
+                                m_options.Path);
+        }
+        if (trs_trace_block == tag)
+        {
+            break;
+        }
+
+        // Every value needed is a little-endian integer of up to 8 bytes.
+        std::vector<char> value(size);
+        file.read(value.data(), static_cast<std::streamsize>(size));
+        std::uint64_t integer{0};
+        for (std::size_t i{0}; i < size && i < sizeof(integer); ++i)
+        {
+            integer |= static_cast<std::uint64_t>(
+                           static_cast<std::uint8_t>(value[i]))
+                       << (8 * i);
+        }
+
+        switch (tag)
+        {
+            case trs_number_of_samples:
+                number_of_samples = integer;
+                break;
+            case trs_sample_coding:
+                sample_coding = integer;
+                break;
+            case trs_data_length:
+                data_length = integer;
+                break;
+            case trs_title_space:
+                title_space = integer;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (trs_float != sample_coding || number_of_samples != m_number_of_samples)
+    {
+        Error::Report_Error("The traces in '{}' do not match those that were "
+                            "generated so can not be indexed",
+                            m_options.Path);
+    }
+
+    // Each trace is stored as its title, then its data, then its samples.
+    return {static_cast<std::uint64_t>(file.tellg()) + title_space +
+                data_length,
+            title_space + data_length + number_of_samples * sizeof(float),
+            false};
+}
+
+//! @brief Reads the header of a .npy file to find where the traces are.
+//! @returns Where the traces are.
+const GILES::Internal::Output_Index::Layout
+GILES::Internal::Output_Index::layout_numpy() const
+{
+    std::ifstream file{m_options.Path, std::ios::binary};
+
+    // Version 1 uses a 2 byte header length. Later versions use 4 bytes.
+    char preamble[12]{};
+    file.read(preamble, sizeof(preamble));
+    if (!file || 0 != std::memcmp(preamble, "\x93NUMPY", 6))
+    {
+        Error::Report_Error("Could not read the header of '{}'",
+                            m_options.Path);
+    }
+
+    std::uint64_t data_offset{0};
+    if (1 == preamble[6])
+    {
+        std::uint16_t length{0};
+        std::memcpy(&length, preamble + 8, sizeof(length));
+        data_offset = 10 + length;
+    }
+    else
+    {
+        std::uint32_t length{0};
+        std::memcpy(&length, preamble + 8, sizeof(length));
+        data_offset = 12 + length;
+    }
+
+    return {data_offset, m_number_of_samples * sizeof(float), true};
+}
+
+//! @brief Finds where the traces are within the traces file.
+//! @returns Where the traces are.
+const GILES::Internal::Output_Index::Layout
+GILES::Internal::Output_Index::layout() const
+{
+    if ("TRS" == m_options.Format)
+    {
+        return layout_trs();
+    }
+    if ("NumPy" == m_options.Format)
+    {
+        return layout_numpy();
+    }
+    return {0, m_number_of_samples * sizeof(float), true};
+}
+
+void GILES::Internal::Output_Index::Start(
+    const std::size_t p_number_of_runs,
+    const std::size_t /*p_number_of_threads*/)
+{
+    m_entries.assign(p_number_of_runs, {});
+    m_added.assign(p_number_of_runs, 0);
+}
+
+//! @brief Records the run index and extra data of a trace. No locking is
+//! needed as every run has its own entry.
+void GILES::Internal::Output_Index::Add_Trace(
+    const std::size_t /*p_thread*/,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    std::call_once(m_number_of_samples_resolved,
+                   [this, &p_trace] { m_number_of_samples = p_trace.size(); });
+
+    if (p_trace.size() != m_number_of_samples)
+    {
+        Error::Report_Error("The {} format requires every trace to be the same "
+                            "length. Trace {} has {} samples but {} were "
+                            "expected.",
+                            Get_Name(),
+                            p_run_index,
+                            p_trace.size(),
+                            m_number_of_samples);
+    }
+
+    m_entries.at(p_run_index) = {
+        p_run_index, 0, Trace_Index::Hash(p_extra_data)};
+    m_added[p_run_index] = 1;
+}
+
+//! @brief Finds the position of every trace within the traces file and saves
+//! the index.
+void GILES::Internal::Output_Index::Finish()
+{
+    const auto traces = layout();
+
+    Trace_Index::Header header;
+    header.Number_Of_Samples = m_number_of_samples;
+
+    Writer file{Trace_Index::Index_Path(m_options.Path),
+                m_options.Write_Budget};
+    file.Append(&header, sizeof(header));
+
+    for (std::size_t run{0}; run < m_entries.size(); ++run)
+    {
+        if (0 == m_added[run])
+        {
+            continue;
+        }
+
+        // Formats that do not store a trace for every run store them one
+        // after another.
+        const std::uint64_t row{traces.Rows_Are_Run_Indices
+                                    ? run
+                                    : header.Number_Of_Traces};
+        m_entries[run].Offset = traces.Data_Offset + row * traces.Stride;
+        file.Append(&m_entries[run], sizeof(m_entries[run]));
+        ++header.Number_Of_Traces;
+    }
+
+    file.Write(&header, sizeof(header), 0);
+    file.Close();
+
+    m_entries.clear();
+    m_added.clear();
+}
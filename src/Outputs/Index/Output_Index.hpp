@@ -0,0 +1,117 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Index.hpp
+    @brief Contains an Output that saves an index of the traces saved by
+    another Output.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_INDEX_HPP
+#define OUTPUT_INDEX_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <mutex>    // for once_flag
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output.hpp"       // for Output_Interface
+#include "Trace_Index.hpp"  // for Trace_Index
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Index
+//! @brief Saves an index of the traces saved at the path given in the
+//! options, in the format given in the options, so that they can be retrieved
+//! individually using Trace_Index. The index is saved at the path given by
+//! Trace_Index::Index_Path().
+//!
+//! The position of each trace is found by reading the header of the traces
+//! file once it has been saved, so this Output must be finished after the
+//! Output saving the traces. Only formats that store each trace as
+//! consecutive float32 samples, in run order, can be indexed. These are
+//! "TRS", "NumPy" and "Raw".
+//! @note Every trace must contain the same number of samples.
+class Output_Index : public virtual Output_Interface<Output_Index>
+{
+private:
+    //! Where the traces are within the traces file.
+    struct Layout
+    {
+        //! The position of the first sample of the first trace.
+        std::uint64_t Data_Offset;
+
+        //! The distance between the start of consecutive traces.
+        std::uint64_t Stride;
+
+        //! Whether each trace is stored at the row given by its run index
+        //! rather than directly after the previous trace.
+        bool Rows_Are_Run_Indices;
+    };
+
+    //! One entry per run, indexed by run index. Offsets are filled in by
+    //! Finish().
+    std::vector<Trace_Index::Entry> m_entries;
+
+    //! Whether a trace has been added for each run. char is used rather than
+    //! bool as each element is written by a different thread.
+    std::vector<char> m_added;
+
+    //! The number of samples in every trace, taken from the first trace.
+    std::size_t m_number_of_samples;
+
+    //! Ensures m_number_of_samples is only set once.
+    std::once_flag m_number_of_samples_resolved;
+
+    const Layout layout() const;
+
+    const Layout layout_trs() const;
+
+    const Layout layout_numpy() const;
+
+public:
+    //! @brief Constructs an Output that will index the traces saved at the
+    //! path given in p_options.
+    //! @param p_options The settings for this Output.
+    explicit Output_Index(const Output_Options& p_options);
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    //! @brief Retrieves the name of this Output.
+    //! @returns The name as a string.
+    //! @note This is needed to ensure self registration in the factory
+    //! works. The factory registration requires this as unique identifier.
+    static const std::string Get_Name() { return "Index"; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_INDEX_HPP
@@ -0,0 +1,231 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Trace_Index.cpp
+    @brief Contains the Trace_Index class which retrieves traces from a file
+    using the index saved alongside it.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for min
+#include <cstdint>    // for uint64_t
+#include <cstring>    // for memcmp, memcpy
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include <fcntl.h>     // for open, O_RDONLY
+#include <sys/mman.h>  // for mmap, munmap, madvise
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+
+#include "Trace_Index.hpp"
+
+#include "Error.hpp"  // for Report_Error
+
+static_assert(sizeof(GILES::Internal::Trace_Index::Header) == 64,
+              "The header must be exactly 64 bytes");
+static_assert(sizeof(GILES::Internal::Trace_Index::Entry) == 24,
+              "Each entry must be exactly 24 bytes");
+
+//! @brief Maps the whole of the file at p_path into memory, read only.
+//! @param p_path The path to the file.
+GILES::Internal::Trace_Index::Mapping::Mapping(const std::string& p_path)
+    : m_data{nullptr}, m_size{0}
+{
+    const int file{::open(p_path.c_str(), O_RDONLY)};
+    if (file < 0)
+    {
+        Error::Report_Error("Could not open '{}'", p_path);
+    }
+
+    // The file is closed before reporting an error as the error may be
+    // thrown.
+    struct stat status;
+    if (0 != ::fstat(file, &status))
+    {
+        ::close(file);
+        Error::Report_Error("Could not read '{}'", p_path);
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+
+    // Empty files can not be mapped but there is nothing to read anyway.
+    if (0 != m_size)
+    {
+        void* const data{
+            ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, file, 0)};
+        if (MAP_FAILED == data)
+        {
+            ::close(file);
+            Error::Report_Error("Could not read '{}'", p_path);
+        }
+        m_data = static_cast<const char*>(data);
+    }
+
+    // The mapping remains valid once the file is closed.
+    ::close(file);
+}
+
+GILES::Internal::Trace_Index::Mapping::~Mapping()
+{
+    if (nullptr != m_data)
+    {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+GILES::Internal::Trace_Index::Trace_Index(const std::string& p_traces_path,
+                                          const std::string& p_index_path)
+    : m_traces_path{p_traces_path}, m_traces{p_traces_path},
+      m_index{p_index_path}, m_header{}, m_entries{nullptr}
+{
+    const Header expected;
+    if (m_index.Size() < sizeof(Header))
+    {
+        Error::Report_Error("'{}' is not an index saved by GILES",
+                            p_index_path);
+    }
+    std::memcpy(&m_header, m_index.Data(), sizeof(m_header));
+    if (0 != std::memcmp(
+                 m_header.Magic, expected.Magic, sizeof(m_header.Magic)) ||
+        m_header.Version != expected.Version)
+    {
+        Error::Report_Error("'{}' is not an index saved by this version of "
+                            "GILES",
+                            p_index_path);
+    }
+    if (m_index.Size() <
+        sizeof(Header) + m_header.Number_Of_Traces * sizeof(Entry))
+    {
+        Error::Report_Error(
+            "Could not read '{}'. The file may be incomplete", p_index_path);
+    }
+    m_entries = m_index.Data() + sizeof(Header);
+
+    // Traces are usually retrieved in no particular order.
+    if (nullptr != m_traces.Data())
+    {
+        ::madvise(const_cast<char*>(m_traces.Data()),
+                  m_traces.Size(),
+                  MADV_RANDOM);
+    }
+}
+
+//! @brief Retrieves a single entry from the index.
+//! @param p_position The position of the entry within the index.
+//! @returns The entry.
+const GILES::Internal::Trace_Index::Entry
+GILES::Internal::Trace_Index::entry(const std::size_t p_position) const
+{
+    Entry entry;
+    std::memcpy(&entry, m_entries + p_position * sizeof(Entry), sizeof(entry));
+    return entry;
+}
+
+const GILES::Internal::Trace_Index::Entry
+GILES::Internal::Trace_Index::Find(const std::size_t p_run_index) const
+{
+    // Entries are in run order so this is a binary search.
+    std::size_t first{0};
+    std::size_t last{Number_Of_Traces()};
+    while (first < last)
+    {
+        const std::size_t middle{first + (last - first) / 2};
+        if (entry(middle).Run_Index < p_run_index)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    if (first == Number_Of_Traces() || entry(first).Run_Index != p_run_index)
+    {
+        Error::Report_Error("Run {} is not in the index of '{}'",
+                            p_run_index,
+                            m_traces_path);
+    }
+    return entry(first);
+}
+
+std::vector<std::size_t>
+GILES::Internal::Trace_Index::Find(const std::string& p_extra_data) const
+{
+    const auto hash = Hash(p_extra_data);
+
+    std::vector<std::size_t> run_indices;
+    for (std::size_t i{0}; i < Number_Of_Traces(); ++i)
+    {
+        const auto found = entry(i);
+        if (found.Extra_Data_Hash == hash)
+        {
+            run_indices.push_back(static_cast<std::size_t>(found.Run_Index));
+        }
+    }
+    return run_indices;
+}
+
+std::vector<float> GILES::Internal::Trace_Index::Traces(
+    const std::vector<std::size_t>& p_run_indices,
+    const std::size_t p_first_sample,
+    const std::size_t p_number_of_samples) const
+{
+    if (p_first_sample > Number_Of_Samples())
+    {
+        Error::Report_Error("Sample {} was requested but traces in '{}' only "
+                            "have {} samples",
+                            p_first_sample,
+                            m_traces_path,
+                            Number_Of_Samples());
+    }
+    const std::size_t number_of_samples{
+        std::min(p_number_of_samples, Number_Of_Samples() - p_first_sample)};
+    const std::size_t size{number_of_samples * sizeof(float)};
+
+    std::vector<float> samples(p_run_indices.size() * number_of_samples);
+    for (std::size_t i{0}; i < p_run_indices.size(); ++i)
+    {
+        const std::uint64_t offset{Find(p_run_indices[i]).Offset +
+                                   p_first_sample * sizeof(float)};
+        if (offset + size > m_traces.Size())
+        {
+            Error::Report_Error(
+                "Could not read '{}'. The file may be incomplete",
+                m_traces_path);
+        }
+        std::memcpy(samples.data() + i * number_of_samples,
+                    m_traces.Data() + offset,
+                    size);
+    }
+    return samples;
+}
+
+std::uint64_t
+GILES::Internal::Trace_Index::Hash(const std::string& p_extra_data)
+{
+    std::uint64_t hash{0xcbf29ce484222325};
+    for (const auto byte : p_extra_data)
+    {
+        hash ^= static_cast<unsigned char>(byte);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
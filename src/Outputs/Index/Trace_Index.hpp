@@ -0,0 +1,202 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Trace_Index.hpp
+    @brief Contains the Trace_Index class which retrieves traces from a file
+    using the index saved alongside it.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef TRACE_INDEX_HPP
+#define TRACE_INDEX_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t
+#include <limits>   // for numeric_limits
+#include <string>   // for string
+#include <vector>   // for vector
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Trace_Index
+//! @brief Retrieves individual traces, or some of their samples, from a file
+//! saved by GILES without reading the rest of the file. This uses the index
+//! saved by the "Index" Output, which gives the position of every trace within
+//! the file. Both files are memory mapped so only the parts that are used are
+//! read from disk.
+//!
+//! All values in the index are stored little-endian. The index is laid out as:
+//! - A Header.
+//! - An Entry for every trace, in run order.
+class Trace_Index
+{
+public:
+    //! The start of every index.
+    struct Header
+    {
+        char Magic[8]{'G', 'I', 'L', 'E', 'S', 'I', 'D', 'X'};
+        std::uint32_t Version{1};
+        std::uint32_t Reserved{0};
+        std::uint64_t Number_Of_Traces{0};
+        std::uint64_t Number_Of_Samples{0};
+        std::uint64_t Padding[4]{};
+    };
+
+    //! Describes a single trace.
+    struct Entry
+    {
+        std::uint64_t Run_Index;
+
+        //! The position, in bytes, of the first sample of the trace within
+        //! the traces file. Samples are stored as consecutive float32 values.
+        std::uint64_t Offset;
+
+        //! The result of Hash() for the extra data of the trace.
+        std::uint64_t Extra_Data_Hash;
+    };
+
+private:
+    //! A file that has been memory mapped for reading.
+    class Mapping
+    {
+    private:
+        const char* m_data;
+        std::size_t m_size;
+
+    public:
+        explicit Mapping(const std::string& p_path);
+        ~Mapping();
+
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+
+        const char* Data() const { return m_data; }
+        std::size_t Size() const { return m_size; }
+    };
+
+    const std::string m_traces_path;
+    const Mapping m_traces;
+    const Mapping m_index;
+
+    Header m_header;
+
+    //! The first Entry within m_index. Entries are copied out by entry()
+    //! rather than accessed in place.
+    const char* m_entries;
+
+    const Entry entry(const std::size_t p_position) const;
+
+public:
+    //! @brief Opens a traces file and its index.
+    //! @param p_traces_path The path to the traces file.
+    //! @param p_index_path The path to the index of the traces file.
+    Trace_Index(const std::string& p_traces_path,
+                const std::string& p_index_path);
+
+    //! @brief Opens a traces file and the index saved alongside it, at the
+    //! path given by Index_Path().
+    //! @param p_traces_path The path to the traces file.
+    explicit Trace_Index(const std::string& p_traces_path)
+        : Trace_Index(p_traces_path, Index_Path(p_traces_path))
+    {
+    }
+
+    //! The mappings of both files are owned by the Trace_Index, and unmapped
+    //! when it is destroyed, so it can not be copied. Nothing needs to move
+    //! one either, so that is not supported.
+    Trace_Index(const Trace_Index&) = delete;
+    Trace_Index& operator=(const Trace_Index&) = delete;
+
+    //! @brief Retrieves the number of traces in the index.
+    //! @returns The number of traces.
+    std::size_t Number_Of_Traces() const
+    {
+        return static_cast<std::size_t>(m_header.Number_Of_Traces);
+    }
+
+    //! @brief Retrieves the number of samples in every trace.
+    //! @returns The number of samples.
+    std::size_t Number_Of_Samples() const
+    {
+        return static_cast<std::size_t>(m_header.Number_Of_Samples);
+    }
+
+    //! @brief Retrieves the position of a trace within the traces file.
+    //! @param p_run_index The run that generated the trace.
+    //! @returns The Entry describing the trace.
+    const Entry Find(const std::size_t p_run_index) const;
+
+    //! @brief Retrieves the run index of every trace with the given extra
+    //! data. Only the hashes in the index are compared so the traces file is
+    //! not read.
+    //! @param p_extra_data The extra data to look for. e.g. a plaintext.
+    //! @returns The run indices in ascending order.
+    std::vector<std::size_t> Find(const std::string& p_extra_data) const;
+
+    //! @brief Retrieves some or all of the samples of a single trace.
+    //! @param p_run_index The run that generated the trace.
+    //! @param p_first_sample The index of the first sample to retrieve.
+    //! @param p_number_of_samples The number of samples to retrieve. This is
+    //! limited to the samples remaining after p_first_sample.
+    //! @returns The samples.
+    std::vector<float> Trace(const std::size_t p_run_index,
+                             const std::size_t p_first_sample = 0,
+                             const std::size_t p_number_of_samples =
+                                 std::numeric_limits<std::size_t>::max()) const
+    {
+        return Traces({p_run_index}, p_first_sample, p_number_of_samples);
+    }
+
+    //! @brief Retrieves the same samples from several traces. e.g. a column
+    //! of samples from every trace.
+    //! @param p_run_indices The runs that generated the traces.
+    //! @param p_first_sample The index of the first sample to retrieve from
+    //! each trace.
+    //! @param p_number_of_samples The number of samples to retrieve from each
+    //! trace. This is limited to the samples remaining after p_first_sample.
+    //! @returns The samples as a row-major array with one row per run, in the
+    //! order given.
+    std::vector<float>
+    Traces(const std::vector<std::size_t>& p_run_indices,
+           const std::size_t p_first_sample      = 0,
+           const std::size_t p_number_of_samples =
+               std::numeric_limits<std::size_t>::max()) const;
+
+    //! @brief Retrieves the path of the index saved alongside a traces file.
+    //! @param p_traces_path The path to the traces file.
+    //! @returns The path to the index.
+    static const std::string Index_Path(const std::string& p_traces_path)
+    {
+        return p_traces_path + ".idx";
+    }
+
+    //! @brief Hashes extra data, using 64 bit FNV-1a, so that traces can be
+    //! found by their extra data.
+    //! @param p_extra_data The extra data to hash.
+    //! @returns The hash.
+    //! @see http://www.isthe.com/chongo/tech/comp/fnv/
+    static std::uint64_t Hash(const std::string& p_extra_data);
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // TRACE_INDEX_HPP
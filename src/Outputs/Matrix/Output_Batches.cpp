@@ -0,0 +1,80 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Batches.cpp
+    @brief Contains an Output that passes traces to a callback in batches as
+    they are generated.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "Output_Batches.hpp"
+
+//! @brief Passes the batch collected by a thread to the callback, if it holds
+//! any traces, and empties it.
+//! @param p_thread The index of the thread.
+void GILES::Internal::Output_Batches::deliver(const std::size_t p_thread)
+{
+    auto& batch = m_batches[p_thread];
+    if (0 != batch.Rows())
+    {
+        m_callback(batch);
+        batch.Clear();
+    }
+}
+
+void GILES::Internal::Output_Batches::Start(
+    const std::size_t /*p_number_of_runs*/,
+    const std::size_t p_number_of_threads)
+{
+    m_batches.assign(p_number_of_threads, Trace_Matrix{});
+    for (auto& batch : m_batches)
+    {
+        batch.Reserve(m_batch_size);
+    }
+}
+
+void GILES::Internal::Output_Batches::Add_Trace(
+    const std::size_t p_thread,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    m_batches[p_thread].Append(p_run_index, p_trace, p_extra_data);
+    if (m_batches[p_thread].Rows() >= m_batch_size)
+    {
+        deliver(p_thread);
+    }
+}
+
+void GILES::Internal::Output_Batches::Finish()
+{
+    for (std::size_t i{0}; i < m_batches.size(); ++i)
+    {
+        deliver(i);
+    }
+}
+
+void GILES::Internal::Output_Batches::Flush(const std::size_t p_thread)
+{
+    deliver(p_thread);
+}
@@ -0,0 +1,96 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Batches.hpp
+    @brief Contains an Output that passes traces to a callback in batches as
+    they are generated.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_BATCHES_HPP
+#define OUTPUT_BATCHES_HPP
+
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include "Output.hpp"        // for Output
+#include "Trace_Matrix.hpp"  // for Trace_Matrix
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Batches
+//! @brief Passes traces to a callback as they are generated, so that large
+//! numbers of traces can be consumed without keeping them in memory or saving
+//! them to disk. Each thread collects its traces in its own Trace_Matrix,
+//! which is passed to the callback once it holds a batch and is then reused,
+//! so no memory is allocated once the first batch has been filled.
+//! This is constructed by the caller, rather than by name through the
+//! Output_Factory, as it needs the callback. @see GILES::Add_Callback()
+class Output_Batches : public Output
+{
+public:
+    //! @brief Receives a batch of traces. This is called concurrently from
+    //! every thread generating traces, each with its own batch. The batch is
+    //! reused once the callback returns so it must be copied to be kept.
+    //! Runs are shared between threads as they become free so a batch does
+    //! not hold consecutive runs. Trace_Matrix::Run() gives the run of each
+    //! row.
+    using Callback = std::function<void(const Trace_Matrix&)>;
+
+private:
+    const Callback m_callback;
+    const std::size_t m_batch_size;
+
+    //! The batch being collected by each thread.
+    std::vector<Trace_Matrix> m_batches;
+
+    void deliver(const std::size_t p_thread);
+
+public:
+    //! @brief Constructs an Output that passes traces to a callback.
+    //! @param p_callback The callback.
+    //! @param p_batch_size The number of traces in each batch. The last batch
+    //! from each thread may be smaller.
+    Output_Batches(const Callback& p_callback, const std::size_t p_batch_size)
+        : Output{Output_Options{}}, m_callback{p_callback},
+          m_batch_size{p_batch_size > 0 ? p_batch_size : 1}, m_batches{}
+    {
+    }
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    void Flush(const std::size_t p_thread) override;
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_BATCHES_HPP
@@ -0,0 +1,124 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Matrix.cpp
+    @brief Contains an Output that keeps every trace in memory, in a single
+    contiguous matrix.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <mutex>         // for unique_lock
+#include <optional>      // for optional, nullopt
+#include <shared_mutex>  // for shared_lock
+#include <string>        // for string
+#include <utility>       // for move
+#include <vector>        // for vector
+
+#include "Output_Matrix.hpp"
+
+#include "Error.hpp"          // for Report_Error
+#include "Memory_Budget.hpp"  // for Memory_Budget
+
+GILES::Internal::Output_Matrix::~Output_Matrix()
+{
+    Memory_Budget::Remove(m_memory_used);
+}
+
+//! @brief Updates the memory accounted for after the matrix has been resized,
+//! reporting an error if it can not fit within the limit.
+void GILES::Internal::Output_Matrix::account()
+{
+    const std::size_t memory_used{m_matrix.Get_Memory_Used()};
+    Memory_Budget::Add(memory_used);
+    Memory_Budget::Remove(m_memory_used);
+    m_memory_used = memory_used;
+
+    const std::size_t limit{Memory_Budget::Get_Limit()};
+    if (0 != limit && m_memory_used > limit)
+    {
+        Error::Report_Error("Keeping every trace in memory needs {} MB, which "
+                            "is more than the memory limit of {} MB",
+                            m_memory_used / (1024 * 1024),
+                            limit / (1024 * 1024));
+    }
+}
+
+void GILES::Internal::Output_Matrix::Start(
+    const std::size_t p_number_of_runs,
+    const std::size_t /*p_number_of_threads*/)
+{
+    m_matrix.Clear();
+    m_matrix.Widen(m_trace_length, m_extra_data_size);
+    m_matrix.Resize(p_number_of_runs);
+    account();
+}
+
+void GILES::Internal::Output_Matrix::Add_Trace(
+    const std::size_t /*p_thread*/,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    {
+        const std::shared_lock<std::shared_mutex> lock{m_mutex};
+        if (m_matrix.Fits(p_trace, p_extra_data))
+        {
+            m_matrix.Set(p_run_index, p_run_index, p_trace, p_extra_data);
+            return;
+        }
+    }
+
+    // Only the first trace, or one longer than every trace before it, needs
+    // the matrix to be widened.
+    const std::unique_lock<std::shared_mutex> lock{m_mutex};
+    m_matrix.Widen(p_trace.size(), p_extra_data.size());
+    account();
+    m_matrix.Set(p_run_index, p_run_index, p_trace, p_extra_data);
+}
+
+//! @brief Retrieves the row of a run so that its trace can be generated
+//! straight into the matrix. Every row is allocated up front once the size of
+//! the traces has been given, so this only fails for a trace longer than
+//! expected.
+//! @param p_run_index The index of the run.
+//! @param p_trace_length The number of samples in the trace.
+//! @param p_extra_data_size The number of bytes of extra data of the trace.
+//! @returns The row, or nothing if the trace does not fit, in which case it
+//! is to be added using Add_Trace().
+std::optional<GILES::Internal::Output_Matrix::Row>
+GILES::Internal::Output_Matrix::Take_Row(const std::size_t p_run_index,
+                                         const std::size_t p_trace_length,
+                                         const std::size_t p_extra_data_size)
+{
+    std::shared_lock<std::shared_mutex> lock{m_mutex};
+    if (!m_matrix.Fits(p_trace_length, p_extra_data_size))
+    {
+        return std::nullopt;
+    }
+    return Row{std::move(lock), m_matrix, p_run_index};
+}
+
+//! @brief Removes the rows of the runs that were never started.
+//! @param p_number_of_runs The number of runs that were completed.
+void GILES::Internal::Output_Matrix::Stopped(const std::size_t p_number_of_runs)
+{
+    m_matrix.Resize(p_number_of_runs);
+    account();
+}
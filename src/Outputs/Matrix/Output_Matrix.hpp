@@ -0,0 +1,158 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Matrix.hpp
+    @brief Contains an Output that keeps every trace in memory, in a single
+    contiguous matrix.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_MATRIX_HPP
+#define OUTPUT_MATRIX_HPP
+
+#include <cstddef>       // for size_t
+#include <optional>      // for optional
+#include <shared_mutex>  // for shared_mutex, shared_lock
+#include <string>        // for string
+#include <utility>       // for move
+#include <vector>        // for vector
+
+#include "Output.hpp"        // for Output
+#include "Trace_Matrix.hpp"  // for Trace_Matrix
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Matrix
+//! @brief Keeps every trace in memory so that GILES can be used as a library
+//! without saving traces to disk. Row i of the matrix holds the trace of run
+//! i, so the whole matrix is allocated at once. This is done by Start() if the
+//! size of the traces has been given, otherwise once the size of the first
+//! trace is known. Rows for runs that were skipped, when resuming, are left
+//! empty.
+//! This is constructed by the caller, rather than by name through the
+//! Output_Factory, as the matrix is read back once traces have been
+//! generated. @see GILES::Collect_Traces()
+//! The matrix is accounted for by the Memory_Budget. As it is only freed
+//! once it is no longer needed, an error is reported if it does not fit
+//! within the limit rather than waiting for it to be freed.
+class Output_Matrix : public Output
+{
+private:
+    Trace_Matrix m_matrix;
+
+    //! The bytes of m_matrix accounted for by the Memory_Budget.
+    std::size_t m_memory_used;
+
+    //! The number of samples each trace is expected to have, or 0 if unknown.
+    std::size_t m_trace_length;
+
+    //! The number of bytes of extra data each trace is expected to have.
+    std::size_t m_extra_data_size;
+
+    //! Threads set their own rows while holding this shared. It is only held
+    //! exclusively while the matrix is widened.
+    std::shared_mutex m_mutex;
+
+    void account();
+
+public:
+    //! @class Row
+    //! @brief The row of a run, which the model writes the trace of the run
+    //! straight into rather than the trace being copied in by Add_Trace().
+    //! The matrix is not widened while this exists.
+    class Row
+    {
+    private:
+        std::shared_lock<std::shared_mutex> m_lock;
+        Trace_Matrix& m_matrix;
+        const std::size_t m_run_index;
+
+    public:
+        Row(std::shared_lock<std::shared_mutex>&& p_lock,
+            Trace_Matrix& p_matrix,
+            const std::size_t p_run_index)
+            : m_lock{std::move(p_lock)}, m_matrix{p_matrix},
+              m_run_index{p_run_index}
+        {
+        }
+
+        //! @returns The first sample of the row.
+        float* Samples() { return m_matrix.Row(m_run_index); }
+
+        //! @brief Completes the row once the trace has been written, in place
+        //! of Add_Trace().
+        //! @param p_length The number of samples written.
+        //! @param p_extra_data The extra data of the trace.
+        void Complete(const std::size_t p_length,
+                      const std::string& p_extra_data)
+        {
+            m_matrix.Complete(m_run_index, m_run_index, p_length, p_extra_data);
+        }
+    };
+
+    Output_Matrix()
+        : Output{Output_Options{}}, m_matrix{}, m_memory_used{0},
+          m_trace_length{0}, m_extra_data_size{0}, m_mutex{}
+    {
+    }
+
+    ~Output_Matrix() override;
+
+    Output_Matrix(const Output_Matrix&) = delete;
+    Output_Matrix& operator=(const Output_Matrix&) = delete;
+
+    //! @brief Gives the size that each trace is expected to have, so that
+    //! Start() can allocate the whole matrix before any traces are generated.
+    //! Longer traces, or more extra data, still widen the matrix.
+    //! @param p_trace_length The number of samples.
+    //! @param p_extra_data_size The number of bytes of extra data.
+    void Set_Trace_Size(const std::size_t p_trace_length,
+                        const std::size_t p_extra_data_size)
+    {
+        m_trace_length    = p_trace_length;
+        m_extra_data_size = p_extra_data_size;
+    }
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    std::optional<Row> Take_Row(const std::size_t p_run_index,
+                                const std::size_t p_trace_length,
+                                const std::size_t p_extra_data_size);
+
+    void Stopped(const std::size_t p_number_of_runs) override;
+
+    void Finish() override {}
+
+    //! @returns The traces. This must not be used while traces are being
+    //! added.
+    const Trace_Matrix& Get_Matrix() const { return m_matrix; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_MATRIX_HPP
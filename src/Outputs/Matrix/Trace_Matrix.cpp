@@ -0,0 +1,164 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Trace_Matrix.cpp
+    @brief Contains the Trace_Matrix class which holds traces in a single
+    contiguous block of memory.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for copy, fill, max
+#include <cstddef>    // for size_t
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include "Trace_Matrix.hpp"
+
+//! @brief Allocates enough memory for a number of rows, at the current
+//! stride, so that appending them does not allocate.
+//! @param p_rows The number of rows.
+void GILES::Internal::Trace_Matrix::Reserve(const std::size_t p_rows)
+{
+    m_samples.reserve(p_rows * m_stride);
+    m_lengths.reserve(p_rows);
+    m_runs.reserve(p_rows);
+    m_extra_data.reserve(p_rows * m_extra_data_stride);
+    m_extra_data_lengths.reserve(p_rows);
+}
+
+//! @brief Changes the number of rows. Any new rows are empty.
+//! @param p_rows The number of rows.
+void GILES::Internal::Trace_Matrix::Resize(const std::size_t p_rows)
+{
+    m_samples.resize(p_rows * m_stride);
+    m_lengths.resize(p_rows);
+    m_runs.resize(p_rows);
+    m_extra_data.resize(p_rows * m_extra_data_stride);
+    m_extra_data_lengths.resize(p_rows);
+}
+
+//! @brief Increases the stride of the samples and extra data, moving every
+//! row to its new position. This is only needed when a trace is longer than
+//! any before it so the cost is only paid for the first few traces.
+//! @param p_stride The number of samples between the start of each row. This
+//! is not reduced if it is lower than the current stride.
+//! @param p_extra_data_stride The number of bytes between the start of the
+//! extra data of each row. This is not reduced if it is lower than the
+//! current stride.
+void GILES::Internal::Trace_Matrix::Widen(
+    const std::size_t p_stride, const std::size_t p_extra_data_stride)
+{
+    const std::size_t stride{std::max(m_stride, p_stride)};
+    if (stride != m_stride)
+    {
+        // Keep the rows reserved so that appending them still does not
+        // allocate.
+        std::vector<float> samples;
+        samples.reserve(m_lengths.capacity() * stride);
+        samples.resize(Rows() * stride);
+        for (std::size_t i{0}; i < Rows(); ++i)
+        {
+            std::copy(Row(i), Row(i) + m_lengths[i], &samples[i * stride]);
+        }
+        m_samples.swap(samples);
+        m_stride = stride;
+    }
+
+    const std::size_t extra_data_stride{
+        std::max(m_extra_data_stride, p_extra_data_stride)};
+    if (extra_data_stride != m_extra_data_stride)
+    {
+        std::string extra_data;
+        extra_data.reserve(m_lengths.capacity() * extra_data_stride);
+        extra_data.resize(Rows() * extra_data_stride);
+        for (std::size_t i{0}; i < Rows(); ++i)
+        {
+            const auto row = Extra_Data(i);
+            std::copy(
+                row.begin(), row.end(), &extra_data[i * extra_data_stride]);
+        }
+        m_extra_data.swap(extra_data);
+        m_extra_data_stride = extra_data_stride;
+    }
+}
+
+//! @brief Places a trace in a row. Rows can be set concurrently, provided
+//! that each thread sets a different row and the matrix is not resized or
+//! widened at the same time.
+//! @param p_row The index of the row.
+//! @param p_run_index The index of the run that generated the trace.
+//! @param p_trace The trace. This must fit within the stride.
+//! @param p_extra_data The extra data of the trace. This must fit within the
+//! extra data stride.
+//! @see Fits()
+void GILES::Internal::Trace_Matrix::Set(const std::size_t p_row,
+                                        const std::size_t p_run_index,
+                                        const std::vector<float>& p_trace,
+                                        const std::string& p_extra_data)
+{
+    std::copy(p_trace.begin(), p_trace.end(), Row(p_row));
+    Complete(p_row, p_run_index, p_trace.size(), p_extra_data);
+}
+
+//! @brief Completes a row whose trace has been written straight into it,
+//! through Row(), rather than by Set(). The same rules as Set() apply.
+//! @param p_row The index of the row.
+//! @param p_run_index The index of the run that generated the trace.
+//! @param p_length The number of samples written. This must fit within the
+//! stride.
+//! @param p_extra_data The extra data of the trace. This must fit within the
+//! extra data stride.
+void GILES::Internal::Trace_Matrix::Complete(const std::size_t p_row,
+                                             const std::size_t p_run_index,
+                                             const std::size_t p_length,
+                                             const std::string& p_extra_data)
+{
+    float* const row{Row(p_row)};
+    std::fill(row + p_length, row + m_stride, 0.0f);
+    m_lengths[p_row] = p_length;
+    m_runs[p_row]    = p_run_index;
+
+    std::copy(p_extra_data.begin(),
+              p_extra_data.end(),
+              m_extra_data.data() + p_row * m_extra_data_stride);
+    m_extra_data_lengths[p_row] = p_extra_data.size();
+}
+
+//! @brief Adds a trace as a new row, widening the matrix if needed. Once
+//! enough memory has been reserved and the matrix is wide enough, this does
+//! not allocate.
+//! @param p_run_index The index of the run that generated the trace.
+//! @param p_trace The trace.
+//! @param p_extra_data The extra data of the trace.
+void GILES::Internal::Trace_Matrix::Append(const std::size_t p_run_index,
+                                           const std::vector<float>& p_trace,
+                                           const std::string& p_extra_data)
+{
+    if (!Fits(p_trace, p_extra_data))
+    {
+        Widen(p_trace.size(), p_extra_data.size());
+    }
+    Resize(Rows() + 1);
+    Set(Rows() - 1, p_run_index, p_trace, p_extra_data);
+}
+
+//! @brief Removes every row. The stride and the memory allocated are kept so
+//! that the matrix can be refilled without allocating.
+void GILES::Internal::Trace_Matrix::Clear() { Resize(0); }
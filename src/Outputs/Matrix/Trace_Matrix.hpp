@@ -0,0 +1,163 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Trace_Matrix.hpp
+    @brief Contains the Trace_Matrix class which holds traces in a single
+    contiguous block of memory.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef TRACE_MATRIX_HPP
+#define TRACE_MATRIX_HPP
+
+#include <cstddef>      // for size_t
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Trace_Matrix
+//! @brief Holds traces as the rows of a single row-major matrix, so that they
+//! can be passed to analysis code without copying each trace. Row i starts at
+//! Data() + i * Stride(). Traces shorter than the stride, from a target that
+//! does not run in constant time, are padded with zeros and Length() gives
+//! the number of samples actually generated. The extra data of each row is
+//! held in the same way.
+class Trace_Matrix
+{
+private:
+    std::size_t m_stride;
+    std::vector<float> m_samples;
+    std::vector<std::size_t> m_lengths;
+
+    //! The run that generated each row.
+    std::vector<std::size_t> m_runs;
+
+    std::size_t m_extra_data_stride;
+    std::string m_extra_data;
+    std::vector<std::size_t> m_extra_data_lengths;
+
+public:
+    Trace_Matrix()
+        : m_stride{0}, m_samples{}, m_lengths{}, m_runs{},
+          m_extra_data_stride{0}, m_extra_data{}, m_extra_data_lengths{}
+    {
+    }
+
+    //! @returns The number of rows, i.e. traces.
+    std::size_t Rows() const { return m_lengths.size(); }
+
+    //! @returns The number of samples between the start of each row.
+    std::size_t Stride() const { return m_stride; }
+
+    //! @returns The first sample of the first row.
+    const float* Data() const { return m_samples.data(); }
+
+    //! @param p_row The index of the row.
+    //! @returns The first sample of the row.
+    const float* Row(const std::size_t p_row) const
+    {
+        return m_samples.data() + p_row * m_stride;
+    }
+
+    //! @param p_row The index of the row.
+    //! @returns The first sample of the row, for a trace to be written
+    //! straight into. @see Complete()
+    float* Row(const std::size_t p_row)
+    {
+        return m_samples.data() + p_row * m_stride;
+    }
+
+    //! @param p_row The index of the row.
+    //! @returns The number of samples in the trace held by the row.
+    std::size_t Length(const std::size_t p_row) const
+    {
+        return m_lengths[p_row];
+    }
+
+    //! @param p_row The index of the row.
+    //! @returns The index of the run that generated the trace held by the row.
+    std::size_t Run(const std::size_t p_row) const { return m_runs[p_row]; }
+
+    //! @param p_row The index of the row.
+    //! @returns The extra data of the trace held by the row.
+    std::string_view Extra_Data(const std::size_t p_row) const
+    {
+        return {m_extra_data.data() + p_row * m_extra_data_stride,
+                m_extra_data_lengths[p_row]};
+    }
+
+    //! @returns Whether a trace and its extra data can be placed in a row
+    //! without widening the matrix.
+    bool Fits(const std::vector<float>& p_trace,
+              const std::string& p_extra_data) const
+    {
+        return Fits(p_trace.size(), p_extra_data.size());
+    }
+
+    //! @returns Whether a trace of p_length samples and p_extra_data_size
+    //! bytes of extra data can be placed in a row without widening the
+    //! matrix.
+    bool Fits(const std::size_t p_length,
+              const std::size_t p_extra_data_size) const
+    {
+        return p_length <= m_stride && p_extra_data_size <= m_extra_data_stride;
+    }
+
+    //! @returns The number of bytes allocated to hold the rows.
+    std::size_t Get_Memory_Used() const
+    {
+        return m_samples.capacity() * sizeof(float) +
+               (m_lengths.capacity() + m_runs.capacity() +
+                m_extra_data_lengths.capacity()) *
+                   sizeof(std::size_t) +
+               m_extra_data.capacity();
+    }
+
+    void Reserve(const std::size_t p_rows);
+
+    void Resize(const std::size_t p_rows);
+
+    void Widen(const std::size_t p_stride,
+               const std::size_t p_extra_data_stride);
+
+    void Set(const std::size_t p_row,
+             const std::size_t p_run_index,
+             const std::vector<float>& p_trace,
+             const std::string& p_extra_data);
+
+    void Complete(const std::size_t p_row,
+                  const std::size_t p_run_index,
+                  const std::size_t p_length,
+                  const std::string& p_extra_data);
+
+    void Append(const std::size_t p_run_index,
+                const std::vector<float>& p_trace,
+                const std::string& p_extra_data);
+
+    void Clear();
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // TRACE_MATRIX_HPP
@@ -0,0 +1,321 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_NumPy.cpp
+    @brief Contains Outputs that save traces as a plain array of float32 values,
+    either as a NumPy .npy file or without any header at all.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for min
+#include <cstdint>    // for uint64_t
+#include <cstdio>     // for sscanf
+#include <fstream>    // for ifstream
+#include <memory>     // for make_unique
+#include <mutex>      // for call_once
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include <fmt/format.h>  // for format, print
+
+#include "Output_NumPy.hpp"
+
+#include "Error.hpp"  // for Report_Error
+
+namespace
+{
+//! Each thread writes its traces once they fill this many bytes.
+constexpr std::size_t block_size{4 * 1024 * 1024};
+
+//! @brief Reads the shape of the 2D array in a .npy file saved by GILES.
+//! @param p_path The path to the file.
+//! @param p_rows Where to store the number of rows.
+//! @param p_columns Where to store the number of elements in each row.
+//! @returns true if the file has a complete header, false if not.
+bool read_shape(const std::string& p_path,
+                std::size_t* const p_rows,
+                std::size_t* const p_columns)
+{
+    std::ifstream file{p_path, std::ios::binary};
+    std::string header(GILES::Internal::Output_NumPy::Header_Size, '\0');
+    file.read(&header[0], static_cast<std::streamsize>(header.size()));
+
+    const auto shape = header.find("'shape': (");
+    return file && 0 == header.compare(0, 6, "\x93NUMPY") &&
+           std::string::npos != shape &&
+           2 == std::sscanf(header.c_str() + shape,
+                            "'shape': (%zu, %zu)",
+                            p_rows,
+                            p_columns);
+}
+}  // namespace
+
+template <typename derived_t>
+GILES::Internal::Output_Array<derived_t>::Output_Array(
+    const Output_Options& p_options,
+    const bool p_header,
+    const std::string& p_extra_data_extension)
+    : Output_Interface<derived_t>{p_options}, m_header{p_header},
+      m_extra_data_path{p_options.Path + p_extra_data_extension}, m_file{},
+      m_extra_data_file{}, m_blocks{}, m_number_of_runs{0},
+      m_number_of_samples{0}, m_extra_data_width{0}, m_sizes_resolved{},
+      m_traces_added{false}
+{
+}
+
+//! @brief Retrieves the position of the first row in both files.
+//! @returns The size of the header, if there is one.
+template <typename derived_t>
+std::uint64_t GILES::Internal::Output_Array<derived_t>::data_offset() const
+{
+    return m_header ? Output_NumPy::Header_Size : 0;
+}
+
+//! @brief Writes the traces and extra data held in p_block to the rows given
+//! by their run indices. The block is then emptied, ready to be reused.
+//! @param p_block The block to write.
+template <typename derived_t>
+void GILES::Internal::Output_Array<derived_t>::write_block(
+    Block* const p_block) const
+{
+    if (p_block->Traces.empty())
+    {
+        return;
+    }
+
+    m_file->Write(p_block->Traces.data(),
+                  p_block->Traces.size() * sizeof(float),
+                  data_offset() +
+                      p_block->First_Run * m_number_of_samples * sizeof(float));
+    m_extra_data_file->Write(
+        p_block->Extra_Data.data(),
+        p_block->Extra_Data.size(),
+        data_offset() + p_block->First_Run * m_extra_data_width);
+
+    p_block->Traces.clear();
+    p_block->Extra_Data.clear();
+}
+
+//! @brief Recovers the number of samples and the width of the extra data from
+//! the files saved by an interrupted run. These are only used if no traces
+//! are added when resuming. They are read from the headers, if the run was
+//! finished, and otherwise from the sizes of the files.
+template <typename derived_t>
+void GILES::Internal::Output_Array<derived_t>::restore_sizes()
+{
+    std::size_t rows{0};
+    if (m_header &&
+        read_shape(this->m_options.Path, &rows, &m_number_of_samples) &&
+        read_shape(m_extra_data_path, &rows, &m_extra_data_width))
+    {
+        return;
+    }
+
+    // Files that were never sized by Add_Trace() hold no traces.
+    if (0 != m_number_of_runs && m_file->Position() > data_offset())
+    {
+        m_number_of_samples = (m_file->Position() - data_offset()) /
+                              (m_number_of_runs * sizeof(float));
+        m_extra_data_width =
+            (m_extra_data_file->Position() - data_offset()) / m_number_of_runs;
+    }
+}
+
+//! @brief Opens both files and creates one block for every thread. When
+//! resuming, the existing files are kept.
+//! @param p_number_of_runs The number of rows in both arrays.
+//! @param p_number_of_threads The number of threads that will add traces.
+template <typename derived_t>
+void GILES::Internal::Output_Array<derived_t>::Start(
+    const std::size_t p_number_of_runs, const std::size_t p_number_of_threads)
+{
+    m_number_of_runs = p_number_of_runs;
+
+    m_file            = std::make_unique<Writer>(this->m_options.Path,
+                                      this->m_options.Write_Budget,
+                                      this->m_options.Resume);
+    m_extra_data_file = std::make_unique<Writer>(m_extra_data_path,
+                                                 this->m_options.Write_Budget,
+                                                 this->m_options.Resume);
+    if (this->m_options.Resume)
+    {
+        restore_sizes();
+    }
+
+    m_blocks.assign(p_number_of_threads, Block{});
+}
+
+//! @brief Adds a trace to the block belonging to the calling thread. The block
+//! is written first if this trace does not directly follow it and is written
+//! afterwards if it is full.
+template <typename derived_t>
+void GILES::Internal::Output_Array<derived_t>::Add_Trace(
+    const std::size_t p_thread,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    std::call_once(m_sizes_resolved, [this, &p_trace, &p_extra_data] {
+        m_number_of_samples = p_trace.size();
+        m_extra_data_width  = p_extra_data.size();
+        m_traces_added      = true;
+
+        // Sizing both files now means a run that is interrupted leaves them at
+        // their final sizes, from which the sizes above can be recovered.
+        m_file->Resize(data_offset() +
+                       m_number_of_runs * m_number_of_samples * sizeof(float));
+        m_extra_data_file->Resize(data_offset() +
+                                  m_number_of_runs * m_extra_data_width);
+    });
+
+    if (p_trace.size() != m_number_of_samples)
+    {
+        Error::Report_Error("The {} format requires every trace to be the same "
+                            "length. Trace {} has {} samples but {} were "
+                            "expected.",
+                            derived_t::Get_Name(),
+                            p_run_index,
+                            p_trace.size(),
+                            m_number_of_samples);
+    }
+    if (p_extra_data.size() > m_extra_data_width)
+    {
+        Error::Report_Error("The {} format stores extra data with a fixed "
+                            "width, taken from the first trace. Trace {} has "
+                            "{} bytes of extra data but at most {} can be "
+                            "stored.",
+                            derived_t::Get_Name(),
+                            p_run_index,
+                            p_extra_data.size(),
+                            m_extra_data_width);
+    }
+    if (p_run_index >= m_number_of_runs)
+    {
+        Error::Report_Error("Trace {} is outside of the {} runs given to the "
+                            "{} format",
+                            p_run_index,
+                            m_number_of_runs,
+                            derived_t::Get_Name());
+    }
+
+    auto& block = m_blocks.at(p_thread);
+    const std::size_t traces_in_block{
+        0 == m_number_of_samples ? 0
+                                 : block.Traces.size() / m_number_of_samples};
+    if (block.Traces.empty() ||
+        p_run_index != block.First_Run + traces_in_block)
+    {
+        write_block(&block);
+        block.First_Run = p_run_index;
+    }
+
+    block.Traces.insert(block.Traces.end(), p_trace.begin(), p_trace.end());
+    block.Extra_Data.insert(
+        block.Extra_Data.end(), p_extra_data.begin(), p_extra_data.end());
+    block.Extra_Data.resize(block.Extra_Data.size() + m_extra_data_width -
+                            p_extra_data.size());
+
+    if (block.Traces.size() * sizeof(float) >= block_size)
+    {
+        write_block(&block);
+    }
+}
+
+//! @brief Writes any partially filled blocks and the headers. Both files are
+//! sized to hold every run so that any run that did not produce a trace is
+//! left as a row of zeros.
+template <typename derived_t>
+void GILES::Internal::Output_Array<derived_t>::Finish()
+{
+    for (auto& block : m_blocks)
+    {
+        write_block(&block);
+    }
+    m_blocks.clear();
+
+    if (m_header)
+    {
+        const auto trace_header =
+            Output_NumPy::Header("<f4", m_number_of_runs, m_number_of_samples);
+        m_file->Write(trace_header.data(), trace_header.size(), 0);
+        const auto extra_data_header =
+            Output_NumPy::Header("|u1", m_number_of_runs, m_extra_data_width);
+        m_extra_data_file->Write(
+            extra_data_header.data(), extra_data_header.size(), 0);
+    }
+
+    m_file->Resize(data_offset() +
+                   m_number_of_runs * m_number_of_samples * sizeof(float));
+    m_extra_data_file->Resize(data_offset() +
+                              m_number_of_runs * m_extra_data_width);
+    m_file->Close();
+    m_extra_data_file->Close();
+
+    if (!m_header)
+    {
+        fmt::print("Saved {} traces of {} float32 samples, with {} bytes of "
+                   "extra data each\n",
+                   m_number_of_runs,
+                   m_number_of_samples,
+                   m_extra_data_width);
+    }
+}
+
+//! @brief Reduces the number of rows in both arrays to the number of runs
+//! that were completed.
+template <typename derived_t>
+void GILES::Internal::Output_Array<derived_t>::Stopped(
+    const std::size_t p_number_of_runs)
+{
+    m_number_of_runs = std::min(m_number_of_runs, p_number_of_runs);
+}
+
+//! @brief Writes the block belonging to the calling thread and waits until
+//! everything given to both files has been written.
+template <typename derived_t>
+void GILES::Internal::Output_Array<derived_t>::Flush(
+    const std::size_t p_thread)
+{
+    write_block(&m_blocks.at(p_thread));
+    m_file->Flush();
+    m_extra_data_file->Flush();
+}
+
+const std::string GILES::Internal::Output_NumPy::Header(
+    const std::string& p_type,
+    const std::size_t p_rows,
+    const std::size_t p_columns)
+{
+    std::string header{"\x93NUMPY\x01\x00", 8};
+    header += static_cast<char>((Header_Size - 10) & 0xFF);
+    header += static_cast<char>((Header_Size - 10) >> 8);
+    header += fmt::format(
+        "{{'descr': '{}', 'fortran_order': False, 'shape': ({}, {}), }}",
+        p_type,
+        p_rows,
+        p_columns);
+    header.resize(Header_Size - 1, ' ');
+    header += '\n';
+    return header;
+}
+
+// Only these Outputs use this implementation, so it is compiled here once.
+template class GILES::Internal::Output_Array<GILES::Internal::Output_NumPy>;
+template class GILES::Internal::Output_Array<GILES::Internal::Output_Raw>;
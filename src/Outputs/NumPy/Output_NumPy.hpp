@@ -0,0 +1,206 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_NumPy.hpp
+    @brief Contains Outputs that save traces as a plain array of float32 values,
+    either as a NumPy .npy file or without any header at all.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_NUMPY_HPP
+#define OUTPUT_NUMPY_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <memory>   // for unique_ptr
+#include <mutex>    // for once_flag
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output.hpp"  // for Output_Interface
+#include "Writer.hpp"  // for Writer
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Array
+//! @brief The implementation shared by Output_NumPy and Output_Raw. Traces are
+//! stored as a single row-major array of little-endian float32 values with one
+//! row per run. The row of each trace is given by its run index, so the order
+//! that runs finish in does not matter and no sorting or locking is needed.
+//! Each thread collects consecutive runs into a block which is handed to a
+//! Writer as a single write once it is full or the next run is not
+//! consecutive.
+//!
+//! The extra data is saved alongside as a second array of bytes, with one row
+//! per run. Every row is as wide as the extra data of the first trace and
+//! shorter extra data is padded with zeros.
+//! @tparam derived_t The Output that is using this implementation.
+//! @note Every trace must contain the same number of samples.
+template <typename derived_t>
+class Output_Array : public Output_Interface<derived_t>
+{
+private:
+    //! The consecutive runs collected by a single thread that have not been
+    //! written.
+    struct Block
+    {
+        //! The run index of the first trace in the block.
+        std::size_t First_Run{0};
+
+        std::vector<float> Traces{};
+        std::vector<char> Extra_Data{};
+    };
+
+    //! Whether or not a .npy header is written before each array.
+    const bool m_header;
+
+    //! The path that the extra data is saved to.
+    const std::string m_extra_data_path;
+
+    //! Write the trace and extra data files in the background.
+    std::unique_ptr<Writer> m_file;
+    std::unique_ptr<Writer> m_extra_data_file;
+
+    //! One block per thread so that collecting traces needs no locking.
+    std::vector<Block> m_blocks;
+
+    //! The number of rows in both arrays.
+    std::size_t m_number_of_runs;
+
+    //! The number of samples in every trace and the width of the extra data,
+    //! both taken from the first trace.
+    std::size_t m_number_of_samples;
+    std::size_t m_extra_data_width;
+
+    //! Ensures the sizes above are only set once.
+    std::once_flag m_sizes_resolved;
+
+    //! Whether any traces have been added. The sizes above are taken from the
+    //! first trace, or from the files saved by an interrupted run if no traces
+    //! are added when resuming.
+    bool m_traces_added;
+
+    void restore_sizes();
+
+    std::uint64_t data_offset() const;
+
+    void write_block(Block* const p_block) const;
+
+protected:
+    //! @brief This constructor is marked as protected as it should only be
+    //! called by derived classes to assist with initialisation.
+    //! @param p_options The settings for this Output.
+    //! @param p_header Whether or not a .npy header is written before each
+    //! array.
+    //! @param p_extra_data_extension The extension added to the path to give
+    //! the path of the extra data.
+    Output_Array(const Output_Options& p_options,
+                 const bool p_header,
+                 const std::string& p_extra_data_extension);
+
+public:
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    void Flush(const std::size_t p_thread) override;
+
+    void Stopped(const std::size_t p_number_of_runs) override;
+
+    //! @brief Both files are sized to hold every run as soon as the first
+    //! trace is added, so an interrupted run can be continued by filling in
+    //! the remaining rows.
+    //! @returns true.
+    bool Resumable() const override { return true; }
+};
+
+//! @class Output_NumPy
+//! @brief Saves the generated traces as a NumPy .npy file of shape
+//! (runs, samples). The extra data is saved at the same path with ".extra.npy"
+//! appended, with the shape (runs, extra data length). Both can be opened
+//! without reading them into memory using np.load(path, mmap_mode='r').
+//! @see https://numpy.org/doc/stable/reference/generated/numpy.lib.format.html
+class Output_NumPy : public Output_Array<Output_NumPy>
+{
+public:
+    //! @brief Constructs an Output that will save to the path given in
+    //! p_options.
+    //! @param p_options The settings for this Output.
+    explicit Output_NumPy(const Output_Options& p_options)
+        : Output_Array{p_options, true, ".extra.npy"}
+    {
+    }
+
+    //! @brief Retrieves the name of this Output.
+    //! @returns The name as a string.
+    //! @note This is needed to ensure self registration in the factory
+    //! works. The factory registration requires this as unique identifier.
+    static const std::string Get_Name() { return "NumPy"; }
+
+    //! The size of every .npy header written by GILES. This is fixed, rather
+    //! than fitted to the header text, so that traces can be written to their
+    //! final position before the number of samples is known. It is a multiple
+    //! of 64 as NumPy requires.
+    static constexpr std::size_t Header_Size{128};
+
+    //! @brief Creates a .npy version 1.0 header describing a 2D array.
+    //! @param p_type The NumPy type string of each element.
+    //! @param p_rows The number of rows.
+    //! @param p_columns The number of elements in each row.
+    //! @returns The header, exactly Header_Size bytes long.
+    static const std::string Header(const std::string& p_type,
+                                    const std::size_t p_rows,
+                                    const std::size_t p_columns);
+};
+
+//! @class Output_Raw
+//! @brief Saves the generated traces as raw float32 values without a header.
+//! The extra data is saved at the same path with ".extra" appended. The number
+//! of samples and the width of the extra data are printed once saving
+//! completes as they are needed in order to read the files.
+class Output_Raw : public Output_Array<Output_Raw>
+{
+public:
+    //! @brief Constructs an Output that will save to the path given in
+    //! p_options.
+    //! @param p_options The settings for this Output.
+    explicit Output_Raw(const Output_Options& p_options)
+        : Output_Array{p_options, false, ".extra"}
+    {
+    }
+
+    //! @brief Retrieves the name of this Output.
+    //! @returns The name as a string.
+    //! @note This is needed to ensure self registration in the factory
+    //! works. The factory registration requires this as unique identifier.
+    static const std::string Get_Name() { return "Raw"; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_NUMPY_HPP
@@ -0,0 +1,120 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Ordered.cpp
+    @brief Contains an Output that hands traces over one at a time, in run
+    order, while a bounded number of runs are generated ahead.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <mutex>    // for lock_guard, unique_lock
+#include <string>   // for string
+#include <utility>  // for swap
+#include <vector>   // for vector
+
+#include "Output_Ordered.hpp"
+
+void GILES::Internal::Output_Ordered::Start(
+    const std::size_t /*p_number_of_runs*/,
+    const std::size_t /*p_number_of_threads*/)
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    m_next = 0;
+    for (auto& slot : m_slots)
+    {
+        slot.Ready = false;
+    }
+}
+
+//! @brief Adds a trace, first waiting until its run is within the window.
+//! The trace is dropped if traces are no longer being taken.
+void GILES::Internal::Output_Ordered::Add_Trace(
+    const std::size_t /*p_thread*/,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_condition.wait(lock, [this, p_run_index] {
+        return m_closed || p_run_index < m_next + m_slots.size();
+    });
+    if (m_closed)
+    {
+        return;
+    }
+
+    // The slot is not touched by anything else until it is ready, as its
+    // previous run has been taken, so it is filled without holding the lock.
+    // Its memory is reused so this only allocates for the first few traces.
+    auto& slot = m_slots[p_run_index % m_slots.size()];
+    lock.unlock();
+    slot.Value.Run = p_run_index;
+    slot.Value.Samples.assign(p_trace.begin(), p_trace.end());
+    slot.Value.Extra_Data.assign(p_extra_data);
+    lock.lock();
+
+    slot.Ready = true;
+    lock.unlock();
+    m_condition.notify_all();
+}
+
+//! @brief Marks that no more traces will be added. This may be called more
+//! than once.
+void GILES::Internal::Output_Ordered::Finish()
+{
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_finished = true;
+    }
+    m_condition.notify_all();
+}
+
+//! @brief Takes the trace of the next run, waiting for it to be added.
+//! @param p_trace Where to store the trace. Its memory is swapped with that of
+//! the trace taken, so reusing the same Trace avoids allocating.
+//! @returns true if a trace was taken, false if there are no more traces.
+bool GILES::Internal::Output_Ordered::Take(Trace* const p_trace)
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    auto& slot = m_slots[m_next % m_slots.size()];
+    m_condition.wait(lock, [this, &slot] { return slot.Ready || m_finished; });
+    if (!slot.Ready)
+    {
+        return false;
+    }
+
+    std::swap(*p_trace, slot.Value);
+    slot.Ready = false;
+    ++m_next;
+    lock.unlock();
+    m_condition.notify_all();
+    return true;
+}
+
+//! @brief Marks that no more traces will be taken, so that threads waiting to
+//! add traces stop waiting.
+void GILES::Internal::Output_Ordered::Close()
+{
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_closed = true;
+    }
+    m_condition.notify_all();
+}
@@ -0,0 +1,114 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Ordered.hpp
+    @brief Contains an Output that hands traces over one at a time, in run
+    order, while a bounded number of runs are generated ahead.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_ORDERED_HPP
+#define OUTPUT_ORDERED_HPP
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <vector>              // for vector
+
+#include "Output.hpp"  // for Output
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Ordered
+//! @brief Hands traces over to a consumer one at a time, in run order, so
+//! that they can be used as they are generated. Only the runs within a
+//! lookahead window of the next trace to be taken are kept. A thread adding a
+//! trace from beyond the window waits for the consumer to catch up, so memory
+//! use does not depend on the number of runs. Runs are handed out to threads
+//! in order so the next trace to be taken is always within the window and
+//! can always be added.
+//! This is constructed by the caller, rather than by name through the
+//! Output_Factory, as traces are taken from it. @see GILES::Trace_Generator
+class Output_Ordered : public Output
+{
+public:
+    //! A single generated trace.
+    struct Trace
+    {
+        std::size_t Run{0};
+        std::vector<float> Samples{};
+        std::string Extra_Data{};
+    };
+
+private:
+    //! Holds the trace of a run within the window, once it has been added.
+    struct Slot
+    {
+        Trace Value{};
+        bool Ready{false};
+    };
+
+    //! The trace of run i is held in slot i % size.
+    std::vector<Slot> m_slots;
+
+    //! The run whose trace will be taken next.
+    std::size_t m_next;
+
+    //! Set once no more traces will be added.
+    bool m_finished;
+
+    //! Set once no more traces will be taken.
+    bool m_closed;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+public:
+    //! @brief Constructs an Output that traces can be taken from in order.
+    //! @param p_lookahead The number of runs that can be generated ahead of
+    //! the next trace to be taken.
+    explicit Output_Ordered(const std::size_t p_lookahead)
+        : Output{Output_Options{}}, m_slots(p_lookahead > 0 ? p_lookahead : 1),
+          m_next{0}, m_finished{false}, m_closed{false}, m_mutex{},
+          m_condition{}
+    {
+    }
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    bool Take(Trace* const p_trace);
+
+    void Close();
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_ORDERED_HPP
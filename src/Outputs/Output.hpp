@@ -0,0 +1,175 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output.hpp
+    @brief Contains the Output class which serves as a base class for the
+    destinations that generated traces are sent to.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_HPP
+#define OUTPUT_HPP
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Abstract_Factory_Register.hpp"  // for Output_Factory_Register
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Options
+//! @brief The settings given to an Output when it is constructed. Not every
+//! Output makes use of every setting.
+struct Output_Options
+{
+    //! The path to save the output to.
+    std::string Path{};
+
+    //! The indices of the samples, within each trace, that are used when
+    //! building templates. If this is empty then every sample is used.
+    std::vector<std::size_t> Points_Of_Interest{};
+
+    //! The offset, in bytes, of the class label within the extra data.
+    std::size_t Label_Offset{0};
+
+    //! The length, in bytes, of the class label within the extra data.
+    std::size_t Label_Length{1};
+
+    //! The number of traces that are written together by formats that store
+    //! traces in tiles or chunks rather than one at a time.
+    std::size_t Traces_Per_Tile{1024};
+
+    //! The number of samples in each chunk, for formats that split traces
+    //! into chunks.
+    std::size_t Samples_Per_Chunk{1024};
+
+    //! The number of bytes that can wait to be written, in the background,
+    //! before trace generation waits for the disk.
+    std::size_t Write_Budget{64 * 1024 * 1024};
+
+    //! The name of the format that the traces at Path are saved in. This is
+    //! used by Outputs that describe the file saved by another Output, such as
+    //! "Index".
+    std::string Format{};
+
+    //! Whether to keep the traces already saved at Path by a run that was
+    //! interrupted, so that only the remaining runs need to be added. This is
+    //! only used by Outputs that are Resumable().
+    bool Resume{false};
+};
+
+//! @class Output
+//! @brief An abstract class that serves as a base class for the destinations
+//! that generated traces are sent to. This could be a file format or something
+//! that consumes the traces as they are generated such as a statistical sink.
+//! This class is not designed to be inherited from directly; instead
+//! Output_Interface should be inherited from. This class provides a
+//! non-templated base class to allow handling of derived objects.
+class Output
+{
+protected:
+    //! The settings this Output was constructed with.
+    const Output_Options m_options;
+
+    //! @brief This constructor is marked as protected as it should only be
+    //! called by derived classes to assist with initialisation.
+    //! @param p_options The settings for this Output.
+    explicit Output(const Output_Options& p_options) : m_options(p_options) {}
+
+public:
+    //! @brief Virtual destructor to ensure proper memory cleanup.
+    //! @see https://stackoverflow.com/a/461224
+    virtual ~Output() = default;
+
+    //! @brief Called once before any traces are added.
+    //! @param p_number_of_runs The number of traces that will be generated.
+    //! @param p_number_of_threads The number of threads that will be adding
+    //! traces. Each call to Add_Trace() gives a thread index lower than this.
+    virtual void Start(const std::size_t /*p_number_of_runs*/,
+                       const std::size_t /*p_number_of_threads*/)
+    {
+    }
+
+    //! @brief Adds a single generated trace to the Output.
+    //! @warning This is called concurrently from every worker thread. Derived
+    //! classes are responsible for their own synchronisation.
+    //! @param p_thread The index of the calling thread.
+    //! @param p_run_index The index of the run that generated this trace.
+    //! @param p_trace The generated trace.
+    //! @param p_extra_data Any extra data given by the simulator for this run.
+    virtual void Add_Trace(const std::size_t p_thread,
+                           const std::size_t p_run_index,
+                           const std::vector<float>& p_trace,
+                           const std::string& p_extra_data) = 0;
+
+    //! @brief Called, before Finish(), if trace generation is stopped before
+    //! every run has been completed.
+    //! @param p_number_of_runs The number of runs that were completed. These
+    //! are the runs with an index lower than this.
+    virtual void Stopped(const std::size_t /*p_number_of_runs*/) {}
+
+    //! @brief Called once after every trace has been added. This is where
+    //! anything still held in memory should be saved.
+    virtual void Finish() = 0;
+
+    //! @brief Ensures that every trace added by a thread has been saved, so
+    //! that it would be kept if the program stopped. This is called
+    //! periodically by each thread, from that thread, so that the runs it has
+    //! completed can be recorded in the Journal.
+    //! @param p_thread The index of the calling thread.
+    virtual void Flush(const std::size_t /*p_thread*/) {}
+
+    //! @brief Whether this Output can continue from the traces saved by a run
+    //! that was interrupted, when constructed with Output_Options::Resume.
+    //! @returns true if it can, false if not.
+    virtual bool Resumable() const { return false; }
+};
+
+//! @class Output_Interface
+//! @brief This adds self registering factory code to the derived class, given
+//! by derived_t and delegates construction of a base class to the Output
+//! class.
+//! @tparam derived_t This should be the same as the derived type. This will add
+//! the self registering factory code automatically, allowing use of the
+//! derived class.
+template <typename derived_t>
+class Output_Interface : public Output, public Output_Factory_Register<derived_t>
+{
+protected:
+    //! @brief This constructor is marked as protected as it should only be
+    //! called by derived classes to assist with initialisation.
+    //! @param p_options The settings for this Output.
+    explicit Output_Interface(const Output_Options& p_options)
+        : Output(p_options)
+    {
+    }
+
+public:
+    //! @brief Virtual destructor to ensure proper memory cleanup.
+    //! @see https://stackoverflow.com/a/461224
+    virtual ~Output_Interface() = default;
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_HPP
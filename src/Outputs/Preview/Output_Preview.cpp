@@ -0,0 +1,223 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Preview.cpp
+    @brief Contains an Output that saves a small preview of the shape of the
+    generated traces.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for min, max
+#include <cstdint>    // for uint64_t
+#include <cstdio>     // for rename
+#include <fstream>    // for ofstream
+#include <limits>     // for numeric_limits
+#include <mutex>      // for lock_guard
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include "Output_Preview.hpp"
+
+#include "Error.hpp"  // for Report_Error
+
+static_assert(sizeof(GILES::Internal::Output_Preview::Header) == 64,
+              "The header must be exactly 64 bytes");
+
+//! @brief Adds a trace to the running totals of an envelope, extending the
+//! envelope if the trace is longer than any before it.
+//! @param p_trace The trace to add.
+//! @param p_envelope The envelope to add to.
+void GILES::Internal::Output_Preview::add(const std::vector<float>& p_trace,
+                                          Envelope* const p_envelope)
+{
+    if (p_trace.size() > p_envelope->Count.size())
+    {
+        p_envelope->Minimum.resize(p_trace.size(),
+                                   std::numeric_limits<float>::max());
+        p_envelope->Maximum.resize(p_trace.size(),
+                                   std::numeric_limits<float>::lowest());
+        p_envelope->Sum.resize(p_trace.size(), 0);
+        p_envelope->Count.resize(p_trace.size(), 0);
+    }
+
+    for (std::size_t i{0}; i < p_trace.size(); ++i)
+    {
+        p_envelope->Minimum[i] = std::min(p_envelope->Minimum[i], p_trace[i]);
+        p_envelope->Maximum[i] = std::max(p_envelope->Maximum[i], p_trace[i]);
+        p_envelope->Sum[i] += p_trace[i];
+        ++p_envelope->Count[i];
+    }
+    ++p_envelope->Number_Of_Traces;
+}
+
+//! @brief Adds the running totals of one envelope to another.
+//! @param p_from The envelope to add.
+//! @param p_into The envelope to add to.
+void GILES::Internal::Output_Preview::merge(const Envelope& p_from,
+                                            Envelope* const p_into)
+{
+    if (p_from.Count.size() > p_into->Count.size())
+    {
+        p_into->Minimum.resize(p_from.Count.size(),
+                               std::numeric_limits<float>::max());
+        p_into->Maximum.resize(p_from.Count.size(),
+                               std::numeric_limits<float>::lowest());
+        p_into->Sum.resize(p_from.Count.size(), 0);
+        p_into->Count.resize(p_from.Count.size(), 0);
+    }
+
+    for (std::size_t i{0}; i < p_from.Count.size(); ++i)
+    {
+        p_into->Minimum[i] = std::min(p_into->Minimum[i], p_from.Minimum[i]);
+        p_into->Maximum[i] = std::max(p_into->Maximum[i], p_from.Maximum[i]);
+        p_into->Sum[i] += p_from.Sum[i];
+        p_into->Count[i] += p_from.Count[i];
+    }
+    p_into->Number_Of_Traces += p_from.Number_Of_Traces;
+}
+
+//! @brief Saves m_total as the preview. The preview is written to a
+//! temporary file which then replaces the previous preview, so that a viewer
+//! never sees a partially written preview.
+//! @warning m_mutex must be held by the caller.
+void GILES::Internal::Output_Preview::save() const
+{
+    const std::size_t number_of_samples{m_total.Count.size()};
+
+    Header header;
+    header.Number_Of_Levels  = Samples_Per_Bin.size();
+    header.Number_Of_Samples = number_of_samples;
+    header.Number_Of_Traces  = m_total.Number_Of_Traces;
+
+    std::vector<Level> levels;
+    std::uint64_t offset{sizeof(Header) +
+                         Samples_Per_Bin.size() * sizeof(Level)};
+    for (const auto samples_per_bin : Samples_Per_Bin)
+    {
+        const std::uint64_t number_of_bins{
+            (number_of_samples + samples_per_bin - 1) / samples_per_bin};
+        levels.push_back({samples_per_bin, number_of_bins, offset});
+        offset += 3 * number_of_bins * sizeof(float);
+    }
+
+    const std::string path{Preview_Path(m_options.Path)};
+    const std::string temporary_path{path + ".tmp"};
+    std::ofstream file{temporary_path, std::ios::binary};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(levels.data()),
+               static_cast<std::streamsize>(levels.size() * sizeof(Level)));
+
+    for (const auto& level : levels)
+    {
+        std::vector<float> minimum(level.Number_Of_Bins);
+        std::vector<float> maximum(level.Number_Of_Bins);
+        std::vector<float> mean(level.Number_Of_Bins);
+
+        for (std::size_t bin{0}; bin < level.Number_Of_Bins; ++bin)
+        {
+            const std::size_t first{bin * level.Samples_Per_Bin};
+            const std::size_t last{std::min<std::size_t>(
+                first + level.Samples_Per_Bin, number_of_samples)};
+
+            float bin_minimum{std::numeric_limits<float>::max()};
+            float bin_maximum{std::numeric_limits<float>::lowest()};
+            double sum{0};
+            std::uint64_t count{0};
+            for (std::size_t i{first}; i < last; ++i)
+            {
+                if (0 != m_total.Count[i])
+                {
+                    bin_minimum = std::min(bin_minimum, m_total.Minimum[i]);
+                    bin_maximum = std::max(bin_maximum, m_total.Maximum[i]);
+                    sum += m_total.Sum[i];
+                    count += m_total.Count[i];
+                }
+            }
+
+            if (0 == count)
+            {
+                bin_minimum = std::numeric_limits<float>::quiet_NaN();
+                bin_maximum = std::numeric_limits<float>::quiet_NaN();
+            }
+            minimum[bin] = bin_minimum;
+            maximum[bin] = bin_maximum;
+            mean[bin]    = 0 == count
+                            ? std::numeric_limits<float>::quiet_NaN()
+                            : static_cast<float>(sum / count);
+        }
+
+        for (const auto* values : {&minimum, &maximum, &mean})
+        {
+            file.write(
+                reinterpret_cast<const char*>(values->data()),
+                static_cast<std::streamsize>(values->size() * sizeof(float)));
+        }
+    }
+
+    file.close();
+    if (!file || 0 != std::rename(temporary_path.c_str(), path.c_str()))
+    {
+        Error::Report_Error("Could not write '{}'", path);
+    }
+}
+
+void GILES::Internal::Output_Preview::Start(
+    const std::size_t /*p_number_of_runs*/,
+    const std::size_t p_number_of_threads)
+{
+    m_envelopes.assign(p_number_of_threads, {});
+    m_total = {};
+}
+
+//! @brief Adds a trace to the envelope belonging to the calling thread. Once
+//! the thread has collected Update_Interval traces they are added to the
+//! saved preview.
+void GILES::Internal::Output_Preview::Add_Trace(
+    const std::size_t p_thread,
+    const std::size_t /*p_run_index*/,
+    const std::vector<float>& p_trace,
+    const std::string& /*p_extra_data*/)
+{
+    auto& envelope = m_envelopes.at(p_thread);
+    add(p_trace, &envelope);
+
+    if (envelope.Number_Of_Traces >= Update_Interval)
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        merge(envelope, &m_total);
+        save();
+
+        envelope = {};
+    }
+}
+
+//! @brief Adds the traces still held by each thread and saves the final
+//! preview.
+void GILES::Internal::Output_Preview::Finish()
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    for (const auto& envelope : m_envelopes)
+    {
+        merge(envelope, &m_total);
+    }
+    m_envelopes.clear();
+
+    save();
+}
@@ -0,0 +1,160 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Preview.hpp
+    @brief Contains an Output that saves a small preview of the shape of the
+    generated traces.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_PREVIEW_HPP
+#define OUTPUT_PREVIEW_HPP
+
+#include <array>    // for array
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t
+#include <mutex>    // for mutex
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output.hpp"  // for Output_Interface
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Preview
+//! @brief Saves the minimum, maximum and mean of every sample across all
+//! traces, so that the shape of the traces can be viewed without loading them.
+//! The preview is saved at the path given by Preview_Path() and is updated as
+//! traces are generated, so it can be viewed before generation finishes.
+//!
+//! To allow long traces to be viewed quickly the preview is saved at several
+//! resolutions. At each level, each bin covers Samples_Per_Bin consecutive
+//! samples and holds the minimum, maximum and mean of those samples. Level 0
+//! has one sample per bin.
+//!
+//! All values are stored little-endian. The preview is laid out as:
+//! - A Header.
+//! - A Level for each level, from the finest to the coarsest.
+//! - The bins of each level, at Level::Offset, as Number_Of_Bins float32
+//!   minimums, then maximums and then means.
+//! @note Traces do not need to be the same length. Bins only holding samples
+//! beyond the end of every trace are saved as NaN.
+class Output_Preview : public virtual Output_Interface<Output_Preview>
+{
+public:
+    //! The start of every preview.
+    struct Header
+    {
+        char Magic[8]{'G', 'I', 'L', 'E', 'S', 'P', 'R', 'V'};
+        std::uint32_t Version{1};
+        std::uint32_t Number_Of_Levels{0};
+        std::uint64_t Number_Of_Samples{0};
+        std::uint64_t Number_Of_Traces{0};
+        std::uint64_t Padding[4]{};
+    };
+
+    //! Describes a single resolution.
+    struct Level
+    {
+        std::uint64_t Samples_Per_Bin;
+        std::uint64_t Number_Of_Bins;
+
+        //! The position, in bytes, of the bins within the preview.
+        std::uint64_t Offset;
+    };
+
+    //! The number of samples in each bin at each level.
+    static constexpr std::array<std::size_t, 4> Samples_Per_Bin{1, 4, 16, 64};
+
+    //! The number of traces each thread collects before the preview is
+    //! updated.
+    static constexpr std::size_t Update_Interval{1024};
+
+private:
+    //! The running totals of every sample, across some number of traces.
+    struct Envelope
+    {
+        std::vector<float> Minimum{};
+        std::vector<float> Maximum{};
+        std::vector<double> Sum{};
+
+        //! The number of traces that contain each sample.
+        std::vector<std::uint64_t> Count{};
+
+        std::uint64_t Number_Of_Traces{0};
+    };
+
+    //! One envelope per thread, holding the traces that have not been added
+    //! to m_total, so that adding traces needs no locking.
+    std::vector<Envelope> m_envelopes;
+
+    //! Every trace that has been included in the saved preview.
+    Envelope m_total;
+
+    //! Guards m_total and the preview file.
+    std::mutex m_mutex;
+
+    static void add(const std::vector<float>& p_trace,
+                    Envelope* const p_envelope);
+
+    static void merge(const Envelope& p_from, Envelope* const p_into);
+
+    void save() const;
+
+public:
+    //! @brief Constructs an Output that will preview the traces saved at the
+    //! path given in p_options.
+    //! @param p_options The settings for this Output.
+    explicit Output_Preview(const Output_Options& p_options)
+        : Output_Interface{p_options}, m_envelopes{}, m_total{}, m_mutex{}
+    {
+    }
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    //! @brief Retrieves the path of the preview saved alongside a traces
+    //! file.
+    //! @param p_traces_path The path to the traces file.
+    //! @returns The path to the preview.
+    static const std::string Preview_Path(const std::string& p_traces_path)
+    {
+        return p_traces_path + ".preview";
+    }
+
+    //! @brief Retrieves the name of this Output.
+    //! @returns The name as a string.
+    //! @note This is needed to ensure self registration in the factory
+    //! works. The factory registration requires this as unique identifier.
+    static const std::string Get_Name() { return "Preview"; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_PREVIEW_HPP
@@ -0,0 +1,196 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Sample_Major.cpp
+    @brief Contains an Output that saves traces transposed, one sample at a
+    time, in fixed size tiles.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for min
+#include <cstdint>    // for uint32_t, uint64_t
+#include <fstream>    // for ofstream
+#include <memory>     // for make_unique
+#include <mutex>      // for call_once, lock_guard
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include "Output_Sample_Major.hpp"
+
+#include "Error.hpp"  // for Report_Error
+
+static_assert(sizeof(GILES::Internal::Output_Sample_Major::Header) == 64,
+              "The header must be exactly 64 bytes");
+
+//! @brief Transposes the traces held in p_tile and appends them, along with
+//! their run indices and extra data, to the end of the trace file. The tile is
+//! then emptied, ready to be reused.
+//! @param p_tile The tile to write.
+void GILES::Internal::Output_Sample_Major::write_tile(Tile* const p_tile)
+{
+    const std::size_t rows{p_tile->Run_Indices.size()};
+    if (0 == rows)
+    {
+        return;
+    }
+    const std::size_t columns{m_number_of_samples};
+
+    // Transpose in small square blocks so that both the reads and the writes
+    // stay within the cache.
+    constexpr std::size_t block{32};
+    auto& transposed = p_tile->Columns;
+    transposed.resize(rows * columns);
+    for (std::size_t row_block{0}; row_block < rows; row_block += block)
+    {
+        const std::size_t row_end{std::min(row_block + block, rows)};
+        for (std::size_t column_block{0}; column_block < columns;
+             column_block += block)
+        {
+            const std::size_t column_end{
+                std::min(column_block + block, columns)};
+            for (std::size_t row{row_block}; row < row_end; ++row)
+            {
+                for (std::size_t column{column_block}; column < column_end;
+                     ++column)
+                {
+                    transposed[column * rows + row] =
+                        p_tile->Rows[row * columns + column];
+                }
+            }
+        }
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+
+        m_index.push_back({m_file->Position(),
+                           static_cast<std::uint64_t>(rows),
+                           m_number_of_traces});
+        m_number_of_traces += rows;
+
+        m_file->Append(transposed.data(), transposed.size() * sizeof(float));
+        m_file->Append(p_tile->Run_Indices.data(),
+                       rows * sizeof(std::uint64_t));
+        for (const auto& extra_data : p_tile->Extra_Data)
+        {
+            const auto size = static_cast<std::uint32_t>(extra_data.size());
+            m_file->Append(&size, sizeof(size));
+            m_file->Append(extra_data.data(), extra_data.size());
+        }
+    }
+
+    p_tile->Rows.clear();
+    p_tile->Run_Indices.clear();
+    p_tile->Extra_Data.clear();
+}
+
+//! @brief Creates the Header describing everything written so far.
+//! @returns The Header.
+const GILES::Internal::Output_Sample_Major::Header
+GILES::Internal::Output_Sample_Major::header() const
+{
+    Header header;
+    header.Number_Of_Samples = m_number_of_samples;
+    header.Number_Of_Traces  = m_number_of_traces;
+    header.Traces_Per_Tile   = m_options.Traces_Per_Tile;
+    header.Number_Of_Tiles   = m_index.size();
+    return header;
+}
+
+//! @brief Opens the trace file, reserving space for the Header, and creates
+//! one tile for every thread.
+//! @param p_number_of_threads The number of threads that will add traces.
+void GILES::Internal::Output_Sample_Major::Start(
+    const std::size_t /*p_number_of_runs*/,
+    const std::size_t p_number_of_threads)
+{
+    if (0 == m_options.Traces_Per_Tile)
+    {
+        Error::Report_Error("The number of traces per tile cannot be 0");
+    }
+
+    m_file = std::make_unique<Writer>(m_options.Path, m_options.Write_Budget);
+    const auto placeholder = header();
+    m_file->Append(&placeholder, sizeof(placeholder));
+
+    m_tiles.assign(p_number_of_threads, Tile{});
+}
+
+//! @brief Adds a trace to the tile belonging to the calling thread, writing
+//! that tile once it is full.
+void GILES::Internal::Output_Sample_Major::Add_Trace(
+    const std::size_t p_thread,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    std::call_once(m_number_of_samples_resolved,
+                   [this, &p_trace] { m_number_of_samples = p_trace.size(); });
+
+    if (p_trace.size() != m_number_of_samples)
+    {
+        Error::Report_Error("The {} format requires every trace to be the same "
+                            "length. Trace {} has {} samples but {} were "
+                            "expected.",
+                            Get_Name(),
+                            p_run_index,
+                            p_trace.size(),
+                            m_number_of_samples);
+    }
+
+    auto& tile = m_tiles.at(p_thread);
+    if (tile.Rows.empty())
+    {
+        tile.Rows.reserve(m_options.Traces_Per_Tile * m_number_of_samples);
+    }
+    tile.Rows.insert(tile.Rows.end(), p_trace.begin(), p_trace.end());
+    tile.Run_Indices.push_back(p_run_index);
+    tile.Extra_Data.push_back(p_extra_data);
+
+    if (tile.Run_Indices.size() >= m_options.Traces_Per_Tile)
+    {
+        write_tile(&tile);
+    }
+}
+
+//! @brief Writes any partially filled tiles, completes the Header and saves
+//! the index.
+void GILES::Internal::Output_Sample_Major::Finish()
+{
+    for (auto& tile : m_tiles)
+    {
+        write_tile(&tile);
+    }
+    m_tiles.clear();
+
+    const auto completed = header();
+    m_file->Write(&completed, sizeof(completed), 0);
+    m_file->Close();
+
+    const std::string index_path{m_options.Path + ".index"};
+    std::ofstream index{index_path, std::ios::binary | std::ios::trunc};
+    index.write(reinterpret_cast<const char*>(&completed), sizeof(completed));
+    index.write(reinterpret_cast<const char*>(m_index.data()),
+                m_index.size() * sizeof(Tile_Entry));
+    if (!index)
+    {
+        Error::Report_Error("Could not save the index to '{}'", index_path);
+    }
+}
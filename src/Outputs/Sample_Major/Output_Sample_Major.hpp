@@ -0,0 +1,162 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Sample_Major.hpp
+    @brief Contains an Output that saves traces transposed, one sample at a
+    time, in fixed size tiles.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_SAMPLE_MAJOR_HPP
+#define OUTPUT_SAMPLE_MAJOR_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex, once_flag
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output.hpp"  // for Output_Interface
+#include "Writer.hpp"  // for Writer
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Sample_Major
+//! @brief Saves the generated traces in sample-major order. Traces are
+//! collected into tiles of up to Output_Options::Traces_Per_Tile traces, which
+//! are transposed before being written so that each sample, across every trace
+//! in the tile, is contiguous on disk. This makes reading one sample across
+//! all traces, as most statistical analyses do, a series of large sequential
+//! reads rather than one small read per trace.
+//!
+//! All values are stored little-endian. The file is laid out as:
+//! - A Header.
+//! - Each tile, one after another. A tile containing k traces of S samples
+//!   holds S rows of k floats (row s is sample s of every trace in the tile),
+//!   then the k run indices as uint64, then for each trace a uint32 length
+//!   followed by that many bytes of extra data.
+//!
+//! A small index is saved alongside, at the same path with ".index"
+//! appended. This holds a copy of the Header followed by one Tile_Entry per
+//! tile, allowing any sample of any trace to be found without scanning.
+//! @note Every trace must contain the same number of samples.
+class Output_Sample_Major : public virtual Output_Interface<Output_Sample_Major>
+{
+public:
+    //! The start of both the trace file and the index file.
+    struct Header
+    {
+        char Magic[8]{'G', 'I', 'L', 'E', 'S', 'S', 'M', 'T'};
+        std::uint32_t Version{1};
+        std::uint32_t Reserved{0};
+        std::uint64_t Number_Of_Samples{0};
+        std::uint64_t Number_Of_Traces{0};
+        std::uint64_t Traces_Per_Tile{0};
+        std::uint64_t Number_Of_Tiles{0};
+        std::uint64_t Padding[2]{};
+    };
+
+    //! Where to find one tile within the trace file.
+    struct Tile_Entry
+    {
+        //! The position of the first byte of the tile in the trace file.
+        std::uint64_t Offset;
+
+        //! The number of traces within the tile.
+        std::uint64_t Number_Of_Traces;
+
+        //! The position of the first trace of this tile within the file, when
+        //! counting every trace in every previous tile.
+        std::uint64_t First_Trace;
+    };
+
+private:
+    //! The traces collected by a single thread that have not been written.
+    struct Tile
+    {
+        //! The traces, one after another, as they were generated.
+        std::vector<float> Rows{};
+
+        //! The same traces after transposing, ready to be written.
+        std::vector<float> Columns{};
+
+        std::vector<std::uint64_t> Run_Indices{};
+        std::vector<std::string> Extra_Data{};
+    };
+
+    //! One tile per thread so that collecting traces needs no locking.
+    std::vector<Tile> m_tiles;
+
+    //! The number of samples in every trace, taken from the first trace.
+    std::size_t m_number_of_samples;
+
+    //! Ensures m_number_of_samples is only set once.
+    std::once_flag m_number_of_samples_resolved;
+
+    //! The location of every tile written so far.
+    std::vector<Tile_Entry> m_index;
+
+    //! The number of traces written so far.
+    std::uint64_t m_number_of_traces;
+
+    //! Writes the trace file in the background.
+    std::unique_ptr<Writer> m_file;
+
+    //! Guards m_file, m_index and m_number_of_traces.
+    std::mutex m_mutex;
+
+    void write_tile(Tile* const p_tile);
+
+    const Header header() const;
+
+public:
+    //! @brief Constructs an Output that will save to the path given in
+    //! p_options.
+    //! @param p_options The settings for this Output.
+    explicit Output_Sample_Major(const Output_Options& p_options)
+        : Output_Interface{p_options}, m_tiles{}, m_number_of_samples{0},
+          m_number_of_samples_resolved{}, m_index{}, m_number_of_traces{0},
+          m_file{}, m_mutex{}
+    {
+    }
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    //! @brief Retrieves the name of this Output.
+    //! @returns The name as a string.
+    //! @note This is needed to ensure self registration in the factory
+    //! works. The factory registration requires this as unique identifier.
+    static const std::string Get_Name() { return "Sample Major"; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_SAMPLE_MAJOR_HPP
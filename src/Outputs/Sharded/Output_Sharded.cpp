@@ -0,0 +1,118 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Sharded.cpp
+    @brief Contains an Output that saves the traces from each thread to a
+    separate file.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdint>  // for uint32_t, uint64_t
+#include <memory>   // for make_unique
+#include <mutex>    // for call_once
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output_Sharded.hpp"
+
+#include "Error.hpp"  // for Report_Error
+
+static_assert(sizeof(GILES::Internal::Output_Sharded::Header) == 64,
+              "The header must be exactly 64 bytes");
+
+//! @brief Creates the Header describing everything written to a shard so far.
+//! @param p_shard The shard to describe.
+//! @returns The Header.
+const GILES::Internal::Output_Sharded::Header
+GILES::Internal::Output_Sharded::header(const Shard& p_shard) const
+{
+    Header header;
+    header.Number_Of_Samples = m_number_of_samples;
+    header.Number_Of_Traces  = p_shard.Run_Indices.size();
+    header.Footer_Offset     = p_shard.File->Position();
+    return header;
+}
+
+//! @brief Opens one shard for every thread, reserving space for the Header.
+//! @param p_number_of_threads The number of threads that will add traces.
+void GILES::Internal::Output_Sharded::Start(
+    const std::size_t /*p_number_of_runs*/,
+    const std::size_t p_number_of_threads)
+{
+    m_shards.resize(p_number_of_threads);
+    for (std::size_t i{0}; i < m_shards.size(); ++i)
+    {
+        auto& shard = m_shards[i];
+        shard.File  = std::make_unique<Writer>(
+            Shard_Path(m_options.Path, i), m_options.Write_Budget);
+
+        const Header placeholder;
+        shard.File->Append(&placeholder, sizeof(placeholder));
+    }
+}
+
+//! @brief Adds a trace to the shard belonging to the calling thread.
+void GILES::Internal::Output_Sharded::Add_Trace(
+    const std::size_t p_thread,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    std::call_once(m_number_of_samples_resolved,
+                   [this, &p_trace] { m_number_of_samples = p_trace.size(); });
+
+    if (p_trace.size() != m_number_of_samples)
+    {
+        Error::Report_Error("The {} format requires every trace to be the same "
+                            "length. Trace {} has {} samples but {} were "
+                            "expected.",
+                            Get_Name(),
+                            p_run_index,
+                            p_trace.size(),
+                            m_number_of_samples);
+    }
+
+    auto& shard = m_shards.at(p_thread);
+    shard.File->Append(p_trace.data(), p_trace.size() * sizeof(float));
+    shard.Run_Indices.push_back(p_run_index);
+    shard.Extra_Data.push_back(p_extra_data);
+}
+
+//! @brief Writes the footer of every shard and completes their Headers.
+void GILES::Internal::Output_Sharded::Finish()
+{
+    for (auto& shard : m_shards)
+    {
+        const auto completed = header(shard);
+
+        shard.File->Append(shard.Run_Indices.data(),
+                           shard.Run_Indices.size() * sizeof(std::uint64_t));
+        for (const auto& extra_data : shard.Extra_Data)
+        {
+            const auto size = static_cast<std::uint32_t>(extra_data.size());
+            shard.File->Append(&size, sizeof(size));
+            shard.File->Append(extra_data.data(), extra_data.size());
+        }
+
+        shard.File->Write(&completed, sizeof(completed), 0);
+        shard.File->Close();
+    }
+    m_shards.clear();
+}
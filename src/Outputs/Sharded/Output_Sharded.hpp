@@ -0,0 +1,135 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Sharded.hpp
+    @brief Contains an Output that saves the traces from each thread to a
+    separate file.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_SHARDED_HPP
+#define OUTPUT_SHARDED_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t
+#include <memory>   // for unique_ptr
+#include <mutex>    // for once_flag
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output.hpp"  // for Output_Interface
+#include "Writer.hpp"  // for Writer
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Sharded
+//! @brief Saves the traces generated by each thread to a separate shard file,
+//! so that threads never wait for each other. Shard n is saved at the path
+//! given with ".shard" and n appended. The GILES-merge tool combines the
+//! shards into a single file, in run order.
+//!
+//! All values are stored little-endian. Each shard is laid out as:
+//! - A Header.
+//! - Every trace generated by the thread, in the order they were generated,
+//!   as Number_Of_Samples float32 values each.
+//! - The footer, at Header::Footer_Offset. This holds the run index of each
+//!   trace as uint64, then for each trace a uint32 length followed by that
+//!   many bytes of extra data.
+//! @note Every trace must contain the same number of samples.
+class Output_Sharded : public virtual Output_Interface<Output_Sharded>
+{
+public:
+    //! The start of every shard.
+    struct Header
+    {
+        char Magic[8]{'G', 'I', 'L', 'E', 'S', 'S', 'H', 'D'};
+        std::uint32_t Version{1};
+        std::uint32_t Reserved{0};
+        std::uint64_t Number_Of_Samples{0};
+        std::uint64_t Number_Of_Traces{0};
+        std::uint64_t Footer_Offset{0};
+        std::uint64_t Padding[3]{};
+    };
+
+private:
+    //! Everything belonging to a single thread.
+    struct Shard
+    {
+        std::unique_ptr<Writer> File{};
+
+        //! The contents of the footer, which is written once every trace has
+        //! been.
+        std::vector<std::uint64_t> Run_Indices{};
+        std::vector<std::string> Extra_Data{};
+    };
+
+    std::vector<Shard> m_shards;
+
+    //! The number of samples in every trace, taken from the first trace.
+    std::size_t m_number_of_samples;
+
+    //! Ensures m_number_of_samples is only set once.
+    std::once_flag m_number_of_samples_resolved;
+
+    const Header header(const Shard& p_shard) const;
+
+public:
+    //! @brief Constructs an Output that will save to the path given in
+    //! p_options.
+    //! @param p_options The settings for this Output.
+    explicit Output_Sharded(const Output_Options& p_options)
+        : Output_Interface{p_options}, m_shards{}, m_number_of_samples{0},
+          m_number_of_samples_resolved{}
+    {
+    }
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    //! @brief Retrieves the path of a shard.
+    //! @param p_path The path given to this Output.
+    //! @param p_shard The index of the shard, which is the index of the
+    //! thread that generated its traces.
+    //! @returns The path the shard is saved to.
+    static const std::string Shard_Path(const std::string& p_path,
+                                        const std::size_t p_shard)
+    {
+        return p_path + ".shard" + std::to_string(p_shard);
+    }
+
+    //! @brief Retrieves the name of this Output.
+    //! @returns The name as a string.
+    //! @note This is needed to ensure self registration in the factory
+    //! works. The factory registration requires this as unique identifier.
+    static const std::string Get_Name() { return "Sharded"; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_SHARDED_HPP
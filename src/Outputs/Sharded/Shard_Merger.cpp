@@ -0,0 +1,477 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Shard_Merger.cpp
+    @brief Contains the Shard_Merger class, which combines the shards saved by
+    the "Sharded" Output into a single file.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for sort, max, min
+#include <cerrno>     // for errno, EINTR, ENOSYS, EXDEV, EINVAL
+#include <cstdint>    // for uint32_t, uint64_t
+#include <cstring>    // for memcmp, memcpy, strerror
+#include <memory>     // for make_unique
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include <fcntl.h>     // for open, O_RDONLY, O_CREAT, O_TRUNC, O_WRONLY
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close, pread, pwrite, lseek
+
+#ifdef __linux__
+#include <sys/sendfile.h>  // for sendfile
+#endif
+
+#include "Shard_Merger.hpp"
+
+#include "Abstract_Factory.hpp"    // for Output_Factory
+#include "Error.hpp"               // for Report_Error
+#include "NumPy/Output_NumPy.hpp"  // for Output_NumPy
+#include "Output.hpp"              // for Output, Output_Options
+
+namespace
+{
+//! @brief Reads exactly p_size bytes from p_file at p_offset.
+//! @param p_file The file to read from.
+//! @param p_path The path of p_file, for error messages.
+//! @param p_data Where to store the bytes read.
+//! @param p_size The number of bytes to read.
+//! @param p_offset The position within p_file to read from.
+void read_exactly(const int p_file,
+                  const std::string& p_path,
+                  void* const p_data,
+                  const std::size_t p_size,
+                  const std::uint64_t p_offset)
+{
+    auto* data = static_cast<char*>(p_data);
+    std::size_t read{0};
+    while (read < p_size)
+    {
+        const auto result = ::pread(p_file,
+                                    data + read,
+                                    p_size - read,
+                                    static_cast<off_t>(p_offset + read));
+        if (result < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            GILES::Internal::Error::Report_Error(
+                "Could not read '{}'. The file may be incomplete", p_path);
+        }
+        read += static_cast<std::size_t>(result);
+    }
+}
+}  // namespace
+
+//! @brief Opens a shard and reads its Header and footer.
+//! @param p_path The path to the shard.
+GILES::Internal::Shard_Merger::Shard::Shard(const std::string& p_path)
+    : Path{p_path}, File{::open(p_path.c_str(), O_RDONLY)}, Header{},
+      Run_Indices{}, Extra_Data{}
+{
+    if (File < 0)
+    {
+        Error::Report_Error("Could not open '{}'", p_path);
+    }
+
+    // The file is closed before passing on an error as the destructor is not
+    // run.
+    try
+    {
+        load();
+    }
+    catch (...)
+    {
+        ::close(File);
+        throw;
+    }
+}
+
+GILES::Internal::Shard_Merger::Shard::~Shard() { ::close(File); }
+
+//! @brief Reads the Header and footer of the shard.
+void GILES::Internal::Shard_Merger::Shard::load()
+{
+    read_exactly(File, Path, &Header, sizeof(Header), 0);
+    const Output_Sharded::Header expected;
+    if (0 !=
+            std::memcmp(Header.Magic, expected.Magic, sizeof(expected.Magic)) ||
+        Header.Version != expected.Version)
+    {
+        Error::Report_Error(
+            "'{}' is not a shard saved by this version of GILES", Path);
+    }
+
+    struct stat status;
+    if (0 != ::fstat(File, &status) ||
+        static_cast<std::uint64_t>(status.st_size) < Header.Footer_Offset)
+    {
+        Error::Report_Error("Could not read '{}'. The file may be incomplete",
+                            Path);
+    }
+    std::vector<char> footer(static_cast<std::size_t>(status.st_size) -
+                             Header.Footer_Offset);
+    read_exactly(
+        File, Path, footer.data(), footer.size(), Header.Footer_Offset);
+
+    const std::size_t traces{Header.Number_Of_Traces};
+    std::size_t position{traces * sizeof(std::uint64_t)};
+    if (position > footer.size())
+    {
+        Error::Report_Error("Could not read '{}'. The file may be incomplete",
+                            Path);
+    }
+    Run_Indices.resize(traces);
+    std::memcpy(Run_Indices.data(), footer.data(), position);
+
+    for (std::size_t i{0}; i < traces; ++i)
+    {
+        std::uint32_t size;
+        if (position + sizeof(size) > footer.size())
+        {
+            Error::Report_Error(
+                "Could not read '{}'. The file may be incomplete", Path);
+        }
+        std::memcpy(&size, footer.data() + position, sizeof(size));
+        position += sizeof(size);
+        if (position + size > footer.size())
+        {
+            Error::Report_Error(
+                "Could not read '{}'. The file may be incomplete", Path);
+        }
+        Extra_Data.emplace_back(footer.data() + position, size);
+        position += size;
+    }
+}
+
+GILES::Internal::Shard_Merger::Shard_Merger(
+    const std::vector<std::string>& p_shard_paths,
+    const std::string& p_output_path,
+    const std::string& p_output_format)
+    : m_output_path{p_output_path}, m_output_format{p_output_format},
+      m_shards{}, m_traces{}, m_number_of_samples{0},
+      m_copy_method{Copy_Method::Copy_File_Range}
+{
+    // Check the format before doing any work.
+    Output_Factory::Find(m_output_format);
+
+    bool number_of_samples_resolved{false};
+    for (const auto& path : p_shard_paths)
+    {
+        m_shards.push_back(std::make_unique<const Shard>(path));
+        const auto& shard = *m_shards.back();
+        if (0 == shard.Header.Number_Of_Traces)
+        {
+            continue;
+        }
+
+        if (!number_of_samples_resolved)
+        {
+            m_number_of_samples        = shard.Header.Number_Of_Samples;
+            number_of_samples_resolved = true;
+        }
+        else if (shard.Header.Number_Of_Samples != m_number_of_samples)
+        {
+            Error::Report_Error("'{}' has traces of {} samples but {} were "
+                                "expected. Only shards from the same run can "
+                                "be merged.",
+                                path,
+                                shard.Header.Number_Of_Samples,
+                                m_number_of_samples);
+        }
+
+        for (std::size_t row{0}; row < shard.Run_Indices.size(); ++row)
+        {
+            m_traces.push_back(
+                {shard.Run_Indices[row], m_shards.size() - 1, row});
+        }
+    }
+
+    std::sort(m_traces.begin(),
+              m_traces.end(),
+              [](const auto& a, const auto& b) {
+                  return a.Run_Index < b.Run_Index;
+              });
+    for (std::size_t i{1}; i < m_traces.size(); ++i)
+    {
+        if (m_traces[i].Run_Index == m_traces[i - 1].Run_Index)
+        {
+            Error::Report_Error("Run {} appears more than once. Only shards "
+                                "from the same run can be merged.",
+                                m_traces[i].Run_Index);
+        }
+    }
+}
+
+//! @brief Writes exactly p_size bytes to p_file at p_offset.
+//! @param p_file The file to write to.
+//! @param p_data The bytes to write.
+//! @param p_size The number of bytes to write.
+//! @param p_offset The position within p_file to write to.
+void GILES::Internal::Shard_Merger::write_exactly(
+    const int p_file,
+    const void* const p_data,
+    const std::size_t p_size,
+    const std::uint64_t p_offset) const
+{
+    const auto* data = static_cast<const char*>(p_data);
+    std::size_t written{0};
+    while (written < p_size)
+    {
+        const auto result = ::pwrite(p_file,
+                                     data + written,
+                                     p_size - written,
+                                     static_cast<off_t>(p_offset + written));
+        if (result < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if (result < 0)
+        {
+            Error::Report_Error("Could not write '{}'. {}",
+                                m_output_path,
+                                std::strerror(errno));
+        }
+        written += static_cast<std::size_t>(result);
+    }
+}
+
+//! @brief Copies p_size bytes between files without passing them through this
+//! program where the system allows it.
+//! @param p_input The file to copy from.
+//! @param p_input_offset The position within p_input to copy from.
+//! @param p_output The file to copy to.
+//! @param p_output_offset The position within p_output to copy to.
+//! @param p_size The number of bytes to copy.
+void GILES::Internal::Shard_Merger::copy_range(const int p_input,
+                                               std::uint64_t p_input_offset,
+                                               const int p_output,
+                                               std::uint64_t p_output_offset,
+                                               std::size_t p_size)
+{
+    while (0 != p_size)
+    {
+        ssize_t copied{-1};
+        switch (m_copy_method)
+        {
+#ifdef __linux__
+            case Copy_Method::Copy_File_Range:
+            {
+                auto input_offset  = static_cast<loff_t>(p_input_offset);
+                auto output_offset = static_cast<loff_t>(p_output_offset);
+                copied             = ::copy_file_range(p_input,
+                                           &input_offset,
+                                           p_output,
+                                           &output_offset,
+                                           p_size,
+                                           0);
+                if (copied < 0 && (ENOSYS == errno || EXDEV == errno ||
+                                   EINVAL == errno || EOPNOTSUPP == errno))
+                {
+                    m_copy_method = Copy_Method::Sendfile;
+                    continue;
+                }
+                break;
+            }
+            case Copy_Method::Sendfile:
+            {
+                // sendfile() writes at the current position of the output.
+                auto input_offset = static_cast<off_t>(p_input_offset);
+                if (::lseek(p_output,
+                            static_cast<off_t>(p_output_offset),
+                            SEEK_SET) < 0)
+                {
+                    m_copy_method = Copy_Method::Read_Write;
+                    continue;
+                }
+                copied =
+                    ::sendfile(p_output, p_input, &input_offset, p_size);
+                if (copied < 0 && (ENOSYS == errno || EINVAL == errno))
+                {
+                    m_copy_method = Copy_Method::Read_Write;
+                    continue;
+                }
+                break;
+            }
+#endif
+            default:
+            {
+                std::vector<char> buffer(
+                    std::min<std::size_t>(p_size, 1 << 20));
+                read_exactly(p_input,
+                             "a shard",
+                             buffer.data(),
+                             buffer.size(),
+                             p_input_offset);
+                write_exactly(
+                    p_output, buffer.data(), buffer.size(), p_output_offset);
+                copied = static_cast<ssize_t>(buffer.size());
+                break;
+            }
+        }
+
+        if (copied < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if (copied <= 0)
+        {
+            Error::Report_Error("Could not write '{}'. {}",
+                                m_output_path,
+                                std::strerror(errno));
+        }
+        p_input_offset += static_cast<std::uint64_t>(copied);
+        p_output_offset += static_cast<std::uint64_t>(copied);
+        p_size -= static_cast<std::size_t>(copied);
+    }
+}
+
+//! @brief Saves the traces as a single float32 array, as the "NumPy" and "Raw"
+//! formats do. Traces that follow each other in a shard and in run order are
+//! copied together.
+//! @param p_header Whether or not .npy headers are written.
+void GILES::Internal::Shard_Merger::merge_array(const bool p_header)
+{
+    const std::size_t row_size{m_number_of_samples * sizeof(float)};
+    const std::uint64_t data_offset{p_header ? Output_NumPy::Header_Size : 0};
+
+    const int output{
+        ::open(m_output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+    if (output < 0)
+    {
+        Error::Report_Error("Could not open '{}'", m_output_path);
+    }
+
+    // The output is closed before passing on an error.
+    try
+    {
+        if (p_header)
+        {
+            const auto header = Output_NumPy::Header(
+                "<f4", m_traces.size(), m_number_of_samples);
+            write_exactly(output, header.data(), header.size(), 0);
+        }
+
+        for (std::size_t first{0}; first < m_traces.size();)
+        {
+            std::size_t last{first + 1};
+            while (last < m_traces.size() &&
+                   m_traces[last].Shard == m_traces[first].Shard &&
+                   m_traces[last].Row == m_traces[first].Row + (last - first))
+            {
+                ++last;
+            }
+
+            copy_range(m_shards[m_traces[first].Shard]->File,
+                       sizeof(Output_Sharded::Header) +
+                           m_traces[first].Row * row_size,
+                       output,
+                       data_offset + first * row_size,
+                       (last - first) * row_size);
+            first = last;
+        }
+    }
+    catch (...)
+    {
+        ::close(output);
+        throw;
+    }
+    ::close(output);
+
+    // The extra data is small so is collected and written in one go.
+    std::size_t width{0};
+    for (const auto& trace : m_traces)
+    {
+        width = std::max(width,
+                         m_shards[trace.Shard]->Extra_Data[trace.Row].size());
+    }
+    std::vector<char> extra_data(m_traces.size() * width, 0);
+    for (std::size_t i{0}; i < m_traces.size(); ++i)
+    {
+        const auto& data =
+            m_shards[m_traces[i].Shard]->Extra_Data[m_traces[i].Row];
+        std::memcpy(extra_data.data() + i * width, data.data(), data.size());
+    }
+
+    const std::string extra_data_path{m_output_path +
+                                      (p_header ? ".extra.npy" : ".extra")};
+    const int extra_data_file{
+        ::open(extra_data_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+    if (extra_data_file < 0)
+    {
+        Error::Report_Error("Could not open '{}'", extra_data_path);
+    }
+    try
+    {
+        if (p_header)
+        {
+            const auto header =
+                Output_NumPy::Header("|u1", m_traces.size(), width);
+            write_exactly(extra_data_file, header.data(), header.size(), 0);
+        }
+        write_exactly(
+            extra_data_file, extra_data.data(), extra_data.size(), data_offset);
+    }
+    catch (...)
+    {
+        ::close(extra_data_file);
+        throw;
+    }
+    ::close(extra_data_file);
+}
+
+//! @brief Saves the traces in any format by passing them, in run order, to
+//! the Output with the name m_output_format.
+void GILES::Internal::Shard_Merger::merge_output() const
+{
+    Output_Options options;
+    options.Path      = m_output_path;
+    const auto output = Output_Factory::Construct(m_output_format, options);
+
+    output->Start(m_traces.size(), 1);
+    std::vector<float> samples(m_number_of_samples);
+    for (const auto& trace : m_traces)
+    {
+        const auto& shard = *m_shards[trace.Shard];
+        read_exactly(shard.File,
+                     shard.Path,
+                     samples.data(),
+                     samples.size() * sizeof(float),
+                     sizeof(Output_Sharded::Header) +
+                         trace.Row * samples.size() * sizeof(float));
+        output->Add_Trace(
+            0, trace.Run_Index, samples, shard.Extra_Data[trace.Row]);
+    }
+    output->Finish();
+}
+
+void GILES::Internal::Shard_Merger::Merge()
+{
+    if ("NumPy" == m_output_format || "Raw" == m_output_format)
+    {
+        merge_array("NumPy" == m_output_format);
+    }
+    else
+    {
+        merge_output();
+    }
+}
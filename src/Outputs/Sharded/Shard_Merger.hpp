@@ -0,0 +1,145 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Shard_Merger.hpp
+    @brief Contains the Shard_Merger class, which combines the shards saved by
+    the "Sharded" Output into a single file.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef SHARD_MERGER_HPP
+#define SHARD_MERGER_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output_Sharded.hpp"  // for Output_Sharded
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Shard_Merger
+//! @brief Combines the shards saved by the "Sharded" Output into a single
+//! file, in run order. This is used by the GILES-merge tool.
+//! The "NumPy" and "Raw" formats are saved by copying each run of consecutive
+//! traces straight between the files, without passing them through this
+//! program where the system allows it. Any other format is saved by passing
+//! every trace to the Output with that name.
+class Shard_Merger
+{
+private:
+    //! A shard that has been opened, along with the contents of its footer.
+    //! The file is closed when this is destroyed.
+    class Shard
+    {
+    private:
+        void load();
+
+    public:
+        const std::string Path;
+        const int File;
+        Output_Sharded::Header Header;
+        std::vector<std::uint64_t> Run_Indices;
+        std::vector<std::string> Extra_Data;
+
+        explicit Shard(const std::string& p_path);
+        ~Shard();
+
+        Shard(const Shard&) = delete;
+        Shard& operator=(const Shard&) = delete;
+    };
+
+    //! Where to find a single trace.
+    struct Trace
+    {
+        std::uint64_t Run_Index;
+        std::size_t Shard;
+        std::size_t Row;
+    };
+
+    //! The ways that bytes can be copied between files, fastest first. Each is
+    //! only used if the ones before it are not supported.
+    enum class Copy_Method
+    {
+        Copy_File_Range,
+        Sendfile,
+        Read_Write
+    };
+
+    const std::string m_output_path;
+    const std::string m_output_format;
+
+    std::vector<std::unique_ptr<const Shard>> m_shards;
+
+    //! Every trace, in run order.
+    std::vector<Trace> m_traces;
+
+    //! The number of samples in every trace.
+    std::size_t m_number_of_samples;
+
+    Copy_Method m_copy_method;
+
+    void write_exactly(const int p_file,
+                       const void* const p_data,
+                       const std::size_t p_size,
+                       const std::uint64_t p_offset) const;
+
+    void copy_range(const int p_input,
+                    std::uint64_t p_input_offset,
+                    const int p_output,
+                    std::uint64_t p_output_offset,
+                    std::size_t p_size);
+
+    void merge_array(const bool p_header);
+
+    void merge_output() const;
+
+public:
+    //! @brief Opens every shard and finds every trace within them. An error
+    //! is reported if the shards are not from the same run.
+    //! @param p_shard_paths The paths to the shards.
+    //! @param p_output_path The path to save the merged traces to.
+    //! @param p_output_format The name of the Output used to save the merged
+    //! traces.
+    Shard_Merger(const std::vector<std::string>& p_shard_paths,
+                 const std::string& p_output_path,
+                 const std::string& p_output_format);
+
+    Shard_Merger(const Shard_Merger&) = delete;
+    Shard_Merger& operator=(const Shard_Merger&) = delete;
+
+    //! @brief Saves every trace, in run order, to the output path.
+    void Merge();
+
+    //! @brief Retrieves the number of traces held by every shard together.
+    //! @returns The number of traces.
+    std::size_t Number_Of_Traces() const { return m_traces.size(); }
+
+    //! @brief Retrieves the number of shards being merged.
+    //! @returns The number of shards.
+    std::size_t Number_Of_Shards() const { return m_shards.size(); }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // SHARD_MERGER_HPP
@@ -0,0 +1,64 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_TRS.cpp
+    @brief Contains an Output that saves traces in the TRS format.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for sort
+#include <mutex>      // for lock_guard
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include <Traces_Serialiser.hpp>  // for Serialiser
+
+#include "Output_TRS.hpp"
+
+void GILES::Internal::Output_TRS::Add_Trace(
+    const std::size_t /*p_thread*/,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    m_traces.push_back({p_run_index, p_trace, p_extra_data});
+}
+
+void GILES::Internal::Output_TRS::Finish()
+{
+    std::sort(m_traces.begin(),
+              m_traces.end(),
+              [](const auto& a, const auto& b) {
+                  return a.Run_Index < b.Run_Index;
+              });
+
+    // Traces_Serialiser keeps its own copy so each trace is released once it
+    // has been handed over.
+    Traces_Serialiser::Serialiser<float> serialiser;
+    for (auto& trace : m_traces)
+    {
+        serialiser.Add_Trace(trace.Samples, trace.Extra_Data);
+        std::vector<float>().swap(trace.Samples);
+    }
+    m_traces.clear();
+
+    serialiser.Save(m_options.Path);
+}
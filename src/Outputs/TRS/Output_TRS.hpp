@@ -0,0 +1,87 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_TRS.hpp
+    @brief Contains an Output that saves traces in the TRS format.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_TRS_HPP
+#define OUTPUT_TRS_HPP
+
+#include <cstddef>  // for size_t
+#include <mutex>    // for mutex
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output.hpp"  // for Output_Interface
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_TRS
+//! @brief Saves the generated traces to a file in the TRS format, making use
+//! of Traces_Serialiser. Traces are saved in run order, regardless of the order
+//! that they were generated in.
+//! @see https://github.com/bristol-sca/Traces-Serialiser
+class Output_TRS : public virtual Output_Interface<Output_TRS>
+{
+private:
+    //! A trace waiting to be saved.
+    struct Trace
+    {
+        std::size_t Run_Index;
+        std::vector<float> Samples;
+        std::string Extra_Data;
+    };
+
+    //! Collects all traces until they are sorted and saved by Finish().
+    std::vector<Trace> m_traces;
+
+    //! Guards m_traces as traces are added from every thread.
+    std::mutex m_mutex;
+
+public:
+    //! @brief Constructs an Output that will save to the path given in
+    //! p_options.
+    //! @param p_options The settings for this Output.
+    explicit Output_TRS(const Output_Options& p_options)
+        : Output_Interface{p_options}, m_traces{}, m_mutex{}
+    {
+    }
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    //! @brief Retrieves the name of this Output.
+    //! @returns The name as a string.
+    //! @note This is needed to ensure self registration in the factory
+    //! works. The factory registration requires this as unique identifier.
+    static const std::string Get_Name() { return "TRS"; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_TRS_HPP
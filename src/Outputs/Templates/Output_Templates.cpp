@@ -0,0 +1,261 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Templates.cpp
+    @brief Contains an Output that builds profiled templates from the generated
+    traces without storing them.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdint>  // for uint8_t
+#include <fstream>  // for ofstream
+#include <mutex>    // for call_once
+#include <numeric>  // for iota
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <fmt/format.h>       // for format
+#include <nlohmann/json.hpp>  // for json
+
+#include "Output_Templates.hpp"
+
+#include "Error.hpp"  // for Report_Error, Report_Warning
+
+//! @brief Combines the accumulated means and co-moments of p_source into
+//! p_destination. Classes that are in both are merged using the pairwise
+//! update by Chan et al.
+//! @param p_destination The Accumulator to merge into.
+//! @param p_source The Accumulator to merge from.
+//! @see https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+void GILES::Internal::Output_Templates::merge(
+    Accumulator* const p_destination, const Accumulator& p_source)
+{
+    if (p_source.Classes.empty())
+    {
+        return;
+    }
+    if (p_destination->Classes.empty())
+    {
+        *p_destination = p_source;
+        return;
+    }
+
+    const std::size_t size{p_source.Sample.size()};
+    auto& co_moment = p_destination->Co_Moment;
+
+    for (std::size_t i{0}; i < co_moment.size(); ++i)
+    {
+        co_moment[i] += p_source.Co_Moment[i];
+    }
+
+    for (const auto& [label, source] : p_source.Classes)
+    {
+        auto& destination = p_destination->Classes[label];
+        if (0 == destination.Count)
+        {
+            destination = source;
+            continue;
+        }
+
+        const double count_a = static_cast<double>(destination.Count);
+        const double count_b = static_cast<double>(source.Count);
+        const double count   = count_a + count_b;
+
+        std::vector<double> delta(size);
+        for (std::size_t i{0}; i < size; ++i)
+        {
+            delta[i] = source.Mean[i] - destination.Mean[i];
+            destination.Mean[i] += delta[i] * count_b / count;
+        }
+
+        // The correction term for the difference between the two means.
+        const double scale{count_a * count_b / count};
+        for (std::size_t i{0}; i < size; ++i)
+        {
+            for (std::size_t j{0}; j < size; ++j)
+            {
+                co_moment[i * size + j] += delta[i] * delta[j] * scale;
+            }
+        }
+        destination.Count += source.Count;
+    }
+}
+
+//! @brief Converts a string of bytes into a printable hexadecimal string so
+//! that it can be used as a json key.
+//! @param p_bytes The bytes to convert.
+//! @returns Two lowercase hexadecimal characters for each byte.
+const std::string
+GILES::Internal::Output_Templates::to_hex(const std::string& p_bytes)
+{
+    std::string hex;
+    for (const auto byte : p_bytes)
+    {
+        hex += fmt::format("{:02x}", static_cast<std::uint8_t>(byte));
+    }
+    return hex;
+}
+
+//! @brief Creates one Accumulator for every thread.
+//! @param p_number_of_threads The number of threads that will add traces.
+void GILES::Internal::Output_Templates::Start(
+    const std::size_t /*p_number_of_runs*/,
+    const std::size_t p_number_of_threads)
+{
+    m_accumulators.assign(p_number_of_threads, Accumulator{});
+}
+
+//! @brief Updates the running mean of the class that p_trace belongs to and
+//! the pooled co-moment using Welford's algorithm.
+//! @see https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Welford's_online_algorithm
+void GILES::Internal::Output_Templates::Add_Trace(
+    const std::size_t p_thread,
+    const std::size_t p_run_index,
+    const std::vector<float>& p_trace,
+    const std::string& p_extra_data)
+{
+    // If no points of interest were given then use every sample.
+    std::call_once(m_points_of_interest_resolved, [this, &p_trace] {
+        if (m_points_of_interest.empty())
+        {
+            m_points_of_interest.resize(p_trace.size());
+            std::iota(
+                m_points_of_interest.begin(), m_points_of_interest.end(), 0);
+        }
+    });
+
+    if (p_extra_data.size() < m_options.Label_Offset + m_options.Label_Length)
+    {
+        Error::Report_Error("The extra data of trace {} is {} bytes long. This "
+                            "is too short to contain a template label of {} "
+                            "byte(s) at offset {}.",
+                            p_run_index,
+                            p_extra_data.size(),
+                            m_options.Label_Length,
+                            m_options.Label_Offset);
+    }
+
+    const std::size_t size{m_points_of_interest.size()};
+    auto& accumulator = m_accumulators.at(p_thread);
+    if (accumulator.Co_Moment.empty())
+    {
+        accumulator.Co_Moment.assign(size * size, 0);
+        accumulator.Sample.resize(size);
+        accumulator.Delta.resize(size);
+    }
+
+    for (std::size_t i{0}; i < size; ++i)
+    {
+        if (m_points_of_interest[i] >= p_trace.size())
+        {
+            Error::Report_Error("The point of interest {} is outside of trace "
+                                "{} which has {} samples.",
+                                m_points_of_interest[i],
+                                p_run_index,
+                                p_trace.size());
+        }
+        accumulator.Sample[i] = p_trace[m_points_of_interest[i]];
+    }
+
+    auto& label = accumulator.Classes[p_extra_data.substr(
+        m_options.Label_Offset, m_options.Label_Length)];
+    if (label.Mean.empty())
+    {
+        label.Mean.assign(size, 0);
+    }
+    ++label.Count;
+
+    const auto& sample = accumulator.Sample;
+    auto& delta        = accumulator.Delta;
+    for (std::size_t i{0}; i < size; ++i)
+    {
+        delta[i] = sample[i] - label.Mean[i];
+        label.Mean[i] += delta[i] / static_cast<double>(label.Count);
+    }
+
+    // Uses the difference from both the old and the updated mean.
+    for (std::size_t i{0}; i < size; ++i)
+    {
+        for (std::size_t j{0}; j < size; ++j)
+        {
+            accumulator.Co_Moment[i * size + j] +=
+                delta[i] * (sample[j] - label.Mean[j]);
+        }
+    }
+}
+
+//! @brief Combines the accumulation from every thread and saves the templates
+//! to the path given in the options as a json file.
+void GILES::Internal::Output_Templates::Finish()
+{
+    Accumulator total;
+    for (const auto& accumulator : m_accumulators)
+    {
+        merge(&total, accumulator);
+    }
+
+    const std::size_t size{m_points_of_interest.size()};
+    std::size_t number_of_traces{0};
+
+    nlohmann::json json;
+    json["Points_Of_Interest"] = m_points_of_interest;
+    json["Classes"]            = nlohmann::json::object();
+    for (const auto& [label, mean] : total.Classes)
+    {
+        json["Classes"][to_hex(label)] = {{"Count", mean.Count},
+                                          {"Mean", mean.Mean}};
+        number_of_traces += mean.Count;
+    }
+    json["Traces"] = number_of_traces;
+
+    // Each class loses one degree of freedom to its own mean.
+    const std::size_t degrees_of_freedom{
+        number_of_traces > total.Classes.size()
+            ? number_of_traces - total.Classes.size()
+            : 0};
+    if (0 == degrees_of_freedom)
+    {
+        Error::Report_Warning("Not enough traces were generated to estimate a "
+                              "pooled covariance for {} classes.",
+                              total.Classes.size());
+    }
+
+    std::vector<std::vector<double>> covariance(size,
+                                                std::vector<double>(size, 0));
+    for (std::size_t i{0}; i < size && 0 != degrees_of_freedom; ++i)
+    {
+        for (std::size_t j{0}; j < size; ++j)
+        {
+            // Averaged with the transpose to remove rounding asymmetry.
+            covariance[i][j] = (total.Co_Moment[i * size + j] +
+                                total.Co_Moment[j * size + i]) /
+                               (2.0 * static_cast<double>(degrees_of_freedom));
+        }
+    }
+    json["Pooled_Covariance"] = covariance;
+
+    std::ofstream file{m_options.Path};
+    if (!file.is_open())
+    {
+        Error::Report_Error("Could not open '{}' to save the templates",
+                            m_options.Path);
+    }
+    file << json.dump(4) << '\n';
+}
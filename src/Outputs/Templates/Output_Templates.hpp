@@ -0,0 +1,124 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Output_Templates.hpp
+    @brief Contains an Output that builds profiled templates from the generated
+    traces without storing them.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef OUTPUT_TEMPLATES_HPP
+#define OUTPUT_TEMPLATES_HPP
+
+#include <cstddef>  // for size_t
+#include <map>      // for map
+#include <mutex>    // for once_flag
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Output.hpp"  // for Output_Interface
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Output_Templates
+//! @brief Builds the templates needed for a template attack: the mean trace of
+//! each class and a single covariance matrix pooled over all classes. Only the
+//! points of interest are considered. Each trace is assigned a class using a
+//! label taken from the extra data given by the simulator.
+//! The means and covariance are updated incrementally, as each trace arrives,
+//! so that the traces themselves never need to be stored. Each thread
+//! accumulates separately and these are combined when Finish() is called.
+//! @see https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+//! @see https://link.springer.com/chapter/10.1007/3-540-36400-5_3
+class Output_Templates : public virtual Output_Interface<Output_Templates>
+{
+private:
+    //! The running mean of all of the traces within one class.
+    struct Class_Mean
+    {
+        std::size_t Count{0};
+        std::vector<double> Mean{};
+    };
+
+    //! Everything accumulated by a single thread.
+    struct Accumulator
+    {
+        //! The running mean of each class, indexed by the class label.
+        std::map<std::string, Class_Mean> Classes{};
+
+        //! The sum, over every class, of the co-moments
+        //! (x - mean) * (x - mean)^T, stored in row-major order. Only a single
+        //! sum needs to be stored as the covariance is pooled.
+        std::vector<double> Co_Moment{};
+
+        //! Reused between traces to avoid allocating for every trace.
+        std::vector<double> Sample{};
+        std::vector<double> Delta{};
+    };
+
+    //! One Accumulator per thread so that no locking is needed.
+    std::vector<Accumulator> m_accumulators;
+
+    //! The samples used from each trace. This is either given in the options
+    //! or it is every sample in the first trace.
+    std::vector<std::size_t> m_points_of_interest;
+
+    //! Ensures m_points_of_interest is only resolved once.
+    std::once_flag m_points_of_interest_resolved;
+
+    static void merge(Accumulator* const p_destination,
+                      const Accumulator& p_source);
+
+    static const std::string to_hex(const std::string& p_bytes);
+
+public:
+    //! @brief Constructs an Output that will save the templates to the path
+    //! given in p_options.
+    //! @param p_options The settings for this Output. The points of interest
+    //! and the location of the label are used as well as the path.
+    explicit Output_Templates(const Output_Options& p_options)
+        : Output_Interface{p_options}, m_accumulators{},
+          m_points_of_interest{p_options.Points_Of_Interest},
+          m_points_of_interest_resolved{}
+    {
+    }
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override;
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& p_trace,
+                   const std::string& p_extra_data) override;
+
+    void Finish() override;
+
+    //! @brief Retrieves the name of this Output.
+    //! @returns The name as a string.
+    //! @note This is needed to ensure self registration in the factory
+    //! works. The factory registration requires this as unique identifier.
+    static const std::string Get_Name() { return "Templates"; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // OUTPUT_TEMPLATES_HPP
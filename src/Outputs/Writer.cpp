@@ -0,0 +1,516 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Writer.cpp
+    @brief Contains the Writer class which writes to a file in the background.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for min, max
+#include <cerrno>     // for errno, EINTR, EAGAIN
+#include <cstdint>    // for uint64_t
+#include <cstdlib>    // for posix_memalign
+#include <cstring>    // for memcpy, strerror
+#include <memory>     // for unique_ptr, make_unique
+#include <mutex>      // for unique_lock
+#include <string>     // for string
+#include <thread>     // for thread
+#include <utility>    // for move
+
+#include <fcntl.h>   // for open, O_CREAT, O_TRUNC, O_WRONLY
+#include <unistd.h>  // for close, ftruncate, lseek, pwrite
+
+#ifdef GILES_HAVE_LIBURING
+#include <liburing.h>  // for io_uring
+#else
+#include <deque>  // for deque
+#endif
+
+#include <fmt/format.h>  // for format
+
+#include "Writer.hpp"
+
+#include "Error.hpp"          // for Report_Error
+#include "Memory_Budget.hpp"  // for Memory_Budget
+
+namespace
+{
+//! The alignment of every block, matching the page size of most systems.
+constexpr std::size_t alignment{4096};
+
+//! The largest size of each block filled by Append().
+constexpr std::size_t maximum_block_size{1024 * 1024};
+
+#ifdef GILES_HAVE_LIBURING
+//! The number of writes that can be submitted to io_uring at once.
+constexpr unsigned ring_entries{64};
+#endif
+}  // namespace
+
+#ifdef GILES_HAVE_LIBURING
+struct GILES::Internal::Writer::Backend
+{
+    io_uring Ring;
+};
+#else
+struct GILES::Internal::Writer::Backend
+{
+    //! The writes waiting for the background thread.
+    std::deque<Request*> Queue{};
+
+    //! Set once the background thread should stop after emptying Queue.
+    bool Stopping{false};
+
+    //! Signalled whenever Queue or Stopping changes.
+    std::condition_variable Queued{};
+};
+#endif
+
+GILES::Internal::Writer::Writer(const std::string& p_path,
+                                const std::size_t p_budget,
+                                const bool p_keep_contents)
+    : m_path{p_path},
+      m_block_size{std::max(alignment,
+                            std::min(maximum_block_size, p_budget / 2))},
+      m_budget{p_budget}, m_file{-1}, m_block{}, m_free_blocks{},
+      m_append_start{0}, m_position{0}, m_in_flight{0}, m_error{}, m_mutex{},
+      m_completed{}, m_backend{std::make_unique<Backend>()}, m_thread{}
+{
+    m_file = ::open(m_path.c_str(),
+                    O_WRONLY | O_CREAT | (p_keep_contents ? 0 : O_TRUNC),
+                    0644);
+    if (m_file < 0)
+    {
+        Error::Report_Error(
+            "Could not open '{}' for writing. {}", m_path, std::strerror(errno));
+    }
+
+    // Anything given to Append() follows what is already in the file.
+    if (p_keep_contents)
+    {
+        const auto size = ::lseek(m_file, 0, SEEK_END);
+        m_append_start  = size < 0 ? 0 : static_cast<std::uint64_t>(size);
+        m_position      = m_append_start;
+    }
+
+#ifdef GILES_HAVE_LIBURING
+    const int result{io_uring_queue_init(ring_entries, &m_backend->Ring, 0)};
+    if (result < 0)
+    {
+        Error::Report_Error("Could not set up io_uring to write '{}'. {}",
+                            m_path,
+                            std::strerror(-result));
+    }
+#endif
+
+    m_thread = std::thread{&Writer::run, this};
+}
+
+GILES::Internal::Writer::~Writer()
+{
+    try
+    {
+        close();
+        if (!m_error.empty())
+        {
+            Error::Report_Warning("{}", m_error);
+        }
+    }
+    catch (...)
+    {
+        // Nothing can be done about an error at this point.
+    }
+}
+
+//! @brief Allocates an aligned buffer for a write, reusing a previous block if
+//! one is available and large enough.
+//! @param p_size The number of bytes that will be written.
+//! @returns An empty Request, with at least p_size bytes of Data.
+std::unique_ptr<GILES::Internal::Writer::Request>
+GILES::Internal::Writer::allocate(const std::size_t p_size)
+{
+    if (p_size <= m_block_size && !m_free_blocks.empty())
+    {
+        auto request = std::move(m_free_blocks.back());
+        m_free_blocks.pop_back();
+        request->Size    = 0;
+        request->Written = 0;
+        request->Offset  = 0;
+        return request;
+    }
+
+    const std::size_t capacity{
+        (std::max(p_size, m_block_size) + alignment - 1) / alignment *
+        alignment};
+    void* data{nullptr};
+    if (0 != ::posix_memalign(&data, alignment, capacity))
+    {
+        Error::Report_Error("Could not allocate memory to write '{}'", m_path);
+    }
+
+    auto request = std::make_unique<Request>();
+    request->Data.reset(static_cast<char*>(data));
+    request->Capacity = capacity;
+    return request;
+}
+
+//! @brief Hands a Request to the background, first waiting while doing so
+//! would exceed the budget. A single Request larger than the budget is allowed
+//! once nothing else is waiting.
+//! @param p_request The Request to write.
+//! @param p_lock The held lock on m_mutex.
+void GILES::Internal::Writer::submit(std::unique_ptr<Request> p_request,
+                                     std::unique_lock<std::mutex>* const p_lock)
+{
+    const std::size_t size{p_request->Size};
+    m_completed.wait(*p_lock, [this, size] {
+        return 0 == m_in_flight || m_in_flight + size <= m_budget;
+    });
+    m_in_flight += size;
+    Memory_Budget::Add_Queued(size);
+    issue(p_request.release());
+}
+
+//! @brief Starts writing the part of p_request that has not been written.
+//! @param p_request The Request to write. Ownership is passed to the
+//! background until complete() is called.
+//! @note m_mutex must be held.
+void GILES::Internal::Writer::issue(Request* const p_request)
+{
+#ifdef GILES_HAVE_LIBURING
+    io_uring_sqe* sqe{io_uring_get_sqe(&m_backend->Ring)};
+    if (nullptr == sqe)
+    {
+        // The submission queue is full, submitting empties it.
+        io_uring_submit(&m_backend->Ring);
+        sqe = io_uring_get_sqe(&m_backend->Ring);
+    }
+    io_uring_prep_write(sqe,
+                        m_file,
+                        p_request->Data.get() + p_request->Written,
+                        static_cast<unsigned>(p_request->Size -
+                                              p_request->Written),
+                        p_request->Offset + p_request->Written);
+    io_uring_sqe_set_data(sqe, p_request);
+    io_uring_submit(&m_backend->Ring);
+#else
+    m_backend->Queue.push_back(p_request);
+    m_backend->Queued.notify_one();
+#endif
+}
+
+//! @brief Accounts for a finished Request, keeping its buffer for reuse if it
+//! is the size of a block.
+//! @param p_request The finished Request.
+//! @note m_mutex must be held.
+void GILES::Internal::Writer::complete(Request* const p_request)
+{
+    std::unique_ptr<Request> request{p_request};
+    m_in_flight -= request->Size;
+    Memory_Budget::Remove_Queued(request->Size);
+
+    // Only enough blocks to fill the budget are kept.
+    if (request->Capacity == m_block_size &&
+        m_free_blocks.size() * m_block_size < m_budget)
+    {
+        m_free_blocks.push_back(std::move(request));
+    }
+
+    m_completed.notify_all();
+}
+
+//! @brief Run by the background thread. Completes writes until Close() is
+//! called.
+void GILES::Internal::Writer::run()
+{
+#ifdef GILES_HAVE_LIBURING
+    while (true)
+    {
+        io_uring_cqe* cqe{nullptr};
+        const int result{io_uring_wait_cqe(&m_backend->Ring, &cqe)};
+        if (-EINTR == result)
+        {
+            continue;
+        }
+        if (result < 0)
+        {
+            // Nothing more can be completed so every write is abandoned.
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_error.empty())
+            {
+                m_error = fmt::format("Could not write to '{}'. {}",
+                                      m_path,
+                                      std::strerror(-result));
+            }
+            Memory_Budget::Remove_Queued(m_in_flight);
+            m_in_flight = 0;
+            m_completed.notify_all();
+            return;
+        }
+
+        auto* const request = static_cast<Request*>(io_uring_cqe_get_data(cqe));
+        const int written{cqe->res};
+        io_uring_cqe_seen(&m_backend->Ring, cqe);
+
+        // Close() submits an empty request to stop this thread.
+        if (nullptr == request)
+        {
+            return;
+        }
+
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        if (-EINTR == written || -EAGAIN == written)
+        {
+            issue(request);
+            continue;
+        }
+        if (written <= 0)
+        {
+            // The rest of the request is abandoned.
+            if (m_error.empty())
+            {
+                m_error = fmt::format("Could not write to '{}'. {}",
+                                      m_path,
+                                      std::strerror(-written));
+            }
+            complete(request);
+            continue;
+        }
+
+        request->Written += static_cast<std::size_t>(written);
+        if (request->Written < request->Size)
+        {
+            issue(request);
+        }
+        else
+        {
+            complete(request);
+        }
+    }
+#else
+    std::unique_lock<std::mutex> lock{m_mutex};
+    while (true)
+    {
+        m_backend->Queued.wait(lock, [this] {
+            return !m_backend->Queue.empty() || m_backend->Stopping;
+        });
+        if (m_backend->Queue.empty())
+        {
+            return;
+        }
+        Request* const request{m_backend->Queue.front()};
+        m_backend->Queue.pop_front();
+
+        lock.unlock();
+        int error{0};
+        while (request->Written < request->Size)
+        {
+            const auto written = ::pwrite(
+                m_file,
+                request->Data.get() + request->Written,
+                request->Size - request->Written,
+                static_cast<off_t>(request->Offset + request->Written));
+            if (written < 0)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+
+                // The rest of the request is abandoned.
+                error = errno;
+                break;
+            }
+            request->Written += static_cast<std::size_t>(written);
+        }
+        lock.lock();
+
+        if (0 != error && m_error.empty())
+        {
+            m_error = fmt::format(
+                "Could not write to '{}'. {}", m_path, std::strerror(error));
+        }
+
+        complete(request);
+    }
+#endif
+}
+
+//! @brief Hands the partially filled block to the background and waits until
+//! everything has been written.
+//! @param p_lock The held lock on m_mutex.
+void GILES::Internal::Writer::flush(std::unique_lock<std::mutex>* const p_lock)
+{
+    if (m_block && 0 != m_block->Size)
+    {
+        submit(std::move(m_block), p_lock);
+    }
+    m_completed.wait(*p_lock, [this] { return 0 == m_in_flight; });
+}
+
+//! @brief Reports the first error met while writing in the background, if
+//! there has been one. It is only reported once.
+//! @param p_lock The held lock on m_mutex. This is released before reporting
+//! the error, as that may throw.
+void GILES::Internal::Writer::report_error(
+    std::unique_lock<std::mutex>* const p_lock)
+{
+    if (m_error.empty())
+    {
+        return;
+    }
+    const std::string error{std::move(m_error)};
+    m_error.clear();
+    p_lock->unlock();
+    Error::Report_Error("{}", error);
+}
+
+//! @brief Writes anything still waiting, stops the background and closes the
+//! file. Any error is kept in m_error rather than being reported.
+void GILES::Internal::Writer::close()
+{
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        if (m_file < 0)
+        {
+            return;
+        }
+        flush(&lock);
+
+#ifdef GILES_HAVE_LIBURING
+        io_uring_sqe* sqe{io_uring_get_sqe(&m_backend->Ring)};
+        if (nullptr == sqe)
+        {
+            io_uring_submit(&m_backend->Ring);
+            sqe = io_uring_get_sqe(&m_backend->Ring);
+        }
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, nullptr);
+        io_uring_submit(&m_backend->Ring);
+#else
+        m_backend->Stopping = true;
+        m_backend->Queued.notify_one();
+#endif
+    }
+
+    m_thread.join();
+
+#ifdef GILES_HAVE_LIBURING
+    io_uring_queue_exit(&m_backend->Ring);
+#endif
+
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    if (0 != ::close(m_file) && m_error.empty())
+    {
+        m_error = fmt::format(
+            "Could not close '{}'. {}", m_path, std::strerror(errno));
+    }
+    m_file = -1;
+}
+
+void GILES::Internal::Writer::Append(const void* const p_data,
+                                     const std::size_t p_size)
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    const auto* data = static_cast<const char*>(p_data);
+    std::size_t remaining{p_size};
+    while (0 != remaining)
+    {
+        if (!m_block)
+        {
+            m_block         = allocate(m_block_size);
+            m_block->Offset = m_position;
+        }
+
+        const std::size_t size{
+            std::min(remaining, m_block_size - m_block->Size)};
+        std::memcpy(m_block->Data.get() + m_block->Size, data, size);
+        m_block->Size += size;
+        m_position += size;
+        data += size;
+        remaining -= size;
+
+        if (m_block->Size == m_block_size)
+        {
+            submit(std::move(m_block), &lock);
+        }
+    }
+}
+
+void GILES::Internal::Writer::Write(const void* const p_data,
+                                    const std::size_t p_size,
+                                    const std::uint64_t p_offset)
+{
+    if (0 == p_size)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    // Writes that overlap each other may complete in any order, so anything
+    // given to Append() that this overlaps is written first. Only what was
+    // given to Append() is checked, so writes over the contents of a file
+    // that was kept, e.g. one sized by Resize() before being interrupted,
+    // are not held up.
+    if (p_offset < m_position && p_offset + p_size > m_append_start)
+    {
+        flush(&lock);
+    }
+
+    auto request = allocate(p_size);
+    std::memcpy(request->Data.get(), p_data, p_size);
+    request->Size   = p_size;
+    request->Offset = p_offset;
+    submit(std::move(request), &lock);
+}
+
+std::uint64_t GILES::Internal::Writer::Position()
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    return m_position;
+}
+
+void GILES::Internal::Writer::Flush()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    flush(&lock);
+    report_error(&lock);
+}
+
+void GILES::Internal::Writer::Resize(const std::uint64_t p_size)
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    flush(&lock);
+    report_error(&lock);
+    if (0 != ::ftruncate(m_file, static_cast<off_t>(p_size)))
+    {
+        Error::Report_Error(
+            "Could not resize '{}'. {}", m_path, std::strerror(errno));
+    }
+}
+
+void GILES::Internal::Writer::Close()
+{
+    close();
+    std::unique_lock<std::mutex> lock{m_mutex};
+    report_error(&lock);
+}
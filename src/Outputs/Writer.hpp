@@ -0,0 +1,207 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Writer.hpp
+    @brief Contains the Writer class which writes to a file in the background.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef WRITER_HPP
+#define WRITER_HPP
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for uint64_t
+#include <cstdlib>             // for free
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex, unique_lock
+#include <string>              // for string
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Writer
+//! @brief Writes to a file in the background so that the caller only waits
+//! for the disk when too much is waiting to be written. Data is copied into
+//! large, aligned blocks. Once a block is full it is handed to the background
+//! and the next block is filled while the first is written.
+//!
+//! When GILES is built with liburing, blocks are written using io_uring.
+//! Otherwise a single background thread writes them using pwrite().
+//!
+//! Callers only wait when the bytes waiting to be written would exceed the
+//! budget given on construction, so memory use is bounded. The bytes waiting
+//! to be written are also accounted for by the Memory_Budget.
+//! @note Every member function may be called from any thread.
+class Writer
+{
+private:
+    //! Frees memory allocated by posix_memalign().
+    struct Buffer_Deleter
+    {
+        void operator()(char* const p_buffer) const { std::free(p_buffer); }
+    };
+
+    //! A single write that is being filled or waiting to be written.
+    struct Request
+    {
+        std::unique_ptr<char, Buffer_Deleter> Data{};
+
+        //! The number of bytes allocated for Data.
+        std::size_t Capacity{0};
+
+        //! The number of bytes of Data to write.
+        std::size_t Size{0};
+
+        //! The number of bytes that have been written so far.
+        std::size_t Written{0};
+
+        //! The position within the file to write to.
+        std::uint64_t Offset{0};
+    };
+
+    //! The state used by the method of writing chosen when GILES was built.
+    struct Backend;
+
+    const std::string m_path;
+
+    //! The size of each block filled by Append().
+    const std::size_t m_block_size;
+
+    //! The number of bytes that can wait to be written before callers have to
+    //! wait.
+    const std::size_t m_budget;
+
+    int m_file;
+
+    //! The block currently being filled by Append().
+    std::unique_ptr<Request> m_block;
+
+    //! Written blocks that can be reused.
+    std::vector<std::unique_ptr<Request>> m_free_blocks;
+
+    //! The position in the file of the first byte given to Append(). This is
+    //! the end of the file, if its contents were kept when it was opened.
+    std::uint64_t m_append_start;
+
+    //! The position in the file of the next byte given to Append().
+    std::uint64_t m_position;
+
+    //! The number of bytes handed to the background that have not been
+    //! written yet.
+    std::size_t m_in_flight;
+
+    //! The first error met while writing in the background, or empty if
+    //! there has not been one. This is reported on the calling thread by the
+    //! next call to Flush(), Resize() or Close().
+    std::string m_error;
+
+    //! Guards every member above and the Backend.
+    std::mutex m_mutex;
+
+    //! Signalled every time a write completes.
+    std::condition_variable m_completed;
+
+    std::unique_ptr<Backend> m_backend;
+
+    //! Completes the writes handed to the background.
+    std::thread m_thread;
+
+    std::unique_ptr<Request> allocate(const std::size_t p_size);
+
+    void submit(std::unique_ptr<Request> p_request,
+                std::unique_lock<std::mutex>* const p_lock);
+
+    void issue(Request* const p_request);
+
+    void complete(Request* const p_request);
+
+    void run();
+
+    void flush(std::unique_lock<std::mutex>* const p_lock);
+
+    void report_error(std::unique_lock<std::mutex>* const p_lock);
+
+    void close();
+
+public:
+    //! @brief Opens, or creates, the file at p_path, removing anything already
+    //! in it unless p_keep_contents is true.
+    //! @param p_path The path to the file to write.
+    //! @param p_budget The number of bytes that can wait to be written before
+    //! callers have to wait.
+    //! @param p_keep_contents Whether to keep what is already in the file. If
+    //! so, Append() adds to the end of it.
+    Writer(const std::string& p_path,
+           const std::size_t p_budget,
+           const bool p_keep_contents = false);
+
+    //! @brief Writes anything still waiting and closes the file. Errors can
+    //! not be reported from here, as that may throw, so they are only printed
+    //! as a warning. Close() should be called first to report them.
+    ~Writer();
+
+    //! @brief Copies p_size bytes to be written after everything given to
+    //! previous calls.
+    //! @param p_data The bytes to write.
+    //! @param p_size The number of bytes to write.
+    void Append(const void* const p_data, const std::size_t p_size);
+
+    //! @brief Copies p_size bytes to be written at p_offset. This is
+    //! independent of Append() and is intended for writing data to a known
+    //! position, such as updating a header. If this overlaps the data given to
+    //! Append() then that data is written first, so that it is overwritten.
+    //! Writes that do not overlap it are written in the background, including
+    //! those within the contents kept when the file was opened.
+    //! @warning Writes given to this that overlap each other may be written in
+    //! any order.
+    //! @param p_data The bytes to write.
+    //! @param p_size The number of bytes to write.
+    //! @param p_offset The position within the file to write to.
+    void Write(const void* const p_data,
+               const std::size_t p_size,
+               const std::uint64_t p_offset);
+
+    //! @brief Retrieves the position in the file that the next byte given to
+    //! Append() will be written to.
+    //! @returns The number of bytes given to Append() so far, after the size
+    //! of the file when it was opened if its contents were kept.
+    std::uint64_t Position();
+
+    //! @brief Waits until everything given so far has been written.
+    void Flush();
+
+    //! @brief Waits until everything given so far has been written and then
+    //! sets the size of the file, adding zeros or removing bytes from the end.
+    //! @param p_size The size of the file in bytes.
+    void Resize(const std::uint64_t p_size);
+
+    //! @brief Waits until everything given so far has been written and then
+    //! closes the file. Nothing can be written afterwards. Any error met while
+    //! writing is reported.
+    void Close();
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // WRITER_HPP
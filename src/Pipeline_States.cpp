@@ -0,0 +1,153 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Pipeline_States.cpp
+    @brief Contains the Pipeline_States class which stores the state of a
+    pipeline stage throughout an Execution as runs of abnormal states.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for max, upper_bound
+#include <stdexcept>  // for out_of_range
+#include <utility>    // for move
+
+#include "Pipeline_States.hpp"
+
+void GILES::Internal::Pipeline_States::append(std::vector<Run>* const p_runs,
+                                              const Run& p_run)
+{
+    if (!p_runs->empty() && p_run.State == p_runs->back().State &&
+        p_run.First == p_runs->back().First + p_runs->back().Length)
+    {
+        p_runs->back().Length += p_run.Length;
+    }
+    else
+    {
+        p_runs->push_back(p_run);
+    }
+}
+
+const GILES::Internal::Pipeline_States::Run*
+GILES::Internal::Pipeline_States::find(const std::size_t p_cycle) const
+{
+    // Find the last run starting at or before p_cycle.
+    const auto next = std::upper_bound(
+        m_runs.begin(),
+        m_runs.end(),
+        p_cycle,
+        [](const std::size_t p_i, const Run& p_run) {
+            return p_i < p_run.First;
+        });
+    if (m_runs.begin() == next)
+    {
+        return nullptr;
+    }
+    const Run& run{*(next - 1)};
+    return p_cycle < run.First + run.Length ? &run : nullptr;
+}
+
+void GILES::Internal::Pipeline_States::Set(const std::size_t p_first,
+                                           const std::size_t p_length,
+                                           const Pipeline_State p_state)
+{
+    if (p_first + p_length > m_number_of_cycles)
+    {
+        throw std::out_of_range(
+            "Cannot set the state of cycles past the end of the stage");
+    }
+    if (0 == p_length)
+    {
+        return;
+    }
+
+    const Run new_run{p_first, p_length, p_state};
+    const std::size_t last{p_first + p_length};
+
+    // Cycles are usually set in order so this can simply be added to the end.
+    if (m_runs.empty() || p_first >= m_runs.back().First + m_runs.back().Length)
+    {
+        if (Pipeline_State::Normal != p_state)
+        {
+            append(&m_runs, new_run);
+        }
+        return;
+    }
+
+    // Otherwise rebuild the runs, cutting out the cycles being set.
+    std::vector<Run> runs;
+    runs.reserve(m_runs.size() + 2);
+    bool added{false};
+    for (const Run& run : m_runs)
+    {
+        const std::size_t end{run.First + run.Length};
+        if (end <= p_first)
+        {
+            append(&runs, run);
+            continue;
+        }
+        if (!added)
+        {
+            if (run.First < p_first)
+            {
+                append(&runs, {run.First, p_first - run.First, run.State});
+            }
+            if (Pipeline_State::Normal != p_state)
+            {
+                append(&runs, new_run);
+            }
+            added = true;
+        }
+        if (end > last)
+        {
+            const std::size_t first{std::max(run.First, last)};
+            append(&runs, {first, end - first, run.State});
+        }
+    }
+    m_runs = std::move(runs);
+}
+
+GILES::Internal::Pipeline_State
+GILES::Internal::Pipeline_States::Get(const std::size_t p_cycle) const
+{
+    if (p_cycle >= m_number_of_cycles)
+    {
+        throw std::out_of_range("The cycle is past the end of the stage");
+    }
+    const Run* const run{find(p_cycle)};
+    return nullptr == run ? Pipeline_State::Normal : run->State;
+}
+
+std::size_t
+GILES::Internal::Pipeline_States::Next_Normal(const std::size_t p_cycle) const
+{
+    if (p_cycle >= m_number_of_cycles)
+    {
+        return m_number_of_cycles;
+    }
+
+    // Runs in different states may be adjacent so keep skipping until a
+    // Normal cycle is reached.
+    std::size_t cycle{p_cycle};
+    while (const Run* const run{find(cycle)})
+    {
+        cycle = run->First + run->Length;
+    }
+    return cycle;
+}
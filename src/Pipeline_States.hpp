@@ -0,0 +1,134 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Pipeline_States.hpp
+    @brief Contains the Pipeline_States class which stores the state of a
+    pipeline stage throughout an Execution as runs of abnormal states.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef PIPELINE_STATES_HPP
+#define PIPELINE_STATES_HPP
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+namespace GILES
+{
+namespace Internal
+{
+//! The states that a processor pipeline stage can be in. These are needed
+//! to be stored as if the pipeline stage is not running smoothly (i.e.
+//! Normal state) then it could prevent leakage from being calculated in a
+//! normal fashion.
+//! @see https://en.wikipedia.org/wiki/Pipeline_stall
+//! @see https://en.wikipedia.org/wiki/Pipeline_flush
+enum class Pipeline_State
+{
+    Normal,
+    Stalled,
+    Flushing
+};
+
+//! @class Pipeline_States
+//! @brief The state of one pipeline stage during every clock cycle. Almost
+//! every cycle is Normal, so only the runs of consecutive cycles in any other
+//! state are stored. This allows the Normal cycles to be iterated over while
+//! skipping whole stalls or flushes at once.
+class Pipeline_States
+{
+public:
+    //! Consecutive cycles that are all in the same, abnormal, state.
+    struct Run
+    {
+        std::size_t First;
+        std::size_t Length;
+        Pipeline_State State;
+
+        bool operator==(const Run& p_other) const
+        {
+            return First == p_other.First && Length == p_other.Length &&
+                   State == p_other.State;
+        }
+    };
+
+private:
+    std::size_t m_number_of_cycles;
+
+    //! The runs sorted by their first cycle. These do not overlap and adjacent
+    //! runs in the same state are merged.
+    std::vector<Run> m_runs;
+
+    //! @brief Adds p_run to the end of p_runs, merging it with the last run if
+    //! they are adjacent and in the same state.
+    static void append(std::vector<Run>* const p_runs, const Run& p_run);
+
+    //! @brief Finds the run containing a clock cycle.
+    //! @returns The run or nullptr if the cycle is Normal.
+    const Run* find(const std::size_t p_cycle) const;
+
+public:
+    //! @brief Creates the states of a pipeline stage where every cycle is
+    //! Normal.
+    //! @param p_number_of_cycles The number of clock cycles.
+    explicit Pipeline_States(const std::size_t p_number_of_cycles)
+        : m_number_of_cycles{p_number_of_cycles}, m_runs{}
+    {
+    }
+
+    //! @brief Sets the state of consecutive clock cycles. This is fastest when
+    //! cycles are set in order.
+    //! @param p_first The first clock cycle.
+    //! @param p_length The number of clock cycles.
+    //! @param p_state The state of those cycles.
+    //! @throws std::out_of_range When the cycles are past the end of the stage.
+    void Set(const std::size_t p_first,
+             const std::size_t p_length,
+             const Pipeline_State p_state);
+
+    //! @brief Retrieves the state during a clock cycle.
+    //! @param p_cycle The clock cycle.
+    //! @returns The state.
+    //! @throws std::out_of_range When p_cycle is past the end of the stage.
+    Pipeline_State Get(const std::size_t p_cycle) const;
+
+    //! @brief Finds the next Normal clock cycle, skipping any runs of other
+    //! states.
+    //! @param p_cycle The clock cycle to start from.
+    //! @returns The first Normal cycle at or after p_cycle or
+    //! Get_Cycle_Count() if there are none.
+    std::size_t Next_Normal(const std::size_t p_cycle) const;
+
+    std::size_t Get_Cycle_Count() const { return m_number_of_cycles; }
+
+    //! @brief Retrieves every run of cycles that are not Normal.
+    //! @returns The runs sorted by their first cycle.
+    const std::vector<Run>& Get_Runs() const { return m_runs; }
+
+    bool operator==(const Pipeline_States& p_other) const
+    {
+        return m_number_of_cycles == p_other.m_number_of_cycles &&
+               m_runs == p_other.m_runs;
+    }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // PIPELINE_STATES_HPP
@@ -0,0 +1,255 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Program_Image.cpp
+    @brief Contains the Program_Image class which allows the memory of a target
+    program to be changed before it is loaded into a simulator.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdint>   // for uint16_t, uint32_t, uint64_t
+#include <cstring>   // for memcmp
+#include <fstream>   // for ifstream, ofstream
+#include <iterator>  // for istreambuf_iterator
+#include <string>    // for string
+
+#include "Program_Image.hpp"
+
+#include "Error.hpp"  // for Report_Error
+
+namespace
+{
+//! The first bytes of every ELF file.
+constexpr char elf_magic[]{0x7f, 'E', 'L', 'F'};
+
+//! The type of a program header describing a segment loaded into memory.
+constexpr std::uint32_t loadable_segment{1};
+
+//! The type of a section holding the symbol table.
+constexpr std::uint32_t symbol_table{2};
+
+//! The type of a symbol naming a function.
+constexpr unsigned char function_symbol{2};
+
+//! @brief Reads a little-endian value from within an ELF file.
+//! @tparam value_t The type of the value.
+//! @param p_contents The contents of the file.
+//! @param p_offset The position of the value within the file.
+//! @returns The value.
+template <typename value_t>
+value_t read(const std::string& p_contents, const std::size_t p_offset)
+{
+    value_t value{0};
+    for (std::size_t i{0}; i < sizeof(value_t); ++i)
+    {
+        value |= static_cast<value_t>(
+                     static_cast<unsigned char>(p_contents[p_offset + i]))
+                 << (8 * i);
+    }
+    return value;
+}
+}  // namespace
+
+//! @brief Loads the program and finds every segment that is loaded from the
+//! file into memory.
+GILES::Internal::Program_Image::Program_Image(const std::string& p_path)
+    : m_path{p_path}, m_contents{}, m_segments{}
+{
+    std::ifstream file{m_path, std::ios::binary};
+    if (!file)
+    {
+        Error::Report_Error("Could not open '{}'", m_path);
+    }
+    m_contents.assign(std::istreambuf_iterator<char>{file},
+                      std::istreambuf_iterator<char>{});
+
+    // Only 32 bit little-endian files are supported.
+    constexpr std::size_t header_size{52};
+    if (m_contents.size() < header_size ||
+        0 != std::memcmp(m_contents.data(), elf_magic, sizeof(elf_magic)) ||
+        1 != m_contents[4] || 1 != m_contents[5])
+    {
+        Error::Report_Error(
+            "'{}' is not a 32 bit little-endian ELF file", m_path);
+    }
+
+    const auto program_headers        = read<std::uint32_t>(m_contents, 28);
+    const auto program_header_size    = read<std::uint16_t>(m_contents, 42);
+    const auto number_program_headers = read<std::uint16_t>(m_contents, 44);
+    for (std::size_t i{0}; i < number_program_headers; ++i)
+    {
+        const std::size_t position{program_headers +
+                                   i * program_header_size};
+        if (position + 32 > m_contents.size())
+        {
+            Error::Report_Error("'{}' is corrupt", m_path);
+        }
+        if (loadable_segment != read<std::uint32_t>(m_contents, position))
+        {
+            continue;
+        }
+
+        Segment segment{read<std::uint32_t>(m_contents, position + 4),
+                        read<std::uint32_t>(m_contents, position + 8),
+                        read<std::uint32_t>(m_contents, position + 12),
+                        read<std::uint32_t>(m_contents, position + 16)};
+        if (std::uint64_t{segment.Offset} + segment.Size > m_contents.size())
+        {
+            Error::Report_Error("'{}' is corrupt", m_path);
+        }
+        m_segments.push_back(segment);
+    }
+}
+
+//! @brief Finds where an address range is stored within the ELF file. Both
+//! the address a segment runs at and the address it is loaded from are
+//! accepted, as variables in .data have both.
+//! @param p_address The address of the first byte.
+//! @param p_size The number of bytes.
+//! @returns The position of the first byte within the file, or
+//! std::string::npos if the range is not wholly within a segment that is
+//! loaded from the file.
+std::size_t
+GILES::Internal::Program_Image::file_offset(const std::uint32_t p_address,
+                                            const std::size_t p_size) const
+{
+    for (const auto& segment : m_segments)
+    {
+        for (const auto start :
+             {segment.Virtual_Address, segment.Physical_Address})
+        {
+            if (p_address >= start &&
+                std::uint64_t{p_address} + p_size <=
+                    std::uint64_t{start} + segment.Size)
+            {
+                return segment.Offset + (p_address - start);
+            }
+        }
+    }
+    return std::string::npos;
+}
+
+bool GILES::Internal::Program_Image::Is_Writable(
+    const std::uint32_t p_address, const std::size_t p_size) const
+{
+    return std::string::npos != file_offset(p_address, p_size);
+}
+
+void GILES::Internal::Program_Image::Write(const std::uint32_t p_address,
+                                           const std::string& p_data)
+{
+    const auto offset = file_offset(p_address, p_data.size());
+    if (std::string::npos == offset)
+    {
+        Error::Report_Error("The {} bytes at 0x{:08x} are not initialised by "
+                            "'{}' so can not be written to. Only memory "
+                            "loaded from the program, e.g. .data, can be "
+                            "written to.",
+                            p_data.size(),
+                            p_address,
+                            m_path);
+    }
+    m_contents.replace(offset, p_data.size(), p_data);
+}
+
+//! @brief Searches every symbol table in the program for p_name. The lowest
+//! bit of the address of a function is cleared, as it only marks Thumb code.
+const GILES::Internal::Program_Image::Buffer
+GILES::Internal::Program_Image::Find_Buffer(const std::string& p_name) const
+{
+    const auto section_headers        = read<std::uint32_t>(m_contents, 32);
+    const auto section_header_size    = read<std::uint16_t>(m_contents, 46);
+    const auto number_section_headers = read<std::uint16_t>(m_contents, 48);
+
+    // The position of a section header, checked to be within the file.
+    const auto section = [&](const std::size_t p_index) {
+        const std::size_t position{section_headers +
+                                   p_index * section_header_size};
+        if (p_index >= number_section_headers ||
+            position + 40 > m_contents.size())
+        {
+            Error::Report_Error("'{}' is corrupt", m_path);
+        }
+        return position;
+    };
+
+    bool found_symbol_table{false};
+    for (std::size_t i{0}; i < number_section_headers; ++i)
+    {
+        const auto header = section(i);
+        if (symbol_table != read<std::uint32_t>(m_contents, header + 4))
+        {
+            continue;
+        }
+        found_symbol_table = true;
+
+        const auto symbols      = read<std::uint32_t>(m_contents, header + 16);
+        const auto symbols_size = read<std::uint32_t>(m_contents, header + 20);
+        const auto names        = read<std::uint32_t>(
+            m_contents,
+            section(read<std::uint32_t>(m_contents, header + 24)) + 16);
+        if (std::uint64_t{symbols} + symbols_size > m_contents.size())
+        {
+            Error::Report_Error("'{}' is corrupt", m_path);
+        }
+
+        for (std::size_t symbol{symbols}; symbol + 16 <= symbols + symbols_size;
+             symbol += 16)
+        {
+            const std::size_t name{names +
+                                   read<std::uint32_t>(m_contents, symbol)};
+            if (name + p_name.size() >= m_contents.size() ||
+                0 != m_contents.compare(name, p_name.size(), p_name) ||
+                '\0' != m_contents[name + p_name.size()])
+            {
+                continue;
+            }
+
+            auto address = read<std::uint32_t>(m_contents, symbol + 4);
+            if (function_symbol == (m_contents[symbol + 12] & 0xf))
+            {
+                address &= ~std::uint32_t{1};
+            }
+            return {address, read<std::uint32_t>(m_contents, symbol + 8)};
+        }
+    }
+
+    if (!found_symbol_table)
+    {
+        Error::Report_Error(
+            "'{}' has no symbol table so '{}' can not be found. It may have "
+            "been stripped.",
+            m_path,
+            p_name);
+    }
+    Error::Report_Error("Could not find '{}' in '{}'", p_name, m_path);
+}
+
+void GILES::Internal::Program_Image::Save(const std::string& p_path) const
+{
+    std::ofstream file{p_path, std::ios::binary | std::ios::trunc};
+    file.write(m_contents.data(),
+               static_cast<std::streamsize>(m_contents.size()));
+    file.close();
+    if (!file)
+    {
+        Error::Report_Error("Could not write '{}'", p_path);
+    }
+}
@@ -0,0 +1,107 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Program_Image.hpp
+    @brief Contains the Program_Image class which allows the memory of a target
+    program to be changed before it is loaded into a simulator.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef PROGRAM_IMAGE_HPP
+#define PROGRAM_IMAGE_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Program_Image
+//! @brief Holds a copy of a 32 bit little-endian ELF file, such as those ran
+//! in the Thumb Sim simulator. Memory initialised by the program can be
+//! written to and the changed program saved, so that values can be placed
+//! in the memory of the target without changing the target or the simulator.
+//! Variables can also be found by name using the symbol table.
+class Program_Image
+{
+public:
+    //! A variable in the memory of the target.
+    struct Buffer
+    {
+        std::uint32_t Address;
+        std::size_t Size;
+    };
+
+private:
+    //! A segment of the program that is loaded into memory.
+    struct Segment
+    {
+        std::uint32_t Offset;
+        std::uint32_t Virtual_Address;
+        std::uint32_t Physical_Address;
+        //! The number of bytes loaded from the file.
+        std::uint32_t Size;
+    };
+
+    const std::string m_path;
+
+    //! The contents of the ELF file.
+    std::string m_contents;
+
+    std::vector<Segment> m_segments;
+
+    std::size_t file_offset(const std::uint32_t p_address,
+                            const std::size_t p_size) const;
+
+public:
+    //! @brief Loads the program at p_path.
+    //! @param p_path The path to the ELF file.
+    explicit Program_Image(const std::string& p_path);
+
+    //! @brief Changes the initial contents of the memory of the program.
+    //! @param p_address The address, in the memory of the target, to write
+    //! to. This must be within a segment that is loaded from the ELF file,
+    //! e.g. .data, rather than one that is zeroed, e.g. .bss.
+    //! @param p_data The bytes to write.
+    void Write(const std::uint32_t p_address, const std::string& p_data);
+
+    //! @brief Whether an address range can be written to using Write().
+    //! @param p_address The address of the first byte.
+    //! @param p_size The number of bytes.
+    //! @returns true if the whole range can be written to, false if not.
+    bool Is_Writable(const std::uint32_t p_address,
+                     const std::size_t p_size) const;
+
+    //! @brief Finds a variable in the program by name, using the symbol table.
+    //! @param p_name The name of the variable. e.g. "plaintext".
+    //! @returns The address and size of the variable.
+    const Buffer Find_Buffer(const std::string& p_name) const;
+
+    //! @brief Saves the program, including any changes.
+    //! @param p_path The path to save the program to.
+    void Save(const std::string& p_path) const;
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // PROGRAM_IMAGE_HPP
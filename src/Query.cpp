@@ -0,0 +1,258 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Query.cpp
+    @brief This file contains a command line executable that retrieves traces
+    from a file saved by GILES using the index saved alongside it.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstddef>    // for size_t
+#include <cstdlib>    // for exit, EXIT_SUCCESS
+#include <fstream>    // for ofstream
+#include <limits>     // for numeric_limits
+#include <optional>   // for optional
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include <boost/program_options.hpp>  // for options_description, value...
+#include <fmt/format.h>               // for format, print
+#include <fmt/ostream.h>              // for operator<<
+
+#include "Error.hpp"                // for Report_Error, Report_Exit
+#include "Index/Trace_Index.hpp"    // for Trace_Index
+#include "NumPy/Output_NumPy.hpp"   // for Output_NumPy
+
+//! Anonymous namespace is used as this functionality is only required when
+//! building not as a library.
+namespace
+{
+std::string m_traces_path;
+std::string m_index_path;
+std::vector<std::size_t> m_run_indices;
+std::optional<std::string> m_extra_data;
+std::size_t m_first_sample;
+std::size_t m_number_of_samples;
+std::optional<std::string> m_output_path;
+
+//! @brief Prints an error message and exits. This is to be called when the
+//! program cannot run given the supplied command line arguments.
+//! @note This function is marked as noreturn as it is guaranteed to always
+//! halt the program. (Through std::exit())
+//! @param p_message An error message can optionally be provided. This will
+//! be printed first on a separate line if provided.
+template <typename... args_t>
+[[noreturn]] void bad_options(const args_t&... p_message) {
+    fmt::print(p_message...);
+    GILES::Internal::Error::Report_Exit(
+        "\nPlease use option --help or -h to see proper usage");
+}
+
+//! @brief Converts a string of hexadecimal digits into the bytes they
+//! represent.
+//! @param p_hex The hexadecimal digits. e.g. "00ff10".
+//! @returns The bytes.
+std::string from_hex(const std::string& p_hex)
+{
+    if (0 != p_hex.size() % 2 ||
+        std::string::npos != p_hex.find_first_not_of("0123456789abcdefABCDEF"))
+    {
+        bad_options("Extra data must be given as pairs of hexadecimal digits. "
+                    "e.g. \"--extra-data 00ff10\"");
+    }
+
+    std::string bytes;
+    for (std::size_t i{0}; i < p_hex.size(); i += 2)
+    {
+        bytes.push_back(
+            static_cast<char>(std::stoul(p_hex.substr(i, 2), nullptr, 16)));
+    }
+    return bytes;
+}
+
+//! @brief Interprets the command line flags.
+void parse_command_line_flags(int argc, char* argv[])
+{
+    boost::program_options::options_description options_description{fmt::format(
+        "Retrieves traces from a file saved by GILES using its index\n"
+        "Usage: {} [--traces] TRACES [--runs RUN...] [--extra-data HEX]\n",
+        argv[0])};
+
+    // clang-format off
+
+    // Adds the command line options.
+    options_description.add_options()
+        ("help,h", "Print help")
+        ("traces",
+            boost::program_options::value<std::string>(),
+            "The traces file saved by GILES")
+        ("index",
+            boost::program_options::value<std::string>(),
+            "The index of the traces file. If not given, the traces file "
+            "with \".idx\" appended is used")
+        ("runs",
+            boost::program_options::value<std::vector<std::size_t>>(
+            &m_run_indices)
+            ->multitoken(),
+            "The runs whose traces are retrieved. e.g. \"--runs 3 7 12\"")
+        ("extra-data",
+            boost::program_options::value<std::string>(),
+            "Print the runs whose extra data matches this, given in "
+            "hexadecimal. e.g. \"--extra-data 00ff10\"")
+        ("first-sample",
+            boost::program_options::value<std::size_t>()->default_value(0),
+            "The first sample retrieved from each trace")
+        ("samples",
+            boost::program_options::value<std::size_t>(),
+            "The number of samples retrieved from each trace. If not given, "
+            "every sample from the first sample onwards is retrieved")
+        ("output,o",
+            boost::program_options::value<std::string>(),
+            "Save the retrieved traces to this file in the NumPy format rather "
+            "than printing them");
+
+    // clang-format on
+
+    boost::program_options::positional_options_description
+        positional_options_description;
+    // Traces can be specified without --traces flag.
+    positional_options_description.add("traces", 1);
+
+    boost::program_options::variables_map options;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::command_line_parser(argc, argv)
+                .options(options_description)
+                .positional(positional_options_description)
+                .run(),
+            options);
+        boost::program_options::notify(options);
+    }
+    catch (const std::exception& exception)
+    {
+        bad_options(exception.what());
+    }
+
+    if (options.count("help"))  // if help flag is passed
+    {
+        fmt::print("{}\n", options_description);
+        std::exit(EXIT_SUCCESS);
+    }
+
+    if (options.count("traces"))
+    {
+        m_traces_path = options["traces"].as<std::string>();
+    }
+    else
+    {
+        bad_options("Traces option is required.(--traces \"Path to traces\")");
+    }
+
+    m_index_path =
+        options.count("index")
+            ? options["index"].as<std::string>()
+            : GILES::Internal::Trace_Index::Index_Path(m_traces_path);
+
+    if (options.count("extra-data"))
+    {
+        m_extra_data = from_hex(options["extra-data"].as<std::string>());
+    }
+
+    // default 0 is used if flag is not passed
+    m_first_sample = options["first-sample"].as<std::size_t>();
+
+    m_number_of_samples = options.count("samples")
+                              ? options["samples"].as<std::size_t>()
+                              : std::numeric_limits<std::size_t>::max();
+
+    if (options.count("output"))
+    {
+        m_output_path = options["output"].as<std::string>();
+    }
+}
+
+//! @brief Saves traces to a file in the NumPy format.
+//! @param p_samples The traces as a row-major array.
+//! @param p_number_of_traces The number of rows in p_samples.
+void save(const std::vector<float>& p_samples,
+          const std::size_t p_number_of_traces)
+{
+    std::ofstream file{m_output_path.value(), std::ios::binary};
+    const auto header = GILES::Internal::Output_NumPy::Header(
+        "<f4",
+        p_number_of_traces,
+        0 == p_number_of_traces ? 0 : p_samples.size() / p_number_of_traces);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char*>(p_samples.data()),
+               static_cast<std::streamsize>(p_samples.size() * sizeof(float)));
+    if (!file)
+    {
+        GILES::Internal::Error::Report_Error("Could not write '{}'",
+                                             m_output_path.value());
+    }
+}
+}  // namespace
+
+//! @brief The entry point of the program.
+int main(int argc, char* argv[])
+{
+    parse_command_line_flags(argc, argv);
+
+    const GILES::Internal::Trace_Index index{m_traces_path, m_index_path};
+
+    if (m_extra_data)
+    {
+        for (const auto run_index : index.Find(m_extra_data.value()))
+        {
+            fmt::print("{}\n", run_index);
+        }
+        return 0;
+    }
+
+    if (m_run_indices.empty())
+    {
+        fmt::print("Traces: {}\nSamples per trace: {}\n",
+                   index.Number_Of_Traces(),
+                   index.Number_Of_Samples());
+        return 0;
+    }
+
+    const auto samples =
+        index.Traces(m_run_indices, m_first_sample, m_number_of_samples);
+    if (m_output_path)
+    {
+        save(samples, m_run_indices.size());
+        return 0;
+    }
+
+    // Each trace is printed on its own line, prefixed by its run index.
+    const std::size_t row_length{samples.size() / m_run_indices.size()};
+    for (std::size_t i{0}; i < m_run_indices.size(); ++i)
+    {
+        fmt::print("{}", m_run_indices[i]);
+        for (std::size_t j{0}; j < row_length; ++j)
+        {
+            fmt::print(",{}", samples[i * row_length + j]);
+        }
+        fmt::print("\n");
+    }
+    return 0;
+}
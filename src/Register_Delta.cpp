@@ -0,0 +1,353 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Register_Delta.cpp
+    @brief Contains the Register_Columns and Register_Delta classes which store
+    the registers of an Execution as the differences from a reference run.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>  // for equal, lower_bound, sort, unique
+#include <cstddef>    // for ptrdiff_t
+#include <stdexcept>  // for invalid_argument, out_of_range
+#include <utility>    // for move
+
+#include "Register_Delta.hpp"
+
+namespace
+{
+//! @brief Retrieves the name of every register that is present during any
+//! cycle.
+//! @param p_registers The registers during every clock cycle.
+//! @returns The names, sorted.
+std::vector<std::string>
+collect_names(const std::vector<GILES::Internal::Registers>& p_registers)
+{
+    std::vector<std::string> names;
+    for (const auto& registers : p_registers)
+    {
+        // Usually every cycle has the same registers, which are already known.
+        if (registers.size() == names.size() &&
+            std::equal(names.begin(),
+                       names.end(),
+                       registers.begin(),
+                       [](const std::string& p_name, const auto& p_register) {
+                           return p_name == p_register.first;
+                       }))
+        {
+            continue;
+        }
+        for (const auto& name_value : registers)
+        {
+            names.push_back(name_value.first);
+        }
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+    }
+    return names;
+}
+
+//! @brief Reports a register that can not be stored relative to the reference
+//! run.
+//! @param p_name The name of the register.
+[[noreturn]] void throw_not_in_reference(const std::string& p_name)
+{
+    throw std::invalid_argument("The register \"" + p_name +
+                                "\" is not in the reference run");
+}
+
+//! @brief Reports a register that is not present during a clock cycle.
+//! @param p_name The name of the register.
+[[noreturn]] void throw_not_present(const std::string& p_name)
+{
+    throw std::out_of_range("The register \"" + p_name +
+                            "\" was not present during that clock cycle");
+}
+
+//! @brief Finds every register whose value differs from p_reference.
+//! @param p_reference The reference run.
+//! @param p_number_of_cycles The number of cycles in the run being stored.
+//! @param p_get Retrieves the value of a register, given by its index in
+//! p_reference, during a cycle of the run being stored. This returns whether
+//! the register was present.
+//! @param p_differences Set to the differences.
+//! @param p_offsets Set to the start of each cycle within p_differences.
+template <typename T_Get>
+void find_differences(
+    const GILES::Internal::Register_Columns& p_reference,
+    const std::size_t p_number_of_cycles,
+    const T_Get& p_get,
+    std::vector<GILES::Internal::Register_Delta::Difference>* const
+        p_differences,
+    std::vector<std::size_t>* const p_offsets)
+{
+    const std::size_t number_of_registers{p_reference.Get_Names().size()};
+
+    p_offsets->reserve(p_number_of_cycles + 1);
+    p_offsets->push_back(0);
+    for (std::size_t cycle{0}; cycle < p_number_of_cycles; ++cycle)
+    {
+        for (std::size_t i{0}; i < number_of_registers; ++i)
+        {
+            std::size_t value{0};
+            const bool present{p_get(cycle, i, &value)};
+            if (present != p_reference.Is_Present(cycle, i) ||
+                value != p_reference.Get_Value(cycle, i))
+            {
+                p_differences->push_back(
+                    {static_cast<std::uint32_t>(i), present, value});
+            }
+        }
+        p_offsets->push_back(p_differences->size());
+    }
+    p_differences->shrink_to_fit();
+}
+}  // namespace
+
+GILES::Internal::Register_Columns::Register_Columns(
+    const std::vector<Registers>& p_registers)
+    : m_names{collect_names(p_registers)},
+      m_number_of_cycles{p_registers.size()},
+      m_values{m_number_of_cycles * m_names.size()},
+      m_present{}
+{
+    for (std::size_t cycle{0}; cycle < m_number_of_cycles; ++cycle)
+    {
+        // Both the registers and the names are sorted so they are walked
+        // together.
+        const Registers& registers{p_registers[cycle]};
+        const std::size_t first{cycle * m_names.size()};
+        auto name_value = registers.begin();
+        for (std::size_t i{0}; i < m_names.size(); ++i)
+        {
+            if (registers.end() != name_value &&
+                m_names[i] == name_value->first)
+            {
+                m_values[first + i] = name_value->second;
+                ++name_value;
+            }
+            else
+            {
+                // Presence is only stored once a register is missing.
+                if (m_present.empty())
+                {
+                    m_present.assign(m_values.Size(), true);
+                }
+                m_present[first + i] = false;
+            }
+        }
+    }
+}
+
+std::size_t
+GILES::Internal::Register_Columns::Find(const std::string& p_name) const
+{
+    const auto name = std::lower_bound(m_names.begin(), m_names.end(), p_name);
+    return m_names.end() != name && p_name == *name
+               ? static_cast<std::size_t>(name - m_names.begin())
+               : m_names.size();
+}
+
+std::size_t
+GILES::Internal::Register_Columns::Get_Value(const std::size_t p_cycle,
+                                             const std::string& p_name) const
+{
+    const std::size_t index{Find(p_name)};
+    if (m_names.size() == index || !Is_Present(p_cycle, index))
+    {
+        throw_not_present(p_name);
+    }
+    return Get_Value(p_cycle, index);
+}
+
+GILES::Internal::Registers
+GILES::Internal::Register_Columns::Get_Registers(
+    const std::size_t p_cycle) const
+{
+    if (p_cycle >= m_number_of_cycles)
+    {
+        throw std::out_of_range("The clock cycle is past the end of the run");
+    }
+
+    Registers registers;
+    for (std::size_t i{0}; i < m_names.size(); ++i)
+    {
+        if (Is_Present(p_cycle, i))
+        {
+            registers.emplace_hint(
+                registers.end(), m_names[i], Get_Value(p_cycle, i));
+        }
+    }
+    return registers;
+}
+
+GILES::Internal::Register_Delta::Register_Delta(
+    std::shared_ptr<const Register_Columns> p_reference,
+    const std::vector<Registers>& p_registers)
+    : m_reference{std::move(p_reference)},
+      m_number_of_cycles{p_registers.size()},
+      m_differences{},
+      m_offsets{}
+{
+    const std::vector<std::string>& names{m_reference->Get_Names()};
+
+    for (const Registers& registers : p_registers)
+    {
+        for (const auto& name_value : registers)
+        {
+            if (names.size() == m_reference->Find(name_value.first))
+            {
+                throw_not_in_reference(name_value.first);
+            }
+        }
+    }
+
+    find_differences(
+        *m_reference,
+        m_number_of_cycles,
+        [&](const std::size_t p_cycle,
+            const std::size_t p_register,
+            std::size_t* const p_value) {
+            const Registers& registers{p_registers[p_cycle]};
+            const auto name_value = registers.find(names[p_register]);
+            if (registers.end() == name_value)
+            {
+                return false;
+            }
+            *p_value = name_value->second;
+            return true;
+        },
+        &m_differences,
+        &m_offsets);
+}
+
+GILES::Internal::Register_Delta::Register_Delta(
+    std::shared_ptr<const Register_Columns> p_reference,
+    const Register_Columns& p_registers)
+    : m_reference{std::move(p_reference)},
+      m_number_of_cycles{p_registers.Get_Cycle_Count()},
+      m_differences{},
+      m_offsets{}
+{
+    for (const std::string& name : p_registers.Get_Names())
+    {
+        if (m_reference->Get_Names().size() == m_reference->Find(name))
+        {
+            throw_not_in_reference(name);
+        }
+    }
+
+    // The index of each of the reference's registers within p_registers.
+    std::vector<std::size_t> indices;
+    for (const std::string& name : m_reference->Get_Names())
+    {
+        indices.push_back(p_registers.Find(name));
+    }
+
+    find_differences(
+        *m_reference,
+        m_number_of_cycles,
+        [&](const std::size_t p_cycle,
+            const std::size_t p_register,
+            std::size_t* const p_value) {
+            const std::size_t index{indices[p_register]};
+            if (p_registers.Get_Names().size() == index ||
+                !p_registers.Is_Present(p_cycle, index))
+            {
+                return false;
+            }
+            *p_value = p_registers.Get_Value(p_cycle, index);
+            return true;
+        },
+        &m_differences,
+        &m_offsets);
+}
+
+bool GILES::Internal::Register_Delta::get(const std::size_t p_cycle,
+                                          const std::size_t p_register,
+                                          std::size_t* const p_value) const
+{
+    // The differences for this cycle are sorted by register.
+    const auto first = m_differences.begin() +
+                       static_cast<std::ptrdiff_t>(m_offsets[p_cycle]);
+    const auto last = m_differences.begin() +
+                      static_cast<std::ptrdiff_t>(m_offsets[p_cycle + 1]);
+    const auto difference =
+        std::lower_bound(first,
+                         last,
+                         p_register,
+                         [](const Difference& p_difference,
+                            const std::size_t p_index) {
+                             return p_difference.Register < p_index;
+                         });
+
+    if (last != difference && p_register == difference->Register)
+    {
+        *p_value = difference->Value;
+        return difference->Present;
+    }
+    *p_value = m_reference->Get_Value(p_cycle, p_register);
+    return m_reference->Is_Present(p_cycle, p_register);
+}
+
+bool GILES::Internal::Register_Delta::Is_Present(
+    const std::size_t p_cycle, const std::string& p_name) const
+{
+    const std::size_t index{m_reference->Find(p_name)};
+    std::size_t value;
+    return p_cycle < m_number_of_cycles &&
+           m_reference->Get_Names().size() != index &&
+           get(p_cycle, index, &value);
+}
+
+std::size_t
+GILES::Internal::Register_Delta::Get_Value(const std::size_t p_cycle,
+                                           const std::string& p_name) const
+{
+    const std::size_t index{m_reference->Find(p_name)};
+    std::size_t value{0};
+    if (p_cycle >= m_number_of_cycles ||
+        m_reference->Get_Names().size() == index ||
+        !get(p_cycle, index, &value))
+    {
+        throw_not_present(p_name);
+    }
+    return value;
+}
+
+GILES::Internal::Registers
+GILES::Internal::Register_Delta::Get_Registers(const std::size_t p_cycle) const
+{
+    if (p_cycle >= m_number_of_cycles)
+    {
+        throw std::out_of_range("The clock cycle is past the end of the run");
+    }
+
+    const std::vector<std::string>& names{m_reference->Get_Names()};
+    Registers registers;
+    for (std::size_t i{0}; i < names.size(); ++i)
+    {
+        if (std::size_t value; get(p_cycle, i, &value))
+        {
+            registers.emplace_hint(registers.end(), names[i], value);
+        }
+    }
+    return registers;
+}
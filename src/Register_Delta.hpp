@@ -0,0 +1,218 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Register_Delta.hpp
+    @brief Contains the Register_Columns and Register_Delta classes which store
+    the registers of an Execution as the differences from a reference run.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef REGISTER_DELTA_HPP
+#define REGISTER_DELTA_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
+#include <map>      // for map
+#include <memory>   // for shared_ptr
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Chunked_Buffer.hpp"  // for Chunked_Buffer
+
+namespace GILES
+{
+namespace Internal
+{
+//! The value in each register during one clock cycle, indexed by the name of
+//! the register.
+using Registers = std::map<std::string, std::size_t>;
+
+//! @class Register_Columns
+//! @brief The registers of a run, stored as a fixed size value for every
+//! register during every cycle. This is far smaller than a map per cycle and,
+//! as the values are held in a Chunked_Buffer, recordings that do not fit in
+//! memory are spilled to a temporary file. This is immutable, so it can be
+//! shared as the reference run of every Register_Delta that is relative to it.
+class Register_Columns
+{
+private:
+    //! The name of every register that is present during any cycle, sorted.
+    //! The index of a register within this is used to identify it.
+    std::vector<std::string> m_names;
+
+    std::size_t m_number_of_cycles;
+
+    //! The value of each register, indexed by cycle and then by register.
+    Chunked_Buffer m_values;
+
+    //! Whether each register was present, indexed as m_values. This is empty
+    //! when every register is present during every cycle, which is usual.
+    std::vector<bool> m_present;
+
+public:
+    //! @brief Stores p_registers as columns.
+    //! @param p_registers The registers during every clock cycle.
+    explicit Register_Columns(const std::vector<Registers>& p_registers);
+
+    //! @brief Retrieves the name of every register, sorted.
+    //! @returns The names.
+    const std::vector<std::string>& Get_Names() const { return m_names; }
+
+    //! @brief Finds the index of a register.
+    //! @param p_name The name of the register.
+    //! @returns The index or Get_Names().size() if there is no such register.
+    std::size_t Find(const std::string& p_name) const;
+
+    std::size_t Get_Cycle_Count() const { return m_number_of_cycles; }
+
+    //! @brief Checks whether a register was present during a clock cycle.
+    //! @param p_cycle The clock cycle. This may be past the end of the run.
+    //! @param p_register The index of the register.
+    //! @returns true if the register was present, false if not.
+    bool Is_Present(const std::size_t p_cycle,
+                    const std::size_t p_register) const
+    {
+        return p_cycle < m_number_of_cycles &&
+               (m_present.empty() ||
+                m_present[p_cycle * m_names.size() + p_register]);
+    }
+
+    //! @brief Retrieves the value in a register during a clock cycle.
+    //! @param p_cycle The clock cycle. This may be past the end of the run.
+    //! @param p_register The index of the register.
+    //! @returns The value, or 0 if the register was not present.
+    std::size_t Get_Value(const std::size_t p_cycle,
+                          const std::size_t p_register) const
+    {
+        return p_cycle < m_number_of_cycles
+                   ? m_values[p_cycle * m_names.size() + p_register]
+                   : 0;
+    }
+
+    //! @brief Retrieves the value in a register during a clock cycle.
+    //! @param p_cycle The clock cycle.
+    //! @param p_name The name of the register.
+    //! @returns The value.
+    //! @throws std::out_of_range When the register was not present.
+    std::size_t Get_Value(const std::size_t p_cycle,
+                          const std::string& p_name) const;
+
+    //! @brief Reconstructs the registers during a clock cycle.
+    //! @param p_cycle The clock cycle.
+    //! @returns The registers.
+    //! @throws std::out_of_range When p_cycle is past the end of the run.
+    Registers Get_Registers(const std::size_t p_cycle) const;
+};
+
+//! @class Register_Delta
+//! @brief The registers of one run, stored as only the values that differ from
+//! a reference run. Most registers, such as pointers, loop counters and
+//! constants, hold the same value on every run of a program, so this is much
+//! smaller than storing every register during every cycle.
+class Register_Delta
+{
+public:
+    //! A register whose value, or presence, differs from the reference run.
+    struct Difference
+    {
+        std::uint32_t Register;
+        bool Present;
+        std::size_t Value;
+    };
+
+private:
+    std::shared_ptr<const Register_Columns> m_reference;
+
+    std::size_t m_number_of_cycles;
+
+    //! The differences during every cycle, sorted by register. The
+    //! differences for cycle i are in [m_offsets[i], m_offsets[i + 1]).
+    std::vector<Difference> m_differences;
+
+    std::vector<std::size_t> m_offsets;
+
+    //! @brief Retrieves the value in a register during a clock cycle, from
+    //! either the differences or the reference run.
+    //! @param p_cycle The clock cycle. This must be within the run.
+    //! @param p_register The index of the register in the reference run.
+    //! @param p_value Set to the value, or 0 if the register was not present.
+    //! @returns true if the register was present, false if not.
+    bool get(const std::size_t p_cycle,
+             const std::size_t p_register,
+             std::size_t* const p_value) const;
+
+public:
+    //! @brief Stores p_registers as the differences from p_reference.
+    //! @param p_reference The reference run.
+    //! @param p_registers The registers during every clock cycle.
+    //! @throws std::invalid_argument When p_registers contains a register that
+    //! is not in p_reference.
+    Register_Delta(std::shared_ptr<const Register_Columns> p_reference,
+                   const std::vector<Registers>& p_registers);
+
+    //! @brief Stores p_registers as the differences from p_reference.
+    //! @param p_reference The reference run.
+    //! @param p_registers The registers during every clock cycle.
+    //! @throws std::invalid_argument When p_registers contains a register that
+    //! is not in p_reference.
+    Register_Delta(std::shared_ptr<const Register_Columns> p_reference,
+                   const Register_Columns& p_registers);
+
+    //! @brief Retrieves the value in a register during a clock cycle.
+    //! @param p_cycle The clock cycle.
+    //! @param p_name The name of the register.
+    //! @returns The value.
+    //! @throws std::out_of_range When the register was not present.
+    std::size_t Get_Value(const std::size_t p_cycle,
+                          const std::string& p_name) const;
+
+    //! @brief Checks whether a register was present during a clock cycle.
+    //! @param p_cycle The clock cycle.
+    //! @param p_name The name of the register.
+    //! @returns true if the register was present, false if not.
+    bool Is_Present(const std::size_t p_cycle, const std::string& p_name) const;
+
+    //! @brief Reconstructs the registers during a clock cycle.
+    //! @param p_cycle The clock cycle.
+    //! @returns The registers.
+    //! @throws std::out_of_range When p_cycle is past the end of the run.
+    Registers Get_Registers(const std::size_t p_cycle) const;
+
+    std::size_t Get_Cycle_Count() const { return m_number_of_cycles; }
+
+    //! @brief Retrieves the run this is relative to.
+    //! @returns The reference run.
+    const std::shared_ptr<const Register_Columns>& Get_Reference() const
+    {
+        return m_reference;
+    }
+
+    //! @brief Retrieves the number of values that differ from the reference
+    //! run.
+    //! @returns The number of differences.
+    std::size_t Get_Number_Of_Differences() const
+    {
+        return m_differences.size();
+    }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // REGISTER_DELTA_HPP
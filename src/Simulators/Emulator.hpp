@@ -27,13 +27,18 @@
 #ifndef EMULATOR_INTERFACE_HPP
 #define EMULATOR_INTERFACE_HPP
 
-#include <cstdio>  // for popen
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t
+#include <cstdio>   // for popen
+#include <memory>   // for shared_ptr
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "Abstract_Factory_Register.hpp"  // for Emulator_Factory_Register
 #include "Assembly_Instruction.hpp"
+#include "Error.hpp"                      // for Report_Error
 #include "Execution.hpp"
+#include "Instruction_Stream.hpp"     // for Instruction_Stream
 
 namespace GILES
 {
@@ -110,14 +115,44 @@ public:
     //! into.
     //! @param p_bit_to_fault The index of the bit to be faulted.
     //! @see https://en.wikipedia.org/wiki/Fault_injection
-    virtual void Inject_Fault(const std::uint32_t p_cycle_to_fault,
+    virtual void Inject_Fault(const std::uint64_t p_cycle_to_fault,
                               const std::string& p_register_to_fault,
                               const std::uint8_t p_bit_to_fault) = 0;
 
-    virtual void Add_Timeout(const std::uint32_t p_number_of_cycles) = 0;
+    virtual void Add_Timeout(const std::uint64_t p_number_of_cycles) = 0;
 
     //! @todo Document
     virtual const std::string& Get_Extra_Data() = 0;
+
+    //! @brief Whether the memory of the target can be written to using
+    //! Write_Memory() and read from using Read_Memory(). Emulators that
+    //! support this should override all three functions.
+    //! @returns true if the memory of the target can be accessed, false if
+    //! not.
+    virtual bool Supports_Memory_Access() const { return false; }
+
+    //! @brief Requests that data be written to the memory of the target after
+    //! it has been reset, before the target starts running. This is much
+    //! faster than having the target read its inputs through emulated I/O.
+    //! This must be called before Run_Code().
+    //! @param p_address The address of the first byte to write to.
+    //! @param p_data The bytes to write.
+    virtual void Write_Memory(const std::uint32_t /*p_address*/,
+                              const std::string& /*p_data*/)
+    {
+        Error::Report_Error("This feature is not supported by this simulator");
+    }
+
+    //! @brief Reads from the memory of the target as it was when the target
+    //! stopped running. This must be called after Run_Code().
+    //! @param p_address The address of the first byte to read.
+    //! @param p_size The number of bytes to read.
+    //! @returns The bytes read.
+    virtual const std::string Read_Memory(const std::uint32_t /*p_address*/,
+                                          const std::size_t /*p_size*/)
+    {
+        Error::Report_Error("This feature is not supported by this simulator");
+    }
 };
 
 //! @class Emulator_Interface
@@ -140,6 +175,18 @@ protected:
     {
     }
 
+    //! @brief Retrieves the pipeline stages of the previous run of this
+    //! emulator on the calling thread. An Emulator is constructed for every
+    //! run so these are kept per thread, rather than by each Emulator, to let
+    //! a constant time program reuse them instead of interning them again.
+    //! Only one stream is kept alive for each thread.
+    //! @returns The stream, which is empty before the first run.
+    static std::shared_ptr<const Instruction_Stream>& last_instruction_stream()
+    {
+        static thread_local std::shared_ptr<const Instruction_Stream> stream;
+        return stream;
+    }
+
 public:
     //! @brief Virtual destructor to ensure proper memory cleanup.
     //! @see https://stackoverflow.com/a/461224
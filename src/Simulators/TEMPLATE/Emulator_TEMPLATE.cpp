@@ -37,7 +37,7 @@ const GILES::Internal::Execution GILES::Internal::Emulator_TEMPLATE::Run_Code()
 }
 
 void GILES::Internal::Emulator_TEMPLATE::Inject_Fault(
-    const std::uint32_t p_cycle_to_fault,
+    const std::uint64_t p_cycle_to_fault,
     const std::string& p_register_to_fault,
     const std::uint8_t p_bit_to_fault)
 {
@@ -45,7 +45,7 @@ void GILES::Internal::Emulator_TEMPLATE::Inject_Fault(
 }
 
 void GILES::Internal::Emulator_TEMPLATE::Add_Timeout(
-    const std::uint32_t p_number_of_cyclest)
+    const std::uint64_t p_number_of_cyclest)
 {
     Error::Report_Error("This feature is not supported by this simulator");
 }
@@ -45,11 +45,19 @@ public:
 
     const std::string& Get_Extra_Data() override;
 
-    void Inject_Fault(const std::uint32_t p_cycle_to_fault,
+    void Inject_Fault(const std::uint64_t p_cycle_to_fault,
                       const std::string& p_register_to_fault,
                       const std::uint8_t p_bit_to_fault) override;
 
-    void Add_Timeout(const std::uint32_t p_number_of_cyclest) override;
+    void Add_Timeout(const std::uint64_t p_number_of_cyclest) override;
+
+    // Override these if the simulator allows the memory of the target to be
+    // accessed directly.
+    // bool Supports_Memory_Access() const override { return true; }
+    // void Write_Memory(const std::uint32_t p_address,
+    //                   const std::string& p_data) override;
+    // const std::string Read_Memory(const std::uint32_t p_address,
+    //                               const std::size_t p_size) override;
 
     //! @brief Retrieves the name of this Emulator.
     //! @returns The name as a string.
@@ -23,13 +23,35 @@
     @copyright GNU Affero General Public License Version 3+
 */
 
+#include <cstdint>  // for uint32_t, uint64_t
+#include <limits>   // for numeric_limits
+#include <memory>   // for make_shared
 #include <string>   // for string
-#include <utility>  // for pair
+#include <utility>  // for move, pair
 
 #include "simulator/regfile.h"  // for Reg
 
 #include "Emulator_Thumb_Sim.hpp"
 #include "Execution.hpp"
+#include "Register_Delta.hpp"  // for Register_Columns
+
+namespace
+{
+//! @brief Converts a clock cycle number to the 32 bit cycle counter used by
+//! Thumb Sim.
+//! @param p_cycle The clock cycle number.
+//! @returns The clock cycle number.
+std::uint32_t to_simulator_cycle(const std::uint64_t p_cycle)
+{
+    if (p_cycle > std::numeric_limits<std::uint32_t>::max())
+    {
+        GILES::Internal::Error::Report_Error(
+            "Thumb Sim can not count beyond clock cycle {}",
+            std::numeric_limits<std::uint32_t>::max());
+    }
+    return static_cast<std::uint32_t>(p_cycle);
+}
+}  // namespace
 
 const GILES::Internal::Execution GILES::Internal::Emulator_Thumb_Sim::Run_Code()
 {
@@ -46,23 +68,50 @@ const GILES::Internal::Execution GILES::Internal::Emulator_Thumb_Sim::Run_Code()
     // stage?
     const auto& registers = m_execution_recording.Get_Registers();
 
-    // Create an Execution object and add the required data to it.
-    Execution execution(m_execution_recording.Get_Cycle_Count());
-    execution.Add_Registers_All(registers);
-    execution.Add_Pipeline_Stage("Fetch", fetch);
-    execution.Add_Pipeline_Stage("Decode", decode);
-    execution.Add_Pipeline_Stage("Execute", execute);
-
-    // Correctly place stalls and flushes so that they can be easily identified.
-    // TODO: Flushes
-    for (std::size_t i{0}; i < execute.size(); ++i)
+    // The pipeline stages only need to be stored again if they differ from
+    // the previous run, otherwise all Executions share the same copy.
+    auto& instruction_stream = last_instruction_stream();
+    if (!instruction_stream || !instruction_stream->Is_Stage("Fetch", fetch) ||
+        !instruction_stream->Is_Stage("Decode", decode) ||
+        !instruction_stream->Is_Stage("Execute", execute))
     {
-        if ("Stalled, pending decode" == execute[i])
-        {
-            execution.Add_Value(
-                i, "Execute", GILES::Internal::Execution::State::Stalled);
-        }
+        Instruction_Stream stream;
+        stream.Add_Stage("Fetch", fetch);
+        stream.Add_Stage("Decode", decode);
+        stream.Add_Stage("Execute", execute);
+
+        // Correctly place stalls and flushes so that they can be easily
+        // identified. Each run of consecutive stalls is stored at once.
+        // TODO: Flushes
+        for (std::size_t i{0}; i < execute.size();)
+        {
+            std::size_t length{0};
+            while (i + length < execute.size() &&
+                   "Stalled, pending decode" == execute[i + length])
+            {
+                ++length;
+            }
+
+            if (0 == length)
+            {
+                ++i;
+                continue;
+            }
+            stream.Set_State("Execute", i, length, Pipeline_State::Stalled);
+            i += length;
+        }
+
+        // Identical streams from other threads are shared as well.
+        instruction_stream = Instruction_Stream::Intern(std::move(stream));
     }
+
+    // Create an Execution object and add the required data to it. The
+    // registers are packed as they are by far the largest part of a long
+    // execution.
+    Execution execution(m_execution_recording.Get_Cycle_Count());
+    execution.Add_Registers_Columns(
+        std::make_shared<const Register_Columns>(registers));
+    execution.Set_Instruction_Stream(instruction_stream);
     return execution;
 }
 
@@ -72,7 +121,7 @@ const std::string& GILES::Internal::Emulator_Thumb_Sim::Get_Extra_Data()
 }
 
 void GILES::Internal::Emulator_Thumb_Sim::Inject_Fault(
-    const std::uint32_t p_cycle_to_fault,
+    const std::uint64_t p_cycle_to_fault,
     const std::string& p_register_to_fault,
     const std::uint8_t p_bit_to_fault)
 {
@@ -157,12 +206,13 @@ void GILES::Internal::Emulator_Thumb_Sim::Inject_Fault(
                             p_register_to_fault);
     }()};
 
-    m_simulator.InjectFault(
-        p_cycle_to_fault, register_to_fault, p_bit_to_fault);
+    m_simulator.InjectFault(to_simulator_cycle(p_cycle_to_fault),
+                            register_to_fault,
+                            p_bit_to_fault);
 }
 
 void GILES::Internal::Emulator_Thumb_Sim::Add_Timeout(
-    const std::uint32_t p_number_of_cycles)
+    const std::uint64_t p_number_of_cycles)
 {
-    m_simulator.AddTimeout(p_number_of_cycles);
+    m_simulator.AddTimeout(to_simulator_cycle(p_number_of_cycles));
 }
@@ -18,11 +18,13 @@
 #ifndef EMULATOR_THUMB_SIM_HPP
 #define EMULATOR_THUMB_SIM_HPP
 
+#include <memory>  // for shared_ptr
 #include <string>  // for string
 #include <vector>  // for vector
 
-#include "Emulator.hpp"   // for Emulator_Interface
-#include "Execution.hpp"  // for Execution
+#include "Emulator.hpp"            // for Emulator_Interface
+#include "Execution.hpp"           // for Execution
+#include "Instruction_Stream.hpp"  // for Instruction_Stream
 
 #include "simulator.cpp"  // for Simulator
 
@@ -42,7 +44,9 @@ public:
     //! @param p_program_path The path to the program to be loaded into the
     //! simulator.
     explicit Emulator_Thumb_Sim(const std::string& p_program_path)
-        : Emulator_Interface{p_program_path}, m_simulator{}
+        : Emulator_Interface{p_program_path},
+          m_simulator{},
+          m_execution_recording{}
     {
     }
 
@@ -50,11 +54,11 @@ public:
 
     const std::string& Get_Extra_Data() override;
 
-    void Inject_Fault(const std::uint32_t p_cycle_to_fault,
+    void Inject_Fault(const std::uint64_t p_cycle_to_fault,
                       const std::string& p_register_to_fault,
                       const std::uint8_t p_bit_to_fault) override;
 
-    void Add_Timeout(const std::uint32_t p_number_of_cyclest) override;
+    void Add_Timeout(const std::uint64_t p_number_of_cyclest) override;
 
     //! @brief Retrieves the name of this Emulator.
     //! @returns The name as a string.
@@ -0,0 +1,340 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*!
+    @file Allocation_Tests.cpp
+    @brief Contains the entry point for the tests that check the Models, and
+    each run of a constant time program, do not allocate memory once warmed
+    up. These replace the global operator new in order to count allocations,
+    so they are kept apart from the other tests.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+//! Required when using Catch testing framework - Tells Catch to provide a
+//! main()
+//! @see https://github.com/catchorg/Catch2
+#ifndef CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_MAIN
+#endif  // CATCH_CONFIG_MAIN
+
+#include <atomic>    // for atomic
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uint32_t
+#include <cstdlib>   // for malloc, free
+#include <map>       // for map
+#include <memory>    // for make_shared
+#include <new>       // for bad_alloc
+#include <optional>  // for optional
+#include <string>    // for string, to_string
+#include <vector>    // for vector
+
+#include <catch.hpp>  // for catch
+
+#include <nlohmann/json.hpp>  // for json
+
+#include "Coefficients.hpp"        // for Coefficients
+#include "Emulator_Test.hpp"       // for Emulator_Test
+#include "Execution.hpp"           // for Execution
+#include "Instruction_Stream.hpp"  // for Instruction_Stream
+#include "Output.hpp"              // for Output
+#include "Register_Delta.hpp"      // for Register_Columns
+
+#include "Hamming_Weight/Model_Hamming_Weight.hpp"  // for Model_Hamming_Weight
+#include "Power/Model_Power.hpp"                    // for Model_Power
+
+// This is included last as, within the GILES class, GILES refers to the class
+// rather than the namespace.
+#include "GILES.cpp"  // for GILES
+
+namespace
+{
+//! Whether allocations are currently being counted.
+std::atomic<bool> counting{false};
+
+//! The number of allocations made while counting.
+std::atomic<std::size_t> allocations{0};
+
+//! @brief Counts the allocations made while running p_function.
+//! @param p_function The code to check.
+//! @returns The number of allocations.
+template <typename T_Function>
+std::size_t count_allocations(const T_Function& p_function)
+{
+    allocations = 0;
+    counting    = true;
+    p_function();
+    counting = false;
+    return allocations;
+}
+
+//! @brief Creates Coefficients with every term used by the Power Model. Shifts
+//! is needed as it is used in place of instructions that were not profiled.
+//! @returns The Coefficients as they would be loaded from a file.
+nlohmann::json make_coefficients()
+{
+    const std::vector<std::string> categories{"ALU", "Loads", "Shifts"};
+    const std::vector<std::string> list_terms{"Bit_Flip1",
+                                              "Bit_Flip1_Bit_Interactions",
+                                              "Bit_Flip2",
+                                              "Bit_Flip2_Bit_Interactions",
+                                              "Operand1",
+                                              "Operand1_Bit_Interactions",
+                                              "Operand2",
+                                              "Operand2_Bit_Interactions"};
+    const std::vector<std::string> category_terms{
+        "Hamming_Distance_Operand1_Previous_Instruction",
+        "Hamming_Distance_Operand1_Subsequent_Instruction",
+        "Hamming_Distance_Operand2_Previous_Instruction",
+        "Hamming_Distance_Operand2_Subsequent_Instruction",
+        "Hamming_Weight_Operand1_Previous_Instruction",
+        "Hamming_Weight_Operand1_Subsequent_Instruction",
+        "Hamming_Weight_Operand2_Previous_Instruction",
+        "Hamming_Weight_Operand2_Subsequent_Instruction",
+        "Previous_Instruction",
+        "Subsequent_Instruction"};
+
+    nlohmann::json coefficients;
+    for (std::size_t i{0}; i < categories.size(); ++i)
+    {
+        nlohmann::json& category{coefficients[categories[i]]};
+        category["Constant"] = 1.0 + static_cast<double>(i);
+        for (const std::string& term : list_terms)
+        {
+            category["Coefficients"][term] = std::vector<double>(32, 0.5);
+        }
+        for (const std::string& term : category_terms)
+        {
+            for (const std::string& target : categories)
+            {
+                category["Coefficients"][term][target] = 0.25;
+            }
+        }
+    }
+    coefficients["ALU"]["Instructions"]    = {"adds", "eors", "movs"};
+    coefficients["Loads"]["Instructions"]  = {"ldr"};
+    coefficients["Shifts"]["Instructions"] = {"lsls"};
+    return coefficients;
+}
+
+//! @brief Creates an Execution of a short program, as the Thumb simulator
+//! would, with a stall and an instruction that has not been profiled.
+//! @param p_stream The shared pipeline stages.
+//! @param p_seed Changes the values in the registers.
+//! @returns The Execution.
+GILES::Internal::Execution
+make_execution(const std::shared_ptr<const GILES::Internal::Instruction_Stream>&
+                   p_stream,
+               const std::size_t p_seed)
+{
+    const std::size_t number_of_cycles{
+        p_stream->Get_States("Execute").Get_Cycle_Count()};
+
+    std::vector<std::map<std::string, std::size_t>> registers(
+        number_of_cycles);
+    for (std::size_t cycle{0}; cycle < number_of_cycles; ++cycle)
+    {
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            registers[cycle]["r" + std::to_string(i)] =
+                (p_seed + cycle) * 2654435761 + i;
+        }
+    }
+
+    GILES::Internal::Execution execution{number_of_cycles};
+    execution.Add_Registers_Columns(
+        std::make_shared<const GILES::Internal::Register_Columns>(registers));
+    execution.Set_Instruction_Stream(p_stream);
+    return execution;
+}
+
+//! @class Output_Allocations
+//! @brief Records the number of allocations counted by the time the trace of
+//! each run is added. Once a chosen run has been added, the instruction
+//! stream kept by the test simulator is dropped so that the next run has to
+//! build it again. This does not allocate once constructed.
+class Output_Allocations : public GILES::Internal::Output
+{
+private:
+    std::vector<std::size_t> m_allocations;
+    const std::size_t m_forget_run;
+
+public:
+    Output_Allocations(const std::size_t p_number_of_runs,
+                       const std::size_t p_forget_run)
+        : Output{GILES::Internal::Output_Options{}},
+          m_allocations(p_number_of_runs), m_forget_run{p_forget_run}
+    {
+    }
+
+    void Add_Trace(const std::size_t /*p_thread*/,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& /*p_trace*/,
+                   const std::string& /*p_extra_data*/) override
+    {
+        m_allocations[p_run_index] = allocations;
+        if (m_forget_run == p_run_index)
+        {
+            GILES::Internal::Emulator_Test::Forget_Instruction_Stream();
+        }
+    }
+
+    void Finish() override {}
+
+    //! @param p_run_index The run, which must not be the first.
+    //! @returns The number of allocations made by the run.
+    std::size_t Get_Allocations(const std::size_t p_run_index) const
+    {
+        return m_allocations[p_run_index] - m_allocations[p_run_index - 1];
+    }
+};
+}  // namespace
+
+//! @brief Replaced in order to count allocations.
+void* operator new(const std::size_t p_size)
+{
+    if (counting)
+    {
+        ++allocations;
+    }
+    if (void* const memory{std::malloc(0 == p_size ? 1 : p_size)})
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t p_size)
+{
+    return operator new(p_size);
+}
+
+void operator delete(void* const p_memory) noexcept { std::free(p_memory); }
+
+void operator delete[](void* const p_memory) noexcept { std::free(p_memory); }
+
+void operator delete(void* const p_memory, std::size_t) noexcept
+{
+    std::free(p_memory);
+}
+
+void operator delete[](void* const p_memory, std::size_t) noexcept
+{
+    std::free(p_memory);
+}
+
+TEST_CASE("Models do not allocate once warmed up", "[allocations]")
+{
+    using GILES::Internal::Instruction_Stream;
+
+    const GILES::Internal::Coefficients coefficients{make_coefficients()};
+
+    Instruction_Stream stream;
+    stream.Add_Stage("Execute",
+                     {"movs r0, #5",
+                      "adds r1, r0, r2",
+                      "ldr r2, [r1, #4]",
+                      "Stalled, pending decode",
+                      "eors r3, r2",
+                      "b label",
+                      "adds r0, r3",
+                      "lsls r1, r0, #2",
+                      "ldr r1, [r0]",
+                      "movs r2, r1"});
+    stream.Set_State("Execute", 3, 1, GILES::Internal::Pipeline_State::Stalled);
+    const auto shared = Instruction_Stream::Intern(std::move(stream));
+
+    // The counter itself must not allocate.
+    REQUIRE(0 == count_allocations([] {}));
+
+    // Check that allocations are seen.
+    std::vector<int> values;
+    REQUIRE(1 == count_allocations([&] { values.reserve(16); }));
+
+    SECTION("Power")
+    {
+        GILES::Internal::Model_Power model{make_execution(shared, 0),
+                                           coefficients};
+        std::vector<float> trace(model.Get_Trace_Length());
+        model.Generate_Traces(trace.data());
+
+        REQUIRE(0 == count_allocations(
+                         [&] { model.Generate_Traces(trace.data()); }));
+
+        // Another run of the same program shares the stream, which has
+        // already been parsed, so even its first traces do not allocate.
+        GILES::Internal::Model_Power next{make_execution(shared, 1),
+                                          coefficients};
+        REQUIRE(0 == count_allocations(
+                         [&] { next.Generate_Traces(trace.data()); }));
+    }
+
+    SECTION("Hamming_Weight")
+    {
+        GILES::Internal::Model_Hamming_Weight model{make_execution(shared, 0),
+                                                    coefficients};
+        std::vector<float> trace(model.Get_Trace_Length());
+        model.Generate_Traces(trace.data());
+
+        REQUIRE(0 == count_allocations(
+                         [&] { model.Generate_Traces(trace.data()); }));
+
+        // Another run of the same program shares the stream, which has
+        // already been parsed, so even its first traces do not allocate.
+        GILES::Internal::Model_Hamming_Weight next{make_execution(shared, 1),
+                                                   coefficients};
+        REQUIRE(0 == count_allocations(
+                         [&] { next.Generate_Traces(trace.data()); }));
+    }
+}
+
+TEST_CASE("Runs of a constant time program reuse the instruction stream",
+          "[allocations]")
+{
+    const std::uint32_t number_of_runs{20};
+    const std::size_t forget_run{10};
+
+    // GILES keeps a reference to the traces path, so this must outlive it.
+    const std::optional<std::string> no_path{};
+
+    // Every Emulator and Execution is constructed by GILES and nothing else
+    // holds the stream, as when GILES is used with a single thread.
+    GILES::GILES giles{"Allocation_Tests.elf",
+                       std::make_shared<const GILES::Internal::Coefficients>(
+                           make_coefficients()),
+                       no_path,
+                       number_of_runs,
+                       "Power"};
+    giles.Set_Simulator("Test");
+    giles.Set_Inputs({{0x20000000, 16}}, 42);
+    giles.Set_Number_Of_Threads(1);
+    const auto output =
+        std::make_shared<Output_Allocations>(number_of_runs, forget_run);
+    giles.Add_Output(output);
+
+    count_allocations([&] { giles.Run(); });
+    REQUIRE(number_of_runs == giles.Get_Runs_Completed());
+
+    // Every run after the first makes the same allocations, which are fewer
+    // than those made by building, interning and parsing the stream again.
+    REQUIRE(output->Get_Allocations(forget_run - 1) ==
+            output->Get_Allocations(forget_run - 2));
+    REQUIRE(output->Get_Allocations(forget_run - 1) <
+            output->Get_Allocations(forget_run + 1));
+}
@@ -0,0 +1,193 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*!
+    @file Emulator_Test.hpp
+    @brief Contains a simulator used by the tests to run GILES from start to
+    finish without a target program.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#ifndef EMULATOR_TEST_HPP
+#define EMULATOR_TEST_HPP
+
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t, uint8_t
+#include <map>      // for map
+#include <memory>   // for make_shared
+#include <string>   // for string, to_string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "Emulator.hpp"            // for Emulator_Interface
+#include "Error.hpp"               // for Report_Error
+#include "Execution.hpp"           // for Execution
+#include "Instruction_Stream.hpp"  // for Instruction_Stream
+#include "Register_Delta.hpp"      // for Register_Columns
+
+namespace GILES
+{
+namespace Internal
+{
+//! @class Emulator_Test
+//! @brief Pretends to run the same short program every time, as the Thumb
+//! simulator would, without needing a target program. The values in the
+//! registers are derived from the memory written before the run, so each set
+//! of inputs gives a different trace. The program path is ignored.
+class Emulator_Test : public virtual Emulator_Interface<Emulator_Test>
+{
+private:
+    //! The memory written before the run, by address.
+    std::map<std::uint32_t, std::string> m_memory;
+
+    const std::string m_extra_data;
+
+    //! @returns The contents of the Execute stage during every cycle.
+    static const Instruction_Stream::Stage& get_program()
+    {
+        static const Instruction_Stream::Stage program{[] {
+            const Instruction_Stream::Stage body{"movs r0, #5",
+                                                 "adds r1, r0, r2",
+                                                 "ldr r2, [r1, #4]",
+                                                 "eors r3, r2",
+                                                 "adds r0, r3",
+                                                 "ldr r1, [r0, #8]",
+                                                 "movs r2, r1",
+                                                 "adds r3, r1, r0"};
+            Instruction_Stream::Stage stage;
+            for (std::size_t i{0}; i < 8; ++i)
+            {
+                stage.insert(stage.end(), body.begin(), body.end());
+            }
+            return stage;
+        }()};
+        return program;
+    }
+
+    //! @returns The number of runs simulated, by every thread.
+    static std::atomic<std::size_t>& runs_simulated()
+    {
+        static std::atomic<std::size_t> runs{0};
+        return runs;
+    }
+
+public:
+    explicit Emulator_Test(const std::string& p_program_path)
+        : Emulator_Interface{p_program_path}, m_memory{}, m_extra_data{}
+    {
+    }
+
+    const Execution Run_Code() override
+    {
+        ++runs_simulated();
+
+        std::size_t seed{0};
+        for (const auto& [address, data] : m_memory)
+        {
+            seed = seed * 31 + address;
+            for (const char byte : data)
+            {
+                seed = seed * 31 + static_cast<unsigned char>(byte);
+            }
+        }
+
+        const Instruction_Stream::Stage& program{get_program()};
+        std::vector<std::map<std::string, std::size_t>> registers(
+            program.size());
+        for (std::size_t cycle{0}; cycle < program.size(); ++cycle)
+        {
+            for (std::size_t i{0}; i < 4; ++i)
+            {
+                registers[cycle]["r" + std::to_string(i)] =
+                    (seed + cycle) * 2654435761 + i;
+            }
+        }
+
+        // The stream is reused between runs, as by the Thumb simulator.
+        auto& instruction_stream = last_instruction_stream();
+        if (!instruction_stream ||
+            !instruction_stream->Is_Stage("Execute", program))
+        {
+            Instruction_Stream stream;
+            stream.Add_Stage("Execute", program);
+            instruction_stream = Instruction_Stream::Intern(std::move(stream));
+        }
+
+        Execution execution{program.size()};
+        execution.Add_Registers_Columns(
+            std::make_shared<const Register_Columns>(registers));
+        execution.Set_Instruction_Stream(instruction_stream);
+        return execution;
+    }
+
+    //! @brief Drops the stream kept for the calling thread so that the next
+    //! run builds it again, as the first run on a thread does.
+    static void Forget_Instruction_Stream()
+    {
+        last_instruction_stream().reset();
+    }
+
+    //! @returns The number of runs simulated so far, by every thread.
+    static std::size_t Get_Runs_Simulated() { return runs_simulated(); }
+
+    const std::string& Get_Extra_Data() override { return m_extra_data; }
+
+    //! @brief Faults are not simulated, but registers that do not exist are
+    //! reported in the same way as by the Thumb simulator.
+    void Inject_Fault(const std::uint64_t /*p_cycle_to_fault*/,
+                      const std::string& p_register_to_fault,
+                      const std::uint8_t /*p_bit_to_fault*/) override
+    {
+        for (std::size_t i{0}; i < 16; ++i)
+        {
+            if ("R" + std::to_string(i) == p_register_to_fault)
+            {
+                return;
+            }
+        }
+        Error::Report_Error("Could not find register with the name \"{}\"",
+                            p_register_to_fault);
+    }
+
+    void Add_Timeout(const std::uint64_t /*p_number_of_cycles*/) override {}
+
+    bool Supports_Memory_Access() const override { return true; }
+
+    void Write_Memory(const std::uint32_t p_address,
+                      const std::string& p_data) override
+    {
+        m_memory[p_address] = p_data;
+    }
+
+    const std::string Read_Memory(const std::uint32_t p_address,
+                                  const std::size_t p_size) override
+    {
+        auto data = m_memory[p_address];
+        data.resize(p_size, '\0');
+        return data;
+    }
+
+    static const std::string Get_Name() { return "Test"; }
+};
+}  // namespace Internal
+}  // namespace GILES
+
+#endif  // EMULATOR_TEST_HPP
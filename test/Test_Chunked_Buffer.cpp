@@ -0,0 +1,96 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Chunked_Buffer.cpp
+    @brief Contains the tests for the Chunked_Buffer class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstddef>  // for size_t
+
+#include <catch.hpp>  // for catch
+
+#include "Chunked_Buffer.hpp"  // for Chunked_Buffer
+
+TEST_CASE("Chunked_Buffer class testing"
+          "[chunked_buffer]")
+{
+    using GILES::Internal::Chunked_Buffer;
+
+    constexpr std::size_t chunk_bytes{Chunked_Buffer::Chunk_Length *
+                                      sizeof(std::size_t)};
+
+    // Other tests may be holding chunks, so limits are relative to this.
+    const std::size_t memory_used{Chunked_Buffer::Get_Memory_Used()};
+
+    SECTION("Values are kept across chunks")
+    {
+        Chunked_Buffer buffer{Chunked_Buffer::Chunk_Length * 2 + 5};
+        REQUIRE(Chunked_Buffer::Chunk_Length * 2 + 5 == buffer.Size());
+        REQUIRE(0 == buffer.Get_Number_Of_Spilled_Chunks());
+
+        // Zero initialised.
+        REQUIRE(0 == buffer[0]);
+        REQUIRE(0 == buffer[buffer.Size() - 1]);
+
+        for (std::size_t i{0}; i < buffer.Size(); i += 997)
+        {
+            buffer[i] = i * 3;
+        }
+        for (std::size_t i{0}; i < buffer.Size(); i += 997)
+        {
+            REQUIRE(i * 3 == buffer[i]);
+        }
+
+        // The last chunk is only as long as it needs to be.
+        REQUIRE(memory_used + 2 * chunk_bytes + 5 * sizeof(std::size_t) ==
+                Chunked_Buffer::Get_Memory_Used());
+    }
+
+    SECTION("Chunks past the memory limit are spilled")
+    {
+        Chunked_Buffer::Set_Memory_Limit(memory_used + chunk_bytes);
+        {
+            Chunked_Buffer buffer{Chunked_Buffer::Chunk_Length * 3};
+            REQUIRE(2 == buffer.Get_Number_Of_Spilled_Chunks());
+            REQUIRE(memory_used + chunk_bytes ==
+                    Chunked_Buffer::Get_Memory_Used());
+
+            // Spilled chunks are zero initialised and hold values as well.
+            REQUIRE(0 == buffer[buffer.Size() - 1]);
+            for (std::size_t i{0}; i < buffer.Size(); i += 4099)
+            {
+                buffer[i] = i + 1;
+            }
+            for (std::size_t i{0}; i < buffer.Size(); i += 4099)
+            {
+                REQUIRE(i + 1 == buffer[i]);
+            }
+
+            // Another buffer has no memory left at all.
+            const Chunked_Buffer other{1};
+            REQUIRE(1 == other.Get_Number_Of_Spilled_Chunks());
+        }
+        Chunked_Buffer::Set_Memory_Limit(0);
+    }
+
+    // All memory is released.
+    REQUIRE(memory_used == Chunked_Buffer::Get_Memory_Used());
+}
@@ -0,0 +1,91 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Codec.cpp
+    @brief Contains the tests for the Codec class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cmath>   // for sin
+#include <random>  // for mt19937, uniform_real_distribution
+#include <vector>  // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Chunked/Codec.hpp"  // for Codec
+
+TEST_CASE("Codec class testing"
+          "[codec]")
+{
+    using GILES::Internal::Codec;
+
+    SECTION("Smooth samples are compressed and restored exactly")
+    {
+        // 16 rows of 500 samples, similar to a set of traces.
+        std::vector<float> samples;
+        for (std::size_t row{0}; row < 16; ++row)
+        {
+            for (std::size_t i{0}; i < 500; ++i)
+            {
+                samples.push_back(
+                    static_cast<float>(static_cast<int>(
+                        100 * std::sin(0.01 * i + row))) /
+                    4);
+            }
+        }
+
+        const auto compressed = Codec::Compress(samples, 500);
+        REQUIRE(compressed.size() < samples.size() * sizeof(float) / 2);
+        REQUIRE(Codec::Decompress(compressed, samples.size(), 500) == samples);
+    }
+
+    SECTION("Noisy samples are stored and restored exactly")
+    {
+        std::mt19937 generator{1};
+        std::uniform_real_distribution<float> distribution{-1, 1};
+        std::vector<float> samples(1001);
+        for (auto& sample : samples)
+        {
+            sample = distribution(generator);
+        }
+
+        // Rows do not need to divide the number of samples.
+        const auto compressed = Codec::Compress(samples, 7);
+        REQUIRE(compressed.size() <= samples.size() * sizeof(float) + 1);
+        REQUIRE(Codec::Decompress(compressed, samples.size(), 7) == samples);
+    }
+
+    SECTION("Runs of a single value are compressed and restored exactly")
+    {
+        const std::vector<float> samples(4096, 1.5);
+
+        const auto compressed = Codec::Compress(samples, 64);
+        REQUIRE(compressed.size() < 64);
+        REQUIRE(Codec::Decompress(compressed, samples.size(), 64) == samples);
+    }
+
+    SECTION("Empty blocks are restored exactly")
+    {
+        const std::vector<float> samples;
+
+        const auto compressed = Codec::Compress(samples, 1);
+        REQUIRE(Codec::Decompress(compressed, 0, 1) == samples);
+    }
+}
@@ -224,3 +224,83 @@ TEST_CASE("Execution class testing"
         REQUIRE_FALSE(execution.Is_Normal_State_Unsafe(100, "Execute"));
     }
 }
+
+TEST_CASE("Execution instruction stream testing"
+          "[execution]")
+{
+    using GILES::Internal::Execution;
+    using GILES::Internal::Instruction_Stream;
+
+    Instruction_Stream stream;
+    stream.Add_Stage("Execute",
+                     {"add r0, 10", "Stalled, pending decode", "str r0, r1"});
+    stream.Set_State("Execute", 1, 1, Execution::State::Stalled);
+    const auto shared = Instruction_Stream::Intern(std::move(stream));
+
+    Execution first{3};
+    Execution second{3};
+    first.Set_Instruction_Stream(shared);
+    second.Set_Instruction_Stream(shared);
+
+    SECTION("Executions share the stream")
+    {
+        REQUIRE(first.Get_Instruction_Stream() ==
+                second.Get_Instruction_Stream());
+
+        REQUIRE("str r0, r1" == first.Get_Value<std::string>(2, "Execute"));
+        REQUIRE("str" == second.Get_Instruction(2, "Execute").Get_Opcode());
+        REQUIRE_THROWS_WITH(
+            first.Get_Value<std::uint8_t>(0, "Execute"),
+            "The requested pipeline state is not stored as the requested type");
+        REQUIRE_THROWS_AS(first.Get_Value<std::string>(0, "Fetch"),
+                          std::out_of_range);
+    }
+
+    SECTION("Stalls are read from the stream")
+    {
+        REQUIRE(Execution::State::Normal == first.Get_State(0, "Execute"));
+        REQUIRE(Execution::State::Stalled == first.Get_State(1, "Execute"));
+        REQUIRE(Execution::State::Stalled ==
+                first.Get_State_Unsafe(3, "Execute"));
+        REQUIRE(Execution::State::Stalled ==
+                first.Get_State_Unsafe(0, "Fetch"));
+    }
+
+    SECTION("Added values take priority over the stream")
+    {
+        first.Add_Value(0, "Execute", Execution::State::Flushing);
+        first.Add_Value<std::string>(2, "Execute", "ldr r0, r1");
+
+        REQUIRE(Execution::State::Flushing == first.Get_State(0, "Execute"));
+        REQUIRE("ldr r0, r1" == first.Get_Value<std::string>(2, "Execute"));
+
+        // The other Execution is unaffected.
+        REQUIRE(Execution::State::Normal == second.Get_State(0, "Execute"));
+        REQUIRE("str r0, r1" == second.Get_Value<std::string>(2, "Execute"));
+    }
+
+    SECTION("Next_Normal_Cycle skips stalls")
+    {
+        REQUIRE(0 == first.Next_Normal_Cycle(0, "Execute"));
+        REQUIRE(2 == first.Next_Normal_Cycle(1, "Execute"));
+        REQUIRE(3 == first.Next_Normal_Cycle(3, "Execute"));
+        REQUIRE(3 == first.Next_Normal_Cycle(0, "Fetch"));
+
+        // Added values are taken into account.
+        first.Add_Value(2, "Execute", Execution::State::Flushing);
+        REQUIRE(3 == first.Next_Normal_Cycle(1, "Execute"));
+        first.Add_Value<std::string>(1, "Execute", "add r0, 10");
+        REQUIRE(1 == first.Next_Normal_Cycle(1, "Execute"));
+    }
+
+    SECTION("Executions shorter than the stream")
+    {
+        Execution shorter{2};
+        shorter.Set_Instruction_Stream(shared);
+
+        REQUIRE(2 == shorter.Get_Cycle_Count());
+        REQUIRE(2 == shorter.Next_Normal_Cycle(1, "Execute"));
+        REQUIRE_THROWS_AS(shorter.Get_Value<std::string>(2, "Execute"),
+                          std::out_of_range);
+    }
+}
@@ -0,0 +1,505 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*!
+    @file Test_GILES.cpp
+    @brief Contains the tests that run GILES from start to finish, using the
+    test simulator.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <algorithm>           // for max
+#include <chrono>              // for milliseconds
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for uint32_t
+#include <cstdio>              // for remove
+#include <fstream>             // for ifstream
+#include <iterator>            // for istreambuf_iterator
+#include <memory>              // for make_shared, make_unique
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <optional>            // for optional
+#include <string>              // for string, to_string
+#include <thread>              // for thread, yield, sleep_for
+#include <vector>              // for vector
+
+#include <catch.hpp>  // for catch
+
+#include <nlohmann/json.hpp>  // for json
+
+#include "Coefficients.hpp"     // for Coefficients
+#include "Emulator_Test.hpp"    // for Emulator_Test
+#include "GILES.cpp"            // for GILES
+#include "Input_Generator.hpp"  // for Input_Generator
+#include "Journal.hpp"          // for Journal
+#include "Memory_Budget.hpp"    // for Memory_Budget
+#include "Output.hpp"           // for Output
+
+namespace
+{
+//! @brief Reads the whole of a file saved by GILES.
+//! @param p_path The path to the file.
+//! @returns The contents of the file.
+std::string read_output(const std::string& p_path)
+{
+    std::ifstream file{p_path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file},
+            std::istreambuf_iterator<char>{}};
+}
+
+//! @class Output_Stop
+//! @brief Stops GILES once the trace of a chosen run has been added, as if
+//! it had been interrupted.
+class Output_Stop : public GILES::Internal::Output
+{
+private:
+    GILES::GILES& m_giles;
+    const std::size_t m_run_index;
+
+public:
+    Output_Stop(GILES::GILES& p_giles, const std::size_t p_run_index)
+        : Output{GILES::Internal::Output_Options{}}, m_giles{p_giles},
+          m_run_index{p_run_index}
+    {
+    }
+
+    void Add_Trace(const std::size_t /*p_thread*/,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& /*p_trace*/,
+                   const std::string& /*p_extra_data*/) override
+    {
+        if (p_run_index >= m_run_index)
+        {
+            m_giles.Stop();
+        }
+    }
+
+    void Finish() override {}
+};
+
+//! @class Output_Hold
+//! @brief Holds back the trace of every run from a chosen run onwards until
+//! GILES is stopped, so that stopping it from another thread always happens
+//! before every run is completed.
+class Output_Hold : public GILES::Internal::Output
+{
+private:
+    const GILES::GILES& m_giles;
+    const std::size_t m_run_index;
+
+public:
+    Output_Hold(const GILES::GILES& p_giles, const std::size_t p_run_index)
+        : Output{GILES::Internal::Output_Options{}}, m_giles{p_giles},
+          m_run_index{p_run_index}
+    {
+    }
+
+    void Add_Trace(const std::size_t /*p_thread*/,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& /*p_trace*/,
+                   const std::string& /*p_extra_data*/) override
+    {
+        while (p_run_index >= m_run_index && !m_giles.Is_Stopping())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void Finish() override {}
+};
+
+//! @class Output_Slow_Sink
+//! @brief Queues a block of memory for every trace, which a background thread
+//! frees slowly as an output writing to a slow disk would. Records the most
+//! memory that was queued when a trace was added.
+class Output_Slow_Sink : public GILES::Internal::Output
+{
+public:
+    //! The number of bytes queued for each trace.
+    static constexpr std::size_t Trace_Bytes{1024 * 1024};
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::size_t m_queued;
+    bool m_finishing;
+    std::size_t m_most_queued;
+    std::thread m_writer;
+
+    void write()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (true)
+        {
+            m_changed.wait(lock,
+                           [this] { return 0 != m_queued || m_finishing; });
+            if (0 == m_queued)
+            {
+                return;
+            }
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+            GILES::Internal::Memory_Budget::Remove_Queued(Trace_Bytes);
+            lock.lock();
+            --m_queued;
+        }
+    }
+
+public:
+    Output_Slow_Sink()
+        : Output{GILES::Internal::Output_Options{}}, m_mutex{}, m_changed{},
+          m_queued{0}, m_finishing{false}, m_most_queued{0},
+          m_writer{[this] { write(); }}
+    {
+    }
+
+    ~Output_Slow_Sink() override { Finish(); }
+
+    void Add_Trace(const std::size_t /*p_thread*/,
+                   const std::size_t /*p_run_index*/,
+                   const std::vector<float>& /*p_trace*/,
+                   const std::string& /*p_extra_data*/) override
+    {
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            m_most_queued = std::max(
+                m_most_queued, GILES::Internal::Memory_Budget::Get_Queued());
+            GILES::Internal::Memory_Budget::Add_Queued(Trace_Bytes);
+            ++m_queued;
+        }
+        m_changed.notify_all();
+    }
+
+    void Finish() override
+    {
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            m_finishing = true;
+        }
+        m_changed.notify_all();
+        if (m_writer.joinable())
+        {
+            m_writer.join();
+        }
+    }
+
+    //! @returns The most bytes that were queued when a trace was added.
+    std::size_t Get_Most_Queued() const { return m_most_queued; }
+};
+
+//! @class Output_Runs
+//! @brief Counts the number of times the trace of each run is added, and
+//! checks that each is added by one of the threads given to Start().
+class Output_Runs : public GILES::Internal::Output
+{
+private:
+    std::mutex m_mutex;
+    std::vector<std::size_t> m_counts;
+    std::size_t m_number_of_threads;
+    bool m_threads_valid;
+
+public:
+    Output_Runs()
+        : Output{GILES::Internal::Output_Options{}}, m_mutex{}, m_counts{},
+          m_number_of_threads{0}, m_threads_valid{true}
+    {
+    }
+
+    void Start(const std::size_t p_number_of_runs,
+               const std::size_t p_number_of_threads) override
+    {
+        m_counts.assign(p_number_of_runs, 0);
+        m_number_of_threads = p_number_of_threads;
+    }
+
+    void Add_Trace(const std::size_t p_thread,
+                   const std::size_t p_run_index,
+                   const std::vector<float>& /*p_trace*/,
+                   const std::string& /*p_extra_data*/) override
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        ++m_counts.at(p_run_index);
+        m_threads_valid = m_threads_valid && p_thread < m_number_of_threads;
+    }
+
+    void Finish() override {}
+
+    //! @returns The number of times the trace of each run was added.
+    const std::vector<std::size_t>& Get_Counts() const { return m_counts; }
+
+    //! @returns Whether every trace was added by a valid thread.
+    bool Threads_Valid() const { return m_threads_valid; }
+};
+}  // namespace
+
+TEST_CASE("GILES class testing"
+          "[giles]")
+{
+    const std::uint32_t number_of_runs{200};
+
+    const auto coefficients =
+        std::make_shared<const GILES::Internal::Coefficients>(
+            nlohmann::json{});
+
+    // GILES keeps a reference to the traces path, so this must outlive it.
+    const std::optional<std::string> no_path{};
+
+    // Traces are generated using the test simulator, which gives a different
+    // trace for each input.
+    const auto make_giles = [&](const std::optional<std::string>& p_path) {
+        auto giles = std::make_unique<GILES::GILES>(
+            "Test_GILES.elf", coefficients, p_path, number_of_runs);
+        giles->Set_Simulator("Test");
+        giles->Set_Inputs({{0x20000000, 16}}, 42);
+        giles->Set_Number_Of_Threads(2);
+        return giles;
+    };
+
+    SECTION("Resuming a stopped run saves the same traces as a complete run")
+    {
+        const std::optional<std::string> complete_path{
+            "Test_GILES_complete.npy"};
+        const std::optional<std::string> resumed_path{"Test_GILES_resumed.npy"};
+
+        {
+            const auto giles = make_giles(complete_path);
+            giles->Set_Output_Format("NumPy");
+            giles->Run();
+            REQUIRE(number_of_runs == giles->Get_Runs_Completed());
+        }
+
+        {
+            const auto giles = make_giles(resumed_path);
+            giles->Set_Output_Format("NumPy");
+            giles->Add_Output(std::make_shared<Output_Stop>(*giles, 50));
+            giles->Run();
+            REQUIRE(giles->Get_Runs_Completed() < number_of_runs);
+        }
+        REQUIRE(read_output(complete_path.value()) !=
+                read_output(resumed_path.value()));
+
+        {
+            const auto giles = make_giles(resumed_path);
+            giles->Set_Output_Format("NumPy");
+            giles->Resume();
+            giles->Run();
+            REQUIRE(number_of_runs == giles->Get_Runs_Completed());
+        }
+        REQUIRE(read_output(complete_path.value()) ==
+                read_output(resumed_path.value()));
+        REQUIRE(read_output(complete_path.value() + ".extra.npy") ==
+                read_output(resumed_path.value() + ".extra.npy"));
+
+        for (const auto& path : {complete_path.value(), resumed_path.value()})
+        {
+            std::remove(path.c_str());
+            std::remove((path + ".extra.npy").c_str());
+            std::remove(GILES::Internal::Journal::Journal_Path(path).c_str());
+        }
+    }
+
+    SECTION("Stopping from another thread saves every completed run")
+    {
+        const std::optional<std::string> stopped_path{"Test_GILES_stopped.npy"};
+
+        const auto giles = make_giles(stopped_path);
+        giles->Set_Output_Format("NumPy");
+        giles->Add_Output(std::make_shared<Output_Hold>(*giles, 20));
+
+        // As a signal handler would, this stops GILES part way through Run().
+        std::thread stopper{[&giles] {
+            while (giles->Get_Runs_Completed() < 20)
+            {
+                std::this_thread::yield();
+            }
+            giles->Stop();
+        }};
+        giles->Run();
+        stopper.join();
+
+        const std::size_t runs_completed{giles->Get_Runs_Completed()};
+        REQUIRE(runs_completed >= 20);
+        REQUIRE(runs_completed < number_of_runs);
+
+        // The header of the finished file only counts the completed runs.
+        const std::string saved{read_output(stopped_path.value())};
+        REQUIRE(std::string::npos !=
+                saved.find("'shape': (" + std::to_string(runs_completed) +
+                           ", "));
+
+        std::remove(stopped_path.value().c_str());
+        std::remove((stopped_path.value() + ".extra.npy").c_str());
+        std::remove(
+            GILES::Internal::Journal::Journal_Path(stopped_path.value())
+                .c_str());
+    }
+
+    SECTION("Kept traces written in place match those copied into memory")
+    {
+        // Kept traces are written straight into memory when they are not
+        // saved as well, and copied there when they are.
+        const auto in_place = make_giles(no_path);
+        in_place->Collect_Traces();
+        in_place->Run();
+
+        const std::optional<std::string> saved_path{"Test_GILES_kept.npy"};
+        const auto copied = make_giles(saved_path);
+        copied->Set_Output_Format("NumPy");
+        copied->Collect_Traces();
+        copied->Run();
+
+        const auto& expected = copied->Get_Traces();
+        const auto& actual   = in_place->Get_Traces();
+        REQUIRE(number_of_runs == actual.Rows());
+        REQUIRE(expected.Stride() == actual.Stride());
+        REQUIRE(std::vector<float>(actual.Data(),
+                                   actual.Data() +
+                                       actual.Rows() * actual.Stride()) ==
+                std::vector<float>(expected.Data(),
+                                   expected.Data() +
+                                       expected.Rows() * expected.Stride()));
+        for (std::size_t run{0}; run < number_of_runs; ++run)
+        {
+            REQUIRE(expected.Length(run) == actual.Length(run));
+            REQUIRE(expected.Run(run) == actual.Run(run));
+            REQUIRE(expected.Extra_Data(run) == actual.Extra_Data(run));
+        }
+
+        std::remove(saved_path.value().c_str());
+        std::remove((saved_path.value() + ".extra.npy").c_str());
+        std::remove(GILES::Internal::Journal::Journal_Path(saved_path.value())
+                        .c_str());
+    }
+
+    SECTION("The run used to estimate the cost is not ran again")
+    {
+        const auto giles  = make_giles(no_path);
+        const auto output = std::make_shared<Output_Runs>();
+        giles->Add_Output(output);
+        giles->Collect_Traces();
+
+        const std::size_t runs_simulated{
+            GILES::Internal::Emulator_Test::Get_Runs_Simulated()};
+        REQUIRE(giles->Estimate_Cycles() > 0);
+        giles->Run();
+        REQUIRE(GILES::Internal::Emulator_Test::Get_Runs_Simulated() -
+                    runs_simulated ==
+                number_of_runs);
+        REQUIRE(std::vector<std::size_t>(number_of_runs, 1) ==
+                output->Get_Counts());
+
+        // The reused run gives the same trace as running it again.
+        const auto again = make_giles(no_path);
+        again->Collect_Traces();
+        again->Run();
+        const auto& expected = again->Get_Traces();
+        const auto& actual   = giles->Get_Traces();
+        REQUIRE(std::vector<float>(actual.Row(0),
+                                   actual.Row(0) + actual.Length(0)) ==
+                std::vector<float>(expected.Row(0),
+                                   expected.Row(0) + expected.Length(0)));
+        REQUIRE(actual.Extra_Data(0) == expected.Extra_Data(0));
+    }
+
+    SECTION("A slow output holds back new runs once over the memory limit")
+    {
+        using GILES::Internal::Memory_Budget;
+
+        // A single thread never has another run in progress to wait for, so
+        // only the output writing its queued traces can free memory.
+        const auto giles = make_giles(no_path);
+        giles->Set_Number_Of_Threads(1);
+        const auto output = std::make_shared<Output_Slow_Sink>();
+        giles->Add_Output(output);
+
+        const std::size_t limit{4 * Output_Slow_Sink::Trace_Bytes};
+        Memory_Budget::Set_Limit(Memory_Budget::Get_Used() + limit);
+        giles->Run();
+        Memory_Budget::Set_Limit(0);
+
+        REQUIRE(number_of_runs == giles->Get_Runs_Completed());
+        REQUIRE(output->Get_Most_Queued() <= limit);
+    }
+
+    SECTION("Batches cover every run once when they do not divide the runs")
+    {
+        const auto giles = make_giles(no_path);
+        giles->Set_Number_Of_Threads(3);
+        giles->Set_Batch_Size(7);
+        const auto output = std::make_shared<Output_Runs>();
+        giles->Add_Output(output);
+        giles->Run();
+
+        REQUIRE(number_of_runs == giles->Get_Runs_Completed());
+        REQUIRE(std::vector<std::size_t>(number_of_runs, 1) ==
+                output->Get_Counts());
+        REQUIRE(output->Threads_Valid());
+    }
+
+    SECTION("Batches cover every run once with more threads than runs")
+    {
+        auto giles = std::make_unique<GILES::GILES>(
+            "Test_GILES.elf", coefficients, no_path, 5);
+        giles->Set_Simulator("Test");
+        giles->Set_Number_Of_Threads(8);
+        giles->Set_Batch_Size(2);
+        const auto output = std::make_shared<Output_Runs>();
+        giles->Add_Output(output);
+        giles->Run();
+
+        REQUIRE(5 == giles->Get_Runs_Completed());
+        REQUIRE(std::vector<std::size_t>(5, 1) == output->Get_Counts());
+        REQUIRE(output->Threads_Valid());
+    }
+
+    SECTION("Tuning a single run uses one thread taking one run at a time")
+    {
+        auto giles = std::make_unique<GILES::GILES>(
+            "Test_GILES.elf", coefficients, no_path, 1);
+        giles->Set_Simulator("Test");
+        giles->Set_Number_Of_Threads(4);
+        giles->Tune();
+        const auto output = std::make_shared<Output_Runs>();
+        giles->Add_Output(output);
+        giles->Run();
+
+        REQUIRE(1 == giles->Get_Number_Of_Threads());
+        REQUIRE(1 == giles->Get_Batch_Size());
+        REQUIRE(std::vector<std::size_t>{1} == output->Get_Counts());
+    }
+
+    SECTION("Tuning never chooses more threads than runs")
+    {
+        auto giles = std::make_unique<GILES::GILES>(
+            "Test_GILES.elf", coefficients, no_path, 3);
+        giles->Set_Simulator("Test");
+        giles->Set_Number_Of_Threads(8);
+        giles->Tune();
+        const auto output = std::make_shared<Output_Runs>();
+        giles->Add_Output(output);
+        giles->Run();
+
+        REQUIRE(giles->Get_Number_Of_Threads() <= 3);
+        REQUIRE(giles->Get_Number_Of_Threads() * giles->Get_Batch_Size() <=
+                3);
+        REQUIRE(std::vector<std::size_t>(3, 1) == output->Get_Counts());
+        REQUIRE(output->Threads_Valid());
+    }
+}
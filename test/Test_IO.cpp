@@ -0,0 +1,87 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Test_IO.cpp
+    @brief Contains the tests for the IO class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdio>     // for remove
+#include <fstream>    // for ofstream
+#include <stdexcept>  // for invalid_argument
+#include <string>     // for string
+
+#include <catch.hpp>  // for catch
+
+#include "IO.hpp"  // for IO
+
+TEST_CASE("Loading jobs"
+          "[io]")
+{
+    const std::string path{"Test_IO_Jobs.json"};
+    {
+        std::ofstream file{path};
+        file << R"([{"program": "aes.elf", "runs": 1000, "output": "aes.npy",
+                     "format": "NumPy", "fault": [10, "R0", 2],
+                     "timeout": 5000},
+                    {"program": "present.elf", "model": "Power"}])";
+    }
+
+    const auto jobs = GILES::Internal::IO().Load_Jobs(path);
+    REQUIRE(jobs.size() == 2);
+
+    SECTION("Every setting is read")
+    {
+        REQUIRE(jobs[0].Program_Path == "aes.elf");
+        REQUIRE(jobs[0].Number_Of_Runs == 1000);
+        REQUIRE(jobs[0].Traces_Path == "aes.npy");
+        REQUIRE(jobs[0].Output_Format == "NumPy");
+        REQUIRE(jobs[0].Fault);
+        REQUIRE(jobs[0].Fault_Cycle == 10);
+        REQUIRE(jobs[0].Fault_Register == "R0");
+        REQUIRE(jobs[0].Fault_Bit == 2);
+        REQUIRE(jobs[0].Timeout == 5000u);
+    }
+
+    SECTION("Settings that are not given use their defaults")
+    {
+        REQUIRE(jobs[1].Program_Path == "present.elf");
+        REQUIRE(jobs[1].Model_Name == "Power");
+        REQUIRE(jobs[1].Number_Of_Runs == 1);
+        REQUIRE_FALSE(jobs[1].Traces_Path);
+        REQUIRE_FALSE(jobs[1].Output_Format);
+        REQUIRE_FALSE(jobs[1].Fault);
+        REQUIRE_FALSE(jobs[1].Timeout);
+    }
+
+    SECTION("Single jobs are parsed without stopping on errors")
+    {
+        const auto job = GILES::Internal::IO().Parse_Job(
+            R"({"program": "aes.elf", "runs": 5})");
+        REQUIRE(job.Program_Path == "aes.elf");
+        REQUIRE(job.Number_Of_Runs == 5);
+
+        REQUIRE_THROWS_AS(GILES::Internal::IO().Parse_Job(R"({"runs": 5})"),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(GILES::Internal::IO().Parse_Job("{"),
+                          std::invalid_argument);
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,163 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Test_Input_Generator.cpp
+    @brief Contains the tests for the Input_Generator and Program_Image
+    classes.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <array>     // for array
+#include <cstdint>   // for uint32_t
+#include <cstdio>    // for remove
+#include <fstream>   // for ifstream, ofstream
+#include <iterator>  // for istreambuf_iterator
+#include <string>    // for string
+#include <vector>    // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Input_Generator.hpp"  // for Input_Generator
+#include "Program_Image.hpp"    // for Program_Image
+
+TEST_CASE("Input_Generator class testing"
+          "[input_generator]")
+{
+    using GILES::Internal::Input_Generator;
+
+    SECTION("Philox matches the published known answers")
+    {
+        REQUIRE(Input_Generator::Philox({0, 0, 0, 0}, {0, 0}) ==
+                std::array<std::uint32_t, 4>{
+                    0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+        REQUIRE(Input_Generator::Philox(
+                    {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                    {0xa4093822, 0x299f31d0}) ==
+                std::array<std::uint32_t, 4>{
+                    0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+    }
+
+    const Input_Generator generator{
+        {{0x20000000, 20},
+         {0x20000100, 2, Input_Generator::Kind::Fixed, "ab"},
+         {0x20000200, 2, Input_Generator::Kind::Interleaved, "cd"}},
+        42};
+
+    SECTION("Inputs only depend on the seed and the run index")
+    {
+        REQUIRE(generator.Generate(7) == generator.Generate(7));
+        REQUIRE(generator.Generate(7)[0].size() == 20);
+        REQUIRE(generator.Generate(7)[0] != generator.Generate(8)[0]);
+
+        const Input_Generator other_seed{generator.Get_Inputs(), 43};
+        REQUIRE(generator.Generate(7)[0] != other_seed.Generate(7)[0]);
+    }
+
+    SECTION("Fixed and interleaved inputs use their fixed value")
+    {
+        REQUIRE(generator.Generate(0)[1] == "ab");
+        REQUIRE(generator.Generate(1)[1] == "ab");
+        REQUIRE(generator.Generate(2)[2] == "cd");
+        REQUIRE(generator.Generate(3)[2] != "cd");
+    }
+}
+
+TEST_CASE("Program_Image class testing"
+          "[program_image]")
+{
+    using GILES::Internal::Program_Image;
+
+    // A minimal ELF file with one segment of 8 bytes, which runs at
+    // 0x20000000 and is loaded from 0x08000000, and a symbol table naming
+    // the 4 bytes at 0x20000004 "key".
+    std::string elf(252, '\0');
+    const auto put = [&elf](const std::size_t p_offset,
+                            const std::uint32_t p_value) {
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            elf[p_offset + i] = static_cast<char>(p_value >> (8 * i));
+        }
+    };
+    // A 32 bit little-endian ELF file.
+    const char identification[]{0x7f, 'E', 'L', 'F', 1, 1};
+    elf.replace(
+        0, sizeof(identification), identification, sizeof(identification));
+
+    put(28, 52);   // The position of the program headers.
+    elf[42] = 32;  // The size of each program header.
+    elf[44] = 1;   // The number of program headers.
+
+    put(52, 1);           // A segment loaded from the file.
+    put(56, 84);          // Its position within the file.
+    put(60, 0x20000000);  // The address it runs at.
+    put(64, 0x08000000);  // The address it is loaded from.
+    put(68, 8);           // Its size.
+    elf.replace(84, 8, "01234567");
+
+    put(32, 132);  // The position of the section headers.
+    elf[46] = 40;  // The size of each section header.
+    elf[48] = 3;   // The number of section headers.
+    elf.replace(92, 5, std::string{"\0key\0", 5});
+    put(116, 1);           // The name of the second symbol.
+    put(120, 0x20000004);  // Its address.
+    put(124, 4);           // Its size.
+    put(176, 2);           // The second section is the symbol table.
+    put(188, 100);         // Its position within the file.
+    put(192, 32);          // Its size.
+    put(196, 2);           // The section holding the names of the symbols.
+    put(216, 3);           // The third section holds the names.
+    put(228, 92);          // Its position within the file.
+    put(232, 5);           // Its size.
+
+    const std::string path{"Test_Program_Image.elf"};
+    {
+        std::ofstream file{path, std::ios::binary};
+        file << elf;
+    }
+
+    Program_Image image{path};
+
+    SECTION("Only memory loaded from the file is writable")
+    {
+        REQUIRE(image.Is_Writable(0x20000000, 8));
+        REQUIRE(image.Is_Writable(0x08000004, 4));
+        REQUIRE_FALSE(image.Is_Writable(0x20000004, 5));
+        REQUIRE_FALSE(image.Is_Writable(0x1fffffff, 1));
+    }
+
+    SECTION("Writes are saved")
+    {
+        image.Write(0x20000002, "ab");
+        image.Save(path);
+
+        std::ifstream file{path, std::ios::binary};
+        const std::string saved{std::istreambuf_iterator<char>{file},
+                                std::istreambuf_iterator<char>{}};
+        REQUIRE(saved.substr(84, 8) == "01ab4567");
+    }
+
+    SECTION("Variables are found by name")
+    {
+        const auto key = image.Find_Buffer("key");
+        REQUIRE(key.Address == 0x20000004);
+        REQUIRE(key.Size == 4);
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,158 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Instruction_Stream.cpp
+    @brief Contains the tests for the Instruction_Stream class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstddef>    // for size_t
+#include <memory>     // for weak_ptr
+#include <stdexcept>  // for out_of_range
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Chunked_Buffer.hpp"      // for Chunked_Buffer
+#include "Instruction_Stream.hpp"  // for Instruction_Stream
+
+TEST_CASE("Instruction_Stream class testing"
+          "[instruction_stream]")
+{
+    using GILES::Internal::Instruction_Stream;
+    using GILES::Internal::Pipeline_State;
+
+    const Instruction_Stream::Stage fetch{"add r0, r1", "str r0, r2", "nop"};
+    const Instruction_Stream::Stage execute{
+        "Stalled, pending decode", "add r0, r1", "str r0, r2"};
+
+    const auto make_stream = [&](const Instruction_Stream::Stage& p_execute) {
+        Instruction_Stream stream;
+        stream.Add_Stage("Fetch", fetch);
+        stream.Add_Stage("Execute", p_execute);
+        stream.Set_State("Execute", 0, 1, Pipeline_State::Stalled);
+        return stream;
+    };
+
+    SECTION("Values and stalls")
+    {
+        const Instruction_Stream stream{make_stream(execute)};
+
+        REQUIRE(stream.Has_Stage("Fetch"));
+        REQUIRE_FALSE(stream.Has_Stage("Decode"));
+
+        REQUIRE("str r0, r2" == stream.Get_Value(1, "Fetch"));
+        REQUIRE("add r0, r1" == stream.Get_Value(1, "Execute"));
+        REQUIRE_THROWS_AS(stream.Get_Value(3, "Fetch"), std::out_of_range);
+        REQUIRE_THROWS_AS(stream.Get_Value(0, "Decode"), std::out_of_range);
+
+        REQUIRE(Pipeline_State::Stalled == stream.Get_State(0, "Execute"));
+        REQUIRE(Pipeline_State::Normal == stream.Get_State(1, "Execute"));
+        REQUIRE(Pipeline_State::Normal == stream.Get_State(0, "Fetch"));
+        REQUIRE_THROWS_AS(stream.Get_State(3, "Execute"), std::out_of_range);
+        REQUIRE(1 == stream.Get_States("Execute").Next_Normal(0));
+
+        REQUIRE(stream.Is_Stage("Fetch", fetch));
+        REQUIRE_FALSE(stream.Is_Stage("Fetch", execute));
+        REQUIRE_FALSE(stream.Is_Stage("Decode", fetch));
+    }
+
+    SECTION("Stages longer than a chunk")
+    {
+        // Enough cycles to need more than one chunk of the Chunked_Buffer.
+        const std::size_t length{
+            GILES::Internal::Chunked_Buffer::Chunk_Length + 3};
+        Instruction_Stream::Stage stage(length, "nop");
+        stage[length - 1] = "add r0, r1";
+
+        Instruction_Stream stream;
+        stream.Add_Stage("Execute", stage);
+
+        REQUIRE("nop" == stream.Get_Value(0, "Execute"));
+        REQUIRE("add r0, r1" == stream.Get_Value(length - 1, "Execute"));
+        REQUIRE("add" == stream.Get_Instruction(length - 1, "Execute")
+                             .Get_Opcode());
+        REQUIRE_THROWS_AS(stream.Get_Value(length, "Execute"),
+                          std::out_of_range);
+        REQUIRE_THROWS_AS(stream.Get_Instruction(length, "Execute"),
+                          std::out_of_range);
+        REQUIRE(stream.Is_Stage("Execute", stage));
+
+        stage[1] = "add r0, r1";
+        REQUIRE_FALSE(stream.Is_Stage("Execute", stage));
+    }
+
+    SECTION("Set_State outside of a stage")
+    {
+        Instruction_Stream stream;
+        stream.Add_Stage("Execute", execute);
+
+        REQUIRE_THROWS_AS(
+            stream.Set_State("Execute", 2, 2, Pipeline_State::Stalled),
+            std::out_of_range);
+        REQUIRE_THROWS_AS(
+            stream.Set_State("Decode", 0, 1, Pipeline_State::Stalled),
+            std::out_of_range);
+    }
+
+    SECTION("Intern shares identical streams")
+    {
+        const auto first = Instruction_Stream::Intern(make_stream(execute));
+        const auto second = Instruction_Stream::Intern(make_stream(execute));
+
+        REQUIRE(first == second);
+        REQUIRE(first->Get_Hash() == second->Get_Hash());
+
+        // A different stall is a different stream.
+        Instruction_Stream unstalled;
+        unstalled.Add_Stage("Fetch", fetch);
+        unstalled.Add_Stage("Execute", execute);
+        const auto third = Instruction_Stream::Intern(std::move(unstalled));
+
+        REQUIRE(first != third);
+        REQUIRE(*first != *third);
+
+        // As is a different instruction.
+        Instruction_Stream::Stage changed{execute};
+        changed[2] = "str r0, r3";
+        const auto fourth = Instruction_Stream::Intern(make_stream(changed));
+
+        REQUIRE(first != fourth);
+        REQUIRE("str r0, r3" == fourth->Get_Value(2, "Execute"));
+    }
+
+    SECTION("Intern does not keep streams alive")
+    {
+        auto first = Instruction_Stream::Intern(make_stream(execute));
+        const std::weak_ptr<const Instruction_Stream> weak{first};
+        first.reset();
+
+        REQUIRE(weak.expired());
+
+        // Interning the same stream again creates a new one which is shared
+        // from then on.
+        const auto second = Instruction_Stream::Intern(make_stream(execute));
+        const auto third = Instruction_Stream::Intern(make_stream(execute));
+
+        REQUIRE(second == third);
+    }
+}
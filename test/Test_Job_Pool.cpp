@@ -0,0 +1,105 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Job_Pool.cpp
+    @brief Contains the tests for the Job_Pool class and for errors being
+    thrown rather than stopping the program.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <memory>    // for make_shared
+#include <optional>  // for optional
+#include <string>    // for string
+
+#include <catch.hpp>  // for catch
+
+#include <nlohmann/json.hpp>  // for json
+
+#include "Coefficients.hpp"  // for Coefficients
+#include "Error.hpp"         // for Error
+#include "GILES.cpp"         // for GILES, Job_Pool
+
+TEST_CASE("Job_Pool class testing"
+          "[job_pool]")
+{
+    using GILES::Internal::Error;
+
+    const auto coefficients =
+        std::make_shared<const GILES::Internal::Coefficients>(
+            nlohmann::json{});
+    const std::optional<std::string> traces_path;
+
+    SECTION("Errors are thrown while a Throw_Errors exists")
+    {
+        REQUIRE_FALSE(Error::Is_Throwing());
+        {
+            const Error::Throw_Errors throw_errors;
+            REQUIRE_THROWS_WITH(Error::Report_Error("Bad value {}", 3),
+                                "Bad value 3");
+            {
+                const Error::Throw_Errors nested{false};
+                REQUIRE_FALSE(Error::Is_Throwing());
+            }
+            REQUIRE(Error::Is_Throwing());
+        }
+        REQUIRE_FALSE(Error::Is_Throwing());
+    }
+
+    SECTION("Jobs cancelled before they start are not ran")
+    {
+        const auto giles = std::make_shared<GILES::GILES>(
+            "Test_Job_Pool.elf", coefficients, traces_path, 10);
+        giles->Stop();
+
+        GILES::Job_Pool pool{2, 2};
+        const auto handle = pool.Submit(giles);
+        const auto& result = handle.Get();
+        REQUIRE(handle.Is_Done());
+        REQUIRE(result.Cancelled);
+        REQUIRE_FALSE(result.Error);
+        REQUIRE(result.Runs_Completed == 0);
+        REQUIRE(handle.Get_Progress() == 0.0);
+    }
+
+    SECTION("Errors are returned rather than stopping the program")
+    {
+        // The simulator can not read the memory of the target so this fails
+        // before any runs are started.
+        const auto unreadable = std::make_shared<GILES::GILES>(
+            "Test_Job_Pool.elf", coefficients, traces_path, 10);
+        unreadable->Add_Target_Output(0x20000000, 16);
+
+        // The register does not exist so this fails within every thread
+        // generating traces.
+        const auto bad_fault = std::make_shared<GILES::GILES>(
+            "Test_Job_Pool.elf", coefficients, traces_path, 10);
+        bad_fault->Inject_Fault(1, "R99", 0);
+
+        GILES::Job_Pool pool{2, 2};
+        const auto first  = pool.Submit(unreadable);
+        const auto second = pool.Submit(bad_fault);
+
+        REQUIRE(first.Get().Error);
+        REQUIRE_FALSE(first.Get().Cancelled);
+        REQUIRE(second.Get().Error.value_or("").find("R99") !=
+                std::string::npos);
+        REQUIRE(second.Get().Runs_Completed == 0);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Test_Journal.cpp
+    @brief Contains the tests for the Journal class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdio>   // for remove
+#include <fstream>  // for ofstream
+#include <string>   // for string
+
+#include <catch.hpp>  // for catch
+
+#include "Journal.hpp"  // for Journal
+
+TEST_CASE("Journal class testing"
+          "[journal]")
+{
+    using GILES::Internal::Journal;
+
+    const std::string path{"Test_Journal.journal"};
+
+    {
+        Journal journal{path, 10, false};
+        REQUIRE(0 == journal.Number_Completed());
+        journal.Add({4, 2});
+        journal.Add({7});
+    }
+
+    SECTION("Completed runs are kept when resuming")
+    {
+        const Journal journal{path, 10, true};
+        REQUIRE(3 == journal.Number_Completed());
+        REQUIRE(journal.Is_Complete(2));
+        REQUIRE(journal.Is_Complete(4));
+        REQUIRE(journal.Is_Complete(7));
+        REQUIRE_FALSE(journal.Is_Complete(0));
+        REQUIRE_FALSE(journal.Is_Complete(9));
+    }
+
+    SECTION("A partly written run is ignored")
+    {
+        {
+            std::ofstream file{path, std::ios::binary | std::ios::app};
+            file.write("\x01\x00\x00", 3);
+        }
+        {
+            Journal journal{path, 10, true};
+            REQUIRE(3 == journal.Number_Completed());
+            journal.Add({1});
+        }
+
+        const Journal journal{path, 10, true};
+        REQUIRE(4 == journal.Number_Completed());
+        REQUIRE(journal.Is_Complete(1));
+    }
+
+    SECTION("Runs are forgotten when not resuming")
+    {
+        const Journal journal{path, 10, false};
+        REQUIRE(0 == journal.Number_Completed());
+        REQUIRE_FALSE(journal.Is_Complete(4));
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,132 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Memory_Budget.cpp
+    @brief Contains the tests for the Memory_Budget class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <atomic>   // for atomic
+#include <chrono>   // for milliseconds
+#include <cstddef>  // for size_t
+#include <thread>   // for thread, sleep_for
+
+#include <catch.hpp>  // for catch
+
+#include "Memory_Budget.hpp"  // for Memory_Budget
+
+TEST_CASE("Memory_Budget class testing"
+          "[memory_budget]")
+{
+    using GILES::Internal::Memory_Budget;
+
+    // Other tests may be holding memory, so limits are relative to this.
+    const std::size_t memory_used{Memory_Budget::Get_Used()};
+
+    SECTION("Memory is accounted for")
+    {
+        Memory_Budget::Add(100);
+        REQUIRE(memory_used + 100 == Memory_Budget::Get_Used());
+        Memory_Budget::Add(50);
+        Memory_Budget::Remove(100);
+        REQUIRE(memory_used + 50 == Memory_Budget::Get_Used());
+        Memory_Budget::Remove(50);
+        REQUIRE(memory_used == Memory_Budget::Get_Used());
+    }
+
+    SECTION("Queued memory is accounted for as used")
+    {
+        const std::size_t memory_queued{Memory_Budget::Get_Queued()};
+        Memory_Budget::Add_Queued(100);
+        REQUIRE(memory_queued + 100 == Memory_Budget::Get_Queued());
+        REQUIRE(memory_used + 100 == Memory_Budget::Get_Used());
+        Memory_Budget::Remove_Queued(100);
+        REQUIRE(memory_queued == Memory_Budget::Get_Queued());
+        REQUIRE(memory_used == Memory_Budget::Get_Used());
+    }
+
+    SECTION("Held buffers are accounted for while alive")
+    {
+        {
+            Memory_Budget::Held held;
+            held.Set(100);
+            REQUIRE(memory_used + 100 == Memory_Budget::Get_Used());
+            held.Set(300);
+            REQUIRE(memory_used + 300 == Memory_Budget::Get_Used());
+            held.Set(200);
+            REQUIRE(memory_used + 200 == Memory_Budget::Get_Used());
+        }
+        REQUIRE(memory_used == Memory_Budget::Get_Used());
+    }
+
+    SECTION("Waiting without a limit does not wait")
+    {
+        Memory_Budget::Set_Limit(0);
+        REQUIRE(0 == Memory_Budget::Get_Limit());
+
+        Memory_Budget::Add(1024);
+        bool asked{false};
+        Memory_Budget::Wait([&asked] {
+            asked = true;
+            return false;
+        });
+        REQUIRE_FALSE(asked);
+        Memory_Budget::Remove(1024);
+    }
+
+    SECTION("Waiting within the limit does not wait")
+    {
+        Memory_Budget::Set_Limit(memory_used + 1024);
+        REQUIRE(memory_used + 1024 == Memory_Budget::Get_Limit());
+
+        Memory_Budget::Add(1024);
+        Memory_Budget::Wait([] { return false; });
+        Memory_Budget::Remove(1024);
+    }
+
+    SECTION("Waiting over the limit waits until memory is freed")
+    {
+        Memory_Budget::Set_Limit(memory_used + 1024);
+        Memory_Budget::Add(2048);
+
+        std::atomic<bool> freed{false};
+        std::thread freeing{[&freed] {
+            std::this_thread::sleep_for(std::chrono::milliseconds{50});
+            freed = true;
+            Memory_Budget::Remove(2048);
+        }};
+        Memory_Budget::Wait([] { return false; });
+        REQUIRE(freed);
+        freeing.join();
+    }
+
+    SECTION("Waiting over the limit stops when giving up")
+    {
+        Memory_Budget::Set_Limit(memory_used + 1024);
+        Memory_Budget::Add(2048);
+
+        std::size_t asked{0};
+        Memory_Budget::Wait([&asked] { return ++asked == 3; });
+        REQUIRE(3 == asked);
+        Memory_Budget::Remove(2048);
+    }
+
+    Memory_Budget::Set_Limit(0);
+}
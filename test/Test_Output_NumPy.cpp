@@ -0,0 +1,189 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Test_Output_NumPy.cpp
+    @brief Contains the tests for the Output_NumPy and Output_Raw classes.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdio>    // for remove
+#include <fstream>   // for ifstream
+#include <iterator>  // for istreambuf_iterator
+#include <string>    // for string
+#include <vector>    // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Abstract_Factory.hpp"    // for Output_Factory
+#include "Error.hpp"               // for Error
+#include "NumPy/Output_NumPy.hpp"  // for Output_NumPy, Output_Raw
+#include "Output.hpp"              // for Output_Options
+
+TEST_CASE("Output_NumPy class testing"
+          "[output_numpy]")
+{
+    using GILES::Internal::Output_NumPy;
+
+    const std::string path{"Test_Output_NumPy.bin"};
+
+    // Reads the whole of a file.
+    const auto read = [](const std::string& p_path) {
+        std::ifstream file{p_path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file},
+                           std::istreambuf_iterator<char>{}};
+    };
+
+    // Sample s of run r is 10 * r + s. The extra data of the first run added
+    // is the widest, so the rest are padded with zeros.
+    const std::size_t number_of_runs{6};
+    const std::size_t number_of_samples{4};
+    const std::size_t extra_data_width{3};
+    const auto make_trace = [&](const std::size_t p_run_index) {
+        std::vector<float> trace(number_of_samples);
+        for (std::size_t sample{0}; sample < number_of_samples; ++sample)
+        {
+            trace[sample] = static_cast<float>(10 * p_run_index + sample);
+        }
+        return trace;
+    };
+    const auto make_extra_data = [&](const std::size_t p_run_index) {
+        return std::string(extra_data_width - p_run_index % extra_data_width,
+                           static_cast<char>('a' + p_run_index));
+    };
+
+    // Two threads add runs out of order, as they do when each takes its own
+    // batch of runs.
+    const std::vector<std::size_t> runs{0, 3, 1, 2, 4, 5};
+    const auto save = [&](const std::string& p_name,
+                          const std::size_t p_runs_completed) {
+        const auto output =
+            GILES::Internal::Output_Factory::Construct(p_name, {path});
+        output->Start(number_of_runs, 2);
+        for (std::size_t i{0}; i < runs.size(); ++i)
+        {
+            if (runs[i] < p_runs_completed)
+            {
+                output->Add_Trace(i % 2,
+                                  runs[i],
+                                  make_trace(runs[i]),
+                                  make_extra_data(runs[i]));
+            }
+        }
+        if (p_runs_completed < number_of_runs)
+        {
+            output->Stopped(p_runs_completed);
+        }
+        output->Finish();
+    };
+
+    // The rows of both arrays, in run order.
+    const auto expected_traces = [&](const std::size_t p_runs) {
+        std::string traces;
+        for (std::size_t run{0}; run < p_runs; ++run)
+        {
+            const auto trace = make_trace(run);
+            traces.append(reinterpret_cast<const char*>(trace.data()),
+                          trace.size() * sizeof(float));
+        }
+        return traces;
+    };
+    const auto expected_extra_data = [&](const std::size_t p_runs) {
+        std::string extra_data;
+        for (std::size_t run{0}; run < p_runs; ++run)
+        {
+            std::string row{make_extra_data(run)};
+            row.resize(extra_data_width, '\0');
+            extra_data += row;
+        }
+        return extra_data;
+    };
+
+    SECTION("NumPy")
+    {
+        save("NumPy", number_of_runs);
+
+        const std::string traces{read(path)};
+        REQUIRE(traces.size() ==
+                Output_NumPy::Header_Size +
+                    number_of_runs * number_of_samples * sizeof(float));
+        REQUIRE(traces.substr(0, Output_NumPy::Header_Size) ==
+                Output_NumPy::Header("<f4", number_of_runs, number_of_samples));
+        REQUIRE(std::string::npos != traces.find("'shape': (6, 4)"));
+        REQUIRE(traces.substr(Output_NumPy::Header_Size) ==
+                expected_traces(number_of_runs));
+
+        const std::string extra_data{read(path + ".extra.npy")};
+        REQUIRE(extra_data.substr(0, Output_NumPy::Header_Size) ==
+                Output_NumPy::Header("|u1", number_of_runs, extra_data_width));
+        REQUIRE(extra_data.substr(Output_NumPy::Header_Size) ==
+                expected_extra_data(number_of_runs));
+
+        std::remove((path + ".extra.npy").c_str());
+    }
+
+    SECTION("Raw")
+    {
+        save("Raw", number_of_runs);
+
+        REQUIRE(read(path) == expected_traces(number_of_runs));
+        REQUIRE(read(path + ".extra") == expected_extra_data(number_of_runs));
+
+        std::remove((path + ".extra").c_str());
+    }
+
+    SECTION("Only completed runs are kept when stopped")
+    {
+        save("NumPy", 4);
+
+        const std::string traces{read(path)};
+        REQUIRE(traces.substr(0, Output_NumPy::Header_Size) ==
+                Output_NumPy::Header("<f4", 4, number_of_samples));
+        REQUIRE(std::string::npos != traces.find("'shape': (4, 4)"));
+        REQUIRE(traces.substr(Output_NumPy::Header_Size) == expected_traces(4));
+
+        const std::string extra_data{read(path + ".extra.npy")};
+        REQUIRE(extra_data.substr(0, Output_NumPy::Header_Size) ==
+                Output_NumPy::Header("|u1", 4, extra_data_width));
+        REQUIRE(extra_data.substr(Output_NumPy::Header_Size) ==
+                expected_extra_data(4));
+
+        std::remove((path + ".extra.npy").c_str());
+    }
+
+    SECTION("Traces of different lengths are reported")
+    {
+        const GILES::Internal::Error::Throw_Errors throw_errors;
+
+        const auto output =
+            GILES::Internal::Output_Factory::Construct("Raw", {path});
+        output->Start(number_of_runs, 1);
+        output->Add_Trace(0, 0, make_trace(0), make_extra_data(0));
+        REQUIRE_THROWS_AS(output->Add_Trace(0, 1, {1, 2}, ""),
+                          GILES::Internal::Error::Exception);
+
+        // Extra data wider than that of the first trace can not be stored.
+        REQUIRE_THROWS_AS(output->Add_Trace(0, 1, make_trace(1), "wider"),
+                          GILES::Internal::Error::Exception);
+        output->Finish();
+
+        std::remove((path + ".extra").c_str());
+    }
+
+    std::remove(path.c_str());
+}
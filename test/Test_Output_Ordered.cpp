@@ -0,0 +1,137 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Output_Ordered.cpp
+    @brief Contains the tests for the Output_Ordered class and the
+    Trace_Generator that uses it.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <atomic>    // for atomic
+#include <chrono>    // for milliseconds
+#include <cstddef>   // for size_t
+#include <memory>    // for make_shared
+#include <optional>  // for optional
+#include <string>    // for string
+#include <thread>    // for thread, sleep_for
+#include <vector>    // for vector
+
+#include <catch.hpp>  // for catch
+
+#include <nlohmann/json.hpp>  // for json
+
+#include "Coefficients.hpp"            // for Coefficients
+#include "Error.hpp"                   // for Error
+#include "GILES.cpp"                   // for GILES, Trace_Generator
+#include "Ordered/Output_Ordered.hpp"  // for Output_Ordered
+
+TEST_CASE("Output_Ordered class testing"
+          "[output_ordered]")
+{
+    using GILES::Internal::Output_Ordered;
+
+    SECTION("Traces are taken in run order")
+    {
+        Output_Ordered output{4};
+        output.Start(100, 4);
+
+        // Runs are handed out in order, as they are by GILES.
+        std::atomic<std::size_t> next_run{0};
+        std::vector<std::thread> threads;
+        for (std::size_t thread{0}; thread < 4; ++thread)
+        {
+            threads.emplace_back([&output, &next_run, thread] {
+                for (std::size_t run{next_run++}; run < 100; run = next_run++)
+                {
+                    output.Add_Trace(thread,
+                                     run,
+                                     {static_cast<float>(run)},
+                                     std::to_string(run));
+                }
+            });
+        }
+
+        Output_Ordered::Trace trace;
+        for (std::size_t run{0}; run < 100; ++run)
+        {
+            REQUIRE(output.Take(&trace));
+            REQUIRE(trace.Run == run);
+            REQUIRE(trace.Samples ==
+                    std::vector<float>{static_cast<float>(run)});
+            REQUIRE(trace.Extra_Data == std::to_string(run));
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        output.Finish();
+        REQUIRE_FALSE(output.Take(&trace));
+    }
+
+    SECTION("Runs beyond the lookahead wait for traces to be taken")
+    {
+        Output_Ordered output{2};
+        output.Start(3, 1);
+        output.Add_Trace(0, 0, {0}, "");
+        output.Add_Trace(0, 1, {1}, "");
+
+        std::atomic<bool> added{false};
+        std::thread thread{[&output, &added] {
+            output.Add_Trace(0, 2, {2}, "");
+            added = true;
+        }};
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        REQUIRE_FALSE(added);
+
+        Output_Ordered::Trace trace;
+        REQUIRE(output.Take(&trace));
+        thread.join();
+        REQUIRE(added);
+    }
+
+    SECTION("Closing stops runs from waiting")
+    {
+        Output_Ordered output{1};
+        output.Start(2, 1);
+        output.Add_Trace(0, 0, {0}, "");
+
+        std::thread thread{[&output] { output.Add_Trace(0, 1, {1}, ""); }};
+        output.Close();
+        thread.join();
+    }
+
+    SECTION("Errors are thrown when stepping through a Trace_Generator")
+    {
+        const GILES::Internal::Error::Throw_Errors throw_errors;
+        const std::optional<std::string> traces_path;
+        GILES::GILES giles{
+            "Test_Output_Ordered.elf",
+            std::make_shared<const GILES::Internal::Coefficients>(
+                nlohmann::json{}),
+            traces_path,
+            10};
+        giles.Inject_Fault(1, "R99", 0);
+
+        GILES::Trace_Generator generator{giles, 4};
+        REQUIRE_THROWS_AS(generator.begin(),
+                          GILES::Internal::Error::Exception);
+    }
+}
@@ -0,0 +1,110 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Test_Output_Preview.cpp
+    @brief Contains the tests for the Output_Preview class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdio>   // for remove
+#include <fstream>  // for ifstream
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Abstract_Factory.hpp"        // for Output_Factory
+#include "Output.hpp"                  // for Output_Options
+#include "Preview/Output_Preview.hpp"  // for Output_Preview
+
+TEST_CASE("Output_Preview class testing"
+          "[output_preview]")
+{
+    using GILES::Internal::Output_Preview;
+
+    const std::string path{"Test_Output_Preview.trs"};
+
+    const auto output =
+        GILES::Internal::Output_Factory::Construct("Preview", {path});
+
+    // Split the traces between two threads. The last trace is shorter.
+    const std::vector<std::vector<float>> traces{
+        {1, 2, 3, 4, 5}, {3, 0, 3, 8, 1}, {2, 4, 3}};
+    output->Start(traces.size(), 2);
+    for (std::size_t i{0}; i < traces.size(); ++i)
+    {
+        output->Add_Trace(i % 2, i, traces[i], "");
+    }
+    output->Finish();
+
+    std::ifstream file{Output_Preview::Preview_Path(path), std::ios::binary};
+    Output_Preview::Header header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    std::vector<Output_Preview::Level> levels(header.Number_Of_Levels);
+    file.read(reinterpret_cast<char*>(levels.data()),
+              static_cast<std::streamsize>(levels.size() *
+                                           sizeof(Output_Preview::Level)));
+
+    // Reads the minimums, maximums and means of a level.
+    const auto read_level = [&file](const Output_Preview::Level& p_level) {
+        std::vector<float> values(3 * p_level.Number_Of_Bins);
+        file.seekg(static_cast<std::streamoff>(p_level.Offset));
+        file.read(reinterpret_cast<char*>(values.data()),
+                  static_cast<std::streamsize>(values.size() * sizeof(float)));
+        return values;
+    };
+
+    SECTION("Header")
+    {
+        REQUIRE(3 == header.Number_Of_Traces);
+        REQUIRE(5 == header.Number_Of_Samples);
+        REQUIRE(4 == header.Number_Of_Levels);
+        REQUIRE(5 == levels[0].Number_Of_Bins);
+        REQUIRE(2 == levels[1].Number_Of_Bins);
+        REQUIRE(1 == levels[3].Number_Of_Bins);
+    }
+
+    SECTION("Every sample")
+    {
+        const auto values = read_level(levels[0]);
+        REQUIRE(std::vector<float>(values.begin(), values.begin() + 5) ==
+                std::vector<float>{1, 0, 3, 4, 1});
+        REQUIRE(std::vector<float>(values.begin() + 5, values.begin() + 10) ==
+                std::vector<float>{3, 4, 3, 8, 5});
+        REQUIRE(2.0 == Approx(values[10]));
+        REQUIRE(2.0 == Approx(values[11]));
+        REQUIRE(3.0 == Approx(values[12]));
+        REQUIRE(6.0 == Approx(values[13]));
+        REQUIRE(3.0 == Approx(values[14]));
+    }
+
+    SECTION("Four samples per bin")
+    {
+        const auto values = read_level(levels[1]);
+        REQUIRE(std::vector<float>(values.begin(), values.begin() + 4) ==
+                std::vector<float>{0, 1, 8, 5});
+
+        // The mean of all 11 samples in the first bin.
+        REQUIRE(3.0 == Approx(values[4]));
+        REQUIRE(3.0 == Approx(values[5]));
+    }
+
+    file.close();
+    std::remove(Output_Preview::Preview_Path(path).c_str());
+}
@@ -0,0 +1,168 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Test_Output_Sample_Major.cpp
+    @brief Contains the tests for the Output_Sample_Major class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdint>  // for uint32_t, uint64_t
+#include <cstdio>   // for remove
+#include <fstream>  // for ifstream
+#include <string>   // for string, to_string
+#include <vector>   // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Abstract_Factory.hpp"                  // for Output_Factory
+#include "Output.hpp"                            // for Output_Options
+#include "Sample_Major/Output_Sample_Major.hpp"  // for Output_Sample_Major
+
+TEST_CASE("Output_Sample_Major class testing"
+          "[output_sample_major]")
+{
+    using GILES::Internal::Output_Sample_Major;
+
+    GILES::Internal::Output_Options options;
+    options.Path            = "Test_Output_Sample_Major.bin";
+    options.Traces_Per_Tile = 3;
+
+    // Sample s of run r is 10 * r + s.
+    const std::size_t number_of_runs{8};
+    const std::size_t number_of_samples{4};
+    const auto make_trace = [&](const std::size_t p_run_index) {
+        std::vector<float> trace(number_of_samples);
+        for (std::size_t sample{0}; sample < number_of_samples; ++sample)
+        {
+            trace[sample] = static_cast<float>(10 * p_run_index + sample);
+        }
+        return trace;
+    };
+
+    // Split the traces between two threads, so each thread fills one tile
+    // and leaves one partially filled.
+    {
+        const auto output =
+            GILES::Internal::Output_Factory::Construct("Sample Major", options);
+        output->Start(number_of_runs, 2);
+        for (std::size_t run{0}; run < number_of_runs; ++run)
+        {
+            output->Add_Trace(
+                run % 2, run, make_trace(run), std::to_string(run));
+        }
+        output->Finish();
+    }
+
+    std::ifstream file{options.Path, std::ios::binary};
+    Output_Sample_Major::Header header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    std::ifstream index_file{options.Path + ".index", std::ios::binary};
+    Output_Sample_Major::Header index_header;
+    index_file.read(reinterpret_cast<char*>(&index_header),
+                    sizeof(index_header));
+    std::vector<Output_Sample_Major::Tile_Entry> index(
+        index_header.Number_Of_Tiles);
+    index_file.read(
+        reinterpret_cast<char*>(index.data()),
+        static_cast<std::streamsize>(
+            index.size() * sizeof(Output_Sample_Major::Tile_Entry)));
+
+    SECTION("Header")
+    {
+        REQUIRE(std::string(header.Magic, 8) == "GILESSMT");
+        REQUIRE(1 == header.Version);
+        REQUIRE(number_of_samples == header.Number_Of_Samples);
+        REQUIRE(number_of_runs == header.Number_Of_Traces);
+        REQUIRE(3 == header.Traces_Per_Tile);
+        REQUIRE(4 == header.Number_Of_Tiles);
+
+        // The index starts with a copy of the header.
+        REQUIRE(index_header.Number_Of_Samples == header.Number_Of_Samples);
+        REQUIRE(index_header.Number_Of_Traces == header.Number_Of_Traces);
+        REQUIRE(index_header.Number_Of_Tiles == header.Number_Of_Tiles);
+    }
+
+    SECTION("Index")
+    {
+        REQUIRE(index.size() == 4);
+        REQUIRE(index[0].Offset == sizeof(header));
+        REQUIRE(index[0].Number_Of_Traces == 3);
+        REQUIRE(index[1].Number_Of_Traces == 3);
+        REQUIRE(index[2].Number_Of_Traces == 1);
+        REQUIRE(index[3].Number_Of_Traces == 1);
+
+        std::uint64_t first_trace{0};
+        for (const auto& entry : index)
+        {
+            REQUIRE(entry.First_Trace == first_trace);
+            first_trace += entry.Number_Of_Traces;
+        }
+    }
+
+    SECTION("Each tile holds every sample of its traces contiguously")
+    {
+        std::vector<bool> seen(number_of_runs, false);
+        for (const auto& entry : index)
+        {
+            const std::size_t traces{entry.Number_Of_Traces};
+            std::vector<float> samples(number_of_samples * traces);
+            std::vector<std::uint64_t> run_indices(traces);
+            file.seekg(static_cast<std::streamoff>(entry.Offset));
+            file.read(reinterpret_cast<char*>(samples.data()),
+                      static_cast<std::streamsize>(samples.size() *
+                                                   sizeof(float)));
+            file.read(reinterpret_cast<char*>(run_indices.data()),
+                      static_cast<std::streamsize>(run_indices.size() *
+                                                   sizeof(std::uint64_t)));
+
+            for (std::size_t trace{0}; trace < traces; ++trace)
+            {
+                const std::size_t run{run_indices[trace]};
+                REQUIRE(run < number_of_runs);
+                REQUIRE_FALSE(seen[run]);
+                seen[run] = true;
+
+                // Row s of the tile holds sample s of every trace.
+                for (std::size_t sample{0}; sample < number_of_samples;
+                     ++sample)
+                {
+                    REQUIRE(samples[sample * traces + trace] ==
+                            make_trace(run)[sample]);
+                }
+            }
+
+            for (std::size_t trace{0}; trace < traces; ++trace)
+            {
+                std::uint32_t size{0};
+                file.read(reinterpret_cast<char*>(&size), sizeof(size));
+                std::string extra_data(size, '\0');
+                file.read(&extra_data[0], size);
+                REQUIRE(extra_data == std::to_string(run_indices[trace]));
+            }
+            REQUIRE(file);
+        }
+        REQUIRE(std::vector<bool>(number_of_runs, true) == seen);
+    }
+
+    file.close();
+    index_file.close();
+    std::remove(options.Path.c_str());
+    std::remove((options.Path + ".index").c_str());
+}
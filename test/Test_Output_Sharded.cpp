@@ -0,0 +1,220 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Test_Output_Sharded.cpp
+    @brief Contains the tests for the Output_Sharded and Shard_Merger classes.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdint>   // for uint32_t, uint64_t
+#include <cstdio>    // for remove
+#include <fstream>   // for ifstream
+#include <iterator>  // for istreambuf_iterator
+#include <string>    // for string, to_string
+#include <vector>    // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Abstract_Factory.hpp"        // for Output_Factory
+#include "Error.hpp"                   // for Error
+#include "NumPy/Output_NumPy.hpp"      // for Output_NumPy
+#include "Output.hpp"                  // for Output_Options
+#include "Sharded/Output_Sharded.hpp"  // for Output_Sharded
+#include "Sharded/Shard_Merger.hpp"    // for Shard_Merger
+
+TEST_CASE("Output_Sharded class testing"
+          "[output_sharded]")
+{
+    using GILES::Internal::Output_Sharded;
+    using GILES::Internal::Shard_Merger;
+
+    const std::string path{"Test_Output_Sharded.bin"};
+    const std::string merged_path{"Test_Output_Sharded_merged.bin"};
+    const std::vector<std::string> shard_paths{
+        Output_Sharded::Shard_Path(path, 0),
+        Output_Sharded::Shard_Path(path, 1)};
+
+    // Reads the whole of a file.
+    const auto read = [](const std::string& p_path) {
+        std::ifstream file{p_path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file},
+                           std::istreambuf_iterator<char>{}};
+    };
+
+    // Sample s of run r is 10 * r + s.
+    const std::size_t number_of_runs{7};
+    const std::size_t number_of_samples{4};
+    const auto make_trace = [&](const std::size_t p_run_index) {
+        std::vector<float> trace(number_of_samples);
+        for (std::size_t sample{0}; sample < number_of_samples; ++sample)
+        {
+            trace[sample] = static_cast<float>(10 * p_run_index + sample);
+        }
+        return trace;
+    };
+    const auto make_extra_data = [](const std::size_t p_run_index) {
+        return std::string(2, static_cast<char>('a' + p_run_index));
+    };
+
+    // Each thread takes batches of runs, so the shards interleave. Runs 2 and
+    // 3 follow each other in shard 1, as do runs 4, 5 and 6 in shard 0.
+    const std::vector<std::vector<std::size_t>> runs_by_thread{{0, 1, 4, 5, 6},
+                                                               {2, 3}};
+    {
+        const auto output =
+            GILES::Internal::Output_Factory::Construct("Sharded", {path});
+        output->Start(number_of_runs, runs_by_thread.size());
+        for (std::size_t thread{0}; thread < runs_by_thread.size(); ++thread)
+        {
+            for (const std::size_t run : runs_by_thread[thread])
+            {
+                output->Add_Trace(
+                    thread, run, make_trace(run), make_extra_data(run));
+            }
+        }
+        output->Finish();
+    }
+
+    // The rows of the merged arrays, in run order.
+    std::string traces;
+    std::string extra_data;
+    for (std::size_t run{0}; run < number_of_runs; ++run)
+    {
+        const auto trace = make_trace(run);
+        traces.append(reinterpret_cast<const char*>(trace.data()),
+                      trace.size() * sizeof(float));
+        extra_data += make_extra_data(run);
+    }
+
+    SECTION("Each shard holds the traces of one thread in order")
+    {
+        for (std::size_t thread{0}; thread < runs_by_thread.size(); ++thread)
+        {
+            const auto& runs = runs_by_thread[thread];
+            const std::string shard{read(shard_paths[thread])};
+
+            Output_Sharded::Header header;
+            REQUIRE(shard.size() >= sizeof(header));
+            shard.copy(reinterpret_cast<char*>(&header), sizeof(header));
+            REQUIRE(std::string(header.Magic, 8) == "GILESSHD");
+            REQUIRE(number_of_samples == header.Number_Of_Samples);
+            REQUIRE(runs.size() == header.Number_Of_Traces);
+            REQUIRE(sizeof(header) +
+                        runs.size() * number_of_samples * sizeof(float) ==
+                    header.Footer_Offset);
+
+            std::size_t position{sizeof(header)};
+            for (const std::size_t run : runs)
+            {
+                std::vector<float> trace(number_of_samples);
+                shard.copy(reinterpret_cast<char*>(trace.data()),
+                           trace.size() * sizeof(float),
+                           position);
+                REQUIRE(make_trace(run) == trace);
+                position += trace.size() * sizeof(float);
+            }
+            for (const std::size_t run : runs)
+            {
+                std::uint64_t run_index{0};
+                shard.copy(reinterpret_cast<char*>(&run_index),
+                           sizeof(run_index),
+                           position);
+                REQUIRE(run == run_index);
+                position += sizeof(run_index);
+            }
+            for (const std::size_t run : runs)
+            {
+                std::uint32_t size{0};
+                shard.copy(
+                    reinterpret_cast<char*>(&size), sizeof(size), position);
+                position += sizeof(size);
+                REQUIRE(shard.substr(position, size) == make_extra_data(run));
+                position += size;
+            }
+            REQUIRE(shard.size() == position);
+        }
+    }
+
+    SECTION("Merging into NumPy")
+    {
+        Shard_Merger merger{shard_paths, merged_path, "NumPy"};
+        REQUIRE(number_of_runs == merger.Number_Of_Traces());
+        REQUIRE(2 == merger.Number_Of_Shards());
+        merger.Merge();
+
+        using GILES::Internal::Output_NumPy;
+        REQUIRE(read(merged_path) ==
+                Output_NumPy::Header("<f4", number_of_runs, number_of_samples) +
+                    traces);
+        REQUIRE(read(merged_path + ".extra.npy") ==
+                Output_NumPy::Header("|u1", number_of_runs, 2) + extra_data);
+
+        std::remove((merged_path + ".extra.npy").c_str());
+    }
+
+    SECTION("Merging into Raw")
+    {
+        Shard_Merger{shard_paths, merged_path, "Raw"}.Merge();
+
+        REQUIRE(read(merged_path) == traces);
+        REQUIRE(read(merged_path + ".extra") == extra_data);
+
+        std::remove((merged_path + ".extra").c_str());
+    }
+
+    SECTION("Merging into any other format passes the traces in run order")
+    {
+        Shard_Merger{shard_paths, merged_path, "TRS"}.Merge();
+
+        // The same traces saved directly, in run order.
+        const std::string direct_path{"Test_Output_Sharded_direct.trs"};
+        {
+            const auto output = GILES::Internal::Output_Factory::Construct(
+                "TRS", {direct_path});
+            output->Start(number_of_runs, 1);
+            for (std::size_t run{0}; run < number_of_runs; ++run)
+            {
+                output->Add_Trace(
+                    0, run, make_trace(run), make_extra_data(run));
+            }
+            output->Finish();
+        }
+        REQUIRE(read(merged_path) == read(direct_path));
+
+        std::remove(direct_path.c_str());
+    }
+
+    SECTION("Shards from different runs are reported")
+    {
+        const GILES::Internal::Error::Throw_Errors throw_errors;
+
+        // Every run in the shard appears twice.
+        REQUIRE_THROWS_AS(
+            Shard_Merger({shard_paths[0], shard_paths[0]}, merged_path, "Raw"),
+            GILES::Internal::Error::Exception);
+        REQUIRE_THROWS_AS(Shard_Merger({path}, merged_path, "Raw"),
+                          GILES::Internal::Error::Exception);
+    }
+
+    std::remove(merged_path.c_str());
+    for (const auto& shard_path : shard_paths)
+    {
+        std::remove(shard_path.c_str());
+    }
+}
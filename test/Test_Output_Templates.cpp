@@ -0,0 +1,97 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Output_Templates.cpp
+    @brief Contains the tests for the Output_Templates class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdio>   // for remove
+#include <fstream>  // for ifstream
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include <catch.hpp>  // for catch
+
+#include <nlohmann/json.hpp>  // for json
+
+#include "Abstract_Factory.hpp"  // for Output_Factory
+#include "Output.hpp"            // for Output_Options
+
+TEST_CASE("Output_Templates class testing"
+          "[output_templates]")
+{
+    const std::string path{"Test_Output_Templates.json"};
+
+    // Label is the second byte of the extra data.
+    GILES::Internal::Output_Options options{path, {0, 2}};
+    options.Label_Offset = 1;
+
+    const auto output =
+        GILES::Internal::Output_Factory::Construct("Templates", options);
+
+    // Three samples per trace, only the first and last are used.
+    const std::vector<std::vector<float>> class_a{
+        {1, 9, 2}, {3, 9, 5}, {2, 9, 1}, {6, 9, 4}};
+    const std::vector<std::vector<float>> class_b{{10, 9, 0}, {12, 9, 3}};
+
+    // Split the traces between two threads.
+    output->Start(6, 2);
+    for (std::size_t i{0}; i < class_a.size(); ++i)
+    {
+        output->Add_Trace(i % 2, i, class_a[i], "xAx");
+    }
+    for (std::size_t i{0}; i < class_b.size(); ++i)
+    {
+        output->Add_Trace(i % 2, i, class_b[i], "xBx");
+    }
+    output->Finish();
+
+    std::ifstream file{path};
+    const auto json = nlohmann::json::parse(file);
+    std::remove(path.c_str());
+
+    SECTION("Per class means")
+    {
+        // 'A' is 0x41, 'B' is 0x42.
+        REQUIRE(4 == json["Classes"]["41"]["Count"]);
+        REQUIRE(3.0 == Approx(json["Classes"]["41"]["Mean"][0].get<double>()));
+        REQUIRE(3.0 == Approx(json["Classes"]["41"]["Mean"][1].get<double>()));
+
+        REQUIRE(2 == json["Classes"]["42"]["Count"]);
+        REQUIRE(11.0 ==
+                Approx(json["Classes"]["42"]["Mean"][0].get<double>()));
+        REQUIRE(1.5 == Approx(json["Classes"]["42"]["Mean"][1].get<double>()));
+
+        REQUIRE(6 == json["Traces"]);
+    }
+
+    SECTION("Pooled covariance")
+    {
+        // Sum of the per class co-moments divided by (6 traces - 2 classes).
+        // Class A: xx = 14, xy = 7, yy = 10
+        // Class B: xx = 2, xy = 3, yy = 4.5
+        const auto& covariance = json["Pooled_Covariance"];
+        REQUIRE(16.0 / 4 == Approx(covariance[0][0].get<double>()));
+        REQUIRE(10.0 / 4 == Approx(covariance[0][1].get<double>()));
+        REQUIRE(10.0 / 4 == Approx(covariance[1][0].get<double>()));
+        REQUIRE(14.5 / 4 == Approx(covariance[1][1].get<double>()));
+    }
+}
@@ -0,0 +1,114 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Pipeline_States.cpp
+    @brief Contains the tests for the Pipeline_States class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <stdexcept>  // for out_of_range
+#include <vector>     // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Pipeline_States.hpp"  // for Pipeline_States, Pipeline_State
+
+TEST_CASE("Pipeline_States class testing"
+          "[pipeline_states]")
+{
+    using GILES::Internal::Pipeline_State;
+    using GILES::Internal::Pipeline_States;
+    using Runs = std::vector<Pipeline_States::Run>;
+
+    Pipeline_States states{10};
+
+    SECTION("Every cycle starts Normal")
+    {
+        REQUIRE(states.Get_Runs().empty());
+        REQUIRE(Pipeline_State::Normal == states.Get(9));
+        REQUIRE(0 == states.Next_Normal(0));
+        REQUIRE(10 == states.Next_Normal(10));
+        REQUIRE_THROWS_AS(states.Get(10), std::out_of_range);
+    }
+
+    SECTION("Runs set in order")
+    {
+        states.Set(1, 2, Pipeline_State::Stalled);
+        states.Set(3, 1, Pipeline_State::Stalled);
+        states.Set(4, 2, Pipeline_State::Flushing);
+        states.Set(8, 2, Pipeline_State::Stalled);
+
+        // Adjacent runs in the same state are merged.
+        REQUIRE(Runs{{1, 3, Pipeline_State::Stalled},
+                     {4, 2, Pipeline_State::Flushing},
+                     {8, 2, Pipeline_State::Stalled}} == states.Get_Runs());
+
+        REQUIRE(Pipeline_State::Normal == states.Get(0));
+        REQUIRE(Pipeline_State::Stalled == states.Get(3));
+        REQUIRE(Pipeline_State::Flushing == states.Get(5));
+        REQUIRE(Pipeline_State::Normal == states.Get(6));
+
+        // The stall and the flush are skipped together.
+        REQUIRE(0 == states.Next_Normal(0));
+        REQUIRE(6 == states.Next_Normal(1));
+        REQUIRE(7 == states.Next_Normal(7));
+        REQUIRE(10 == states.Next_Normal(8));
+
+        REQUIRE_THROWS_AS(states.Set(9, 2, Pipeline_State::Stalled),
+                          std::out_of_range);
+    }
+
+    SECTION("Runs set out of order")
+    {
+        states.Set(6, 3, Pipeline_State::Stalled);
+        states.Set(0, 2, Pipeline_State::Stalled);
+
+        // Splitting a run.
+        states.Set(7, 1, Pipeline_State::Flushing);
+        REQUIRE(Runs{{0, 2, Pipeline_State::Stalled},
+                     {6, 1, Pipeline_State::Stalled},
+                     {7, 1, Pipeline_State::Flushing},
+                     {8, 1, Pipeline_State::Stalled}} == states.Get_Runs());
+
+        // Setting cycles back to Normal, across several runs.
+        states.Set(1, 7, Pipeline_State::Normal);
+        REQUIRE(Runs{{0, 1, Pipeline_State::Stalled},
+                     {8, 1, Pipeline_State::Stalled}} == states.Get_Runs());
+
+        // Joining runs back together.
+        states.Set(1, 7, Pipeline_State::Stalled);
+        REQUIRE(Runs{{0, 9, Pipeline_State::Stalled}} == states.Get_Runs());
+        REQUIRE(9 == states.Next_Normal(0));
+    }
+
+    SECTION("Equality")
+    {
+        Pipeline_States other{10};
+        REQUIRE(other == states);
+
+        states.Set(2, 1, Pipeline_State::Stalled);
+        REQUIRE_FALSE(other == states);
+
+        other.Set(2, 1, Pipeline_State::Stalled);
+        REQUIRE(other == states);
+
+        REQUIRE_FALSE(Pipeline_States{9} == Pipeline_States{10});
+    }
+}
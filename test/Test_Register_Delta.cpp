@@ -0,0 +1,185 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Register_Delta.cpp
+    @brief Contains the tests for the Register_Columns and Register_Delta
+    classes.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <memory>     // for make_shared
+#include <stdexcept>  // for invalid_argument, out_of_range
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Execution.hpp"       // for Execution
+#include "Register_Delta.hpp"  // for Register_Delta, Register_Columns
+
+TEST_CASE("Register_Delta class testing"
+          "[register_delta]")
+{
+    using GILES::Internal::Register_Columns;
+    using GILES::Internal::Register_Delta;
+    using GILES::Internal::Registers;
+
+    const std::vector<Registers> reference_registers{
+        {{"R0", 1}, {"R1", 0x2000}, {"PC", 8}},
+        {{"R0", 2}, {"R1", 0x2000}, {"PC", 10}},
+        {{"R0", 3}, {"R1", 0x2000}, {"PC", 12}}};
+    const auto reference =
+        std::make_shared<const Register_Columns>(reference_registers);
+
+    SECTION("Register_Columns")
+    {
+        REQUIRE(std::vector<std::string>{"PC", "R0", "R1"} ==
+                reference->Get_Names());
+        REQUIRE(3 == reference->Get_Cycle_Count());
+        REQUIRE(1 == reference->Find("R0"));
+        REQUIRE(3 == reference->Find("R7"));
+        REQUIRE(10 == reference->Get_Value(1, 0));
+        REQUIRE(reference->Is_Present(2, 2));
+        REQUIRE_FALSE(reference->Is_Present(3, 2));
+        REQUIRE(0 == reference->Get_Value(3, 2));
+
+        REQUIRE(0x2000 == reference->Get_Value(2, "R1"));
+        REQUIRE_THROWS_AS(reference->Get_Value(2, "R7"), std::out_of_range);
+        REQUIRE_THROWS_AS(reference->Get_Value(3, "R1"), std::out_of_range);
+        REQUIRE(reference_registers[1] == reference->Get_Registers(1));
+        REQUIRE_THROWS_AS(reference->Get_Registers(3), std::out_of_range);
+
+        // Registers missing from some cycles.
+        const std::vector<Registers> registers{
+            {{"R0", 1}}, {{"R1", 2}, {"SP", 3}}, {}};
+        const Register_Columns columns{registers};
+
+        REQUIRE(std::vector<std::string>{"R0", "R1", "SP"} ==
+                columns.Get_Names());
+        REQUIRE_FALSE(columns.Is_Present(0, 1));
+        REQUIRE(columns.Is_Present(1, 2));
+        REQUIRE_THROWS_AS(columns.Get_Value(0, "SP"), std::out_of_range);
+        for (std::size_t cycle{0}; cycle < registers.size(); ++cycle)
+        {
+            REQUIRE(registers[cycle] == columns.Get_Registers(cycle));
+        }
+    }
+
+    SECTION("Identical runs have no differences")
+    {
+        const Register_Delta delta{reference, reference_registers};
+
+        REQUIRE(0 == delta.Get_Number_Of_Differences());
+        for (std::size_t cycle{0}; cycle < reference_registers.size(); ++cycle)
+        {
+            REQUIRE(reference_registers[cycle] == delta.Get_Registers(cycle));
+        }
+    }
+
+    SECTION("Only differences are stored")
+    {
+        const std::vector<Registers> registers{
+            {{"R0", 7}, {"R1", 0x2000}, {"PC", 8}},
+            {{"R0", 2}, {"R1", 0x2000}, {"PC", 10}},
+            {{"R0", 3}, {"PC", 12}},
+            {{"R0", 4}, {"R1", 0x2000}, {"PC", 14}}};
+        const Register_Delta delta{reference, registers};
+
+        // R0 during the first cycle, R1 during the third and every register
+        // during the fourth which is past the end of the reference run.
+        REQUIRE(5 == delta.Get_Number_Of_Differences());
+
+        REQUIRE(7 == delta.Get_Value(0, "R0"));
+        REQUIRE(0x2000 == delta.Get_Value(0, "R1"));
+        REQUIRE(12 == delta.Get_Value(2, "PC"));
+        REQUIRE(14 == delta.Get_Value(3, "PC"));
+
+        REQUIRE_FALSE(delta.Is_Present(2, "R1"));
+        REQUIRE_THROWS_AS(delta.Get_Value(2, "R1"), std::out_of_range);
+        REQUIRE_THROWS_AS(delta.Get_Value(0, "R7"), std::out_of_range);
+        REQUIRE_THROWS_AS(delta.Get_Value(4, "R0"), std::out_of_range);
+
+        for (std::size_t cycle{0}; cycle < registers.size(); ++cycle)
+        {
+            REQUIRE(registers[cycle] == delta.Get_Registers(cycle));
+        }
+        REQUIRE_THROWS_AS(delta.Get_Registers(4), std::out_of_range);
+    }
+
+    SECTION("Registers that are not in the reference")
+    {
+        REQUIRE_THROWS_AS(
+            Register_Delta(reference, {{{"R0", 1}, {"R2", 0}, {"PC", 8}}}),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(Register_Delta(reference, {{{"SP", 1}}}),
+                          std::invalid_argument);
+    }
+
+    SECTION("Compressed Executions")
+    {
+        GILES::Internal::Execution first{3};
+        first.Add_Registers_All(reference_registers);
+
+        GILES::Internal::Execution second{3};
+        second.Add_Registers_All({{{"R0", 9}, {"R1", 0x2000}, {"PC", 8}},
+                                  {{"R0", 2}, {"R1", 0x2000}, {"PC", 10}},
+                                  {{"R0", 3}, {"R1", 0x2000}, {"PC", 12}}});
+
+        REQUIRE(second.Compress_Registers(first.Make_Register_Reference()));
+        REQUIRE(second.Is_Compressed());
+
+        REQUIRE(second.Is_Register("R1"));
+        REQUIRE_FALSE(second.Is_Register("R7"));
+        REQUIRE(9 == second.Get_Register_Value(0, "R0"));
+        REQUIRE(9 == second.Get_Operand_Value(0, "R0"));
+        REQUIRE(12 == second.Get_Register_Value(2, "PC"));
+        REQUIRE(reference_registers[1] == second.Get_Registers(1));
+        REQUIRE_THROWS(second.Get_Register_Value(3, "PC"));
+        REQUIRE_THROWS(second.Get_Registers(3));
+
+        // Changing a register stores them in full again.
+        second.Add_Registers_Cycle(1, {{"R0", 5}});
+        REQUIRE_FALSE(second.Is_Compressed());
+        REQUIRE(5 == second.Get_Register_Value(1, "R0"));
+        REQUIRE(12 == second.Get_Register_Value(2, "PC"));
+
+        // Packed registers can be compressed and shared as a reference.
+        GILES::Internal::Execution packed{3};
+        packed.Add_Registers_Columns(reference);
+        REQUIRE(reference == packed.Make_Register_Reference());
+        REQUIRE(packed.Is_Register("PC"));
+        REQUIRE(0x2000 == packed.Get_Register_Value(2, "R1"));
+        REQUIRE_THROWS(packed.Get_Register_Value(3, "R1"));
+        REQUIRE(packed.Compress_Registers(reference));
+        REQUIRE(10 == packed.Get_Register_Value(1, "PC"));
+
+        // Changing a packed register unpacks them.
+        packed.Add_Registers_Cycle(0, {{"R0", 6}});
+        REQUIRE(6 == packed.Get_Register_Value(0, "R0"));
+        REQUIRE(reference_registers[2] == packed.Get_Registers(2));
+
+        // A register missing from the reference leaves them uncompressed.
+        GILES::Internal::Execution third{1};
+        third.Add_Registers_All({{{"R7", 1}}});
+        REQUIRE_FALSE(third.Compress_Registers(reference));
+        REQUIRE_FALSE(third.Is_Compressed());
+        REQUIRE(1 == third.Get_Register_Value(0, "R7"));
+    }
+}
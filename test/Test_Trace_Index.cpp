@@ -0,0 +1,141 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+    @file Test_Trace_Index.cpp
+    @brief Contains the tests for the Output_Index and Trace_Index classes.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdio>  // for remove
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Abstract_Factory.hpp"   // for Output_Factory
+#include "Index/Trace_Index.hpp"  // for Trace_Index
+#include "Output.hpp"             // for Output_Options
+
+TEST_CASE("Trace_Index class testing"
+          "[trace_index]")
+{
+    using GILES::Internal::Trace_Index;
+
+    const std::string path{"Test_Trace_Index.npy"};
+
+    GILES::Internal::Output_Options options{path};
+    options.Format = "NumPy";
+
+    // The index must be finished after the traces have been saved.
+    const auto traces =
+        GILES::Internal::Output_Factory::Construct("NumPy", options);
+    const auto index =
+        GILES::Internal::Output_Factory::Construct("Index", options);
+
+    // Four samples per trace, added out of order by two threads.
+    traces->Start(4, 2);
+    index->Start(4, 2);
+    for (const std::size_t run : {2, 0, 3, 1})
+    {
+        const std::vector<float> trace{static_cast<float>(run * 10),
+                                       static_cast<float>(run * 10 + 1),
+                                       static_cast<float>(run * 10 + 2),
+                                       static_cast<float>(run * 10 + 3)};
+        const std::string extra_data{run % 2 ? "odd" : "even"};
+        traces->Add_Trace(run % 2, run, trace, extra_data);
+        index->Add_Trace(run % 2, run, trace, extra_data);
+    }
+    traces->Finish();
+    index->Finish();
+
+    {
+        const Trace_Index trace_index{path};
+
+        SECTION("Sizes are read from the index")
+        {
+            REQUIRE(4 == trace_index.Number_Of_Traces());
+            REQUIRE(4 == trace_index.Number_Of_Samples());
+        }
+
+        SECTION("Whole traces are retrieved by run index")
+        {
+            REQUIRE(trace_index.Trace(0) == std::vector<float>{0, 1, 2, 3});
+            REQUIRE(trace_index.Trace(3) ==
+                    std::vector<float>{30, 31, 32, 33});
+        }
+
+        SECTION("Some samples of several traces are retrieved")
+        {
+            REQUIRE(trace_index.Traces({2, 1}, 1, 2) ==
+                    std::vector<float>{21, 22, 11, 12});
+            REQUIRE(trace_index.Traces({0, 1, 2, 3}, 3) ==
+                    std::vector<float>{3, 13, 23, 33});
+        }
+
+        SECTION("Traces are found by their extra data")
+        {
+            REQUIRE(trace_index.Find(std::string{"odd"}) ==
+                    std::vector<std::size_t>{1, 3});
+            REQUIRE(trace_index.Find(std::string{"none"}).empty());
+        }
+    }
+
+    std::remove(path.c_str());
+    std::remove((path + ".extra.npy").c_str());
+    std::remove(Trace_Index::Index_Path(path).c_str());
+}
+
+TEST_CASE("Only the completed runs of a stopped run are indexed"
+          "[trace_index]")
+{
+    using GILES::Internal::Trace_Index;
+
+    const std::string path{"Test_Trace_Index_Stopped.npy"};
+
+    GILES::Internal::Output_Options options{path};
+    options.Format = "NumPy";
+
+    const auto traces =
+        GILES::Internal::Output_Factory::Construct("NumPy", options);
+    const auto index =
+        GILES::Internal::Output_Factory::Construct("Index", options);
+
+    // Only the first two of four runs are completed.
+    traces->Start(4, 1);
+    index->Start(4, 1);
+    for (const std::size_t run : {1, 0})
+    {
+        const std::vector<float> trace{static_cast<float>(run),
+                                       static_cast<float>(run + 1)};
+        traces->Add_Trace(0, run, trace, "");
+        index->Add_Trace(0, run, trace, "");
+    }
+    traces->Stopped(2);
+    index->Stopped(2);
+    traces->Finish();
+    index->Finish();
+
+    const Trace_Index trace_index{path};
+    REQUIRE(2 == trace_index.Number_Of_Traces());
+    REQUIRE(trace_index.Trace(1) == std::vector<float>{1, 2});
+
+    std::remove(path.c_str());
+    std::remove((path + ".extra.npy").c_str());
+    std::remove(Trace_Index::Index_Path(path).c_str());
+}
@@ -0,0 +1,214 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*!
+    @file Test_Trace_Matrix.cpp
+    @brief Contains the tests for the Trace_Matrix class and the Outputs that
+    fill it.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstddef>  // for size_t
+#include <mutex>    // for mutex, lock_guard
+#include <string>   // for string
+#include <thread>   // for thread
+#include <vector>   // for vector
+
+#include <catch.hpp>  // for catch
+
+#include "Matrix/Output_Batches.hpp"  // for Output_Batches
+#include "Matrix/Output_Matrix.hpp"   // for Output_Matrix
+#include "Matrix/Trace_Matrix.hpp"    // for Trace_Matrix
+
+TEST_CASE("Trace_Matrix class testing"
+          "[trace_matrix]")
+{
+    using GILES::Internal::Trace_Matrix;
+
+    SECTION("Rows are contiguous and padded to the widest trace")
+    {
+        Trace_Matrix matrix;
+        matrix.Append(7, {1, 2}, "ab");
+        matrix.Append(3, {3, 4, 5}, "c");
+
+        REQUIRE(matrix.Rows() == 2);
+        REQUIRE(matrix.Stride() == 3);
+        REQUIRE(matrix.Row(1) == matrix.Data() + 3);
+        REQUIRE(std::vector<float>(matrix.Data(), matrix.Data() + 6) ==
+                std::vector<float>{1, 2, 0, 3, 4, 5});
+        REQUIRE(matrix.Length(0) == 2);
+        REQUIRE(matrix.Run(0) == 7);
+        REQUIRE(matrix.Run(1) == 3);
+        REQUIRE(matrix.Extra_Data(0) == "ab");
+        REQUIRE(matrix.Extra_Data(1) == "c");
+    }
+
+    SECTION("Clearing keeps the memory for reuse")
+    {
+        Trace_Matrix matrix;
+        matrix.Reserve(4);
+        matrix.Append(0, {1, 2, 3}, "");
+        const float* const data{matrix.Data()};
+
+        matrix.Clear();
+        REQUIRE(matrix.Rows() == 0);
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            matrix.Append(i, {4, 5, 6}, "");
+        }
+        REQUIRE(matrix.Data() == data);
+    }
+
+    SECTION("Output_Matrix places each run in its own row")
+    {
+        GILES::Internal::Output_Matrix output;
+        output.Start(64, 4);
+
+        std::vector<std::thread> threads;
+        for (std::size_t thread{0}; thread < 4; ++thread)
+        {
+            threads.emplace_back([&output, thread] {
+                for (std::size_t run{thread}; run < 64; run += 4)
+                {
+                    // Later runs are longer so the matrix is widened while
+                    // other threads are adding traces.
+                    const std::vector<float> trace(1 + run / 16,
+                                                   static_cast<float>(run));
+                    output.Add_Trace(
+                        thread, run, trace, {static_cast<char>(run)});
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        output.Finish();
+
+        const auto& matrix = output.Get_Matrix();
+        REQUIRE(matrix.Rows() == 64);
+        REQUIRE(matrix.Stride() == 4);
+        for (std::size_t run{0}; run < 64; ++run)
+        {
+            REQUIRE(matrix.Run(run) == run);
+            REQUIRE(matrix.Length(run) == 1 + run / 16);
+            REQUIRE(matrix.Row(run)[0] == static_cast<float>(run));
+            REQUIRE(matrix.Extra_Data(run) ==
+                    std::string{static_cast<char>(run)});
+        }
+    }
+
+    SECTION("Output_Matrix allocates every row up front given the size")
+    {
+        GILES::Internal::Output_Matrix output;
+        output.Set_Trace_Size(8, 2);
+        output.Start(16, 1);
+
+        const auto& matrix = output.Get_Matrix();
+        REQUIRE(matrix.Rows() == 16);
+        REQUIRE(matrix.Stride() == 8);
+
+        // Traces of the expected size are placed without reallocating.
+        const float* const data{matrix.Data()};
+        const char* const extra_data{matrix.Extra_Data(0).data()};
+        for (std::size_t run{0}; run < 16; ++run)
+        {
+            output.Add_Trace(0,
+                             run,
+                             std::vector<float>(8, static_cast<float>(run)),
+                             std::string(2, static_cast<char>(run)));
+        }
+        output.Finish();
+        REQUIRE(matrix.Data() == data);
+        REQUIRE(matrix.Extra_Data(0).data() == extra_data);
+        REQUIRE(matrix.Row(15)[7] == 15);
+        REQUIRE(matrix.Extra_Data(15) == std::string(2, 15));
+    }
+
+    SECTION("Output_Matrix lets traces be written straight into their rows")
+    {
+        GILES::Internal::Output_Matrix output;
+        output.Set_Trace_Size(4, 1);
+        output.Start(2, 1);
+
+        const auto& matrix = output.Get_Matrix();
+        const float* const data{matrix.Data()};
+        {
+            auto row = output.Take_Row(1, 3, 1);
+            REQUIRE(row);
+            REQUIRE(row->Samples() == data + 4);
+            for (std::size_t sample{0}; sample < 3; ++sample)
+            {
+                row->Samples()[sample] = static_cast<float>(sample + 1);
+            }
+            row->Complete(3, "x");
+        }
+
+        // A trace longer than expected is added using Add_Trace() instead.
+        REQUIRE_FALSE(output.Take_Row(0, 5, 1));
+        output.Finish();
+
+        REQUIRE(matrix.Data() == data);
+        REQUIRE(std::vector<float>(matrix.Row(1), matrix.Row(1) + 4) ==
+                std::vector<float>{1, 2, 3, 0});
+        REQUIRE(matrix.Length(1) == 3);
+        REQUIRE(matrix.Run(1) == 1);
+        REQUIRE(matrix.Extra_Data(1) == "x");
+    }
+
+    SECTION("Output_Matrix only keeps completed runs when stopped")
+    {
+        GILES::Internal::Output_Matrix output;
+        output.Start(10, 1);
+        output.Add_Trace(0, 0, {1}, "");
+        output.Add_Trace(0, 1, {2}, "");
+        output.Stopped(2);
+        output.Finish();
+
+        REQUIRE(output.Get_Matrix().Rows() == 2);
+    }
+
+    SECTION("Output_Batches passes full batches to the callback")
+    {
+        std::mutex mutex;
+        std::vector<std::size_t> batch_sizes;
+        std::vector<std::size_t> runs;
+        GILES::Internal::Output_Batches output{
+            [&](const Trace_Matrix& p_batch) {
+                const std::lock_guard<std::mutex> lock{mutex};
+                batch_sizes.push_back(p_batch.Rows());
+                for (std::size_t i{0}; i < p_batch.Rows(); ++i)
+                {
+                    runs.push_back(p_batch.Run(i));
+                }
+            },
+            4};
+        output.Start(10, 2);
+
+        for (std::size_t run{0}; run < 10; ++run)
+        {
+            output.Add_Trace(run % 2, run, {1, 2}, "");
+        }
+        REQUIRE(batch_sizes == std::vector<std::size_t>{4, 4});
+
+        output.Finish();
+        REQUIRE(batch_sizes == std::vector<std::size_t>{4, 4, 1, 1});
+        REQUIRE(runs.size() == 10);
+    }
+}
@@ -0,0 +1,203 @@
+/*
+    This file is part of GILES.
+
+    GILES is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    GILES is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with GILES.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*!
+/*!
+    @file Test_Writer.cpp
+    @brief Contains the tests for the Writer class.
+    @author Scott Egerton
+    @date 2017-2019
+    @copyright GNU Affero General Public License Version 3+
+*/
+
+#include <cstdint>   // for uint64_t
+#include <cstdio>    // for remove
+#include <fstream>   // for ifstream
+#include <iterator>  // for istreambuf_iterator
+#include <string>    // for string
+
+#include <catch.hpp>  // for catch
+
+#include "Error.hpp"   // for Error
+#include "Writer.hpp"  // for Writer
+
+namespace
+{
+//! @brief Reads the whole of a file.
+//! @param p_path The path to the file.
+//! @returns The contents of the file.
+std::string read_file(const std::string& p_path)
+{
+    std::ifstream file{p_path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file},
+            std::istreambuf_iterator<char>{}};
+}
+
+//! @brief Creates data that differs at every position, so that anything
+//! written to the wrong place is noticed.
+//! @param p_size The number of bytes.
+//! @returns The data.
+std::string make_data(const std::size_t p_size)
+{
+    std::string data(p_size, '\0');
+    for (std::size_t i{0}; i < p_size; ++i)
+    {
+        data[i] = static_cast<char>(i * 7 + i / 251);
+    }
+    return data;
+}
+}  // namespace
+
+TEST_CASE("Writer class testing"
+          "[writer]")
+{
+    using GILES::Internal::Writer;
+
+    const std::string path{"Test_Writer.bin"};
+
+    // This is small enough that the data below fills many blocks.
+    constexpr std::size_t budget{8192};
+    const std::string data{make_data(20000)};
+
+    SECTION("Appended data is written in order")
+    {
+        {
+            Writer writer{path, budget};
+            for (std::size_t i{0}; i < data.size(); i += 1000)
+            {
+                writer.Append(data.data() + i, 1000);
+            }
+            REQUIRE(data.size() == writer.Position());
+        }
+        REQUIRE(data == read_file(path));
+    }
+
+    SECTION("Positional writes are written in order")
+    {
+        {
+            Writer writer{path, budget};
+            for (std::size_t i{0}; i < data.size(); i += 500)
+            {
+                writer.Write(data.data() + i, 500, i);
+            }
+
+            // Positional writes do not move the position of Append().
+            REQUIRE(0 == writer.Position());
+        }
+        REQUIRE(data == read_file(path));
+    }
+
+    SECTION("Positional writes are written out of order")
+    {
+        {
+            Writer writer{path, budget};
+            for (std::size_t i{data.size()}; 0 != i; i -= 500)
+            {
+                writer.Write(data.data() + i - 500, 500, i - 500);
+            }
+        }
+        REQUIRE(data == read_file(path));
+    }
+
+    SECTION("Positional writes overwrite appended data")
+    {
+        {
+            Writer writer{path, budget};
+            writer.Append(data.data(), data.size());
+            writer.Write("header", 6, 100);
+        }
+        auto expected = data;
+        expected.replace(100, 6, "header");
+        REQUIRE(expected == read_file(path));
+    }
+
+    SECTION("Flushed data is on disk before closing")
+    {
+        Writer writer{path, budget};
+        writer.Append(data.data(), 100);
+        writer.Flush();
+        REQUIRE(data.substr(0, 100) == read_file(path));
+
+        writer.Write(data.data() + 100, 100, 100);
+        writer.Flush();
+        REQUIRE(data.substr(0, 200) == read_file(path));
+
+        writer.Close();
+        REQUIRE(data.substr(0, 200) == read_file(path));
+    }
+
+    SECTION("Contents are kept when reopening")
+    {
+        {
+            Writer writer{path, budget};
+            writer.Append(data.data(), 5000);
+        }
+        {
+            Writer writer{path, budget, true};
+            REQUIRE(5000 == writer.Position());
+            writer.Append(data.data() + 5000, data.size() - 5000);
+        }
+        REQUIRE(data == read_file(path));
+
+        {
+            Writer writer{path, budget};
+            writer.Append(data.data(), 10);
+        }
+        REQUIRE(data.substr(0, 10) == read_file(path));
+    }
+
+    SECTION("Positional writes are written within kept contents")
+    {
+        // As an interrupted run leaves a file that it had sized up front.
+        {
+            Writer writer{path, budget};
+            writer.Append(data.data(), 5000);
+            writer.Resize(data.size());
+        }
+        {
+            Writer writer{path, budget, true};
+            REQUIRE(data.size() == writer.Position());
+            for (std::size_t i{data.size()}; i > 5000; i -= 500)
+            {
+                writer.Write(data.data() + i - 500, 500, i - 500);
+            }
+        }
+        REQUIRE(data == read_file(path));
+    }
+
+    SECTION("Write errors are reported by Close() but not the destructor")
+    {
+        const GILES::Internal::Error::Throw_Errors throw_errors;
+
+        // Every write to this fails as the device is always full.
+        const std::string full{"/dev/full"};
+        {
+            Writer writer{full, budget, true};
+            writer.Append(data.data(), data.size());
+            REQUIRE_THROWS_AS(writer.Close(),
+                              GILES::Internal::Error::Exception);
+
+            // The error is only reported once.
+            REQUIRE_NOTHROW(writer.Close());
+        }
+        REQUIRE_NOTHROW([&] {
+            Writer writer{full, budget, true};
+            writer.Append(data.data(), data.size());
+        }());
+    }
+
+    std::remove(path.c_str());
+}
@@ -33,7 +33,27 @@
 #include <catch.hpp>  // for catch
 
 // The actual tests
+#include "Test_Chunked_Buffer.cpp"
+#include "Test_Codec.cpp"
 #include "Test_Coefficients.cpp"
 #include "Test_Execution.cpp"
 #include "Test_Factory.cpp"
+#include "Test_GILES.cpp"
+#include "Test_IO.cpp"
+#include "Test_Input_Generator.cpp"
+#include "Test_Instruction_Stream.cpp"
+#include "Test_Job_Pool.cpp"
+#include "Test_Journal.cpp"
+#include "Test_Memory_Budget.cpp"
+#include "Test_Output_NumPy.cpp"
+#include "Test_Output_Ordered.cpp"
+#include "Test_Output_Preview.cpp"
+#include "Test_Output_Sample_Major.cpp"
+#include "Test_Output_Sharded.cpp"
+#include "Test_Output_Templates.cpp"
+#include "Test_Pipeline_States.cpp"
+#include "Test_Register_Delta.cpp"
+#include "Test_Trace_Index.cpp"
+#include "Test_Trace_Matrix.cpp"
 #include "Test_Validator_Coefficients.cpp"
+#include "Test_Writer.cpp"